@@ -0,0 +1,269 @@
+#include "bodyStore.h"
+
+#include "physical.h"
+#include <cmath>
+#include <assert.h>
+
+namespace P3D {
+void Vec3Array::resize(std::size_t size) {
+	x.resize(size);
+	y.resize(size);
+	z.resize(size);
+}
+
+void Vec3Array::reserve(std::size_t size) {
+	x.reserve(size);
+	y.reserve(size);
+	z.reserve(size);
+}
+
+void SymmetricMat3Array::resize(std::size_t size) {
+	xx.resize(size);
+	yy.resize(size);
+	zz.resize(size);
+	xy.resize(size);
+	xz.resize(size);
+	yz.resize(size);
+}
+
+void SymmetricMat3Array::reserve(std::size_t size) {
+	xx.reserve(size);
+	yy.reserve(size);
+	zz.reserve(size);
+	xy.reserve(size);
+	xz.reserve(size);
+	yz.reserve(size);
+}
+
+void Mat3Array::resize(std::size_t size) {
+	for(std::vector<double>& element : m) {
+		element.resize(size);
+	}
+}
+
+void Mat3Array::reserve(std::size_t size) {
+	for(std::vector<double>& element : m) {
+		element.reserve(size);
+	}
+}
+
+void BodyStore::clear() {
+	physicals.clear();
+}
+
+void BodyStore::reserve(std::size_t size) {
+	physicals.reserve(size);
+	velocity.reserve(size);
+	angularVelocity.reserve(size);
+	force.reserve(size);
+	moment.reserve(size);
+	inverseMass.reserve(size);
+	inertia.reserve(size);
+	inverseInertia.reserve(size);
+	localCenterOfMass.reserve(size);
+	rotation.reserve(size);
+	movement.reserve(size);
+}
+
+std::size_t BodyStore::add(MotorizedPhysical* physical) {
+	assert(physical->childPhysicals.empty());
+
+	std::size_t index = physicals.size();
+	physicals.push_back(physical);
+
+	// the arrays only grow, clear keeps their memory for the next tick
+	if(inverseMass.size() < physicals.size()) {
+		std::size_t newSize = physicals.size();
+		velocity.resize(newSize);
+		angularVelocity.resize(newSize);
+		force.resize(newSize);
+		moment.resize(newSize);
+		inverseMass.resize(newSize);
+		inertia.resize(newSize);
+		inverseInertia.resize(newSize);
+		localCenterOfMass.resize(newSize);
+		rotation.resize(newSize);
+		movement.resize(newSize);
+	}
+
+	velocity.set(index, physical->motionOfCenterOfMass.getVelocity());
+	angularVelocity.set(index, physical->motionOfCenterOfMass.getAngularVelocity());
+	force.set(index, physical->totalForce);
+	moment.set(index, physical->totalMoment);
+	inverseMass[index] = 1.0 / physical->totalMass;
+	inertia.set(index, physical->rigidBody.inertia);
+	inverseInertia.set(index, physical->momentResponse);
+	localCenterOfMass.set(index, physical->totalCenterOfMass);
+	rotation.set(index, physical->getCFrame().getRotation().asRotationMatrix());
+
+	return index;
+}
+
+// Rotates (x, y, z) by the rotation vector r with Rodrigues' formula, sinc and cosc are sin(angle) / angle and (1 - cos(angle)) / angle^2
+static inline void rotateByRotationVector(double& x, double& y, double& z, double rx, double ry, double rz, double cosAngle, double sinc, double cosc) {
+	double dot = (rx * x + ry * y + rz * z) * cosc;
+	double newX = cosAngle * x + sinc * (ry * z - rz * y) + dot * rx;
+	double newY = cosAngle * y + sinc * (rz * x - rx * z) + dot * ry;
+	double newZ = cosAngle * z + sinc * (rx * y - ry * x) + dot * rz;
+	x = newX;
+	y = newY;
+	z = newZ;
+}
+
+void BodyStore::integrate(double deltaT) {
+	std::size_t count = size();
+
+	double* vx = velocity.x.data();
+	double* vy = velocity.y.data();
+	double* vz = velocity.z.data();
+	double* wx = angularVelocity.x.data();
+	double* wy = angularVelocity.y.data();
+	double* wz = angularVelocity.z.data();
+	double* fx = force.x.data();
+	double* fy = force.y.data();
+	double* fz = force.z.data();
+	double* mx = moment.x.data();
+	double* my = moment.y.data();
+	double* mz = moment.z.data();
+	const double* invMass = inverseMass.data();
+	const double* ixx = inertia.xx.data();
+	const double* iyy = inertia.yy.data();
+	const double* izz = inertia.zz.data();
+	const double* ixy = inertia.xy.data();
+	const double* ixz = inertia.xz.data();
+	const double* iyz = inertia.yz.data();
+	const double* rxx = inverseInertia.xx.data();
+	const double* ryy = inverseInertia.yy.data();
+	const double* rzz = inverseInertia.zz.data();
+	const double* rxy = inverseInertia.xy.data();
+	const double* rxz = inverseInertia.xz.data();
+	const double* ryz = inverseInertia.yz.data();
+	const double* cx = localCenterOfMass.x.data();
+	const double* cy = localCenterOfMass.y.data();
+	const double* cz = localCenterOfMass.z.data();
+	double* r[9];
+	for(int j = 0; j < 9; j++) {
+		r[j] = rotation.m[j].data();
+	}
+	double* dx = movement.x.data();
+	double* dy = movement.y.data();
+	double* dz = movement.z.data();
+
+	double halfDeltaTSq = deltaT * deltaT * 0.5;
+
+	for(std::size_t i = 0; i < count; i++) {
+		double r00 = r[0][i], r01 = r[1][i], r02 = r[2][i];
+		double r10 = r[3][i], r11 = r[4][i], r12 = r[5][i];
+		double r20 = r[6][i], r21 = r[7][i], r22 = r[8][i];
+
+		double factor = invMass[i] * deltaT;
+		double ax = fx[i] * factor;
+		double ay = fy[i] * factor;
+		double az = fz[i] * factor;
+
+		double velX = vx[i] + ax;
+		double velY = vy[i] + ay;
+		double velZ = vz[i] + az;
+
+		// the moment is applied in local space, like in MotorizedPhysical::update
+		double localMx = r00 * mx[i] + r10 * my[i] + r20 * mz[i];
+		double localMy = r01 * mx[i] + r11 * my[i] + r21 * mz[i];
+		double localMz = r02 * mx[i] + r12 * my[i] + r22 * mz[i];
+		double localAccX = (rxx[i] * localMx + rxy[i] * localMy + rxz[i] * localMz) * deltaT;
+		double localAccY = (rxy[i] * localMx + ryy[i] * localMy + ryz[i] * localMz) * deltaT;
+		double localAccZ = (rxz[i] * localMx + ryz[i] * localMy + rzz[i] * localMz) * deltaT;
+		double angX = wx[i] + r00 * localAccX + r01 * localAccY + r02 * localAccZ;
+		double angY = wy[i] + r10 * localAccX + r11 * localAccY + r12 * localAccZ;
+		double angZ = wz[i] + r20 * localAccX + r21 * localAccY + r22 * localAccZ;
+
+		// angular momentum before the step, R * I * R^T * w
+		double localWx = r00 * angX + r10 * angY + r20 * angZ;
+		double localWy = r01 * angX + r11 * angY + r21 * angZ;
+		double localWz = r02 * angX + r12 * angY + r22 * angZ;
+		double localLx = ixx[i] * localWx + ixy[i] * localWy + ixz[i] * localWz;
+		double localLy = ixy[i] * localWx + iyy[i] * localWy + iyz[i] * localWz;
+		double localLz = ixz[i] * localWx + iyz[i] * localWy + izz[i] * localWz;
+		double lx = r00 * localLx + r01 * localLy + r02 * localLz;
+		double ly = r10 * localLx + r11 * localLy + r12 * localLz;
+		double lz = r20 * localLx + r21 * localLy + r22 * localLz;
+
+		// the rotation of this step turns every column of the rotation matrix
+		double rotX = angX * deltaT;
+		double rotY = angY * deltaT;
+		double rotZ = angZ * deltaT;
+		double angleSq = rotX * rotX + rotY * rotY + rotZ * rotZ;
+		double angle = std::sqrt(angleSq);
+		double cosAngle = std::cos(angle);
+		// series around 0, as in rotationMatrixFromRotationVec
+		double sinc = (angleSq > 1E-20) ? std::sin(angle) / angle : 1 - angleSq / 6;
+		double cosc = (angleSq > 1E-20) ? (1 - cosAngle) / angleSq : 0.5 - angleSq / 24;
+
+		double comBeforeX = r00 * cx[i] + r01 * cy[i] + r02 * cz[i];
+		double comBeforeY = r10 * cx[i] + r11 * cy[i] + r12 * cz[i];
+		double comBeforeZ = r20 * cx[i] + r21 * cy[i] + r22 * cz[i];
+
+		rotateByRotationVector(r00, r10, r20, rotX, rotY, rotZ, cosAngle, sinc, cosc);
+		rotateByRotationVector(r01, r11, r21, rotX, rotY, rotZ, cosAngle, sinc, cosc);
+		rotateByRotationVector(r02, r12, r22, rotX, rotY, rotZ, cosAngle, sinc, cosc);
+
+		double comAfterX = r00 * cx[i] + r01 * cy[i] + r02 * cz[i];
+		double comAfterY = r10 * cx[i] + r11 * cy[i] + r12 * cz[i];
+		double comAfterZ = r20 * cx[i] + r21 * cy[i] + r22 * cz[i];
+
+		// the main part turns around the center of mass while the center of mass moves
+		dx[i] = velX * deltaT + ax * halfDeltaTSq + comBeforeX - comAfterX;
+		dy[i] = velY * deltaT + ay * halfDeltaTSq + comBeforeY - comAfterY;
+		dz[i] = velZ * deltaT + az * halfDeltaTSq + comBeforeZ - comAfterZ;
+
+		// the inertia turns along with the body, the same correction as MotorizedPhysical::updateRigid
+		// w -= R' * I^-1 * R'^T * (R' * I * R'^T * w - L)
+		double newLocalWx = r00 * angX + r10 * angY + r20 * angZ;
+		double newLocalWy = r01 * angX + r11 * angY + r21 * angZ;
+		double newLocalWz = r02 * angX + r12 * angY + r22 * angZ;
+		double newLocalLx = ixx[i] * newLocalWx + ixy[i] * newLocalWy + ixz[i] * newLocalWz;
+		double newLocalLy = ixy[i] * newLocalWx + iyy[i] * newLocalWy + iyz[i] * newLocalWz;
+		double newLocalLz = ixz[i] * newLocalWx + iyz[i] * newLocalWy + izz[i] * newLocalWz;
+		double deltaLx = r00 * newLocalLx + r01 * newLocalLy + r02 * newLocalLz - lx;
+		double deltaLy = r10 * newLocalLx + r11 * newLocalLy + r12 * newLocalLz - ly;
+		double deltaLz = r20 * newLocalLx + r21 * newLocalLy + r22 * newLocalLz - lz;
+		double localDeltaLx = r00 * deltaLx + r10 * deltaLy + r20 * deltaLz;
+		double localDeltaLy = r01 * deltaLx + r11 * deltaLy + r21 * deltaLz;
+		double localDeltaLz = r02 * deltaLx + r12 * deltaLy + r22 * deltaLz;
+		double localDeltaWx = rxx[i] * localDeltaLx + rxy[i] * localDeltaLy + rxz[i] * localDeltaLz;
+		double localDeltaWy = rxy[i] * localDeltaLx + ryy[i] * localDeltaLy + ryz[i] * localDeltaLz;
+		double localDeltaWz = rxz[i] * localDeltaLx + ryz[i] * localDeltaLy + rzz[i] * localDeltaLz;
+
+		vx[i] = velX;
+		vy[i] = velY;
+		vz[i] = velZ;
+		wx[i] = angX - (r00 * localDeltaWx + r01 * localDeltaWy + r02 * localDeltaWz);
+		wy[i] = angY - (r10 * localDeltaWx + r11 * localDeltaWy + r12 * localDeltaWz);
+		wz[i] = angZ - (r20 * localDeltaWx + r21 * localDeltaWy + r22 * localDeltaWz);
+
+		r[0][i] = r00; r[1][i] = r01; r[2][i] = r02;
+		r[3][i] = r10; r[4][i] = r11; r[5][i] = r12;
+		r[6][i] = r20; r[7][i] = r21; r[8][i] = r22;
+
+		fx[i] = 0.0;
+		fy[i] = 0.0;
+		fz[i] = 0.0;
+		mx[i] = 0.0;
+		my[i] = 0.0;
+		mz[i] = 0.0;
+	}
+}
+
+void BodyStore::scatter() {
+	for(std::size_t i = 0; i < size(); i++) {
+		MotorizedPhysical* physical = physicals[i];
+
+		physical->motionOfCenterOfMass.translation.translation[0] = velocity.get(i);
+		physical->motionOfCenterOfMass.rotation.rotation[0] = angularVelocity.get(i);
+		physical->totalForce = Vec3();
+		physical->totalMoment = Vec3();
+
+		GlobalCFrame cframe = physical->getCFrame();
+		physical->rigidBody.setCFrame(GlobalCFrame(cframe.getPosition() + movement.get(i), Rotation::fromRotationMatrix(rotation.get(i))));
+	}
+}
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "math/linalg/vec.h"
+#include "math/linalg/mat.h"
+
+namespace P3D {
+class MotorizedPhysical;
+
+// Vec3s stored as three separate arrays so loops over many of them can be vectorized
+struct Vec3Array {
+	std::vector<double> x;
+	std::vector<double> y;
+	std::vector<double> z;
+
+	inline Vec3 get(std::size_t index) const {
+		return Vec3(x[index], y[index], z[index]);
+	}
+
+	inline void set(std::size_t index, const Vec3& value) {
+		x[index] = value.x;
+		y[index] = value.y;
+		z[index] = value.z;
+	}
+
+	void resize(std::size_t size);
+	void reserve(std::size_t size);
+};
+
+struct SymmetricMat3Array {
+	std::vector<double> xx;
+	std::vector<double> yy;
+	std::vector<double> zz;
+	std::vector<double> xy;
+	std::vector<double> xz;
+	std::vector<double> yz;
+
+	inline SymmetricMat3 get(std::size_t index) const {
+		return SymmetricMat3{
+			xx[index],
+			xy[index], yy[index],
+			xz[index], yz[index], zz[index]
+		};
+	}
+
+	inline void set(std::size_t index, const SymmetricMat3& value) {
+		xx[index] = value(0, 0);
+		yy[index] = value(1, 1);
+		zz[index] = value(2, 2);
+		xy[index] = value(0, 1);
+		xz[index] = value(0, 2);
+		yz[index] = value(1, 2);
+	}
+
+	void resize(std::size_t size);
+	void reserve(std::size_t size);
+};
+
+struct Mat3Array {
+	std::vector<double> m[9];
+
+	inline Mat3 get(std::size_t index) const {
+		return Mat3{
+			m[0][index], m[1][index], m[2][index],
+			m[3][index], m[4][index], m[5][index],
+			m[6][index], m[7][index], m[8][index]
+		};
+	}
+
+	inline void set(std::size_t index, const Mat3& value) {
+		for(std::size_t row = 0; row < 3; row++) {
+			for(std::size_t col = 0; col < 3; col++) {
+				m[row * 3 + col][index] = value(row, col);
+			}
+		}
+	}
+
+	void resize(std::size_t size);
+	void reserve(std::size_t size);
+};
+
+/*
+	Structure of arrays copy of the integrable state of rigid physicals, those without connected physicals.
+
+	Physicals are gathered into the store, integrated together and the result is scattered back. The store is refilled every tick,
+	physicals are merged, split and deleted while handling the world and an index kept between ticks would not survive that.
+	Positions are not needed to integrate, integrate only computes how far each body moves and scatter applies it.
+
+	Gathering and scattering is bound by loading the physicals from memory, when the store is filled with blocks of BLOCK_SIZE
+	physicals every physical is still in the cache when it is scattered.
+*/
+class BodyStore {
+public:
+	static constexpr std::size_t BLOCK_SIZE = 64;
+
+private:
+	std::vector<MotorizedPhysical*> physicals;
+
+	Vec3Array velocity;
+	Vec3Array angularVelocity;
+	Vec3Array force;
+	Vec3Array moment;
+	std::vector<double> inverseMass;
+
+	// the inertia, inverse inertia and center of mass are local to the rigid body, rotation rotates the body from local to global
+	SymmetricMat3Array inertia;
+	SymmetricMat3Array inverseInertia;
+	Vec3Array localCenterOfMass;
+	Mat3Array rotation;
+
+	// result of integrate, how far the cframe of the main part moved
+	Vec3Array movement;
+
+public:
+	std::size_t size() const { return physicals.size(); }
+	bool empty() const { return physicals.empty(); }
+	MotorizedPhysical* getPhysical(std::size_t index) const { return physicals[index]; }
+
+	void clear();
+	void reserve(std::size_t size);
+
+	// Copies the state of the given physical into the store, the physical must not have connected physicals
+	std::size_t add(MotorizedPhysical* physical);
+
+	// Integrates all bodies with the same step as MotorizedPhysical::update, the bodies themselves are only moved by scatter
+	void integrate(double deltaT);
+
+	// Writes the motion back to the physicals and moves them, resets their accumulated force and moment
+	void scatter();
+};
+};
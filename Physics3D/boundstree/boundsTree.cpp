@@ -1,5 +1,7 @@
 #include "boundsTree.h"
 
+#include <algorithm>
+#include <cmath>
 
 #include "../datastructures/aligned_alloc.h"
 
@@ -125,6 +127,37 @@ std::array<bool, BRANCH_FACTOR> TrunkSIMDHelperFallback::computeOverlapsWith(con
 	return result;
 }
 
+// distances along the ray to both planes of one slab, sorted into near and far
+// a ray parallel to the slab that starts on one of its planes gives 0 * inf = NaN, it stays on the plane and the slab does not limit it
+static void computeSlabInterval(float toMin, float toMax, float& near, float& far) {
+	if(std::isnan(toMin) || std::isnan(toMax)) {
+		near = -std::numeric_limits<float>::infinity();
+		far = std::numeric_limits<float>::infinity();
+	} else {
+		near = std::min(toMin, toMax);
+		far = std::max(toMin, toMax);
+	}
+}
+
+std::array<float, BRANCH_FACTOR> TrunkSIMDHelperFallback::computeRayEntryDistances(const TreeTrunk& trunk, int trunkSize, const PositionTemplate<float>& origin, const Vec3f& inverseDirection, float maxDistance) {
+	std::array<float, BRANCH_FACTOR> result;
+	const BoundsArray<BRANCH_FACTOR>& bounds = trunk.subNodeBounds;
+
+	for(int i = 0; i < trunkSize; i++) {
+		float nearX, farX, nearY, farY, nearZ, farZ;
+		computeSlabInterval((bounds.xMin[i] - origin.x) * inverseDirection.x, (bounds.xMax[i] - origin.x) * inverseDirection.x, nearX, farX);
+		computeSlabInterval((bounds.yMin[i] - origin.y) * inverseDirection.y, (bounds.yMax[i] - origin.y) * inverseDirection.y, nearY, farY);
+		computeSlabInterval((bounds.zMin[i] - origin.z) * inverseDirection.z, (bounds.zMax[i] - origin.z) * inverseDirection.z, nearZ, farZ);
+
+		float entry = std::max(std::max(nearX, nearY), std::max(nearZ, 0.0f));
+		float exit = std::min(std::min(farX, farY), std::min(farZ, maxDistance));
+
+		result[i] = entry <= exit ? entry : std::numeric_limits<float>::infinity();
+	}
+
+	return result;
+}
+
 OverlapMatrix TrunkSIMDHelperFallback::computeBoundsOverlapMatrix(const TreeTrunk& trunkA, int trunkASize, const TreeTrunk& trunkB, int trunkBSize) {
 	OverlapMatrix result;
 	for(int a = 0; a < trunkASize; a++) {
@@ -533,26 +566,27 @@ static bool insertGroupIntoGroup(TrunkAllocator& sourceAlloc, TrunkAllocator& de
 }
 
 
-TrunkAllocator::TrunkAllocator() : allocationCount(0) {}
+TrunkAllocator::TrunkAllocator() : allocationCount(0), totalAllocationCount(0) {}
 TrunkAllocator::~TrunkAllocator() {
 	assert(this->allocationCount == 0);
 }
-TrunkAllocator::TrunkAllocator(TrunkAllocator&& other) noexcept : allocationCount(other.allocationCount) {
+TrunkAllocator::TrunkAllocator(TrunkAllocator&& other) noexcept : allocationCount(other.allocationCount), totalAllocationCount(other.totalAllocationCount) {
 	other.allocationCount = 0;
+	other.totalAllocationCount = 0;
 }
 TrunkAllocator& TrunkAllocator::operator=(TrunkAllocator&& other) noexcept {
 	std::swap(this->allocationCount, other.allocationCount);
+	std::swap(this->totalAllocationCount, other.totalAllocationCount);
 	return *this;
 }
 
 TreeTrunk* TrunkAllocator::allocTrunk() {
 	this->allocationCount++;
-	std::cout << "allocTrunk " << this->allocationCount << std::endl;
+	this->totalAllocationCount++;
 	return static_cast<TreeTrunk*>(aligned_malloc(sizeof(TreeTrunk), alignof(TreeTrunk)));
 }
 void TrunkAllocator::freeTrunk(TreeTrunk* trunk) {
 	this->allocationCount--;
-	std::cout << "freeTrunk " << this->allocationCount << std::endl;
 	aligned_free(trunk);
 }
 void TrunkAllocator::freeAllTrunks(TreeTrunk& baseTrunk, int baseTrunkSize) {
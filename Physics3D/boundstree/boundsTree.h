@@ -230,6 +230,13 @@ struct TrunkSIMDHelperFallback {
 	static std::pair<int, int> computeFurthestObjects(const BoundsArray<BRANCH_FACTOR * 2>& boundsArray, int size);
 	static int getLowestCombinationCost(const TreeTrunk& trunk, const BoundsTemplate<float>& boundsExtention, int nodeSize);
 	static std::array<bool, BRANCH_FACTOR> computeOverlapsWith(const TreeTrunk& trunk, int trunkSize, const BoundsTemplate<float>& bounds);
+	// slab test of a ray against every subNode, returns the distance along the ray where it enters each subNode, or infinity if it misses it or enters beyond maxDistance
+	// a ray starting inside a subNode enters it at 0, inverseDirection is 1/direction per component
+	static std::array<float, BRANCH_FACTOR> computeRayEntryDistances(const TreeTrunk& trunk, int trunkSize, const PositionTemplate<float>& origin, const Vec3f& inverseDirection, float maxDistance);
+#ifdef __AVX__
+	// only built with AVX, also reports the subNodes past trunkSize as missed
+	static std::array<float, BRANCH_FACTOR> computeRayEntryDistancesAVX(const TreeTrunk& trunk, int trunkSize, const PositionTemplate<float>& origin, const Vec3f& inverseDirection, float maxDistance);
+#endif
 	// indexed result[a][b]
 	static OverlapMatrix computeBoundsOverlapMatrix(const TreeTrunk& trunkA, int trunkASize, const TreeTrunk& trunkB, int trunkBSize);
 	static OverlapMatrix computeBoundsOverlapMatrixAVX(const TreeTrunk& trunkA, int trunkASize, const TreeTrunk& trunkB, int trunkBSize);
@@ -268,6 +275,7 @@ inline BoundsTemplate<float> TreeNodeRef::recalculateBoundsRecursive(const GetOb
 
 class TrunkAllocator {
 	size_t allocationCount;
+	size_t totalAllocationCount;
 public:
 	TrunkAllocator();
 	~TrunkAllocator();
@@ -278,6 +286,9 @@ public:
 	TreeTrunk* allocTrunk();
 	void freeTrunk(TreeTrunk* trunk);
 	void freeAllTrunks(TreeTrunk& baseTrunk, int baseTrunkSize);
+	inline size_t getAllocationCount() const { return allocationCount; }
+	// trunks allocated over the lifetime of the allocator, including the ones already freed
+	inline size_t getTotalAllocationCount() const { return totalAllocationCount; }
 };
 
 int addRecursive(TrunkAllocator& allocator, TreeTrunk& curTrunk, int curTrunkSize, TreeNodeRef&& newNode, const BoundsTemplate<float>& bounds);
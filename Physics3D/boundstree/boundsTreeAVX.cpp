@@ -90,4 +90,41 @@ OverlapMatrix TrunkSIMDHelperFallback::computeBoundsOverlapMatrixAVX(const TreeT
 
 
 
-}
\ No newline at end of file
+#ifdef __AVX__
+// the same slab interval as computeSlabInterval in boundsTree.cpp, for eight subNodes at once
+static void computeSlabIntervals(__m256 toMin, __m256 toMax, __m256& near, __m256& far) {
+	__m256 parallelOnPlane = _mm256_cmp_ps(toMin, toMax, _CMP_UNORD_Q);
+	near = _mm256_blendv_ps(_mm256_min_ps(toMin, toMax), _mm256_set1_ps(-std::numeric_limits<float>::infinity()), parallelOnPlane);
+	far = _mm256_blendv_ps(_mm256_max_ps(toMin, toMax), _mm256_set1_ps(std::numeric_limits<float>::infinity()), parallelOnPlane);
+}
+
+std::array<float, BRANCH_FACTOR> TrunkSIMDHelperFallback::computeRayEntryDistancesAVX(const TreeTrunk& trunk, int trunkSize, const PositionTemplate<float>& origin, const Vec3f& inverseDirection, float maxDistance) {
+	const BoundsArray<BRANCH_FACTOR>& bounds = trunk.subNodeBounds;
+
+	__m256 ox = _mm256_set1_ps(origin.x);
+	__m256 oy = _mm256_set1_ps(origin.y);
+	__m256 oz = _mm256_set1_ps(origin.z);
+
+	__m256 ix = _mm256_set1_ps(inverseDirection.x);
+	__m256 iy = _mm256_set1_ps(inverseDirection.y);
+	__m256 iz = _mm256_set1_ps(inverseDirection.z);
+
+	__m256 nearX, farX, nearY, farY, nearZ, farZ;
+	computeSlabIntervals(_mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(bounds.xMin), ox), ix), _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(bounds.xMax), ox), ix), nearX, farX);
+	computeSlabIntervals(_mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(bounds.yMin), oy), iy), _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(bounds.yMax), oy), iy), nearY, farY);
+	computeSlabIntervals(_mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(bounds.zMin), oz), iz), _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(bounds.zMax), oz), iz), nearZ, farZ);
+
+	__m256 entry = _mm256_max_ps(_mm256_max_ps(nearX, nearY), _mm256_max_ps(nearZ, _mm256_setzero_ps()));
+	__m256 exit = _mm256_min_ps(_mm256_min_ps(farX, farY), _mm256_min_ps(farZ, _mm256_set1_ps(maxDistance)));
+
+	// the lanes past trunkSize hold stale bounds, they are reported as missed
+	__m256 used = _mm256_cmp_ps(_mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_ps(static_cast<float>(trunkSize)), _CMP_LT_OQ);
+	__m256 hits = _mm256_and_ps(_mm256_cmp_ps(entry, exit, _CMP_LE_OQ), used);
+	__m256 distances = _mm256_blendv_ps(_mm256_set1_ps(std::numeric_limits<float>::infinity()), entry, hits);
+
+	alignas(32) std::array<float, BRANCH_FACTOR> result;
+	_mm256_store_ps(result.data(), distances);
+	return result;
+}
+#endif
+}
@@ -0,0 +1,94 @@
+#include "frustumFilter.h"
+
+namespace P3D {
+FrustumFilter::FrustumFilter(const Vec3f* normals, const float* offsets, int planeCount) : normals(), offsets(), planeCount(planeCount) {
+	assert(planeCount >= 0 && planeCount <= MAX_PLANES);
+	for(int i = 0; i < planeCount; i++) {
+		this->normals[i] = normals[i];
+		this->offsets[i] = offsets[i];
+	}
+}
+
+FrustumFilter FrustumFilter::fromMatrix(const Mat4f& projectionView) {
+	// A point is inside the clip volume if -w <= x, y, z <= w, every inequality gives one plane in world space
+	Vec3f normals[MAX_PLANES];
+	float offsets[MAX_PLANES];
+	for(int axis = 0; axis < 3; axis++) {
+		for(int side = 0; side < 2; side++) {
+			float sign = side == 0 ? 1.0f : -1.0f;
+			int plane = axis * 2 + side;
+
+			// (row3 + sign * rowAxis) * (p, 1) >= 0  <=>  -(row3 + sign * rowAxis).xyz * p <= (row3 + sign * rowAxis).w
+			normals[plane] = -Vec3f(
+				projectionView(3, 0) + sign * projectionView(axis, 0),
+				projectionView(3, 1) + sign * projectionView(axis, 1),
+				projectionView(3, 2) + sign * projectionView(axis, 2)
+			);
+			offsets[plane] = projectionView(3, 3) + sign * projectionView(axis, 3);
+		}
+	}
+
+	return FrustumFilter(normals, offsets, MAX_PLANES);
+}
+
+bool FrustumFilter::operator()(const Position& point) const {
+	Vec3f p = castPositionToVec3f(point);
+	for(int i = 0; i < planeCount; i++) {
+		if(normals[i] * p > offsets[i])
+			return false;
+	}
+	return true;
+}
+
+bool FrustumFilter::operator()(const BoundsTemplate<float>& bounds) const {
+	for(int i = 0; i < planeCount; i++) {
+		const Vec3f& normal = normals[i];
+		// the corner furthest to the inside of the plane, if it is outside then the whole box is
+		Vec3f cornerOfInterest(
+			(normal.x >= 0) ? bounds.min.x : bounds.max.x,
+			(normal.y >= 0) ? bounds.min.y : bounds.max.y,
+			(normal.z >= 0) ? bounds.min.z : bounds.max.z
+		);
+
+		if(normal * cornerOfInterest > offsets[i])
+			return false;
+	}
+	return true;
+}
+
+bool FrustumFilter::operator()(const Part& part) const {
+	return (*this)(part.getBounds());
+}
+
+std::array<bool, BRANCH_FACTOR> FrustumFilter::operator()(const TreeTrunk& trunk, int trunkSize) const {
+	return cullTrunkAgainstPlanes(trunk, normals, offsets, planeCount);
+}
+
+std::array<bool, BRANCH_FACTOR> cullTrunkAgainstPlanes(const TreeTrunk& trunk, const Vec3f* normals, const float* offsets, int planeCount) {
+	const BoundsArray<BRANCH_FACTOR>& bounds = trunk.subNodeBounds;
+
+	bool inside[BRANCH_FACTOR];
+	for(int lane = 0; lane < BRANCH_FACTOR; lane++) {
+		inside[lane] = true;
+	}
+
+	for(int i = 0; i < planeCount; i++) {
+		const Vec3f& normal = normals[i];
+		const float* xs = (normal.x >= 0) ? bounds.xMin : bounds.xMax;
+		const float* ys = (normal.y >= 0) ? bounds.yMin : bounds.yMax;
+		const float* zs = (normal.z >= 0) ? bounds.zMin : bounds.zMax;
+		float offset = offsets[i];
+
+		for(int lane = 0; lane < BRANCH_FACTOR; lane++) {
+			float distance = xs[lane] * normal.x + ys[lane] * normal.y + zs[lane] * normal.z;
+			inside[lane] &= distance <= offset;
+		}
+	}
+
+	std::array<bool, BRANCH_FACTOR> result;
+	for(int lane = 0; lane < BRANCH_FACTOR; lane++) {
+		result[lane] = inside[lane];
+	}
+	return result;
+}
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+
+#include "../../math/linalg/vec.h"
+#include "../../math/linalg/mat.h"
+#include "../../math/bounds.h"
+#include "../../part.h"
+#include "../boundsTree.h"
+
+namespace P3D {
+/*
+	Filters bounds against a convex set of planes, such as the view volume of a camera or a light.
+
+	A point p lies on the inside of a plane if normal * p <= offset, bounds pass if they are not entirely outside of any of the planes.
+	Used with BoundsTree::forEachFiltered whole subtrees outside of the volume are skipped.
+*/
+class FrustumFilter {
+public:
+	static constexpr int MAX_PLANES = 6;
+
+private:
+	Vec3f normals[MAX_PLANES];
+	float offsets[MAX_PLANES];
+	int planeCount;
+
+public:
+	FrustumFilter() : normals(), offsets(), planeCount(0) {}
+	FrustumFilter(const Vec3f* normals, const float* offsets, int planeCount);
+
+	/*
+		Creates a FrustumFilter for the volume that the given projection * view matrix maps into clip space.
+		Works for both perspective and orthographic projections.
+	*/
+	static FrustumFilter fromMatrix(const Mat4f& projectionView);
+
+	bool operator()(const Position& point) const;
+	bool operator()(const BoundsTemplate<float>& bounds) const;
+	bool operator()(const Part& part) const;
+	std::array<bool, BRANCH_FACTOR> operator()(const TreeTrunk& trunk, int trunkSize) const;
+
+	int getPlaneCount() const { return planeCount; }
+};
+
+/*
+	Tests the bounds of all subnodes of the trunk against the given planes at once.
+	The trunk stores its bounds per coordinate, so the test runs over all BRANCH_FACTOR lanes and vectorizes, lanes past the trunk size are meaningless.
+*/
+std::array<bool, BRANCH_FACTOR> cullTrunkAgainstPlanes(const TreeTrunk& trunk, const Vec3f* normals, const float* offsets, int planeCount);
+};
@@ -4,6 +4,7 @@
 #include "../../math/position.h"
 #include "../../math/bounds.h"
 #include "../../part.h"
+#include "frustumFilter.h"
 
 namespace P3D {
 VisibilityFilter::VisibilityFilter(const Position& origin, Vec3 normals[5], double maxDepth) :
@@ -99,6 +100,17 @@ bool VisibilityFilter::operator()(const Bounds& bounds) const {
 	return true;
 }
 
+std::array<bool, BRANCH_FACTOR> VisibilityFilter::operator()(const TreeTrunk& trunk, int trunkSize) const {
+	// The trunk bounds are absolute, move the planes from the origin into world space
+	Vec3f originf = castPositionToVec3f(origin);
+	Vec3f normals[5]{Vec3f(up), Vec3f(down), Vec3f(left), Vec3f(right), Vec3f(forward)};
+	float offsets[5]{0, 0, 0, 0, static_cast<float>(maxDepth)};
+	for(int i = 0; i < 5; i++) {
+		offsets[i] += normals[i] * originf;
+	}
+
+	return cullTrunkAgainstPlanes(trunk, normals, offsets, 5);
+}
 
 bool VisibilityFilter::operator()(const Part& part) const {
 	return true;
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
+
 #include "../../math/linalg/vec.h"
 #include "../../math/bounds.h"
 #include "../../part.h"
+#include "../boundsTree.h"
 
 namespace P3D {
 class VisibilityFilter {
@@ -66,6 +69,7 @@ public:
 	bool operator()(const Position& point) const;
 	bool operator()(const Part& part) const;
 	bool operator()(const Bounds& bounds) const;
+	std::array<bool, BRANCH_FACTOR> operator()(const TreeTrunk& trunk, int trunkSize) const;
 
 	Vec3 getForwardStep() const { return forward; }
 	Vec3 getTopOfViewPort() const { return projectToPlaneNormal(forward, up); }
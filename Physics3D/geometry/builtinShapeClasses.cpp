@@ -2,8 +2,11 @@
 
 #include "shapeCreation.h"
 #include "shapeLibrary.h"
+#include "shapeClassCache.h"
 #include "../math/constants.h"
 
+#include <algorithm>
+
 
 namespace P3D {
 #pragma region CubeClass
@@ -441,12 +444,132 @@ Polyhedron CornerClass::asPolyhedron() const {
 #pragma endregion
 
 #pragma region PolyhedronShapeClass
-PolyhedronShapeClass::PolyhedronShapeClass(Polyhedron&& poly) noexcept : poly(std::move(poly)), ShapeClass(poly.getVolume(), poly.getCenterOfMass(), poly.getScalableInertiaAroundCenterOfMass(), CONVEX_POLYHEDRON_CLASS_ID) {}
+struct DirectedEdge {
+	int from;
+	int to;
+	int triangle;
+
+	bool operator<(const DirectedEdge& other) const {
+		return from < other.from || (from == other.from && to < other.to);
+	}
+};
+
+/*
+	Hill climbing only finds the furthest vertex if every local maximum is a global one, which holds for the edge graph of a closed convex polyhedron
+	The polyhedron is closed if every directed edge has a twin going the other way, and convex if at every edge the triangle on the other side bends inwards
+	and it is a single piece. Every closed piece that bends inwards everywhere is a convex sphere with V - E + F == 2, so several separate pieces add up to more
+	Fills the adjacency and returns true if all hold
+*/
+static bool buildConvexAdjacency(const Polyhedron& poly, std::vector<int>& adjacencyOffsets, std::vector<int>& adjacentVertices) {
+	std::vector<DirectedEdge> edges;
+	edges.reserve(poly.triangleCount * 3);
+	for(int i = 0; i < poly.triangleCount; i++) {
+		Triangle t = poly.getTriangle(i);
+		edges.push_back(DirectedEdge{t[0], t[1], i});
+		edges.push_back(DirectedEdge{t[1], t[2], i});
+		edges.push_back(DirectedEdge{t[2], t[0], i});
+	}
+	std::sort(edges.begin(), edges.end());
+
+	float tolerance = static_cast<float>(poly.getMaxRadius()) * 0.0001f;
+	for(std::size_t i = 0; i < edges.size(); i++) {
+		const DirectedEdge& edge = edges[i];
+		if(i + 1 < edges.size() && edges[i + 1].from == edge.from && edges[i + 1].to == edge.to) return false;
 
+		auto twin = std::lower_bound(edges.begin(), edges.end(), DirectedEdge{edge.to, edge.from, 0});
+		if(twin == edges.end() || twin->from != edge.to || twin->to != edge.from) return false;
+
+		Triangle triangle = poly.getTriangle(edge.triangle);
+		Triangle otherTriangle = poly.getTriangle(twin->triangle);
+		int opposite = otherTriangle[0] + otherTriangle[1] + otherTriangle[2] - edge.from - edge.to;
+		Vec3f normal = normalize(poly.getNormalVecOfTriangle(triangle));
+		if((poly.getVertex(opposite) - poly.getVertex(edge.from)) * normal > tolerance) return false;
+	}
+
+	// every edge is listed once in each direction
+	if(poly.vertexCount - static_cast<int>(edges.size() / 2) + poly.triangleCount != 2) return false;
+
+	// every vertex must be on an edge, a lone vertex could never be climbed to
+	adjacencyOffsets.assign(poly.vertexCount + 1, 0);
+	for(const DirectedEdge& edge : edges) {
+		adjacencyOffsets[edge.from + 1]++;
+	}
+	for(int i = 0; i < poly.vertexCount; i++) {
+		if(adjacencyOffsets[i + 1] == 0) return false;
+		adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+	}
+	adjacentVertices.resize(edges.size());
+	for(std::size_t i = 0; i < edges.size(); i++) {
+		adjacentVertices[i] = edges[i].to;
+	}
+	return true;
+}
+
+PolyhedronShapeClass::PolyhedronShapeClass(Polyhedron&& poly) : poly(std::move(poly)), ShapeClass(poly.getVolume(), poly.getCenterOfMass(), poly.getScalableInertiaAroundCenterOfMass(), CONVEX_POLYHEDRON_CLASS_ID) {
+	if(!buildConvexAdjacency(this->poly, adjacencyOffsets, adjacentVertices)) {
+		adjacencyOffsets.clear();
+		adjacentVertices.clear();
+		// the BVH quantizes to the -1..1 box, polyhedra that stick out keep testing every triangle
+		BoundingBox bounds = this->poly.getBounds();
+		if(this->poly.triangleCount >= POLYHEDRON_BVH_TRIANGLE_THRESHOLD && bounds.min.x >= -1.0 && bounds.min.y >= -1.0 && bounds.min.z >= -1.0 &&
+			bounds.max.x <= 1.0 && bounds.max.y <= 1.0 && bounds.max.z <= 1.0) {
+			triangleNodes = buildQuantizedBVH(this->poly);
+		}
+		return;
+	}
+	facePlanes = FacePlanes(this->poly);
+	if(this->poly.vertexCount < HILL_CLIMBING_VERTEX_THRESHOLD) {
+		adjacencyOffsets.clear();
+		adjacentVertices.clear();
+		return;
+	}
+	climbVertices.resize(this->poly.vertexCount);
+	this->poly.getVertices(climbVertices.data());
+}
+
+PolyhedronShapeClass::~PolyhedronShapeClass() {
+	if(interned) ShapeClassCache::remove(this);
+}
+
+// steepest ascent over the edges, starting from the given vertex
+int PolyhedronShapeClass::furthestIndexByHillClimbing(const Vec3f& direction, int start) const {
+	int current = start >= 0 && start < poly.vertexCount ? start : 0;
+	float currentDistance = climbVertices[current] * direction;
+	while(true) {
+		int best = current;
+		float bestDistance = currentDistance;
+		for(int i = adjacencyOffsets[current]; i < adjacencyOffsets[current + 1]; i++) {
+			int neighbor = adjacentVertices[i];
+			float distance = climbVertices[neighbor] * direction;
+			if(distance > bestDistance) {
+				best = neighbor;
+				bestDistance = distance;
+			}
+		}
+		if(best == current) break;
+		current = best;
+		currentDistance = bestDistance;
+	}
+	return current;
+}
+
+// the first triangle hit going along +x must face away from the point, the same test as Polyhedron::containsPoint
 bool PolyhedronShapeClass::containsPoint(Vec3 point) const {
+	if(usesFacePlanes()) return facePlanes.containsPoint(point);
+	if(usesTriangleBVH()) {
+		double distance;
+		int closest = closestTriangleOnRay(triangleNodes, poly, point, Vec3(1.0, 0.0, 0.0), distance);
+		return closest != -1 && poly.getNormalVecOfTriangle(poly.getTriangle(closest)).x >= 0.0f;
+	}
 	return poly.containsPoint(point);
 }
 double PolyhedronShapeClass::getIntersectionDistance(Vec3 origin, Vec3 direction) const {
+	if(usesFacePlanes()) return facePlanes.getIntersectionDistance(origin, direction);
+	if(usesTriangleBVH()) {
+		double distance;
+		closestTriangleOnRay(triangleNodes, poly, origin, direction, distance);
+		return distance;
+	}
 	return poly.getIntersectionDistance(origin, direction);
 }
 BoundingBox PolyhedronShapeClass::getBounds(const Rotation& rotation, const DiagonalMat3& scale) const {
@@ -459,8 +582,14 @@ double PolyhedronShapeClass::getScaledMaxRadiusSq(DiagonalMat3 scale) const {
 	return poly.getScaledMaxRadiusSq(scale);
 }
 Vec3f PolyhedronShapeClass::furthestInDirection(const Vec3f& direction) const {
+	if(usesHillClimbing()) return climbVertices[furthestIndexByHillClimbing(direction, 0)];
 	return poly.furthestInDirection(direction);
 }
+Vec3f PolyhedronShapeClass::furthestInDirectionFrom(const Vec3f& direction, int& hint) const {
+	if(!usesHillClimbing()) return furthestInDirection(direction);
+	hint = furthestIndexByHillClimbing(direction, hint);
+	return climbVertices[hint];
+}
 Polyhedron PolyhedronShapeClass::asPolyhedron() const {
 	return poly;
 }
@@ -471,27 +600,55 @@ BoundingBox PolyhedronShapeClassAVX::getBounds(const Rotation& rotation, const D
 	return poly.getBoundsAVX(Mat3f(rotation.asRotationMatrix() * scale));
 }
 Vec3f PolyhedronShapeClassAVX::furthestInDirection(const Vec3f& direction) const {
+	if(usesHillClimbing()) return climbVertices[furthestIndexByHillClimbing(direction, 0)];
 	return poly.furthestInDirectionAVX(direction);
 }
+bool PolyhedronShapeClassAVX::containsPoint(Vec3 point) const {
+	if(usesFacePlanes()) return facePlanes.containsPointAVX(point);
+	return PolyhedronShapeClass::containsPoint(point);
+}
+double PolyhedronShapeClassAVX::getIntersectionDistance(Vec3 origin, Vec3 direction) const {
+	if(usesFacePlanes()) return facePlanes.getIntersectionDistanceAVX(origin, direction);
+	return PolyhedronShapeClass::getIntersectionDistance(origin, direction);
+}
 
 BoundingBox PolyhedronShapeClassSSE::getBounds(const Rotation& rotation, const DiagonalMat3& scale) const {
 	return poly.getBoundsSSE(Mat3f(rotation.asRotationMatrix() * scale));
 }
 Vec3f PolyhedronShapeClassSSE::furthestInDirection(const Vec3f& direction) const {
+	if(usesHillClimbing()) return climbVertices[furthestIndexByHillClimbing(direction, 0)];
 	return poly.furthestInDirectionSSE(direction);
 }
+bool PolyhedronShapeClassSSE::containsPoint(Vec3 point) const {
+	if(usesFacePlanes()) return facePlanes.containsPointSSE(point);
+	return PolyhedronShapeClass::containsPoint(point);
+}
+double PolyhedronShapeClassSSE::getIntersectionDistance(Vec3 origin, Vec3 direction) const {
+	if(usesFacePlanes()) return facePlanes.getIntersectionDistanceSSE(origin, direction);
+	return PolyhedronShapeClass::getIntersectionDistance(origin, direction);
+}
 
 BoundingBox PolyhedronShapeClassSSE4::getBounds(const Rotation& rotation, const DiagonalMat3& scale) const {
 	return poly.getBoundsSSE(Mat3f(rotation.asRotationMatrix() * scale));
 }
 Vec3f PolyhedronShapeClassSSE4::furthestInDirection(const Vec3f& direction) const {
+	if(usesHillClimbing()) return climbVertices[furthestIndexByHillClimbing(direction, 0)];
 	return poly.furthestInDirectionSSE4(direction);
 }
+bool PolyhedronShapeClassSSE4::containsPoint(Vec3 point) const {
+	if(usesFacePlanes()) return facePlanes.containsPointSSE(point);
+	return PolyhedronShapeClass::containsPoint(point);
+}
+double PolyhedronShapeClassSSE4::getIntersectionDistance(Vec3 origin, Vec3 direction) const {
+	if(usesFacePlanes()) return facePlanes.getIntersectionDistanceSSE(origin, direction);
+	return PolyhedronShapeClass::getIntersectionDistance(origin, direction);
+}
 
 BoundingBox PolyhedronShapeClassFallback::getBounds(const Rotation& rotation, const DiagonalMat3& scale) const {
 	return poly.getBoundsFallback(Mat3f(rotation.asRotationMatrix() * scale));
 }
 Vec3f PolyhedronShapeClassFallback::furthestInDirection(const Vec3f& direction) const {
+	if(usesHillClimbing()) return climbVertices[furthestIndexByHillClimbing(direction, 0)];
 	return poly.furthestInDirectionFallback(direction);
 }
 #pragma endregion
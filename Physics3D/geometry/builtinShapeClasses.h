@@ -2,6 +2,10 @@
 
 #include "polyhedron.h"
 #include "shapeClass.h"
+#include "facePlanes.h"
+#include "triangleBVH.h"
+
+#include <vector>
 
 namespace P3D {
 #define CUBE_CLASS_ID 0
@@ -10,6 +14,8 @@ namespace P3D {
 #define WEDGE_CLASS_ID 3
 #define CORNER_CLASS_ID 4
 #define CONVEX_POLYHEDRON_CLASS_ID 10
+#define TRIANGLE_MESH_CLASS_ID 11
+#define HEIGHTFIELD_CLASS_ID 12
 
 
 class CubeClass : public ShapeClass {
@@ -89,11 +95,43 @@ public:
 
 };
 
+/*
+	Polyhedra with at least this many vertices find their furthest vertex by hill climbing over their edges instead of scanning all vertices
+	Below it the SIMD scan wins, a climb that has to cross the whole polyhedron costs about as much as scanning a few hundred vertices
+*/
+#define HILL_CLIMBING_VERTEX_THRESHOLD 256
+// non-convex polyhedra with at least this many triangles answer ray and containment queries through a BVH, smaller ones test every triangle
+#define POLYHEDRON_BVH_TRIANGLE_THRESHOLD 32
+
 class PolyhedronShapeClass : public ShapeClass {
 protected:
 	Polyhedron poly;
+
+	/*
+		Vertex adjacency of poly, the neighbors of vertex i are adjacentVertices[adjacencyOffsets[i]..adjacencyOffsets[i+1]]
+		Only built for closed convex polyhedra with at least HILL_CLIMBING_VERTEX_THRESHOLD vertices, empty otherwise
+	*/
+	std::vector<int> adjacencyOffsets;
+	std::vector<int> adjacentVertices;
+	// the vertices of poly stored together, a climb reads scattered vertices so the blocked layout of poly would cost three loads each
+	std::vector<Vec3f> climbVertices;
+	// the face planes of closed convex polyhedra, empty otherwise
+	FacePlanes facePlanes;
+	// a BVH over the triangles of large non-convex polyhedra, empty otherwise
+	std::vector<QuantizedBVHNode> triangleNodes;
+	// set by ShapeClassCache while the class is shared through it
+	mutable std::size_t internedHash = 0;
+	mutable bool interned = false;
+	friend class ShapeClassCache;
+
+	int furthestIndexByHillClimbing(const Vec3f& direction, int start) const;
 public:
-	PolyhedronShapeClass(Polyhedron&& poly) noexcept;
+	PolyhedronShapeClass(Polyhedron&& poly);
+	~PolyhedronShapeClass();
+
+	bool usesHillClimbing() const { return !adjacentVertices.empty(); }
+	bool usesFacePlanes() const { return !facePlanes.empty(); }
+	bool usesTriangleBVH() const { return !triangleNodes.empty(); }
 
 	virtual bool containsPoint(Vec3 point) const override;
 	virtual double getIntersectionDistance(Vec3 origin, Vec3 direction) const override;
@@ -101,6 +139,8 @@ public:
 	virtual double getScaledMaxRadius(DiagonalMat3 scale) const override;
 	virtual double getScaledMaxRadiusSq(DiagonalMat3 scale) const override;
 	virtual Vec3f furthestInDirection(const Vec3f& direction) const override;
+	// climbs from the hint, successive support queries tend to ask for nearby directions
+	virtual Vec3f furthestInDirectionFrom(const Vec3f& direction, int& hint) const override;
 	virtual Polyhedron asPolyhedron() const override;
 };
 
@@ -108,6 +148,8 @@ class PolyhedronShapeClassAVX : public PolyhedronShapeClass {
 public:
 	using PolyhedronShapeClass::PolyhedronShapeClass;
 
+	virtual bool containsPoint(Vec3 point) const override;
+	virtual double getIntersectionDistance(Vec3 origin, Vec3 direction) const override;
 	virtual BoundingBox getBounds(const Rotation& rotation, const DiagonalMat3& scale) const override;
 	virtual Vec3f furthestInDirection(const Vec3f& direction) const override;
 };
@@ -116,6 +158,8 @@ class PolyhedronShapeClassSSE : public PolyhedronShapeClass {
 public:
 	using PolyhedronShapeClass::PolyhedronShapeClass;
 
+	virtual bool containsPoint(Vec3 point) const override;
+	virtual double getIntersectionDistance(Vec3 origin, Vec3 direction) const override;
 	virtual BoundingBox getBounds(const Rotation& rotation, const DiagonalMat3& scale) const override;
 	virtual Vec3f furthestInDirection(const Vec3f& direction) const override;
 };
@@ -124,6 +168,8 @@ class PolyhedronShapeClassSSE4 : public PolyhedronShapeClass {
 public:
 	using PolyhedronShapeClass::PolyhedronShapeClass;
 
+	virtual bool containsPoint(Vec3 point) const override;
+	virtual double getIntersectionDistance(Vec3 origin, Vec3 direction) const override;
 	virtual BoundingBox getBounds(const Rotation& rotation, const DiagonalMat3& scale) const override;
 	virtual Vec3f furthestInDirection(const Vec3f& direction) const override;
 };
@@ -8,6 +8,7 @@ ComputationBuffers::ComputationBuffers(int initialVertCount, int initialTriangle
 	vertexCapacity(initialVertCount), triangleCapacity(initialTriangleCount) {
 	createVertexBuffersUnsafe(initialVertCount);
 	createTriangleBuffersUnsafe(initialTriangleCount);
+	faceHeap.reserve(initialTriangleCount);
 }
 
 void ComputationBuffers::ensureCapacity(int vertCapacity, int triangleCapacity) {
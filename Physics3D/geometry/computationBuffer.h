@@ -3,9 +3,21 @@
 #include "../math/linalg/vec.h"
 #include "convexShapeBuilder.h"
 
+#include <vector>
+
 namespace P3D {
 struct MinkowskiPointIndices;
 
+// a triangle of the EPA polytope with its outward normal and squared distance to the origin, computed once when the triangle is made
+struct EPAFace {
+	float distanceSquared;
+	int triangleIndex;
+	// the triangle at triangleIndex when the face was made, the face is stale once the builder stores something else there
+	Triangle triangle;
+	// not normalized, its length is the double area of the triangle
+	Vec3f normal;
+};
+
 struct ComputationBuffers {
 	Vec3f* vertBuf;
 	Triangle* triangleBuf;
@@ -13,6 +25,8 @@ struct ComputationBuffers {
 	EdgePiece* edgeBuf;
 	int* removalBuf;
 	MinkowskiPointIndices* knownVecs;
+	// min-heap on distance, stale faces are skipped when they reach the top
+	std::vector<EPAFace> faceHeap;
 
 	int vertexCapacity;
 	int triangleCapacity;
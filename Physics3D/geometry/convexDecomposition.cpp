@@ -0,0 +1,377 @@
+#include "convexDecomposition.h"
+
+#include "convexHull.h"
+#include "../misc/debug.h"
+#include "../misc/hash.h"
+#include "../misc/serialization/serialization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+// voxels are split off by at most this many planes per axis per split, each costs two hulls
+#define SPLIT_PLANES_PER_AXIS 8
+// the fraction of the added volume of a piece a cut must remove to be chosen over halving the piece
+#define SPLIT_MIN_IMPROVEMENT 0.1
+// bump when the result of the decomposition changes, so old cache files are not read
+#define DECOMPOSITION_CACHE_VERSION 1
+
+namespace P3D {
+namespace {
+struct Voxel {
+	int x, y, z;
+
+	int operator[](int axis) const {
+		return axis == 0 ? x : axis == 1 ? y : z;
+	}
+};
+
+struct Piece {
+	std::vector<Voxel> voxels;
+	// volume of the hull minus the volume of the voxels
+	double addedVolume;
+	bool splittable;
+};
+
+class Decomposer {
+	const ConvexDecompositionSettings& settings;
+
+	Vec3f origin;
+	float voxelSize;
+	int size[3];
+	double voxelVolume;
+
+	// reused while collecting hull points and components
+	std::vector<int> rowMin;
+	std::vector<int> rowMax;
+	std::vector<int> touchedRows;
+	std::vector<int> labels;
+	std::vector<Vec3f> hullPoints;
+
+	int rowIndex(int y, int z) const {
+		return y * size[2] + z;
+	}
+	int voxelIndex(int x, int y, int z) const {
+		return (x * size[1] + y) * size[2] + z;
+	}
+
+	// rays along x through the center of every row of voxels, voxels between an entry and an exit of the mesh are filled
+	std::vector<Voxel> voxelize(const TriangleMesh& mesh) {
+		BoundingBox bounds = mesh.getBounds();
+		Vec3f extent = bounds.max - bounds.min;
+		float longest = std::max(extent.x, std::max(extent.y, extent.z));
+		voxelSize = longest / settings.resolution;
+		for(int axis = 0; axis < 3; axis++) {
+			size[axis] = std::max(1, static_cast<int>(std::ceil(extent[axis] / voxelSize)));
+		}
+		origin = bounds.min;
+		voxelVolume = static_cast<double>(voxelSize) * voxelSize * voxelSize;
+
+		// the rows are moved off center slightly, so they don't run exactly through the edges of axis aligned meshes
+		const double rowOffset = 0.5 + 0.0001234;
+		std::vector<std::vector<double>> crossings(size[1] * size[2]);
+		for(int i = 0; i < mesh.triangleCount; i++) {
+			Triangle triangle = mesh.getTriangle(i);
+			Vec3 a = mesh.getVertex(triangle[0]) - origin;
+			Vec3 b = mesh.getVertex(triangle[1]) - origin;
+			Vec3 c = mesh.getVertex(triangle[2]) - origin;
+			double determinant = (b.y - a.y) * (c.z - a.z) - (b.z - a.z) * (c.y - a.y);
+			if(determinant == 0.0) continue;
+
+			int minY = std::max(0, static_cast<int>(std::ceil(std::min(a.y, std::min(b.y, c.y)) / voxelSize - rowOffset)));
+			int maxY = std::min(size[1] - 1, static_cast<int>(std::floor(std::max(a.y, std::max(b.y, c.y)) / voxelSize - rowOffset)));
+			int minZ = std::max(0, static_cast<int>(std::ceil(std::min(a.z, std::min(b.z, c.z)) / voxelSize - rowOffset)));
+			int maxZ = std::min(size[2] - 1, static_cast<int>(std::floor(std::max(a.z, std::max(b.z, c.z)) / voxelSize - rowOffset)));
+			for(int y = minY; y <= maxY; y++) {
+				double py = (y + rowOffset) * voxelSize;
+				for(int z = minZ; z <= maxZ; z++) {
+					double pz = (z + rowOffset) * voxelSize;
+					double weightA = ((b.y - py) * (c.z - pz) - (b.z - pz) * (c.y - py)) / determinant;
+					double weightB = ((c.y - py) * (a.z - pz) - (c.z - pz) * (a.y - py)) / determinant;
+					double weightC = 1.0 - weightA - weightB;
+					if(weightA < 0.0 || weightB < 0.0 || weightC < 0.0) continue;
+					crossings[rowIndex(y, z)].push_back(weightA * a.x + weightB * b.x + weightC * c.x);
+				}
+			}
+		}
+
+		std::vector<Voxel> filled;
+		for(int y = 0; y < size[1]; y++) {
+			for(int z = 0; z < size[2]; z++) {
+				std::vector<double>& row = crossings[rowIndex(y, z)];
+				std::sort(row.begin(), row.end());
+				// an odd crossing left over comes from a hole in the mesh and is ignored
+				for(std::size_t i = 0; i + 1 < row.size(); i += 2) {
+					int firstX = std::max(0, static_cast<int>(std::ceil(row[i] / voxelSize - 0.5)));
+					int lastX = std::min(size[0] - 1, static_cast<int>(std::floor(row[i + 1] / voxelSize - 0.5)));
+					// walls thinner than a voxel keep the voxel they are in
+					if(firstX > lastX) {
+						firstX = lastX = std::clamp(static_cast<int>((row[i] + row[i + 1]) / 2 / voxelSize), 0, size[0] - 1);
+					}
+					for(int x = firstX; x <= lastX; x++) {
+						filled.push_back(Voxel{x, y, z});
+					}
+				}
+			}
+		}
+		return filled;
+	}
+
+	// the hull of the extreme voxels of every row along x is the hull of all voxels
+	// only voxels on the given side of the plane at splitAt along axis are used, axis -1 uses all of them
+	void collectHullPoints(const std::vector<Voxel>& voxels, int axis, int splitAt, bool below) {
+		hullPoints.clear();
+		touchedRows.clear();
+		for(const Voxel& voxel : voxels) {
+			if(axis != -1 && (voxel[axis] < splitAt) != below) continue;
+			int row = rowIndex(voxel.y, voxel.z);
+			if(rowMin[row] > rowMax[row]) {
+				touchedRows.push_back(row);
+				rowMin[row] = rowMax[row] = voxel.x;
+			} else {
+				rowMin[row] = std::min(rowMin[row], voxel.x);
+				rowMax[row] = std::max(rowMax[row], voxel.x);
+			}
+		}
+		for(int row : touchedRows) {
+			int y = row / size[2];
+			int z = row % size[2];
+			for(int x : {rowMin[row], rowMax[row] + 1}) {
+				for(int corner = 0; corner < 4; corner++) {
+					hullPoints.push_back(origin + Vec3f(static_cast<float>(x), static_cast<float>(y + (corner & 1)), static_cast<float>(z + (corner >> 1))) * voxelSize);
+				}
+			}
+			rowMin[row] = std::numeric_limits<int>::max();
+			rowMax[row] = std::numeric_limits<int>::min();
+		}
+	}
+
+	double hullVolume(const std::vector<Voxel>& voxels, int axis = -1, int splitAt = 0, bool below = false) {
+		collectHullPoints(voxels, axis, splitAt, below);
+		if(hullPoints.empty()) return 0.0;
+		return convexHull(hullPoints.data(), static_cast<int>(hullPoints.size())).getVolume();
+	}
+
+	Piece makePiece(std::vector<Voxel>&& voxels) {
+		double volume = hullVolume(voxels);
+		double added = volume - voxels.size() * voxelVolume;
+		return Piece{std::move(voxels), added, true};
+	}
+
+	// splits voxels into pieces of voxels that touch each other through a face
+	void addComponents(const std::vector<Voxel>& voxels, std::vector<Piece>& pieces) {
+		for(const Voxel& voxel : voxels) labels[voxelIndex(voxel.x, voxel.y, voxel.z)] = 0;
+
+		std::vector<Voxel> stack;
+		for(const Voxel& start : voxels) {
+			if(labels[voxelIndex(start.x, start.y, start.z)] != 0) continue;
+			labels[voxelIndex(start.x, start.y, start.z)] = 1;
+			std::vector<Voxel> component;
+			stack.push_back(start);
+			while(!stack.empty()) {
+				Voxel voxel = stack.back();
+				stack.pop_back();
+				component.push_back(voxel);
+				Voxel neighbors[6]{{voxel.x - 1, voxel.y, voxel.z}, {voxel.x + 1, voxel.y, voxel.z}, {voxel.x, voxel.y - 1, voxel.z}, {voxel.x, voxel.y + 1, voxel.z}, {voxel.x, voxel.y, voxel.z - 1}, {voxel.x, voxel.y, voxel.z + 1}};
+				for(const Voxel& neighbor : neighbors) {
+					if(neighbor.x < 0 || neighbor.y < 0 || neighbor.z < 0 || neighbor.x >= size[0] || neighbor.y >= size[1] || neighbor.z >= size[2]) continue;
+					int& label = labels[voxelIndex(neighbor.x, neighbor.y, neighbor.z)];
+					if(label != 0) continue;
+					label = 1;
+					stack.push_back(neighbor);
+				}
+			}
+			pieces.push_back(makePiece(std::move(component)));
+		}
+
+		for(const Voxel& voxel : voxels) labels[voxelIndex(voxel.x, voxel.y, voxel.z)] = -1;
+	}
+
+	// returns false if the piece is a single voxel
+	bool splitPiece(std::vector<Piece>& pieces, std::size_t pieceIndex) {
+		const std::vector<Voxel>& voxels = pieces[pieceIndex].voxels;
+		double bestAddedVolume = pieces[pieceIndex].addedVolume;
+		int bestAxis = -1;
+		int bestSplit = 0;
+		int longestAxis = -1;
+		int longestLow = 0;
+		int longestHigh = 0;
+		for(int axis = 0; axis < 3; axis++) {
+			int low = std::numeric_limits<int>::max();
+			int high = std::numeric_limits<int>::min();
+			for(const Voxel& voxel : voxels) {
+				low = std::min(low, voxel[axis]);
+				high = std::max(high, voxel[axis]);
+			}
+			if(high > low && (longestAxis == -1 || high - low > longestHigh - longestLow)) {
+				longestAxis = axis;
+				longestLow = low;
+				longestHigh = high;
+			}
+			int step = std::max(1, (high - low) / SPLIT_PLANES_PER_AXIS);
+			for(int splitAt = low + step; splitAt <= high; splitAt += step) {
+				double addedVolume = hullVolume(voxels, axis, splitAt, true) + hullVolume(voxels, axis, splitAt, false) - voxels.size() * voxelVolume;
+				if(addedVolume < bestAddedVolume) {
+					bestAddedVolume = addedVolume;
+					bestAxis = axis;
+					bestSplit = splitAt;
+				}
+			}
+		}
+		if(longestAxis == -1) return false;
+
+		// a ring loses little by any one cut, but its halves do split well, so cuts that barely help halve the piece instead
+		if(bestAddedVolume > pieces[pieceIndex].addedVolume * (1.0 - SPLIT_MIN_IMPROVEMENT)) {
+			bestAxis = longestAxis;
+			bestSplit = (longestLow + longestHigh + 1) / 2;
+		}
+
+		std::vector<Voxel> below;
+		std::vector<Voxel> above;
+		for(const Voxel& voxel : voxels) {
+			(voxel[bestAxis] < bestSplit ? below : above).push_back(voxel);
+		}
+		pieces.erase(pieces.begin() + pieceIndex);
+		addComponents(below, pieces);
+		addComponents(above, pieces);
+		return true;
+	}
+
+public:
+	Decomposer(const ConvexDecompositionSettings& settings) : settings(settings) {}
+
+	std::vector<Polyhedron> decompose(const TriangleMesh& mesh) {
+		std::vector<Voxel> filled = voxelize(mesh);
+		rowMin.assign(size[1] * size[2], std::numeric_limits<int>::max());
+		rowMax.assign(size[1] * size[2], std::numeric_limits<int>::min());
+		labels.assign(size[0] * size[1] * size[2], -1);
+
+		std::vector<Piece> pieces;
+		addComponents(filled, pieces);
+
+		double allowedAddedVolume = settings.maxConcavity * filled.size() * voxelVolume;
+		while(static_cast<int>(pieces.size()) < settings.maxPieceCount) {
+			std::size_t worst = pieces.size();
+			for(std::size_t i = 0; i < pieces.size(); i++) {
+				if(!pieces[i].splittable || pieces[i].addedVolume <= allowedAddedVolume) continue;
+				if(worst == pieces.size() || pieces[i].addedVolume > pieces[worst].addedVolume) worst = i;
+			}
+			if(worst == pieces.size()) break;
+			if(!splitPiece(pieces, worst)) {
+				pieces[worst].splittable = false;
+			}
+		}
+
+		std::vector<Polyhedron> result;
+		for(const Piece& piece : pieces) {
+			collectHullPoints(piece.voxels, -1, 0, false);
+			result.push_back(convexHull(hullPoints.data(), static_cast<int>(hullPoints.size()), settings.maxVerticesPerHull));
+		}
+		return result;
+	}
+};
+};
+
+std::vector<Polyhedron> convexDecomposition(const TriangleMesh& mesh, const ConvexDecompositionSettings& settings) {
+	return Decomposer(settings).decompose(mesh);
+}
+
+std::string getConvexDecompositionCacheFile(const TriangleMesh& mesh, const std::string& cacheDirectory, const ConvexDecompositionSettings& settings) {
+	std::uint64_t hash = hashValue(DECOMPOSITION_CACHE_VERSION);
+	hash = hashValue(settings.resolution, hash);
+	hash = hashValue(settings.maxConcavity, hash);
+	hash = hashValue(settings.maxPieceCount, hash);
+	hash = hashValue(settings.maxVerticesPerHull, hash);
+	for(int i = 0; i < mesh.vertexCount; i++) {
+		hash = hashValue(mesh.getVertex(i), hash);
+	}
+	for(int i = 0; i < mesh.triangleCount; i++) {
+		hash = hashValue(mesh.getTriangle(i), hash);
+	}
+
+	char fileName[32];
+	std::snprintf(fileName, sizeof(fileName), "%016llx.hulls", static_cast<unsigned long long>(hash));
+	return cacheDirectory + "/" + fileName;
+}
+
+/*
+	Reads the pieces stored in a cache file, the counts in the file are checked against its size before anything is allocated for them
+	A cache file may hold no pieces, when the mesh has no volume
+*/
+static bool readCachedPieces(std::istream& input, std::uint64_t fileSize, std::vector<Polyhedron>& result) {
+	std::uint64_t remaining = fileSize;
+	if(remaining < sizeof(int)) return false;
+	int pieceCount = deserializeBasicTypes<int>(input);
+	remaining -= sizeof(int);
+	if(!input || pieceCount < 0 || static_cast<std::uint64_t>(pieceCount) > remaining / (2 * sizeof(int))) return false;
+
+	result.reserve(pieceCount);
+	for(int i = 0; i < pieceCount; i++) {
+		if(remaining < 2 * sizeof(int)) return false;
+		std::istream::pos_type pieceStart = input.tellg();
+		int vertexCount = deserializeBasicTypes<int>(input);
+		int triangleCount = deserializeBasicTypes<int>(input);
+		if(!input || vertexCount < 0 || triangleCount < 0) return false;
+		std::uint64_t pieceSize = 2 * sizeof(int) + static_cast<std::uint64_t>(vertexCount) * sizeof(Vec3f) + static_cast<std::uint64_t>(triangleCount) * sizeof(Triangle);
+		if(pieceSize > remaining) return false;
+		remaining -= pieceSize;
+
+		input.seekg(pieceStart);
+		result.push_back(deserializePolyhedron(input));
+		if(!input) return false;
+	}
+	return remaining == 0;
+}
+
+// the file is written next to its final name and moved over it once complete, so a reader never sees half a cache file
+static bool writeCachedPieces(const std::string& cacheFile, const std::vector<Polyhedron>& pieces) {
+	std::string temporaryFile = cacheFile + ".tmp";
+	{
+		std::ofstream output(temporaryFile, std::ios::binary | std::ios::trunc);
+		if(!output.is_open()) return false;
+		serializeBasicTypes<int>(static_cast<int>(pieces.size()), output);
+		for(const Polyhedron& piece : pieces) {
+			serializePolyhedron(piece, output);
+		}
+		output.close();
+		if(output.fail()) {
+			std::remove(temporaryFile.c_str());
+			return false;
+		}
+	}
+
+	// rename does not replace an existing file on every platform, a damaged cache file is removed first then
+	if(std::rename(temporaryFile.c_str(), cacheFile.c_str()) != 0) {
+		std::remove(cacheFile.c_str());
+		if(std::rename(temporaryFile.c_str(), cacheFile.c_str()) != 0) {
+			std::remove(temporaryFile.c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+std::vector<Polyhedron> cachedConvexDecomposition(const TriangleMesh& mesh, const std::string& cacheDirectory, const ConvexDecompositionSettings& settings) {
+	std::string cacheFile = getConvexDecompositionCacheFile(mesh, cacheDirectory, settings);
+
+	std::ifstream input(cacheFile, std::ios::binary | std::ios::ate);
+	if(input.is_open()) {
+		std::uint64_t fileSize = static_cast<std::uint64_t>(input.tellg());
+		input.seekg(0);
+		std::vector<Polyhedron> result;
+		if(readCachedPieces(input, fileSize, result)) return result;
+		Debug::logWarn("Convex decomposition cache %s is damaged, decomposing again", cacheFile.c_str());
+		input.close();
+	}
+
+	std::vector<Polyhedron> result = convexDecomposition(mesh, settings);
+
+	if(!writeCachedPieces(cacheFile, result)) {
+		Debug::logWarn("Could not write convex decomposition cache %s", cacheFile.c_str());
+	}
+	return result;
+}
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "polyhedron.h"
+
+#include <vector>
+#include <string>
+
+namespace P3D {
+struct ConvexDecompositionSettings {
+	// voxels along the longest side of the bounds of the mesh, pieces are accurate to about one voxel
+	int resolution = 32;
+	// pieces are split until the volume their hull adds is at most this fraction of the volume of the mesh
+	double maxConcavity = 0.02;
+	int maxPieceCount = 16;
+	// vertex limit of each hull, 0 for no limit
+	int maxVerticesPerHull = 32;
+};
+
+/*
+	Approximates a concave mesh with convex polyhedra, so it can be used as the shape of a dynamic part
+
+	The mesh is voxelized, then the piece whose hull adds the most volume is split by the axis aligned plane that
+	lowers the added volume the most, like V-HACD. Parts of a piece that are not connected become separate pieces.
+	The mesh must be closed, the returned polyhedra are in the coordinates of the mesh
+
+	Slow for high resolutions, use cachedConvexDecomposition for meshes that are loaded more than once
+*/
+std::vector<Polyhedron> convexDecomposition(const TriangleMesh& mesh, const ConvexDecompositionSettings& settings = ConvexDecompositionSettings());
+
+// the file in cacheDirectory the decomposition of this mesh is stored in, named after a hash of the mesh and settings
+std::string getConvexDecompositionCacheFile(const TriangleMesh& mesh, const std::string& cacheDirectory, const ConvexDecompositionSettings& settings = ConvexDecompositionSettings());
+
+// convexDecomposition, read from its cache file if it has been computed before, otherwise computed and written to it
+// cacheDirectory must exist, if the file can't be written the decomposition is still returned
+std::vector<Polyhedron> cachedConvexDecomposition(const TriangleMesh& mesh, const std::string& cacheDirectory, const ConvexDecompositionSettings& settings = ConvexDecompositionSettings());
+};
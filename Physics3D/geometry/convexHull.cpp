@@ -0,0 +1,364 @@
+#include "convexHull.h"
+
+#include "indexedShape.h"
+#include "../threading/threadPool.h"
+#include "../misc/validityHelper.h"
+#include "../misc/catchable_assert.h"
+
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <stdexcept>
+
+// points closer to a face than this, relative to the size of the cloud, count as lying on it
+#define HULL_EPSILON_FACTOR 0.000001
+// assigning fewer points than this is not worth waking the thread pool
+#define HULL_PARALLEL_POINT_COUNT 32768
+#define HULL_PARALLEL_CHUNK_SIZE 4096
+
+namespace P3D {
+namespace {
+struct HullFace {
+	Triangle triangle;
+	// same layout as the neighborBuf of ConvexShapeBuilder, neighbors[i] is the face across the side opposite vertex i
+	TriangleNeighbors neighbors;
+	Vec3 normal;
+	double offset;
+	// the points above this face that are not above a face assigned earlier
+	std::vector<int> outsidePoints;
+	int furthestPoint;
+	double furthestDistance;
+	bool removed;
+};
+
+struct HorizonEdge {
+	int from;
+	int to;
+	int outerFace;
+	int outerSide;
+};
+
+struct HorizonWalk {
+	int face;
+	int nextSide;
+	int sidesLeft;
+};
+
+class QuickHull {
+	const Vec3f* points;
+	int pointCount;
+	ThreadPool* threadPool;
+	double epsilon;
+
+	std::vector<HullFace> faces;
+	std::vector<int> freeFaces;
+	// faces with points outside of them, furthest point first. Entries of faces that changed since are skipped
+	std::priority_queue<std::pair<double, int>> pendingFaces;
+
+	// reused between added points
+	std::vector<int> visibleFaces;
+	std::vector<HorizonEdge> horizon;
+	std::vector<HorizonWalk> walkStack;
+	std::vector<int> newFaces;
+	std::vector<int> orphanedPoints;
+
+	double distanceAbove(const HullFace& face, int point) const {
+		return face.normal * Vec3(points[point]) - face.offset;
+	}
+
+	int createFace(int a, int b, int c) {
+		int index;
+		if(freeFaces.empty()) {
+			index = static_cast<int>(faces.size());
+			faces.emplace_back();
+		} else {
+			index = freeFaces.back();
+			freeFaces.pop_back();
+		}
+		HullFace& face = faces[index];
+		face.triangle = Triangle{a, b, c};
+		Vec3 va = points[a];
+		Vec3 vb = points[b];
+		Vec3 vc = points[c];
+		Vec3 normal = (vb - va) % (vc - va);
+		double normalLength = length(normal);
+		// a sliver face that no point can be above, its neighbors keep the hull closed
+		face.normal = normalLength > 0.0 ? normal / normalLength : Vec3(0.0, 0.0, 0.0);
+		face.offset = face.normal * ((va + vb + vc) / 3.0);
+		face.outsidePoints.clear();
+		face.furthestPoint = -1;
+		face.furthestDistance = 0.0;
+		face.removed = false;
+		return index;
+	}
+
+	void assignPointsToFaces(const int* pointIndices, std::size_t count, const std::vector<int>& candidateFaces, std::vector<std::vector<int>>& outsideSets, std::vector<std::pair<double, int>>& furthest) const {
+		for(std::size_t i = 0; i < count; i++) {
+			int point = pointIndices[i];
+			int bestCandidate = -1;
+			double bestDistance = epsilon;
+			for(std::size_t candidate = 0; candidate < candidateFaces.size(); candidate++) {
+				double distance = distanceAbove(faces[candidateFaces[candidate]], point);
+				if(distance > bestDistance) {
+					bestDistance = distance;
+					bestCandidate = static_cast<int>(candidate);
+				}
+			}
+			if(bestCandidate == -1) continue;
+			outsideSets[bestCandidate].push_back(point);
+			if(bestDistance > furthest[bestCandidate].first) {
+				furthest[bestCandidate] = std::make_pair(bestDistance, point);
+			}
+		}
+	}
+
+	// points that are above none of candidateFaces are inside the hull and dropped
+	void assignPoints(const std::vector<int>& pointIndices, const std::vector<int>& candidateFaces) {
+		std::vector<std::vector<int>> outsideSets(candidateFaces.size());
+		std::vector<std::pair<double, int>> furthest(candidateFaces.size(), std::make_pair(0.0, -1));
+
+		if(threadPool != nullptr && pointIndices.size() >= HULL_PARALLEL_POINT_COUNT) {
+			std::atomic<std::size_t> nextChunk(0);
+			std::mutex mergeMutex;
+			threadPool->doInParallel([&]() {
+				std::vector<std::vector<int>> localSets(candidateFaces.size());
+				std::vector<std::pair<double, int>> localFurthest(candidateFaces.size(), std::make_pair(0.0, -1));
+				while(true) {
+					std::size_t chunkStart = nextChunk.fetch_add(HULL_PARALLEL_CHUNK_SIZE);
+					if(chunkStart >= pointIndices.size()) break;
+					std::size_t chunkSize = std::min<std::size_t>(HULL_PARALLEL_CHUNK_SIZE, pointIndices.size() - chunkStart);
+					assignPointsToFaces(pointIndices.data() + chunkStart, chunkSize, candidateFaces, localSets, localFurthest);
+				}
+
+				std::lock_guard<std::mutex> lock(mergeMutex);
+				for(std::size_t candidate = 0; candidate < candidateFaces.size(); candidate++) {
+					outsideSets[candidate].insert(outsideSets[candidate].end(), localSets[candidate].begin(), localSets[candidate].end());
+					if(localFurthest[candidate].first > furthest[candidate].first) {
+						furthest[candidate] = localFurthest[candidate];
+					}
+				}
+			});
+		} else {
+			assignPointsToFaces(pointIndices.data(), pointIndices.size(), candidateFaces, outsideSets, furthest);
+		}
+
+		for(std::size_t candidate = 0; candidate < candidateFaces.size(); candidate++) {
+			if(outsideSets[candidate].empty()) continue;
+			int faceIndex = candidateFaces[candidate];
+			HullFace& face = faces[faceIndex];
+			face.outsidePoints = std::move(outsideSets[candidate]);
+			face.furthestDistance = furthest[candidate].first;
+			face.furthestPoint = furthest[candidate].second;
+			pendingFaces.push(std::make_pair(face.furthestDistance, faceIndex));
+		}
+	}
+
+	void createInitialTetrahedron() {
+		if(pointCount < 4) {
+			throw std::invalid_argument("A convex hull needs at least 4 points");
+		}
+		Vec3f maxAbs(0.0f, 0.0f, 0.0f);
+		int extremes[6]{0, 0, 0, 0, 0, 0};
+		for(int i = 0; i < pointCount; i++) {
+			catchable_assert(isVecValid(points[i]));
+			for(int axis = 0; axis < 3; axis++) {
+				if(points[i][axis] < points[extremes[axis * 2]][axis]) extremes[axis * 2] = i;
+				if(points[i][axis] > points[extremes[axis * 2 + 1]][axis]) extremes[axis * 2 + 1] = i;
+				maxAbs[axis] = std::max(maxAbs[axis], std::abs(points[i][axis]));
+			}
+		}
+		epsilon = HULL_EPSILON_FACTOR * (maxAbs.x + maxAbs.y + maxAbs.z);
+
+		// the two extreme points furthest apart
+		int a = extremes[0];
+		int b = extremes[1];
+		double bestLengthSq = -1.0;
+		for(int i = 0; i < 6; i++) {
+			for(int j = i + 1; j < 6; j++) {
+				double lengthSq = lengthSquared(Vec3(points[extremes[j]]) - Vec3(points[extremes[i]]));
+				if(lengthSq > bestLengthSq) {
+					bestLengthSq = lengthSq;
+					a = extremes[i];
+					b = extremes[j];
+				}
+			}
+		}
+
+		// the point furthest from the line through them
+		Vec3 va = points[a];
+		Vec3 lineDirection = normalize(Vec3(points[b]) - va);
+		int c = -1;
+		double bestLineDistance = epsilon;
+		for(int i = 0; i < pointCount; i++) {
+			double lineDistance = length((Vec3(points[i]) - va) % lineDirection);
+			if(lineDistance > bestLineDistance) {
+				bestLineDistance = lineDistance;
+				c = i;
+			}
+		}
+
+		// the point furthest from the plane through all three
+		int d = -1;
+		double bestPlaneDistance = epsilon;
+		if(c != -1) {
+			Vec3 planeNormal = normalize((Vec3(points[b]) - va) % (Vec3(points[c]) - va));
+			for(int i = 0; i < pointCount; i++) {
+				double planeDistance = std::abs((Vec3(points[i]) - va) * planeNormal);
+				if(planeDistance > bestPlaneDistance) {
+					bestPlaneDistance = planeDistance;
+					d = i;
+				}
+			}
+		}
+
+		if(d == -1) {
+			throw std::invalid_argument("Cannot build a convex hull of points that all lie on a plane");
+		}
+
+		if((Vec3(points[d]) - va) * ((Vec3(points[b]) - va) % (Vec3(points[c]) - va)) > 0.0) {
+			std::swap(b, c);
+		}
+
+		Triangle tetrahedron[4]{{a, b, c}, {a, d, b}, {b, d, c}, {c, d, a}};
+		TriangleNeighbors neighbors[4];
+		fillNeighborBuf(tetrahedron, 4, neighbors);
+		for(int i = 0; i < 4; i++) {
+			int face = createFace(tetrahedron[i][0], tetrahedron[i][1], tetrahedron[i][2]);
+			faces[face].neighbors = neighbors[i];
+		}
+
+		std::vector<int> remainingPoints;
+		remainingPoints.reserve(pointCount);
+		for(int i = 0; i < pointCount; i++) {
+			if(i != a && i != b && i != c && i != d) remainingPoints.push_back(i);
+		}
+		assignPoints(remainingPoints, std::vector<int>{0, 1, 2, 3});
+	}
+
+	// depth first walk over the faces that see the eye, the sides to faces that don't form the horizon, in order around it
+	void findHorizon(int startFace, int eye) {
+		visibleFaces.clear();
+		horizon.clear();
+
+		faces[startFace].removed = true;
+		visibleFaces.push_back(startFace);
+		walkStack.push_back(HorizonWalk{startFace, 0, 3});
+
+		while(!walkStack.empty()) {
+			HorizonWalk& walk = walkStack.back();
+			if(walk.sidesLeft == 0) {
+				walkStack.pop_back();
+				continue;
+			}
+			int face = walk.face;
+			int side = walk.nextSide;
+			walk.nextSide = (side + 1) % 3;
+			walk.sidesLeft--;
+
+			int neighbor = faces[face].neighbors[side];
+			if(faces[neighbor].removed) continue;
+
+			int neighborSide = faces[neighbor].neighbors.getNeighborIndex(face);
+			if(distanceAbove(faces[neighbor], eye) > epsilon) {
+				faces[neighbor].removed = true;
+				visibleFaces.push_back(neighbor);
+				walkStack.push_back(HorizonWalk{neighbor, (neighborSide + 1) % 3, 2});
+			} else {
+				Triangle triangle = faces[face].triangle;
+				horizon.push_back(HorizonEdge{triangle[(side + 1) % 3], triangle[(side + 2) % 3], neighbor, neighborSide});
+			}
+		}
+	}
+
+	void addEyePoint(int startFace) {
+		int eye = faces[startFace].furthestPoint;
+		findHorizon(startFace, eye);
+
+		orphanedPoints.clear();
+		for(int visible : visibleFaces) {
+			for(int point : faces[visible].outsidePoints) {
+				if(point != eye) orphanedPoints.push_back(point);
+			}
+			faces[visible].outsidePoints.clear();
+			freeFaces.push_back(visible);
+		}
+
+		// a cone of faces from the horizon to the eye replaces the visible faces
+		newFaces.clear();
+		for(const HorizonEdge& edge : horizon) {
+			int newFace = createFace(edge.from, edge.to, eye);
+			faces[newFace].neighbors.AB_Neighbor = edge.outerFace;
+			faces[edge.outerFace].neighbors[edge.outerSide] = newFace;
+			newFaces.push_back(newFace);
+		}
+		for(std::size_t i = 0; i < newFaces.size(); i++) {
+			int next = newFaces[(i + 1) % newFaces.size()];
+			int previous = newFaces[(i + newFaces.size() - 1) % newFaces.size()];
+			faces[newFaces[i]].neighbors.BC_Neighbor = next;
+			faces[newFaces[i]].neighbors.CA_Neighbor = previous;
+		}
+
+		assignPoints(orphanedPoints, newFaces);
+	}
+
+public:
+	QuickHull(const Vec3f* points, int pointCount, ThreadPool* threadPool) : points(points), pointCount(pointCount), threadPool(threadPool), epsilon(0.0) {}
+
+	Polyhedron build(int maxVertexCount) {
+		if(maxVertexCount != 0 && maxVertexCount < 4) {
+			throw std::invalid_argument("A convex hull needs at least 4 vertices");
+		}
+		createInitialTetrahedron();
+
+		int hullVertexCount = 4;
+		while(!pendingFaces.empty() && (maxVertexCount == 0 || hullVertexCount < maxVertexCount)) {
+			std::pair<double, int> pending = pendingFaces.top();
+			pendingFaces.pop();
+			const HullFace& face = faces[pending.second];
+			if(face.removed || face.outsidePoints.empty() || face.furthestDistance != pending.first) continue;
+
+			addEyePoint(pending.second);
+			hullVertexCount++;
+		}
+
+		std::vector<int> newVertexIndices(pointCount, -1);
+		std::vector<Vec3f> vertices;
+		std::vector<Triangle> triangles;
+		for(const HullFace& face : faces) {
+			if(face.removed) continue;
+			Triangle triangle;
+			for(int corner = 0; corner < 3; corner++) {
+				int& newIndex = newVertexIndices[face.triangle[corner]];
+				if(newIndex == -1) {
+					newIndex = static_cast<int>(vertices.size());
+					vertices.push_back(points[face.triangle[corner]]);
+				}
+				triangle[corner] = newIndex;
+			}
+			triangles.push_back(triangle);
+		}
+
+		return Polyhedron(vertices.data(), triangles.data(), static_cast<int>(vertices.size()), static_cast<int>(triangles.size()));
+	}
+};
+};
+
+Polyhedron convexHull(const Vec3f* points, int pointCount, int maxVertexCount) {
+	return QuickHull(points, pointCount, nullptr).build(maxVertexCount);
+}
+
+Polyhedron convexHull(const Vec3f* points, int pointCount, ThreadPool& threadPool, int maxVertexCount) {
+	return QuickHull(points, pointCount, &threadPool).build(maxVertexCount);
+}
+
+Polyhedron convexHull(const TriangleMesh& mesh, int maxVertexCount) {
+	std::vector<Vec3f> vertices(mesh.vertexCount);
+	mesh.getVertices(vertices.data());
+	return convexHull(vertices.data(), mesh.vertexCount, maxVertexCount);
+}
+};
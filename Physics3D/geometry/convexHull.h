@@ -0,0 +1,21 @@
+#pragma once
+
+#include "polyhedron.h"
+
+namespace P3D {
+class ThreadPool;
+
+/*
+	Convex hulls of arbitrary point clouds, built with quickhull
+
+	maxVertexCount limits the vertices of the hull for use as a colission shape, 0 keeps every vertex of the hull
+	The point furthest outside of the hull so far is added first, so a limited hull loses its smallest features
+
+	Throws std::invalid_argument if all points lie on a plane, the hull would have no volume
+*/
+Polyhedron convexHull(const Vec3f* points, int pointCount, int maxVertexCount = 0);
+// Points are assigned to faces on the threads of threadPool when there are many of them to assign
+Polyhedron convexHull(const Vec3f* points, int pointCount, ThreadPool& threadPool, int maxVertexCount = 0);
+// The hull of the vertices of mesh, mesh does not need to be convex or closed
+Polyhedron convexHull(const TriangleMesh& mesh, int maxVertexCount = 0);
+};
@@ -8,9 +8,9 @@
 #include "../misc/catchable_assert.h"
 
 namespace P3D {
-ConvexShapeBuilder::ConvexShapeBuilder(Vec3f* vertBuf, Triangle* triangleBuf, int vertexCount, int triangleCount, TriangleNeighbors* neighborBuf, int* removalBuffer, EdgePiece* newTriangleBuffer)
+ConvexShapeBuilder::ConvexShapeBuilder(Vec3f* vertBuf, Triangle* triangleBuf, int vertexCount, int triangleCount, TriangleNeighbors* neighborBuf, int* removalBuffer, EdgePiece* newTriangleBuffer, bool fillNeighbors)
 	: vertexBuf(vertBuf), triangleBuf(triangleBuf), vertexCount(vertexCount), triangleCount(triangleCount), neighborBuf(neighborBuf), removalBuffer(removalBuffer), newTriangleBuffer(newTriangleBuffer) {
-	fillNeighborBuf(triangleBuf, triangleCount, neighborBuf);
+	if(fillNeighbors) fillNeighborBuf(triangleBuf, triangleCount, neighborBuf);
 }
 
 ConvexShapeBuilder::ConvexShapeBuilder(const Polyhedron& s, Vec3f* vertBuf, Triangle* triangleBuf, TriangleNeighbors* neighborBuf, int* removalBuffer, EdgePiece* newTriangleBuffer)
@@ -219,7 +219,7 @@ struct ConvexTriangleIterator {
 	}
 };
 
-void ConvexShapeBuilder::addPoint(const Vec3f& point, int oldTriangleIndex) {
+int ConvexShapeBuilder::addPoint(const Vec3f& point, int oldTriangleIndex) {
 	catchable_assert(isVecValid(point));
 
 	ConvexTriangleIterator iter(point, *this, this->removalBuffer, this->newTriangleBuffer);
@@ -232,8 +232,19 @@ void ConvexShapeBuilder::addPoint(const Vec3f& point, int oldTriangleIndex) {
 	iter.recurseTriangle(neighbors[1], oldTriangleIndex, 1);
 	iter.recurseTriangle(neighbors[2], oldTriangleIndex, 2);
 
+	int oldTriangleCount = triangleCount;
 	vertexBuf[vertexCount++] = point;
 	iter.applyUpdates(vertexCount - 1);
+
+	// removed indices below the new count were refilled with a tip triangle or a moved triangle, indices past the old count hold extra tip triangles
+	int changedCount = 0;
+	for(int i = 0; i < iter.removalCount; i++) {
+		if(iter.removalList[i] < triangleCount) iter.removalList[changedCount++] = iter.removalList[i];
+	}
+	for(int i = oldTriangleCount; i < triangleCount; i++) {
+		iter.removalList[changedCount++] = i;
+	}
+	return changedCount;
 }
 
 bool ConvexShapeBuilder::addPoint(const Vec3f& point) {
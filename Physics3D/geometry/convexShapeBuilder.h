@@ -26,10 +26,12 @@ public:
 	int* removalBuffer;
 	EdgePiece* newTriangleBuffer;
 
-	ConvexShapeBuilder(Vec3f* vertBuf, Triangle* triangleBuf, int vertexCount, int triangleCount, TriangleNeighbors* neighborBuf, int* removalBuffer, EdgePiece* newTriangleBuffer);
+	// neighborBuf is filled from the triangles, unless fillNeighbors is false and it already holds their neighbors
+	ConvexShapeBuilder(Vec3f* vertBuf, Triangle* triangleBuf, int vertexCount, int triangleCount, TriangleNeighbors* neighborBuf, int* removalBuffer, EdgePiece* newTriangleBuffer, bool fillNeighbors = true);
 	ConvexShapeBuilder(const Polyhedron& s, Vec3f* newVertBuf, Triangle* newTriangleBuf, TriangleNeighbors* neighborBuf, int* removalBuffer, EdgePiece* newTriangleBuffer);
 
-	void addPoint(const Vec3f& point, int oldTriangleIndex);
+	// returns the number of triangles that were created or moved to another index, their indices are left at the start of removalBuffer
+	int addPoint(const Vec3f& point, int oldTriangleIndex);
 	// returns true if successful
 	bool addPoint(const Vec3f& point);
 
@@ -0,0 +1,89 @@
+#include "facePlanes.h"
+
+#include "polyhedron.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace P3D {
+#define RAY_PLANE_EPSILON 0.0000001
+// triangles whose planes differ by less than this share one plane
+#define PLANE_MERGE_TOLERANCE 0.000001f
+
+FacePlanes::FacePlanes() : planes(), planeCount(0) {}
+
+static bool isSamePlane(const Vec4f& a, const Vec4f& b) {
+	return std::abs(a.x - b.x) < PLANE_MERGE_TOLERANCE && std::abs(a.y - b.y) < PLANE_MERGE_TOLERANCE &&
+		std::abs(a.z - b.z) < PLANE_MERGE_TOLERANCE && std::abs(a.w - b.w) < PLANE_MERGE_TOLERANCE;
+}
+
+FacePlanes::FacePlanes(const Polyhedron& poly) : planeCount(0) {
+	std::vector<Vec4f> trianglePlanes;
+	trianglePlanes.reserve(poly.triangleCount);
+	for(int i = 0; i < poly.triangleCount; i++) {
+		Triangle triangle = poly.getTriangle(i);
+		Vec3f normalVec = poly.getNormalVecOfTriangle(triangle);
+		// a degenerate triangle has no plane, its neighbors close the polyhedron
+		if(lengthSquared(normalVec) == 0.0f) continue;
+		Vec3f normal = normalize(normalVec);
+		trianglePlanes.push_back(Vec4f(normal.x, normal.y, normal.z, normal * poly.getVertex(triangle.firstIndex)));
+	}
+
+	// sorted by x, the planes that can match a plane are the kept ones whose x lies within the tolerance below it
+	std::sort(trianglePlanes.begin(), trianglePlanes.end(), [](const Vec4f& a, const Vec4f& b) { return a.x < b.x; });
+	std::vector<Vec4f> found;
+	for(const Vec4f& plane : trianglePlanes) {
+		bool isNew = true;
+		for(std::size_t j = found.size(); j > 0 && plane.x - found[j - 1].x < PLANE_MERGE_TOLERANCE; j--) {
+			if(isSamePlane(found[j - 1], plane)) {
+				isNew = false;
+				break;
+			}
+		}
+		if(isNew) found.push_back(plane);
+	}
+
+	planeCount = static_cast<int>(found.size());
+	int blockCount = (planeCount + 7) / 8;
+	planes = UniqueAlignedPointer<float>(blockCount * 32, 32);
+	for(int i = 0; i < blockCount * 8; i++) {
+		// the padding planes have no normal and a positive offset, every point is behind them
+		Vec4f plane = i < planeCount ? found[i] : Vec4f(0.0f, 0.0f, 0.0f, 1.0f);
+		float* block = planes.get() + (i / 8) * 32 + i % 8;
+		block[0] = plane.x;
+		block[8] = plane.y;
+		block[16] = plane.z;
+		block[24] = plane.w;
+	}
+}
+
+bool FacePlanes::containsPoint(Vec3f point) const {
+	for(int i = 0; i < planeCount; i++) {
+		const float* block = planes.get() + (i / 8) * 32 + i % 8;
+		if(block[0] * point.x + block[8] * point.y + block[16] * point.z > block[24]) return false;
+	}
+	return true;
+}
+
+double FacePlanes::getIntersectionDistance(Vec3 origin, Vec3 direction) const {
+	double entry = -std::numeric_limits<double>::infinity();
+	double exit = std::numeric_limits<double>::infinity();
+	for(int i = 0; i < planeCount; i++) {
+		const float* block = planes.get() + (i / 8) * 32 + i % 8;
+		Vec3 normal(block[0], block[8], block[16]);
+		double speed = normal * direction;
+		double distance = block[24] - normal * origin;
+		if(speed < 0.0) {
+			entry = std::max(entry, distance / speed);
+		} else if(speed > 0.0) {
+			exit = std::min(exit, distance / speed);
+		} else if(distance < 0.0) {
+			return std::numeric_limits<double>::max();
+		}
+	}
+	if(entry > exit || exit <= RAY_PLANE_EPSILON) return std::numeric_limits<double>::max();
+	return entry > RAY_PLANE_EPSILON ? entry : exit;
+}
+};
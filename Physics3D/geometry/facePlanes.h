@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../math/linalg/vec.h"
+#include "../datastructures/alignedPtr.h"
+
+namespace P3D {
+class Polyhedron;
+
+/*
+	The planes of the faces of a closed convex polyhedron, a point is inside if it is behind all of them
+	Containment is the largest distance to a plane, and a ray is clipped by every plane like a slab
+
+	Stored in blocks of 8 planes, 8 normal x, 8 normal y, 8 normal z and 8 offsets
+	The last block is padded with planes that contain everything, so the SIMD versions never need a remainder loop
+*/
+class FacePlanes {
+	UniqueAlignedPointer<float> planes;
+	int planeCount;
+
+public:
+	FacePlanes();
+	// poly must be closed and convex, one plane is made per face, the triangles that lie in the same plane share it
+	explicit FacePlanes(const Polyhedron& poly);
+
+	FacePlanes(FacePlanes&& other) noexcept = default;
+	FacePlanes& operator=(FacePlanes&& other) noexcept = default;
+
+	int getPlaneCount() const { return planeCount; }
+	bool empty() const { return planeCount == 0; }
+
+	// points on a plane count as inside
+	bool containsPoint(Vec3f point) const;
+	// same result as TriangleMesh::getIntersectionDistance on the polyhedron, the exit distance for rays starting inside
+	double getIntersectionDistance(Vec3 origin, Vec3 direction) const;
+
+	bool containsPointSSE(Vec3f point) const;
+	double getIntersectionDistanceSSE(Vec3 origin, Vec3 direction) const;
+
+	bool containsPointAVX(Vec3f point) const;
+	double getIntersectionDistanceAVX(Vec3 origin, Vec3 direction) const;
+};
+};
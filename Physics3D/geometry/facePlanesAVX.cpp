@@ -0,0 +1,75 @@
+#include "facePlanes.h"
+
+#include <immintrin.h>
+#include <limits>
+
+// AVX2 implementation for FacePlanes functions
+namespace P3D {
+#define RAY_PLANE_EPSILON 0.0000001f
+
+static float horizontalMax(__m256 values) {
+	__m128 half = _mm_max_ps(_mm256_castps256_ps128(values), _mm256_extractf128_ps(values, 1));
+	half = _mm_max_ps(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(1, 0, 3, 2)));
+	half = _mm_max_ps(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(half);
+}
+
+static float horizontalMin(__m256 values) {
+	__m128 half = _mm_min_ps(_mm256_castps256_ps128(values), _mm256_extractf128_ps(values, 1));
+	half = _mm_min_ps(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(1, 0, 3, 2)));
+	half = _mm_min_ps(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(half);
+}
+
+bool FacePlanes::containsPointAVX(Vec3f point) const {
+	__m256 px = _mm256_set1_ps(point.x);
+	__m256 py = _mm256_set1_ps(point.y);
+	__m256 pz = _mm256_set1_ps(point.z);
+
+	int blockCount = (planeCount + 7) / 8;
+	for(int blockI = 0; blockI < blockCount; blockI++) {
+		const float* block = planes.get() + blockI * 32;
+		__m256 dot = _mm256_fmadd_ps(pz, _mm256_load_ps(block + 16), _mm256_fmadd_ps(py, _mm256_load_ps(block + 8), _mm256_mul_ps(px, _mm256_load_ps(block))));
+		if(_mm256_movemask_ps(_mm256_cmp_ps(dot, _mm256_load_ps(block + 24), _CMP_GT_OQ)) != 0) return false;
+	}
+	return true;
+}
+
+double FacePlanes::getIntersectionDistanceAVX(Vec3 origin, Vec3 direction) const {
+	__m256 ox = _mm256_set1_ps(static_cast<float>(origin.x));
+	__m256 oy = _mm256_set1_ps(static_cast<float>(origin.y));
+	__m256 oz = _mm256_set1_ps(static_cast<float>(origin.z));
+	__m256 dx = _mm256_set1_ps(static_cast<float>(direction.x));
+	__m256 dy = _mm256_set1_ps(static_cast<float>(direction.y));
+	__m256 dz = _mm256_set1_ps(static_cast<float>(direction.z));
+
+	__m256 zero = _mm256_setzero_ps();
+	__m256 negativeInfinity = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+	__m256 positiveInfinity = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+	__m256 entry = negativeInfinity;
+	__m256 exit = positiveInfinity;
+	__m256 parallelOutside = zero;
+
+	int blockCount = (planeCount + 7) / 8;
+	for(int blockI = 0; blockI < blockCount; blockI++) {
+		const float* block = planes.get() + blockI * 32;
+		__m256 nx = _mm256_load_ps(block);
+		__m256 ny = _mm256_load_ps(block + 8);
+		__m256 nz = _mm256_load_ps(block + 16);
+
+		__m256 speed = _mm256_fmadd_ps(nz, dz, _mm256_fmadd_ps(ny, dy, _mm256_mul_ps(nx, dx)));
+		__m256 distance = _mm256_sub_ps(_mm256_load_ps(block + 24), _mm256_fmadd_ps(nz, oz, _mm256_fmadd_ps(ny, oy, _mm256_mul_ps(nx, ox))));
+		__m256 t = _mm256_div_ps(distance, speed);
+
+		entry = _mm256_max_ps(entry, _mm256_blendv_ps(negativeInfinity, t, _mm256_cmp_ps(speed, zero, _CMP_LT_OQ)));
+		exit = _mm256_min_ps(exit, _mm256_blendv_ps(positiveInfinity, t, _mm256_cmp_ps(speed, zero, _CMP_GT_OQ)));
+		parallelOutside = _mm256_or_ps(parallelOutside, _mm256_and_ps(_mm256_cmp_ps(speed, zero, _CMP_EQ_OQ), _mm256_cmp_ps(distance, zero, _CMP_LT_OQ)));
+	}
+
+	if(_mm256_movemask_ps(parallelOutside) != 0) return std::numeric_limits<double>::max();
+	float entryDistance = horizontalMax(entry);
+	float exitDistance = horizontalMin(exit);
+	if(entryDistance > exitDistance || exitDistance <= RAY_PLANE_EPSILON) return std::numeric_limits<double>::max();
+	return entryDistance > RAY_PLANE_EPSILON ? entryDistance : exitDistance;
+}
+};
@@ -0,0 +1,80 @@
+#include "facePlanes.h"
+
+#include <immintrin.h>
+#include <limits>
+
+// SSE2 implementation for FacePlanes functions
+namespace P3D {
+#define RAY_PLANE_EPSILON 0.0000001f
+
+// emulates _mm_blendv_ps, SSE4_1 is not available
+static __m128 custom_blendv_ps(__m128 a, __m128 b, __m128 mask) {
+	return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+}
+
+static float horizontalMax(__m128 values) {
+	values = _mm_max_ps(values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(1, 0, 3, 2)));
+	values = _mm_max_ps(values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(values);
+}
+
+static float horizontalMin(__m128 values) {
+	values = _mm_min_ps(values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(1, 0, 3, 2)));
+	values = _mm_min_ps(values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(values);
+}
+
+bool FacePlanes::containsPointSSE(Vec3f point) const {
+	__m128 px = _mm_set1_ps(point.x);
+	__m128 py = _mm_set1_ps(point.y);
+	__m128 pz = _mm_set1_ps(point.z);
+
+	int halfBlockCount = (planeCount + 7) / 8 * 2;
+	for(int halfI = 0; halfI < halfBlockCount; halfI++) {
+		const float* block = planes.get() + (halfI / 2) * 32 + (halfI % 2) * 4;
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_load_ps(block)), _mm_mul_ps(py, _mm_load_ps(block + 8))), _mm_mul_ps(pz, _mm_load_ps(block + 16)));
+		if(_mm_movemask_ps(_mm_cmpgt_ps(dot, _mm_load_ps(block + 24))) != 0) return false;
+	}
+	return true;
+}
+
+double FacePlanes::getIntersectionDistanceSSE(Vec3 origin, Vec3 direction) const {
+	__m128 ox = _mm_set1_ps(static_cast<float>(origin.x));
+	__m128 oy = _mm_set1_ps(static_cast<float>(origin.y));
+	__m128 oz = _mm_set1_ps(static_cast<float>(origin.z));
+	__m128 dx = _mm_set1_ps(static_cast<float>(direction.x));
+	__m128 dy = _mm_set1_ps(static_cast<float>(direction.y));
+	__m128 dz = _mm_set1_ps(static_cast<float>(direction.z));
+
+	__m128 zero = _mm_setzero_ps();
+	__m128 negativeInfinity = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+	__m128 positiveInfinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+	__m128 entry = negativeInfinity;
+	__m128 exit = positiveInfinity;
+	__m128 parallelOutside = zero;
+
+	int halfBlockCount = (planeCount + 7) / 8 * 2;
+	for(int halfI = 0; halfI < halfBlockCount; halfI++) {
+		const float* block = planes.get() + (halfI / 2) * 32 + (halfI % 2) * 4;
+		__m128 nx = _mm_load_ps(block);
+		__m128 ny = _mm_load_ps(block + 8);
+		__m128 nz = _mm_load_ps(block + 16);
+
+		__m128 speed = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, dx), _mm_mul_ps(ny, dy)), _mm_mul_ps(nz, dz));
+		__m128 distance = _mm_sub_ps(_mm_load_ps(block + 24), _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, ox), _mm_mul_ps(ny, oy)), _mm_mul_ps(nz, oz)));
+		__m128 t = _mm_div_ps(distance, speed);
+
+		__m128 entering = _mm_cmplt_ps(speed, zero);
+		__m128 exiting = _mm_cmpgt_ps(speed, zero);
+		entry = _mm_max_ps(entry, custom_blendv_ps(negativeInfinity, t, entering));
+		exit = _mm_min_ps(exit, custom_blendv_ps(positiveInfinity, t, exiting));
+		parallelOutside = _mm_or_ps(parallelOutside, _mm_and_ps(_mm_cmpeq_ps(speed, zero), _mm_cmplt_ps(distance, zero)));
+	}
+
+	if(_mm_movemask_ps(parallelOutside) != 0) return std::numeric_limits<double>::max();
+	float entryDistance = horizontalMax(entry);
+	float exitDistance = horizontalMin(exit);
+	if(entryDistance > exitDistance || exitDistance <= RAY_PLANE_EPSILON) return std::numeric_limits<double>::max();
+	return entryDistance > RAY_PLANE_EPSILON ? entryDistance : exitDistance;
+}
+};
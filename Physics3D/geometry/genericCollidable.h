@@ -5,5 +5,13 @@
 namespace P3D {
 struct GenericCollidable {
 	virtual Vec3f furthestInDirection(const Vec3f& direction) const = 0;
+
+	/*
+		Like furthestInDirection, hint is where the search may start and is set to where it ended. The hint belongs to the caller,
+		so one collidable can serve many queries at once. The successive queries of a GJK or EPA run pass the same hint
+	*/
+	virtual Vec3f furthestInDirectionFrom(const Vec3f& direction, int& /*hint*/) const {
+		return furthestInDirection(direction);
+	}
 };
 };
@@ -13,10 +13,17 @@
 #include "../misc/catchable_assert.h"
 
 #include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <limits>
 
 
 #define GJK_MAX_ITER 200
 #define EPA_MAX_ITER 200
+#define GJK_DISTANCE_TOLERANCE 0.0001f
+#define GJK_DISTANCE_EPSILON 0.0000001f
+#define GJK_FLAT_TOLERANCE 0.00001f
 
 namespace P3D {
 inline static void incDebugTally(HistoricTally<long long, IterationTime>& tally, int iterTime) {
@@ -37,41 +44,47 @@ static Vec3f getNormalVec(Triangle t, Vec3f* vertices) {
 	return (v1 - v0) % (v2 - v0);
 }
 
-static double getDistanceOfTriangleToOriginSquared(Triangle t, Vec3f* vertices) {
-	return pointToPlaneDistanceSquared(getNormalVec(t, vertices), vertices[t[0]]);
+// equally distant faces are ordered on their index, the nearest face is the first one a scan over the triangles would find
+static bool isCloserFace(const EPAFace& first, const EPAFace& second) {
+	return first.distanceSquared < second.distanceSquared || (first.distanceSquared == second.distanceSquared && first.triangleIndex < second.triangleIndex);
 }
 
-struct NearestSurface {
-	int triangleIndex;
-	double distanceSquared;
-};
-
-static NearestSurface getNearestSurface(const ConvexShapeBuilder& builder) {
-	int best = 0;
-	double bestDistSq = getDistanceOfTriangleToOriginSquared(builder.triangleBuf[0], builder.vertexBuf);
+// the heap is ordered with std::push_heap, which puts the largest element on top, so the comparison is reversed
+static bool isFurtherFace(const EPAFace& first, const EPAFace& second) {
+	return isCloserFace(second, first);
+}
 
-	for(int i = 1; i < builder.triangleCount; i++) {
-		Triangle t = builder.triangleBuf[i];
+// degenerate triangles get an infinite distance so they never come up as the nearest face
+static void pushFace(std::vector<EPAFace>& heap, const ConvexShapeBuilder& builder, int triangleIndex) {
+	Triangle triangle = builder.triangleBuf[triangleIndex];
+	Vec3f normal = getNormalVec(triangle, builder.vertexBuf);
+	float distanceSquared = pointToPlaneDistanceSquared(normal, builder.vertexBuf[triangle[0]]);
+	if(!std::isfinite(distanceSquared)) distanceSquared = std::numeric_limits<float>::infinity();
+	heap.push_back(EPAFace{distanceSquared, triangleIndex, triangle, normal});
+	std::push_heap(heap.begin(), heap.end(), isFurtherFace);
+}
 
-		double distSq = getDistanceOfTriangleToOriginSquared(t, builder.vertexBuf);
+static bool isStale(const EPAFace& face, const ConvexShapeBuilder& builder) {
+	if(face.triangleIndex >= builder.triangleCount) return true;
+	Triangle current = builder.triangleBuf[face.triangleIndex];
+	return current.firstIndex != face.triangle.firstIndex || current.secondIndex != face.triangle.secondIndex || current.thirdIndex != face.triangle.thirdIndex;
+}
 
-		if(distSq < bestDistSq) {
-			best = i;
-			bestDistSq = distSq;
-		}
+// removes stale faces from the top of the heap until the nearest face of the polytope is on top
+static const EPAFace& getNearestFace(std::vector<EPAFace>& heap, const ConvexShapeBuilder& builder) {
+	while(isStale(heap.front(), builder)) {
+		std::pop_heap(heap.begin(), heap.end(), isFurtherFace);
+		heap.pop_back();
 	}
-
-	return NearestSurface{best, bestDistSq};
+	return heap.front();
 }
 
 static MinkPoint getSupport(const ColissionPair& info, const Vec3f& searchDirection) {
-	Vec3f furthest1 = info.scaleFirst * info.first.furthestInDirection(info.scaleFirst * searchDirection);  // in local space of first
-	Vec3f transformedSearchDirection = -info.transform.relativeToLocal(searchDirection);
-	Vec3f furthest2 = info.scaleSecond * info.second.furthestInDirection(info.scaleSecond * transformedSearchDirection);  // in local space of second
-	Vec3f secondVertex = info.transform.localToGlobal(furthest2);  // converted to local space of first
+	Vec3f furthest1 = info.scaleFirst * info.first.furthestInDirectionFrom(info.scaleFirst * searchDirection, info.firstHint);  // in local space of first
+	Vec3f furthest2 = info.second.furthestInDirectionFrom(-(info.firstToSecondDirection * searchDirection), info.secondHint);  // in the shape class of second
+	Vec3f secondVertex = info.secondToFirst * furthest2 + info.transform.position;  // converted to local space of first
 
 	/*catchable_assert(isVecValid(furthest1));
-	catchable_assert(isVecValid(transformedSearchDirection));
 	catchable_assert(isVecValid(furthest2));
 	catchable_assert(isVecValid(secondVertex));*/
 
@@ -204,6 +217,156 @@ std::optional<Tetrahedron> runGJKTransformed(const ColissionPair& info, Vec3f se
 	return std::optional<Tetrahedron>();
 }
 
+// the sub-simplex closest to the origin, with the barycentric weights of the closest point on it
+struct DistanceSimplex {
+	MinkPoint points[4];
+	float weights[4];
+	int order;
+
+	MinkPoint getClosest() const {
+		MinkPoint result{Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 0.0f, 0.0f), Vec3f(0.0f, 0.0f, 0.0f)};
+		for(int i = 0; i < order; i++) {
+			result.p += points[i].p * weights[i];
+			result.originFirst += points[i].originFirst * weights[i];
+			result.originSecond += points[i].originSecond * weights[i];
+		}
+		return result;
+	}
+};
+
+static DistanceSimplex closestOnSegment(const MinkPoint& a, const MinkPoint& b) {
+	Vec3f ab = b.p - a.p;
+	float t = -(a.p * ab);
+	if(t <= 0.0f) return DistanceSimplex{{a}, {1.0f}, 1};
+	float lengthSq = ab * ab;
+	if(t >= lengthSq) return DistanceSimplex{{b}, {1.0f}, 1};
+	t /= lengthSq;
+	return DistanceSimplex{{a, b}, {1.0f - t, t}, 2};
+}
+
+// voronoi region tests of the origin against the vertices, edges and face of the triangle
+static DistanceSimplex closestOnTriangle(const MinkPoint& a, const MinkPoint& b, const MinkPoint& c) {
+	Vec3f ab = b.p - a.p;
+	Vec3f ac = c.p - a.p;
+
+	float d1 = -(ab * a.p);
+	float d2 = -(ac * a.p);
+	if(d1 <= 0.0f && d2 <= 0.0f) return DistanceSimplex{{a}, {1.0f}, 1};
+
+	float d3 = -(ab * b.p);
+	float d4 = -(ac * b.p);
+	if(d3 >= 0.0f && d4 <= d3) return DistanceSimplex{{b}, {1.0f}, 1};
+
+	float vc = d1 * d4 - d3 * d2;
+	if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+		float v = d1 / (d1 - d3);
+		return DistanceSimplex{{a, b}, {1.0f - v, v}, 2};
+	}
+
+	float d5 = -(ab * c.p);
+	float d6 = -(ac * c.p);
+	if(d6 >= 0.0f && d5 <= d6) return DistanceSimplex{{c}, {1.0f}, 1};
+
+	float vb = d5 * d2 - d1 * d6;
+	if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+		float w = d2 / (d2 - d6);
+		return DistanceSimplex{{a, c}, {1.0f - w, w}, 2};
+	}
+
+	float va = d3 * d6 - d5 * d4;
+	if(va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+		float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		return DistanceSimplex{{b, c}, {1.0f - w, w}, 2};
+	}
+
+	float denom = 1.0f / (va + vb + vc);
+	float v = vb * denom;
+	float w = vc * denom;
+	return DistanceSimplex{{a, b, c}, {1.0f - v - w, v, w}, 3};
+}
+
+// a flat tetrahedron counts as outside of every face, so the closest of its faces is still found
+// the opposite vertex counts as lying in the face when its distance to it is within rounding of the size of the tetrahedron,
+// a support point found after the distance has converged lies in the plane of the face and would otherwise land on either side
+static bool isOriginOutsideFace(const Vec3f& a, const Vec3f& b, const Vec3f& c, const Vec3f& opposite) {
+	Vec3f normal = (b - a) % (c - a);
+	float originSide = -(a * normal);
+	float oppositeSide = (opposite - a) * normal;
+	if(oppositeSide * oppositeSide <= GJK_FLAT_TOLERANCE * GJK_FLAT_TOLERANCE * lengthSquared(normal) * lengthSquared(opposite - a)) return true;
+	return originSide * oppositeSide <= 0.0f;
+}
+
+// returns the full tetrahedron if it contains the origin
+static DistanceSimplex closestOnTetrahedron(const MinkPoint& a, const MinkPoint& b, const MinkPoint& c, const MinkPoint& d) {
+	const MinkPoint* faces[4][4]{{&a, &b, &c, &d}, {&a, &c, &d, &b}, {&a, &d, &b, &c}, {&b, &d, &c, &a}};
+
+	DistanceSimplex best{{a, b, c, d}, {0.25f, 0.25f, 0.25f, 0.25f}, 4};
+	float bestDistSq = std::numeric_limits<float>::infinity();
+	for(const MinkPoint* const* face : faces) {
+		if(!isOriginOutsideFace(face[0]->p, face[1]->p, face[2]->p, face[3]->p)) continue;
+		DistanceSimplex candidate = closestOnTriangle(*face[0], *face[1], *face[2]);
+		Vec3f closest = candidate.getClosest().p;
+		float distSq = closest * closest;
+		if(distSq < bestDistSq) {
+			best = candidate;
+			bestDistSq = distSq;
+		}
+	}
+	return best;
+}
+
+/*
+	GJK that keeps only the sub-simplex closest to the origin, each support point in the direction of the origin moves the closest point closer
+	Stops once a new support point can no longer improve the distance by more than GJK_DISTANCE_TOLERANCE relative to it
+*/
+GJKDistance runGJKDistanceTransformed(const ColissionPair& info, Vec3f searchDirection) {
+	DistanceSimplex simplex{{getSupport(info, searchDirection)}, {1.0f}, 1};
+	MinkPoint closest = simplex.points[0];
+
+	for(int iter = 0; iter < GJK_MAX_ITER; iter++) {
+		float closestDistSq = closest.p * closest.p;
+		if(closestDistSq <= GJK_DISTANCE_EPSILON) {
+			return GJKDistance{0.0f, closest};
+		}
+
+		MinkPoint w = getSupport(info, -closest.p);
+		if(closestDistSq - closest.p * w.p <= GJK_DISTANCE_TOLERANCE * closestDistSq) {
+			break;
+		}
+		// a support point already in the simplex adds nothing, the distance has converged within rounding
+		bool known = false;
+		for(int i = 0; i < simplex.order; i++) {
+			if(simplex.points[i].p == w.p) known = true;
+		}
+		if(known) {
+			break;
+		}
+
+		DistanceSimplex newSimplex;
+		switch(simplex.order) {
+			case 1: newSimplex = closestOnSegment(w, simplex.points[0]); break;
+			case 2: newSimplex = closestOnTriangle(w, simplex.points[0], simplex.points[1]); break;
+			default: newSimplex = closestOnTetrahedron(w, simplex.points[0], simplex.points[1], simplex.points[2]); break;
+		}
+		if(newSimplex.order == 4) {
+			return GJKDistance{0.0f, closest};
+		}
+
+		MinkPoint newClosest = newSimplex.getClosest();
+		// rounding errors can stop the distance from decreasing before the tolerance is reached, or leave a degenerate simplex without a closest point
+		if(!(newClosest.p * newClosest.p < closestDistSq)) {
+			break;
+		}
+		simplex = newSimplex;
+		closest = newClosest;
+	}
+
+	return GJKDistance{length(closest.p), closest};
+}
+
+// the neighbors of the triangles of the starting tetrahedron, indexed BC, CA, AB like TriangleNeighbors
+static const int tetrahedronNeighbors[4][3]{{3, 1, 2}, {3, 2, 0}, {3, 0, 1}, {0, 2, 1}};
+
 void initializeBuffer(const Tetrahedron& s, ComputationBuffers& b) {
 	b.vertBuf[0] = s.A.p;
 	b.vertBuf[1] = s.B.p;
@@ -215,22 +378,44 @@ void initializeBuffer(const Tetrahedron& s, ComputationBuffers& b) {
 	b.triangleBuf[2] = {0,3,1};
 	b.triangleBuf[3] = {3,2,1};
 
+	for(int i = 0; i < 4; i++) {
+		for(int side = 0; side < 3; side++) {
+			b.neighborBuf[i].neighbors[side] = tetrahedronNeighbors[i][side];
+		}
+	}
+
 	b.knownVecs[0] = MinkowskiPointIndices{s.A.originFirst, s.A.originSecond};
 	b.knownVecs[1] = MinkowskiPointIndices{s.B.originFirst, s.B.originSecond};
 	b.knownVecs[2] = MinkowskiPointIndices{s.C.originFirst, s.C.originSecond};
 	b.knownVecs[3] = MinkowskiPointIndices{s.D.originFirst, s.D.originSecond};
 }
 
-bool runEPATransformed(const ColissionPair& info, const Tetrahedron& s, Vec3f& intersection, Vec3f& exitVector, ComputationBuffers& bufs) {
+/*
+	The faces of the polytope are kept in a min-heap on their distance to the origin. Adding a point only pushes the triangles the builder created or moved,
+	faces of removed or moved triangles stay in the heap until they reach the top and are recognized as stale
+*/
+bool runEPATransformed(const ColissionPair& info, const Tetrahedron& s, Vec3f& intersection, Vec3f& exitVector, ComputationBuffers& bufs, float tolerance) {
 	initializeBuffer(s, bufs);
 
-	ConvexShapeBuilder builder(bufs.vertBuf, bufs.triangleBuf, 4, 4, bufs.neighborBuf, bufs.removalBuf, bufs.edgeBuf);
+	ConvexShapeBuilder builder(bufs.vertBuf, bufs.triangleBuf, 4, 4, bufs.neighborBuf, bufs.removalBuf, bufs.edgeBuf, false);
+
+	// compared against squared distances
+	float toleranceFactor = (1.0f + tolerance) * (1.0f + tolerance);
+
+	std::vector<EPAFace>& heap = bufs.faceHeap;
+	heap.clear();
+	for(int i = 0; i < 4; i++) {
+		pushFace(heap, builder, i);
+	}
 
 	for(int iter = 0; iter < EPA_MAX_ITER; iter++) {
-		NearestSurface ns = getNearestSurface(builder);
-		int closestTriangleIndex = ns.triangleIndex;
-		double distSq = ns.distanceSquared;
-		Triangle closestTriangle = builder.triangleBuf[closestTriangleIndex];
+		EPAFace nearest = getNearestFace(heap, builder);
+		if(nearest.distanceSquared == std::numeric_limits<float>::infinity()) {
+			Debug::logWarn("EPA polytope is flat!");
+			return false;
+		}
+		int closestTriangleIndex = nearest.triangleIndex;
+		Triangle closestTriangle = nearest.triangle;
 		Vec3f a = builder.vertexBuf[closestTriangle[0]];
 		Vec3f b = builder.vertexBuf[closestTriangle[1]];
 		Vec3f c = builder.vertexBuf[closestTriangle[2]];
@@ -239,28 +424,28 @@ bool runEPATransformed(const ColissionPair& info, const Tetrahedron& s, Vec3f& i
 		catchable_assert(isVecValid(b));
 		catchable_assert(isVecValid(c));
 
-		Vec3f closestTriangleNormal = getNormalVec(closestTriangle, builder.vertexBuf);
-
-		MinkPoint point(getSupport(info, closestTriangleNormal));
+		MinkPoint point(getSupport(info, nearest.normal));
 
-		
 		catchable_assert(isVecValid(point.p));
 
 		// point is the new point to be added, check if it's past the current triangle
-		double newPointDistSq = pow(point.p * closestTriangleNormal, 2) / lengthSquared(closestTriangleNormal);
+		float newPointDistanceSquared = pointToPlaneDistanceSquared(nearest.normal, point.p);
 
 		MinkowskiPointIndices curIndices{point.originFirst, point.originSecond};
 
 		// Do not remove! The inversion catches NaN as well!
-		if(!(newPointDistSq <= distSq * 1.01)) {
+		if(!(newPointDistanceSquared <= nearest.distanceSquared * toleranceFactor)) {
 			bufs.knownVecs[builder.vertexCount] = curIndices;
-			builder.addPoint(point.p, closestTriangleIndex);
+			std::pop_heap(heap.begin(), heap.end(), isFurtherFace);
+			heap.pop_back();
+			int changedCount = builder.addPoint(point.p, closestTriangleIndex);
+			for(int i = 0; i < changedCount; i++) {
+				pushFace(heap, builder, builder.removalBuffer[i]);
+			}
 		} else {
 			// closestTriangle is an edge triangle, so our best direction is towards this triangle.
-
-			RayIntersection<float> ri = rayTriangleIntersection(Vec3f(), closestTriangleNormal, a, b, c);
-
-			exitVector = ri.d * closestTriangleNormal;
+			// the origin projected onto its plane
+			exitVector = nearest.normal * ((nearest.normal * a) / lengthSquared(nearest.normal));
 
 			catchable_assert(isVecValid(exitVector));
 
@@ -48,14 +48,42 @@ struct Tetrahedron {
 	MinkPoint A, B, C, D;
 };
 
+/*
+	Everything GJK and EPA run in is in float, local to first
+	The products of the relative rotation and the scale of second are made once per pair, so a support query costs two matrix products and no conversions
+*/
 struct ColissionPair {
 	const GenericCollidable& first;
 	const GenericCollidable& second;
 	CFramef transform;
 	DiagonalMat3f scaleFirst;
 	DiagonalMat3f scaleSecond;
+	// takes a point of the shape class of second to the local space of first, without the offset of transform
+	Mat3f secondToFirst;
+	// the transpose of secondToFirst, takes a direction local to first to the shape class of second
+	Mat3f firstToSecondDirection;
+	// where the support queries of this pair start their search, see GenericCollidable::furthestInDirectionFrom
+	mutable int firstHint = 0;
+	mutable int secondHint = 0;
+
+	ColissionPair(const GenericCollidable& first, const GenericCollidable& second, const CFramef& transform, const DiagonalMat3f& scaleFirst, const DiagonalMat3f& scaleSecond) :
+		first(first), second(second), transform(transform), scaleFirst(scaleFirst), scaleSecond(scaleSecond),
+		secondToFirst(transform.getRotation().asRotationMatrix() * scaleSecond), firstToSecondDirection(secondToFirst.transpose()) {}
+};
+
+struct GJKDistance {
+	// distance between the two shapes, 0 if they overlap
+	float distance;
+	// closest points of the two shapes, p points from the closest point of second to the closest point of first
+	MinkPoint closest;
 };
 
 std::optional<Tetrahedron> runGJKTransformed(const ColissionPair& colissionPair, Vec3f initialSearchDirection);
-bool runEPATransformed(const ColissionPair& colissionPair, const Tetrahedron& s, Vec3f& intersection, Vec3f& exitVector, ComputationBuffers& bufs);
+GJKDistance runGJKDistanceTransformed(const ColissionPair& colissionPair, Vec3f initialSearchDirection);
+/*
+	EPA stops once the support point in the direction of the nearest face is at most tolerance times its distance further out than that face
+	The exit vector is then within that fraction of the penetration depth, smaller tolerances cost more iterations on curved shapes
+*/
+#define EPA_DEFAULT_TOLERANCE 0.005f
+bool runEPATransformed(const ColissionPair& colissionPair, const Tetrahedron& s, Vec3f& intersection, Vec3f& exitVector, ComputationBuffers& bufs, float tolerance = EPA_DEFAULT_TOLERANCE);
 };
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "heightfieldShapeClass.h"
+
+#include "builtinShapeClasses.h"
+#include "polyhedron.h"
+#include "../math/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace P3D {
+// quantized heights per unit of the -1..1 height of the shape class
+#define HEIGHT_QUANTIZATION_SCALE (65535.0 / 2.0)
+
+namespace {
+double dequantizeHeight(uint16_t height) {
+	return height / HEIGHT_QUANTIZATION_SCALE - 1.0;
+}
+};
+
+HeightfieldShapeClass::HeightfieldShapeClass(std::vector<uint16_t>&& heights, int sampleCountX, int sampleCountZ) :
+	ShapeClass(8, Vec3(0, 0, 0), ScalableInertialMatrix(Vec3(8.0 / 3.0, 8.0 / 3.0, 8.0 / 3.0), Vec3(0, 0, 0)), HEIGHTFIELD_CLASS_ID),
+	sampleCountX(sampleCountX),
+	sampleCountZ(sampleCountZ),
+	heights(std::move(heights)) {
+	if(sampleCountX < 2 || sampleCountZ < 2) throw std::invalid_argument("A heightfield needs at least 2x2 samples");
+	if(this->heights.size() != static_cast<std::size_t>(sampleCountX) * sampleCountZ) throw std::invalid_argument("The heights of a heightfield do not match its sample counts");
+
+	HeightRangeLevel cells(getCellCountX(), getCellCountZ(), 0, 0);
+	for(int z = 0; z < cells.depth; z++) {
+		for(int x = 0; x < cells.width; x++) {
+			uint16_t corners[4]{getQuantizedHeight(x, z), getQuantizedHeight(x + 1, z), getQuantizedHeight(x, z + 1), getQuantizedHeight(x + 1, z + 1)};
+			cells.min[z * cells.width + x] = *std::min_element(corners, corners + 4);
+			cells.max[z * cells.width + x] = *std::max_element(corners, corners + 4);
+		}
+	}
+	levels.push_back(std::move(cells));
+
+	while(levels.back().width > 1 || levels.back().depth > 1) {
+		const HeightRangeLevel& previous = levels.back();
+		HeightRangeLevel next((previous.width + 1) / 2, (previous.depth + 1) / 2, 65535, 0);
+		for(int z = 0; z < previous.depth; z++) {
+			for(int x = 0; x < previous.width; x++) {
+				int target = (z / 2) * next.width + x / 2;
+				next.min[target] = std::min(next.min[target], previous.min[z * previous.width + x]);
+				next.max[target] = std::max(next.max[target], previous.max[z * previous.width + x]);
+			}
+		}
+		levels.push_back(std::move(next));
+	}
+}
+
+uint16_t HeightfieldShapeClass::quantizeDown(double height) {
+	return static_cast<uint16_t>(std::clamp(std::floor((height + 1.0) * HEIGHT_QUANTIZATION_SCALE), 0.0, 65535.0));
+}
+uint16_t HeightfieldShapeClass::quantizeUp(double height) {
+	return static_cast<uint16_t>(std::clamp(std::ceil((height + 1.0) * HEIGHT_QUANTIZATION_SCALE), 0.0, 65535.0));
+}
+
+int HeightfieldShapeClass::getCellX(double x) const {
+	return static_cast<int>(std::clamp(std::floor((x + 1.0) * 0.5 * getCellCountX()), 0.0, double(getCellCountX() - 1)));
+}
+int HeightfieldShapeClass::getCellZ(double z) const {
+	return static_cast<int>(std::clamp(std::floor((z + 1.0) * 0.5 * getCellCountZ()), 0.0, double(getCellCountZ() - 1)));
+}
+
+// the lowest level at which the cells fit in 2x2 entries
+void HeightfieldShapeClass::getHeightRange(int cellX0, int cellZ0, int cellX1, int cellZ1, uint16_t& min, uint16_t& max) const {
+	std::size_t level = 0;
+	while(level + 1 < levels.size() && ((cellX1 >> level) - (cellX0 >> level) > 1 || (cellZ1 >> level) - (cellZ0 >> level) > 1)) {
+		level++;
+	}
+	const HeightRangeLevel& ranges = levels[level];
+	min = 65535;
+	max = 0;
+	for(int z = cellZ0 >> level; z <= (cellZ1 >> level); z++) {
+		for(int x = cellX0 >> level; x <= (cellX1 >> level); x++) {
+			min = std::min(min, ranges.min[z * ranges.width + x]);
+			max = std::max(max, ranges.max[z * ranges.width + x]);
+		}
+	}
+}
+
+bool HeightfieldShapeClass::containsPoint(Vec3 point) const {
+	if(point.x < -1.0 || point.x > 1.0 || point.z < -1.0 || point.z > 1.0 || point.y < -1.0) return false;
+
+	int cellX = getCellX(point.x);
+	int cellZ = getCellZ(point.z);
+	double fractionX = (point.x + 1.0) * 0.5 * getCellCountX() - cellX;
+	double fractionZ = (point.z + 1.0) * 0.5 * getCellCountZ() - cellZ;
+	double height00 = dequantizeHeight(getQuantizedHeight(cellX, cellZ));
+	double height10 = dequantizeHeight(getQuantizedHeight(cellX + 1, cellZ));
+	double height01 = dequantizeHeight(getQuantizedHeight(cellX, cellZ + 1));
+	double height11 = dequantizeHeight(getQuantizedHeight(cellX + 1, cellZ + 1));
+
+	double surfaceHeight;
+	if(fractionX + fractionZ <= 1.0) {
+		surfaceHeight = height00 + (height10 - height00) * fractionX + (height01 - height00) * fractionZ;
+	} else {
+		surfaceHeight = height11 + (height01 - height11) * (1.0 - fractionX) + (height10 - height11) * (1.0 - fractionZ);
+	}
+	return point.y <= surfaceHeight;
+}
+
+/*
+	The ray is clipped to the bounds of the field, then the cells it crosses are visited in order with a 2D DDA
+	The first cell with a hit holds the closest hit, cells the ray passes over entirely are skipped without testing their triangles
+*/
+double HeightfieldShapeClass::getIntersectionDistance(Vec3 origin, Vec3 direction) const {
+	double boxMin[3]{-1.0, -1.0, -1.0};
+	double boxMax[3]{1.0, dequantizeHeight(levels.back().max[0]), 1.0};
+	double entry = 0.0;
+	double exit = std::numeric_limits<double>::infinity();
+	for(int axis = 0; axis < 3; axis++) {
+		if(direction[axis] == 0.0) {
+			if(origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis]) return std::numeric_limits<double>::max();
+			continue;
+		}
+		double t1 = (boxMin[axis] - origin[axis]) / direction[axis];
+		double t2 = (boxMax[axis] - origin[axis]) / direction[axis];
+		entry = std::max(entry, std::min(t1, t2));
+		exit = std::min(exit, std::max(t1, t2));
+	}
+	if(entry > exit) return std::numeric_limits<double>::max();
+
+	// the walk is done in cell coordinates, where every cell is 1 wide
+	double gridX = (origin.x + 1.0) * 0.5 * getCellCountX();
+	double gridZ = (origin.z + 1.0) * 0.5 * getCellCountZ();
+	double gridDirectionX = direction.x * 0.5 * getCellCountX();
+	double gridDirectionZ = direction.z * 0.5 * getCellCountZ();
+	int cellX = getCellX(origin.x + direction.x * entry);
+	int cellZ = getCellZ(origin.z + direction.z * entry);
+	int stepX = gridDirectionX > 0.0 ? 1 : -1;
+	int stepZ = gridDirectionZ > 0.0 ? 1 : -1;
+	// distances along the ray to the next cell border in x and z
+	double nextX = gridDirectionX != 0.0 ? (cellX + (stepX > 0 ? 1 : 0) - gridX) / gridDirectionX : std::numeric_limits<double>::infinity();
+	double nextZ = gridDirectionZ != 0.0 ? (cellZ + (stepZ > 0 ? 1 : 0) - gridZ) / gridDirectionZ : std::numeric_limits<double>::infinity();
+	double deltaX = gridDirectionX != 0.0 ? std::abs(1.0 / gridDirectionX) : std::numeric_limits<double>::infinity();
+	double deltaZ = gridDirectionZ != 0.0 ? std::abs(1.0 / gridDirectionZ) : std::numeric_limits<double>::infinity();
+
+	const HeightRangeLevel& cells = levels[0];
+	double cellEntry = entry;
+	while(true) {
+		double cellExit = std::min(std::min(nextX, nextZ), exit);
+		double lowestY = origin.y + direction.y * (direction.y < 0.0 ? cellExit : cellEntry);
+		if(lowestY <= dequantizeHeight(cells.max[cellZ * cells.width + cellX])) {
+			Vec3 corner00(getVertex(cellX, cellZ));
+			Vec3 corner10(getVertex(cellX + 1, cellZ));
+			Vec3 corner01(getVertex(cellX, cellZ + 1));
+			Vec3 corner11(getVertex(cellX + 1, cellZ + 1));
+			double closest = std::numeric_limits<double>::max();
+			RayIntersection<double> first = rayTriangleIntersection(origin, direction, corner00, corner01, corner10);
+			if(first.rayIntersectsTriangle()) closest = std::min(closest, first.d);
+			RayIntersection<double> second = rayTriangleIntersection(origin, direction, corner10, corner01, corner11);
+			if(second.rayIntersectsTriangle()) closest = std::min(closest, second.d);
+			if(closest != std::numeric_limits<double>::max()) return closest;
+		}
+		if(cellExit >= exit) break;
+
+		if(nextX < nextZ) {
+			cellX += stepX;
+			if(cellX < 0 || cellX >= getCellCountX()) break;
+			cellEntry = nextX;
+			nextX += deltaX;
+		} else {
+			cellZ += stepZ;
+			if(cellZ < 0 || cellZ >= getCellCountZ()) break;
+			cellEntry = nextZ;
+			nextZ += deltaZ;
+		}
+	}
+	return std::numeric_limits<double>::max();
+}
+
+BoundingBox HeightfieldShapeClass::getBounds(const Rotation& rotation, const DiagonalMat3& scale) const {
+	Mat3 transform = rotation.asRotationMatrix() * scale;
+	double top = dequantizeHeight(levels.back().max[0]);
+	Vec3 first = transform * Vec3(-1.0, -1.0, -1.0);
+	BoundingBox result(first, first);
+	for(int i = 1; i < 8; i++) {
+		result = result.expanded(transform * Vec3((i & 1) ? 1.0 : -1.0, (i & 2) ? top : -1.0, (i & 4) ? 1.0 : -1.0));
+	}
+	return result;
+}
+
+double HeightfieldShapeClass::getScaledMaxRadiusSq(DiagonalMat3 scale) const {
+	double top = dequantizeHeight(levels.back().max[0]);
+	double height = std::max(std::abs(top), 1.0);
+	return lengthSquared(scale * Vec3(1.0, height, 1.0));
+}
+
+Vec3f HeightfieldShapeClass::furthestInDirection(const Vec3f& direction) const {
+	// the bottom corners of the solid below the surface
+	Vec3f best(direction.x >= 0.0f ? 1.0f : -1.0f, -1.0f, direction.z >= 0.0f ? 1.0f : -1.0f);
+	float bestDistance = best * direction;
+	for(int z = 0; z < sampleCountZ; z++) {
+		for(int x = 0; x < sampleCountX; x++) {
+			Vec3f vertex = getVertex(x, z);
+			float distance = vertex * direction;
+			if(distance > bestDistance) {
+				best = vertex;
+				bestDistance = distance;
+			}
+		}
+	}
+	return best;
+}
+
+Polyhedron HeightfieldShapeClass::asPolyhedron() const {
+	int sampleCount = sampleCountX * sampleCountZ;
+	std::vector<Vec3f> vertices(2 * sampleCount);
+	for(int z = 0; z < sampleCountZ; z++) {
+		for(int x = 0; x < sampleCountX; x++) {
+			Vec3f vertex = getVertex(x, z);
+			vertices[z * sampleCountX + x] = vertex;
+			vertices[sampleCount + z * sampleCountX + x] = Vec3f(vertex.x, -1.0f, vertex.z);
+		}
+	}
+	auto top = [this](int x, int z) { return z * sampleCountX + x; };
+	auto bottom = [this, sampleCount](int x, int z) { return sampleCount + z * sampleCountX + x; };
+
+	std::vector<Triangle> triangles;
+	triangles.reserve(4 * getCellCountX() * getCellCountZ() + 4 * (getCellCountX() + getCellCountZ()));
+	for(int z = 0; z < getCellCountZ(); z++) {
+		for(int x = 0; x < getCellCountX(); x++) {
+			triangles.push_back(Triangle{top(x, z), top(x, z + 1), top(x + 1, z)});
+			triangles.push_back(Triangle{top(x + 1, z), top(x, z + 1), top(x + 1, z + 1)});
+			triangles.push_back(Triangle{bottom(x, z), bottom(x + 1, z), bottom(x, z + 1)});
+			triangles.push_back(Triangle{bottom(x + 1, z), bottom(x + 1, z + 1), bottom(x, z + 1)});
+		}
+	}
+	// the walls, wound to match the edges of the top and bottom triangles along the border
+	int lastX = getCellCountX();
+	int lastZ = getCellCountZ();
+	for(int x = 0; x < lastX; x++) {
+		triangles.push_back(Triangle{top(x, 0), top(x + 1, 0), bottom(x + 1, 0)});
+		triangles.push_back(Triangle{top(x, 0), bottom(x + 1, 0), bottom(x, 0)});
+		triangles.push_back(Triangle{top(x + 1, lastZ), top(x, lastZ), bottom(x, lastZ)});
+		triangles.push_back(Triangle{top(x + 1, lastZ), bottom(x, lastZ), bottom(x + 1, lastZ)});
+	}
+	for(int z = 0; z < lastZ; z++) {
+		triangles.push_back(Triangle{top(0, z + 1), top(0, z), bottom(0, z)});
+		triangles.push_back(Triangle{top(0, z + 1), bottom(0, z), bottom(0, z + 1)});
+		triangles.push_back(Triangle{top(lastX, z), top(lastX, z + 1), bottom(lastX, z + 1)});
+		triangles.push_back(Triangle{top(lastX, z), bottom(lastX, z + 1), bottom(lastX, z)});
+	}
+	return Polyhedron(vertices.data(), triangles.data(), static_cast<int>(vertices.size()), static_cast<int>(triangles.size()));
+}
+};
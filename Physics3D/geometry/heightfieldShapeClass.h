@@ -0,0 +1,107 @@
+#pragma once
+
+#include "shapeClass.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace P3D {
+/*
+	A regular grid of heights for terrain parts, the solid below the surface down to the bottom of its bounds
+
+	The samples span x and z from -1 to 1, heights are stored as 16 bit fractions of the -1..1 height of the class
+	Every cell is split into two triangles along the diagonal from its (x+1, z) to its (x, z+1) corner
+
+	Colissions are found against the triangles of the cells under the other shape, ray queries walk the cells along the ray
+	Only use it for terrain, it has no meaningful mass: the volume and inertia are those of its bounding box
+	Heightfields and triangle meshes never collide with each other
+*/
+class HeightfieldShapeClass : public ShapeClass {
+	int sampleCountX;
+	int sampleCountZ;
+	// heights[z * sampleCountX + x]
+	std::vector<uint16_t> heights;
+
+	struct HeightRangeLevel {
+		int width;
+		int depth;
+		std::vector<uint16_t> min;
+		std::vector<uint16_t> max;
+
+		HeightRangeLevel(int width, int depth, uint16_t initialMin, uint16_t initialMax) :
+			width(width),
+			depth(depth),
+			min(static_cast<std::size_t>(width) * depth, initialMin),
+			max(static_cast<std::size_t>(width) * depth, initialMax) {}
+	};
+	/*
+		levels[0] holds the lowest and highest corner of each cell, every next level the range of 2x2 entries of the previous one
+		The last level is a single range over the whole field
+	*/
+	std::vector<HeightRangeLevel> levels;
+
+	static uint16_t quantizeDown(double height);
+	static uint16_t quantizeUp(double height);
+public:
+	// heights must have sampleCountX * sampleCountZ entries, see heightfieldShape in shapeCreation.h
+	HeightfieldShapeClass(std::vector<uint16_t>&& heights, int sampleCountX, int sampleCountZ);
+
+	int getSampleCountX() const { return sampleCountX; }
+	int getSampleCountZ() const { return sampleCountZ; }
+	int getCellCountX() const { return sampleCountX - 1; }
+	int getCellCountZ() const { return sampleCountZ - 1; }
+	uint16_t getQuantizedHeight(int x, int z) const { return heights[z * sampleCountX + x]; }
+	Vec3f getVertex(int x, int z) const {
+		return Vec3f(-1.0f + 2.0f * x / getCellCountX(), -1.0f + 2.0f / 65535.0f * getQuantizedHeight(x, z), -1.0f + 2.0f * z / getCellCountZ());
+	}
+
+	// the range of quantized heights over cells cellX0..cellX1 and cellZ0..cellZ1 inclusive, found in the pyramid so it may be wider than the exact range
+	void getHeightRange(int cellX0, int cellZ0, int cellX1, int cellZ1, uint16_t& min, uint16_t& max) const;
+
+	// calls func(a, b, c) for each triangle of a cell under bounds whose height range overlaps them, bounds are in the -1..1 space of the class
+	template<typename Func>
+	void forEachTriangleInBounds(const BoundingBox& bounds, const Func& func) const {
+		if(bounds.max.x < -1.0 || bounds.min.x > 1.0 || bounds.max.z < -1.0 || bounds.min.z > 1.0) return;
+		if(bounds.max.y < -1.0 || bounds.min.y > 1.0) return;
+
+		int cellX0 = getCellX(bounds.min.x);
+		int cellX1 = getCellX(bounds.max.x);
+		int cellZ0 = getCellZ(bounds.min.z);
+		int cellZ1 = getCellZ(bounds.max.z);
+		uint16_t queryMin = quantizeDown(bounds.min.y);
+		uint16_t queryMax = quantizeUp(bounds.max.y);
+
+		uint16_t rangeMin;
+		uint16_t rangeMax;
+		getHeightRange(cellX0, cellZ0, cellX1, cellZ1, rangeMin, rangeMax);
+		if(rangeMax < queryMin || rangeMin > queryMax) return;
+
+		const HeightRangeLevel& cells = levels[0];
+		for(int z = cellZ0; z <= cellZ1; z++) {
+			for(int x = cellX0; x <= cellX1; x++) {
+				int cell = z * cells.width + x;
+				if(cells.max[cell] < queryMin || cells.min[cell] > queryMax) continue;
+				Vec3f corner00 = getVertex(x, z);
+				Vec3f corner10 = getVertex(x + 1, z);
+				Vec3f corner01 = getVertex(x, z + 1);
+				Vec3f corner11 = getVertex(x + 1, z + 1);
+				func(corner00, corner01, corner10);
+				func(corner10, corner01, corner11);
+			}
+		}
+	}
+
+	// the cell containing x, clamped to the field
+	int getCellX(double x) const;
+	int getCellZ(double z) const;
+
+	virtual bool containsPoint(Vec3 point) const override;
+	virtual double getIntersectionDistance(Vec3 origin, Vec3 direction) const override;
+	virtual BoundingBox getBounds(const Rotation& rotation, const DiagonalMat3& scale) const override;
+	virtual double getScaledMaxRadiusSq(DiagonalMat3 scale) const override;
+	// scans every sample, only reached by queries that treat the heightfield as a convex shape
+	virtual Vec3f furthestInDirection(const Vec3f& direction) const override;
+	// the surface closed off by walls down to the bottom of the bounds and a flat bottom
+	virtual Polyhedron asPolyhedron() const override;
+};
+};
@@ -1,6 +1,9 @@
 #include "indexedShape.h"
 
 #include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
 #include "../misc/validityHelper.h"
 
 namespace P3D {
@@ -36,35 +39,77 @@ int TriangleNeighbors::getNeighborIndex(int neighbor) {
 IndexedShape::IndexedShape(Polyhedron&& poly, TriangleNeighbors* neighborBuf) : Polyhedron(std::move(poly)), neighbors(neighborBuf) {}
 IndexedShape::IndexedShape(const Vec3f* vertices, const Triangle* triangles, int vertexCount, int triangleCount, TriangleNeighbors* neighborBuf) : Polyhedron(vertices, triangles, vertexCount, triangleCount), neighbors(neighborBuf) {}
 
-void fillNeighborBuf(const Triangle* triangles, int triangleCount, TriangleNeighbors* neighborBuf) {
+// small meshes, such as the ones EPA builds for every colission, are matched on the stack
+#define NEIGHBOR_STACK_SIDE_COUNT 96
+
+namespace {
+// a triangle side, sorted by the vertices of its edge regardless of direction so the sides sharing an edge end up next to each other
+struct SideEdge {
+	std::uint64_t edgeKey;
+	int triangle;
+	int side;
+
+	bool operator<(const SideEdge& other) const {
+		return edgeKey < other.edgeKey;
+	}
+};
+
+SideEdge makeSideEdge(const Triangle& t, int triangle, int side) {
+	std::uint32_t from = static_cast<std::uint32_t>(t[side]);
+	std::uint32_t to = static_cast<std::uint32_t>(t[(side + 1) % 3]);
+	std::uint64_t key = from < to ? (std::uint64_t(from) << 32 | to) : (std::uint64_t(to) << 32 | from);
+	return SideEdge{key, triangle, side};
+}
+
+bool goesUp(const Triangle* triangles, const SideEdge& edge) {
+	const Triangle& t = triangles[edge.triangle];
+	return t[edge.side] < t[(edge.side + 1) % 3];
+}
+
+int matchSortedSides(const Triangle* triangles, SideEdge* sides, int sideCount, TriangleNeighbors* neighborBuf) {
+	std::sort(sides, sides + sideCount);
+
+	int unmatchedSides = 0;
+	for(int i = 0; i < sideCount;) {
+		int groupEnd = i + 1;
+		while(groupEnd < sideCount && sides[groupEnd].edgeKey == sides[i].edgeKey) groupEnd++;
+
+		// a manifold edge is shared by exactly two triangles that run along it in opposite directions
+		if(groupEnd - i == 2 && goesUp(triangles, sides[i]) != goesUp(triangles, sides[i + 1])) {
+			const SideEdge& a = sides[i];
+			const SideEdge& b = sides[i + 1];
+			// side i goes from vertex i to vertex i+1, its neighbor is stored opposite to vertex i+2
+			neighborBuf[a.triangle][(a.side + 2) % 3] = b.triangle;
+			neighborBuf[b.triangle][(b.side + 2) % 3] = a.triangle;
+		} else {
+			unmatchedSides += groupEnd - i;
+		}
+		i = groupEnd;
+	}
+	return unmatchedSides;
+}
+};
+
+/*
+	The sides of all triangles are sorted by their edge, so the sides that share an edge are next to each other
+	O(n log n) instead of comparing every pair of triangles
+*/
+int fillNeighborBuf(const Triangle* triangles, int triangleCount, TriangleNeighbors* neighborBuf) {
+	int sideCount = triangleCount * 3;
+	SideEdge stackSides[NEIGHBOR_STACK_SIDE_COUNT];
+	std::vector<SideEdge> heapSides;
+	SideEdge* sides = stackSides;
+	if(sideCount > NEIGHBOR_STACK_SIDE_COUNT) {
+		heapSides.resize(sideCount);
+		sides = heapSides.data();
+	}
+
 	for(int i = 0; i < triangleCount; i++) {
-		for(int j = i + 1; j < triangleCount; j++) {
-			const Triangle& ti = triangles[i];
-			const Triangle& tj = triangles[j];
-			for(int index1 = 0; index1 < 3; index1++) {
-				for(int index2 = 0; index2 < 3; index2++) {
-					if(ti[index1] == tj[index2]) {
-						if(ti[(index1 + 1) % 3] == tj[(index2 + 2) % 3]) {
-							// Triangles are joined at edges: index1 - index1+1 <-> index2-1 - index2
-
-							neighborBuf[i][(index1 + 2) % 3] = j;
-							neighborBuf[j][(index2 + 1) % 3] = i;
-
-						} else if(ti[(index1 + 2) % 3] == tj[(index2 + 1) % 3]) {
-							// Triangles are joined at edges: index1-1 - index1 <-> index2 - index2+1
-
-							neighborBuf[i][(index1 + 1) % 3] = j;
-							neighborBuf[j][(index2 + 2) % 3] = i;
-						}
-
-						goto nextTriangle;
-					}
-				}
-			}
-			nextTriangle:
-			continue;
+		for(int side = 0; side < 3; side++) {
+			sides[i * 3 + side] = makeSideEdge(triangles[i], i, side);
 		}
 	}
+	return matchSortedSides(triangles, sides, sideCount, neighborBuf);
 }
 };
 
@@ -31,5 +31,10 @@ struct IndexedShape : Polyhedron {
 	IndexedShape(const Vec3f* vertices, const Triangle* triangles, int vertexCount, int triangleCount, TriangleNeighbors* neighborBuf);
 };
 
-void fillNeighborBuf(const Triangle* triangles, int triangleCount, TriangleNeighbors* neighborBuf);
+/*
+	Fills the neighbors of every triangle, the neighbor across a side is the triangle that has the same edge in the opposite direction
+	Returns the number of triangle sides that could not be matched, because the mesh is open there or the edge is non-manifold (used by more than two triangles or twice in the same direction)
+	The neighbors of unmatched sides are left as they were
+*/
+int fillNeighborBuf(const Triangle* triangles, int triangleCount, TriangleNeighbors* neighborBuf);
 };
\ No newline at end of file
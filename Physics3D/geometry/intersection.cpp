@@ -10,13 +10,93 @@
 
 #include "../misc/validityHelper.h"
 #include "shapeClass.h"
+#include "builtinShapeClasses.h"
+#include "triangleMeshShapeClass.h"
+#include "heightfieldShapeClass.h"
 
 #include "../misc/catchable_assert.h"
+#include "../misc/debug.h"
 
 #include <algorithm>
 
 namespace P3D {
+namespace {
+// a single triangle of a terrain shape class, in the -1..1 space of the class
+struct TerrainTriangleCollidable : public GenericCollidable {
+	Vec3f a;
+	Vec3f b;
+	Vec3f c;
+
+	TerrainTriangleCollidable(const Vec3f& a, const Vec3f& b, const Vec3f& c) : a(a), b(b), c(c) {}
+
+	virtual Vec3f furthestInDirection(const Vec3f& direction) const override {
+		float distA = a * direction;
+		float distB = b * direction;
+		float distC = c * direction;
+		if(distA >= distB && distA >= distC) return a;
+		return distB >= distC ? b : c;
+	}
+};
+
+bool isTerrain(const Shape& shape) {
+	return shape.baseShape->intersectionClassID == TRIANGLE_MESH_CLASS_ID || shape.baseShape->intersectionClassID == HEIGHTFIELD_CLASS_ID;
+}
+
+// bounds of other local to terrain, in the -1..1 space of the class of terrain
+BoundingBox getBoundsInTerrainClass(const Shape& terrain, const BoundingBox& otherBounds) {
+	return BoundingBox(
+		otherBounds.min.x / terrain.scale[0], otherBounds.min.y / terrain.scale[1], otherBounds.min.z / terrain.scale[2],
+		otherBounds.max.x / terrain.scale[0], otherBounds.max.y / terrain.scale[1], otherBounds.max.z / terrain.scale[2]
+	);
+}
+
+BoundingBox getBoundsLocalToTerrain(const Shape& other, const CFrame& relativeTransform) {
+	BoundingBox bounds = other.getBounds(relativeTransform.getRotation());
+	return BoundingBox(bounds.min + relativeTransform.getPosition(), bounds.max + relativeTransform.getPosition());
+}
+
+// calls func(triangle) for each triangle of terrain that may overlap bounds, which are local to terrain
+template<typename Func>
+void forEachTerrainTriangle(const Shape& terrain, const BoundingBox& bounds, const Func& func) {
+	BoundingBox boundsInClass = getBoundsInTerrainClass(terrain, bounds);
+	if(terrain.baseShape->intersectionClassID == HEIGHTFIELD_CLASS_ID) {
+		const HeightfieldShapeClass& heightfield = static_cast<const HeightfieldShapeClass&>(*terrain.baseShape);
+		heightfield.forEachTriangleInBounds(boundsInClass, [&](const Vec3f& a, const Vec3f& b, const Vec3f& c) {
+			func(TerrainTriangleCollidable(a, b, c));
+		});
+	} else {
+		const TriangleMeshShapeClass& meshClass = static_cast<const TriangleMeshShapeClass&>(*terrain.baseShape);
+		const TriangleMesh& mesh = meshClass.getMesh();
+		meshClass.forEachTriangleInBounds(boundsInClass, [&](int triangleIndex) {
+			Triangle triangle = mesh.getTriangle(triangleIndex);
+			func(TerrainTriangleCollidable(mesh.getVertex(triangle.firstIndex), mesh.getVertex(triangle.secondIndex), mesh.getVertex(triangle.thirdIndex)));
+		});
+	}
+}
+
+// other is tested against each triangle of terrain that it might overlap, the deepest intersection is kept
+std::optional<Intersection> intersectsTerrain(const Shape& terrain, const Shape& other, const CFrame& relativeTransform) {
+	std::optional<Intersection> deepest;
+	forEachTerrainTriangle(terrain, getBoundsLocalToTerrain(other, relativeTransform), [&](const TerrainTriangleCollidable& triangle) {
+		std::optional<Intersection> result = intersectsTransformed(triangle, *other.baseShape, relativeTransform, terrain.scale, other.scale);
+		if(result && (!deepest || lengthSquared(result->exitVector) > lengthSquared(deepest->exitVector))) {
+			deepest = result;
+		}
+	});
+	return deepest;
+}
+};
+
 std::optional<Intersection> intersectsTransformed(const Shape& first, const Shape& second, const CFrame& relativeTransform) {
+	if(isTerrain(first) || isTerrain(second)) {
+		// triangle meshes and heightfields are only used for terrain, which never collides with itself
+		if(isTerrain(first) && isTerrain(second)) return std::optional<Intersection>();
+		if(isTerrain(first)) return intersectsTerrain(first, second, relativeTransform);
+
+		std::optional<Intersection> result = intersectsTerrain(second, first, ~relativeTransform);
+		if(!result) return result;
+		return Intersection(relativeTransform.localToGlobal(result->intersection), -relativeTransform.localToRelative(result->exitVector));
+	}
 	return intersectsTransformed(*first.baseShape, *second.baseShape, relativeTransform, first.scale, second.scale);
 }
 
@@ -24,12 +104,12 @@ thread_local ComputationBuffers buffers(1000, 2000);
 
 std::optional<Intersection> intersectsTransformed(const GenericCollidable& first, const GenericCollidable& second, const CFrame& relativeTransform, const DiagonalMat3& scaleFirst, const DiagonalMat3& scaleSecond) {
 	ColissionPair info{first, second, relativeTransform, scaleFirst, scaleSecond};
-	physicsMeasure.mark(PhysicsProcess::GJK_COL);
+	ProfileZone zone(PhysicsProcess::GJK_COL);
 	std::optional collides = runGJKTransformed(info, -relativeTransform.position);
 
 	if(collides) {
 		Tetrahedron& result = collides.value();
-		physicsMeasure.mark(PhysicsProcess::EPA);
+		zone.next(PhysicsProcess::EPA);
 		Vec3f intersection;
 		Vec3f exitVector;
 
@@ -64,8 +144,83 @@ std::optional<Intersection> intersectsTransformed(const GenericCollidable& first
 			return std::optional<Intersection>(Intersection(intersection, exitVector));
 		}
 	} else {
-		physicsMeasure.mark(PhysicsProcess::OTHER, PhysicsProcess::GJK_NO_COL);
+		zone.setProcess(PhysicsProcess::GJK_NO_COL);
 		return std::optional<Intersection>();
 	}
 }
+
+#define SWEEP_MAX_ITER 64
+
+/*
+	Conservative advancement: the distance between the shapes is measured with GJK and second is moved ahead by the time it needs
+	to close that distance along the separating normal at its speed towards first. Second can not touch first before that time,
+	so the steps never skip past the contact, and they get smaller as second closes in.
+*/
+static std::optional<SweepHit> sweepCollidables(const GenericCollidable& first, const GenericCollidable& second, const CFrame& relativeTransform, const DiagonalMat3& scaleFirst, const DiagonalMat3& scaleSecond, const Vec3& movement, double tolerance) {
+	CFrame transform = relativeTransform;
+	// the support points of the closest features lie towards second
+	Vec3f searchDirection = relativeTransform.position;
+	double fraction = 0.0;
+
+	for(int iter = 0; iter < SWEEP_MAX_ITER; iter++) {
+		ColissionPair info{first, second, transform, scaleFirst, scaleSecond};
+		GJKDistance distance = runGJKDistanceTransformed(info, searchDirection);
+
+		if(distance.distance <= tolerance) {
+			if(distance.distance == 0.0f) {
+				if(fraction == 0.0) {
+					return SweepHit{0.0, -normalize(movement), Vec3(distance.closest.originFirst)};
+				}
+				// stepped just past tolerance into first, the normal of the previous step is the best estimate
+				return SweepHit{fraction, Vec3(searchDirection), Vec3(distance.closest.originFirst)};
+			}
+			return SweepHit{fraction, Vec3(-distance.closest.p / distance.distance), Vec3(distance.closest.originFirst)};
+		}
+
+		Vec3 normal = Vec3(-distance.closest.p) / static_cast<double>(distance.distance);
+		double approachSpeed = -(movement * normal);
+		if(approachSpeed <= 0.0) {
+			return std::optional<SweepHit>();
+		}
+
+		fraction += distance.distance / approachSpeed;
+		if(fraction > 1.0) {
+			return std::optional<SweepHit>();
+		}
+		transform.position = relativeTransform.position + movement * fraction;
+		searchDirection = Vec3f(normal);
+	}
+
+	Debug::logWarn("Sweep iteration limit reached!");
+	return std::optional<SweepHit>();
+}
+
+// sweeps other against each triangle of terrain that it might touch along the way, the earliest hit is kept
+static std::optional<SweepHit> sweepTerrain(const Shape& terrain, const Shape& other, const CFrame& relativeTransform, const Vec3& movement, double tolerance) {
+	BoundingBox start = getBoundsLocalToTerrain(other, relativeTransform);
+	BoundingBox end(start.min + movement, start.max + movement);
+	BoundingBox sweptBounds = start.expanded(end).expanded(tolerance);
+
+	std::optional<SweepHit> earliest;
+	forEachTerrainTriangle(terrain, sweptBounds, [&](const TerrainTriangleCollidable& triangle) {
+		std::optional<SweepHit> hit = sweepCollidables(triangle, *other.baseShape, relativeTransform, terrain.scale, other.scale, movement, tolerance);
+		if(hit && (!earliest || hit->fraction < earliest->fraction)) {
+			earliest = hit;
+		}
+	});
+	return earliest;
+}
+
+std::optional<SweepHit> sweepTransformed(const Shape& first, const Shape& second, const CFrame& relativeTransform, const Vec3& movement, double tolerance) {
+	if(isTerrain(first) || isTerrain(second)) {
+		if(isTerrain(first) && isTerrain(second)) return std::optional<SweepHit>();
+		if(isTerrain(first)) return sweepTerrain(first, second, relativeTransform, movement, tolerance);
+
+		// first moves by -movement relative to the terrain instead, the hit is converted back to where second is at that fraction
+		std::optional<SweepHit> hit = sweepTerrain(second, first, ~relativeTransform, -relativeTransform.relativeToLocal(movement), tolerance);
+		if(!hit) return hit;
+		return SweepHit{hit->fraction, -relativeTransform.localToRelative(hit->normal), relativeTransform.localToGlobal(hit->point) + movement * hit->fraction};
+	}
+	return sweepCollidables(*first.baseShape, *second.baseShape, relativeTransform, first.scale, second.scale, movement, tolerance);
+}
 };
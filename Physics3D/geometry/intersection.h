@@ -21,6 +21,17 @@ struct Intersection {
 		exitVector(exitVector) {}
 };
 
+struct SweepHit {
+	// fraction of the movement at which the shapes touch, 0 if they already overlap at the start
+	double fraction;
+	// Local to first, the surface normal of first at the contact, pointing towards second
+	Vec3 normal;
+	// Local to first, the contact point on the surface of first
+	Vec3 point;
+};
+
 std::optional<Intersection> intersectsTransformed(const Shape& first, const Shape& second, const CFrame& relativeTransform);
+// moves second from relativeTransform by movement, local to first, and finds where it first comes within tolerance of first
+std::optional<SweepHit> sweepTransformed(const Shape& first, const Shape& second, const CFrame& relativeTransform, const Vec3& movement, double tolerance);
 std::optional<Intersection> intersectsTransformed(const GenericCollidable& first, const GenericCollidable& second, const CFrame& relativeTransform, const DiagonalMat3& scaleFirst, const DiagonalMat3& scaleSecond);
 };
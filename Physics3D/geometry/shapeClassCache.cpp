@@ -0,0 +1,124 @@
+#include "shapeClassCache.h"
+
+#include "polyhedron.h"
+#include "builtinShapeClasses.h"
+#include "shapeCreation.h"
+
+#include <cmath>
+#include <functional>
+
+namespace P3D {
+// normalized vertices closer than this in every coordinate are the same, scaling and normalizing a polyhedron rounds its last bits
+#define SHAPE_CLASS_VERTEX_TOLERANCE 0.00001f
+
+ShapeClassCache& ShapeClassCache::get() {
+	// never destroyed, shapes in static storage may release their classes after it would have been
+	static ShapeClassCache* cache = new ShapeClassCache();
+	return *cache;
+}
+
+// vertices are hashed rounded to the tolerance, two vertices within the tolerance that round to different steps only cost a separate class
+std::size_t ShapeClassCache::hashPolyhedron(const Polyhedron& poly) {
+	std::size_t hash = std::hash<int>()(poly.vertexCount);
+	auto combine = [&hash](std::size_t value) {
+		hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	};
+	auto combineCoordinate = [&combine](float coordinate) {
+		combine(std::hash<long long>()(std::llround(coordinate / SHAPE_CLASS_VERTEX_TOLERANCE)));
+	};
+	combine(std::hash<int>()(poly.triangleCount));
+	for(int i = 0; i < poly.vertexCount; i++) {
+		Vec3f vertex = poly.getVertex(i);
+		combineCoordinate(vertex.x);
+		combineCoordinate(vertex.y);
+		combineCoordinate(vertex.z);
+	}
+	for(int i = 0; i < poly.triangleCount; i++) {
+		Triangle triangle = poly.getTriangle(i);
+		combine(std::hash<int>()(triangle.firstIndex));
+		combine(std::hash<int>()(triangle.secondIndex));
+		combine(std::hash<int>()(triangle.thirdIndex));
+	}
+	return hash;
+}
+
+bool ShapeClassCache::samePolyhedron(const Polyhedron& first, const Polyhedron& second) {
+	if(first.vertexCount != second.vertexCount || first.triangleCount != second.triangleCount) return false;
+	for(int i = 0; i < first.vertexCount; i++) {
+		Vec3f a = first.getVertex(i);
+		Vec3f b = second.getVertex(i);
+		if(std::abs(a.x - b.x) > SHAPE_CLASS_VERTEX_TOLERANCE || std::abs(a.y - b.y) > SHAPE_CLASS_VERTEX_TOLERANCE || std::abs(a.z - b.z) > SHAPE_CLASS_VERTEX_TOLERANCE) return false;
+	}
+	for(int i = 0; i < first.triangleCount; i++) {
+		Triangle a = first.getTriangle(i);
+		Triangle b = second.getTriangle(i);
+		if(a.firstIndex != b.firstIndex || a.secondIndex != b.secondIndex || a.thirdIndex != b.thirdIndex) return false;
+	}
+	return true;
+}
+
+const PolyhedronShapeClass* ShapeClassCache::findLive(std::size_t hash, const Polyhedron& poly) {
+	auto range = classes.equal_range(hash);
+	for(auto iter = range.first; iter != range.second; ++iter) {
+		const PolyhedronShapeClass* candidate = iter->second;
+		if(!samePolyhedron(candidate->poly, poly)) continue;
+
+		// a class at 0 is being destroyed and waits for the mutex to leave the cache, it must not be revived
+		std::size_t count = candidate->refCount.load();
+		while(count != 0) {
+			if(candidate->refCount.compare_exchange_weak(count, count + 1)) return candidate;
+		}
+	}
+	return nullptr;
+}
+
+void ShapeClassCache::insert(std::size_t hash, const PolyhedronShapeClass* shapeClass) {
+	shapeClass->internedHash = hash;
+	shapeClass->interned = true;
+	classes.emplace(hash, shapeClass);
+}
+
+void ShapeClassCache::remove(const PolyhedronShapeClass* shapeClass) {
+	ShapeClassCache& cache = get();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	auto range = cache.classes.equal_range(shapeClass->internedHash);
+	for(auto iter = range.first; iter != range.second; ++iter) {
+		if(iter->second == shapeClass) {
+			cache.classes.erase(iter);
+			return;
+		}
+	}
+}
+
+intrusive_ptr<const ShapeClass> ShapeClassCache::getPolyhedronClass(Polyhedron&& poly) {
+	ShapeClassCache& cache = get();
+	std::size_t hash = hashPolyhedron(poly);
+	{
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		if(const PolyhedronShapeClass* found = cache.findLive(hash, poly)) return intrusive_ptr<const ShapeClass>(found, false);
+	}
+
+	// built outside of the lock, the class may have been added in the meantime
+	intrusive_ptr<const ShapeClass> created(createPolyhedronShapeClass(std::move(poly)));
+	return intern(created);
+}
+
+intrusive_ptr<const ShapeClass> ShapeClassCache::intern(const intrusive_ptr<const ShapeClass>& shapeClass) {
+	const PolyhedronShapeClass* polyClass = dynamic_cast<const PolyhedronShapeClass*>(shapeClass.get());
+	if(polyClass == nullptr) return shapeClass;
+
+	ShapeClassCache& cache = get();
+	std::size_t hash = hashPolyhedron(polyClass->poly);
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	if(polyClass->interned) return shapeClass;
+	if(const PolyhedronShapeClass* found = cache.findLive(hash, polyClass->poly)) return intrusive_ptr<const ShapeClass>(found, false);
+	cache.insert(hash, polyClass);
+	return shapeClass;
+}
+
+std::size_t ShapeClassCache::getInternedClassCount() {
+	ShapeClassCache& cache = get();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	return cache.classes.size();
+}
+};
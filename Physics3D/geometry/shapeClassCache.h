@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../datastructures/smartPointers.h"
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+namespace P3D {
+class Polyhedron;
+class ShapeClass;
+class PolyhedronShapeClass;
+
+/*
+	Shares one PolyhedronShapeClass between all shapes with the same normalized polyhedron, so copies of a prop share their hull, inertia and mesh
+	Classes are found by a hash of their triangles, their vertices must match within a small tolerance since normalizing scaled copies rounds differently
+
+	The cache does not keep classes alive: a class leaves it when the last intrusive_ptr to it is released,
+	and a class whose refCount already reached 0 is never handed out again
+*/
+class ShapeClassCache {
+	friend class PolyhedronShapeClass;
+
+	std::mutex mutex;
+	std::unordered_multimap<std::size_t, const PolyhedronShapeClass*> classes;
+
+	static ShapeClassCache& get();
+	static std::size_t hashPolyhedron(const Polyhedron& poly);
+	static bool samePolyhedron(const Polyhedron& first, const Polyhedron& second);
+
+	// a live class with hash and poly, with a reference added, or nullptr. mutex must be locked
+	const PolyhedronShapeClass* findLive(std::size_t hash, const Polyhedron& poly);
+	// mutex must be locked
+	void insert(std::size_t hash, const PolyhedronShapeClass* shapeClass);
+	// called by the destructor of interned classes
+	static void remove(const PolyhedronShapeClass* shapeClass);
+
+public:
+	// the shared class for poly, which must already fit the -1..1 box. A new class is created if no live class has the same polyhedron
+	static intrusive_ptr<const ShapeClass> getPolyhedronClass(Polyhedron&& poly);
+	// the shared class equal to shapeClass, which becomes the shared class itself if there is none yet. Only polyhedron classes are shared, others are returned as is
+	static intrusive_ptr<const ShapeClass> intern(const intrusive_ptr<const ShapeClass>& shapeClass);
+
+	static std::size_t getInternedClassCount();
+};
+};
@@ -3,11 +3,18 @@
 #include "shapeClass.h"
 #include "polyhedron.h"
 #include "builtinShapeClasses.h"
+#include "triangleMeshShapeClass.h"
+#include "heightfieldShapeClass.h"
+#include "shapeClassCache.h"
 
 #include "../misc/cpuid.h"
 
 #include "../datastructures/smartPointers.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace P3D {
 Shape boxShape(double width, double height, double depth) {
 	return Shape(intrusive_ptr<const ShapeClass>(&CubeClass::instance), width, height, depth);
@@ -30,25 +37,64 @@ Shape cylinderShape(double radius, double height) {
 }
 
 
+PolyhedronShapeClass* createPolyhedronShapeClass(Polyhedron&& poly) {
+	if(CPUIDCheck::hasTechnology(CPUIDCheck::AVX | CPUIDCheck::AVX2 | CPUIDCheck::FMA)) {
+		return new PolyhedronShapeClassAVX(std::move(poly));
+	} else if(CPUIDCheck::hasTechnology(CPUIDCheck::SSE | CPUIDCheck::SSE2)) {
+		if(CPUIDCheck::hasTechnology(CPUIDCheck::SSE4_1)) {
+			return new PolyhedronShapeClassSSE4(std::move(poly));
+		} else {
+			return new PolyhedronShapeClassSSE(std::move(poly));
+		}
+	} else {
+		return new PolyhedronShapeClassFallback(std::move(poly));
+	}
+}
+
 Shape polyhedronShape(const Polyhedron& poly) {
 	BoundingBox bounds = poly.getBounds();
 	Vec3 center = bounds.getCenter();
 	DiagonalMat3 scale{2 / bounds.getWidth(), 2 / bounds.getHeight(), 2 / bounds.getDepth()};
 
-	PolyhedronShapeClass* shapeClass;
+	return Shape(ShapeClassCache::getPolyhedronClass(poly.translatedAndScaled(-center, scale)), bounds.getWidth(), bounds.getHeight(), bounds.getDepth());
+}
 
-	if(CPUIDCheck::hasTechnology(CPUIDCheck::AVX | CPUIDCheck::AVX2 | CPUIDCheck::FMA)) {
-		shapeClass = new PolyhedronShapeClassAVX(poly.translatedAndScaled(-center, scale));
-	} else if(CPUIDCheck::hasTechnology(CPUIDCheck::SSE | CPUIDCheck::SSE2)) {
-		if(CPUIDCheck::hasTechnology(CPUIDCheck::SSE4_1)) {
-			shapeClass = new PolyhedronShapeClassSSE4(poly.translatedAndScaled(-center, scale));
-		} else {
-			shapeClass = new PolyhedronShapeClassSSE(poly.translatedAndScaled(-center, scale));
+// flat terrain still gets a small thickness, so the scale of the shape can be inverted
+#define TERRAIN_MIN_THICKNESS 0.000001
+
+Shape triangleMeshShape(const TriangleMesh& mesh) {
+	BoundingBox bounds = mesh.getBounds();
+	Vec3 center = bounds.getCenter();
+	double minSize = std::max(bounds.getWidth(), std::max(bounds.getHeight(), bounds.getDepth())) * TERRAIN_MIN_THICKNESS;
+	double width = std::max(bounds.getWidth(), minSize);
+	double height = std::max(bounds.getHeight(), minSize);
+	double depth = std::max(bounds.getDepth(), minSize);
+	DiagonalMat3 scale{2 / width, 2 / height, 2 / depth};
+
+	TriangleMeshShapeClass* shapeClass = new TriangleMeshShapeClass(mesh.translatedAndScaled(-center, scale));
+
+	return Shape(intrusive_ptr<const ShapeClass>(shapeClass), width, height, depth);
+}
+
+Shape heightfieldShape(const float* heights, int sampleCountX, int sampleCountZ, double cellSize) {
+	int sampleCount = sampleCountX * sampleCountZ;
+	float minHeight = *std::min_element(heights, heights + sampleCount);
+	float maxHeight = *std::max_element(heights, heights + sampleCount);
+	double width = (sampleCountX - 1) * cellSize;
+	double depth = (sampleCountZ - 1) * cellSize;
+	double heightRange = double(maxHeight) - minHeight;
+
+	// a flat field is a thin slab with its surface on top
+	std::vector<uint16_t> quantizedHeights(sampleCount, 65535);
+	if(heightRange > 0.0) {
+		for(int i = 0; i < sampleCount; i++) {
+			quantizedHeights[i] = static_cast<uint16_t>(std::round((heights[i] - minHeight) / heightRange * 65535.0));
 		}
-	} else {
-		shapeClass = new PolyhedronShapeClassFallback(poly.translatedAndScaled(-center, scale));
 	}
+	double height = std::max(heightRange, std::max(width, depth) * TERRAIN_MIN_THICKNESS);
+
+	HeightfieldShapeClass* shapeClass = new HeightfieldShapeClass(std::move(quantizedHeights), sampleCountX, sampleCountZ);
 
-	return Shape(intrusive_ptr<const ShapeClass>(shapeClass), bounds.getWidth(), bounds.getHeight(), bounds.getDepth());
+	return Shape(intrusive_ptr<const ShapeClass>(shapeClass), width, height, depth);
 }
-};
\ No newline at end of file
+};
@@ -4,11 +4,20 @@
 
 namespace P3D {
 class Polyhedron;
+class TriangleMesh;
+class PolyhedronShapeClass;
 
 Shape boxShape(double width, double height, double depth);
 Shape wedgeShape(double width, double height, double depth);
 Shape cornerShape(double width, double height, double depth);
 Shape sphereShape(double radius);
 Shape cylinderShape(double radius, double height);
+// identical polyhedra share their ShapeClass, see ShapeClassCache
 Shape polyhedronShape(const Polyhedron& poly);
+// a new class of the fastest PolyhedronShapeClass for this cpu, poly must already fit the -1..1 box. Use polyhedronShape to share classes
+PolyhedronShapeClass* createPolyhedronShapeClass(Polyhedron&& poly);
+// for terrain parts only, see TriangleMeshShapeClass
+Shape triangleMeshShape(const TriangleMesh& mesh);
+// for terrain parts only, see HeightfieldShapeClass. heights[z * sampleCountX + x] are spaced cellSize apart, the shape is centered on its bounds
+Shape heightfieldShape(const float* heights, int sampleCountX, int sampleCountZ, double cellSize);
 }
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "triangleBVH.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace P3D {
+// quantized coordinates per unit of the -1..1 box of the shape class
+#define BVH_QUANTIZATION_SCALE (65535.0 / 2.0)
+#define RAY_TRIANGLE_EPSILON 0.0000001
+
+namespace {
+struct BuildTriangle {
+	Vec3f min;
+	Vec3f max;
+	Vec3f center;
+	int index;
+};
+
+uint16_t quantizeDown(double value) {
+	return static_cast<uint16_t>(std::clamp(std::floor((value + 1.0) * BVH_QUANTIZATION_SCALE), 0.0, 65535.0));
+}
+uint16_t quantizeUp(double value) {
+	return static_cast<uint16_t>(std::clamp(std::ceil((value + 1.0) * BVH_QUANTIZATION_SCALE), 0.0, 65535.0));
+}
+
+// splits the triangles at the median of their centers along the longest side
+void buildSubtree(std::vector<QuantizedBVHNode>& nodes, BuildTriangle* begin, BuildTriangle* end) {
+	Vec3f min = begin->min;
+	Vec3f max = begin->max;
+	Vec3f centerMin = begin->center;
+	Vec3f centerMax = begin->center;
+	for(BuildTriangle* triangle = begin + 1; triangle != end; triangle++) {
+		for(int axis = 0; axis < 3; axis++) {
+			min[axis] = std::min(min[axis], triangle->min[axis]);
+			max[axis] = std::max(max[axis], triangle->max[axis]);
+			centerMin[axis] = std::min(centerMin[axis], triangle->center[axis]);
+			centerMax[axis] = std::max(centerMax[axis], triangle->center[axis]);
+		}
+	}
+
+	QuantizedBVHNode node;
+	for(int axis = 0; axis < 3; axis++) {
+		node.min[axis] = quantizeDown(min[axis]);
+		node.max[axis] = quantizeUp(max[axis]);
+	}
+	std::size_t nodeIndex = nodes.size();
+	nodes.push_back(node);
+
+	if(end - begin == 1) {
+		nodes[nodeIndex].triangleOrSkip = ~static_cast<int32_t>(begin->index);
+		return;
+	}
+
+	Vec3f centerSize = centerMax - centerMin;
+	int axis = centerSize.x >= centerSize.y ? (centerSize.x >= centerSize.z ? 0 : 2) : (centerSize.y >= centerSize.z ? 1 : 2);
+	BuildTriangle* middle = begin + (end - begin) / 2;
+	std::nth_element(begin, middle, end, [axis](const BuildTriangle& a, const BuildTriangle& b) { return a.center[axis] < b.center[axis]; });
+
+	buildSubtree(nodes, begin, middle);
+	buildSubtree(nodes, middle, end);
+	nodes[nodeIndex].triangleOrSkip = static_cast<int32_t>(nodes.size());
+}
+
+// a ray in the quantized coordinates of the nodes, distances along it are the same as along the original ray
+struct QuantizedRay {
+	Vec3 origin;
+	Vec3 direction;
+	Vec3 inverseDirection;
+
+	QuantizedRay(const Vec3& origin, const Vec3& direction) :
+		origin((origin + Vec3(1.0, 1.0, 1.0)) * BVH_QUANTIZATION_SCALE),
+		direction(direction * BVH_QUANTIZATION_SCALE),
+		inverseDirection(1.0 / this->direction.x, 1.0 / this->direction.y, 1.0 / this->direction.z) {}
+};
+
+// whether the ray passes through the bounds of node before maxDistance
+bool rayHitsNode(const QuantizedBVHNode& node, const QuantizedRay& ray, double maxDistance) {
+	double entry = 0.0;
+	double exit = maxDistance;
+	for(int axis = 0; axis < 3; axis++) {
+		if(ray.direction[axis] == 0.0) {
+			if(ray.origin[axis] < node.min[axis] || ray.origin[axis] > node.max[axis]) return false;
+			continue;
+		}
+		double t1 = (node.min[axis] - ray.origin[axis]) * ray.inverseDirection[axis];
+		double t2 = (node.max[axis] - ray.origin[axis]) * ray.inverseDirection[axis];
+		entry = std::max(entry, std::min(t1, t2));
+		exit = std::min(exit, std::max(t1, t2));
+		if(entry > exit) return false;
+	}
+	return true;
+}
+
+// distance along the ray in multiples of direction, the largest double if the triangle is missed, same as TriangleMesh::getIntersectionDistance
+double rayTriangleDistance(const Vec3& origin, const Vec3& direction, const Vec3& v0, const Vec3& v1, const Vec3& v2) {
+	Vec3 edge1 = v1 - v0;
+	Vec3 edge2 = v2 - v0;
+	Vec3 h = direction % edge2;
+
+	double a = edge1 * h;
+	if(a > -RAY_TRIANGLE_EPSILON && a < RAY_TRIANGLE_EPSILON) return std::numeric_limits<double>::max();
+
+	Vec3 s = origin - v0;
+	double f = 1.0 / a;
+	double u = f * (s * h);
+	if(u < 0.0 || u > 1.0) return std::numeric_limits<double>::max();
+
+	Vec3 q = s % edge1;
+	double v = direction * f * q;
+	if(v < 0.0 || u + v > 1.0) return std::numeric_limits<double>::max();
+
+	double r = edge2 * f * q;
+	return r > RAY_TRIANGLE_EPSILON ? r : std::numeric_limits<double>::max();
+}
+
+double rayTriangleDistance(const TriangleMesh& mesh, int triangleIndex, const Vec3& origin, const Vec3& direction) {
+	Triangle triangle = mesh.getTriangle(triangleIndex);
+	return rayTriangleDistance(origin, direction, Vec3(mesh.getVertex(triangle.firstIndex)), Vec3(mesh.getVertex(triangle.secondIndex)), Vec3(mesh.getVertex(triangle.thirdIndex)));
+}
+};
+
+std::vector<QuantizedBVHNode> buildQuantizedBVH(const TriangleMesh& mesh) {
+	std::vector<QuantizedBVHNode> nodes;
+	if(mesh.triangleCount == 0) return nodes;
+
+	std::vector<BuildTriangle> buildTriangles(mesh.triangleCount);
+	for(int i = 0; i < mesh.triangleCount; i++) {
+		Triangle triangle = mesh.getTriangle(i);
+		Vec3f a = mesh.getVertex(triangle.firstIndex);
+		Vec3f b = mesh.getVertex(triangle.secondIndex);
+		Vec3f c = mesh.getVertex(triangle.thirdIndex);
+		BuildTriangle& buildTriangle = buildTriangles[i];
+		for(int axis = 0; axis < 3; axis++) {
+			buildTriangle.min[axis] = std::min(a[axis], std::min(b[axis], c[axis]));
+			buildTriangle.max[axis] = std::max(a[axis], std::max(b[axis], c[axis]));
+		}
+		buildTriangle.center = (buildTriangle.min + buildTriangle.max) * 0.5f;
+		buildTriangle.index = i;
+	}
+
+	nodes.reserve(2 * mesh.triangleCount - 1);
+	buildSubtree(nodes, buildTriangles.data(), buildTriangles.data() + buildTriangles.size());
+	return nodes;
+}
+
+bool quantizeBVHBounds(const BoundingBox& bounds, uint16_t (&min)[3], uint16_t (&max)[3]) {
+	for(int axis = 0; axis < 3; axis++) {
+		if(bounds.max[axis] < -1.0 || bounds.min[axis] > 1.0) return false;
+		min[axis] = quantizeDown(bounds.min[axis]);
+		max[axis] = quantizeUp(bounds.max[axis]);
+	}
+	return true;
+}
+
+// nodes beyond the closest triangle found so far are skipped
+int closestTriangleOnRay(const std::vector<QuantizedBVHNode>& nodes, const TriangleMesh& mesh, const Vec3& origin, const Vec3& direction, double& distance) {
+	QuantizedRay ray(origin, direction);
+	distance = std::numeric_limits<double>::max();
+	int closest = -1;
+	int nodeCount = static_cast<int>(nodes.size());
+	int i = 0;
+	while(i < nodeCount) {
+		const QuantizedBVHNode& node = nodes[i];
+		bool hit = rayHitsNode(node, ray, distance);
+		if(node.isLeaf()) {
+			if(hit) {
+				double triangleDistance = rayTriangleDistance(mesh, node.getTriangleIndex(), origin, direction);
+				if(triangleDistance < distance) {
+					distance = triangleDistance;
+					closest = node.getTriangleIndex();
+				}
+			}
+			i++;
+		} else {
+			i = hit ? i + 1 : node.triangleOrSkip;
+		}
+	}
+	return closest;
+}
+
+int countTrianglesOnRay(const std::vector<QuantizedBVHNode>& nodes, const TriangleMesh& mesh, const Vec3& origin, const Vec3& direction) {
+	QuantizedRay ray(origin, direction);
+	int count = 0;
+	int nodeCount = static_cast<int>(nodes.size());
+	int i = 0;
+	while(i < nodeCount) {
+		const QuantizedBVHNode& node = nodes[i];
+		bool hit = rayHitsNode(node, ray, std::numeric_limits<double>::infinity());
+		if(node.isLeaf()) {
+			if(hit && rayTriangleDistance(mesh, node.getTriangleIndex(), origin, direction) != std::numeric_limits<double>::max()) count++;
+			i++;
+		} else {
+			i = hit ? i + 1 : node.triangleOrSkip;
+		}
+	}
+	return count;
+}
+};
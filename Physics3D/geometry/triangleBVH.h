@@ -0,0 +1,58 @@
+#pragma once
+
+#include "triangleMesh.h"
+#include "../math/boundingBox.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace P3D {
+/*
+	A node of a bounding volume hierarchy over the triangles of a mesh in the -1..1 box of a shape class
+	The bounds are stored as 16 bit fractions of the -1..1 box, rounded outwards
+	Nodes are stored depth first, so the first child of an inner node directly follows it
+*/
+struct QuantizedBVHNode {
+	uint16_t min[3];
+	uint16_t max[3];
+	// ~triangleIndex for leaves, for inner nodes the index of the first node after its subtree
+	int32_t triangleOrSkip;
+
+	bool isLeaf() const { return triangleOrSkip < 0; }
+	int getTriangleIndex() const { return ~triangleOrSkip; }
+};
+
+// the nodes over the triangles of mesh, which must fit the -1..1 box. Every triangle ends up in one leaf
+std::vector<QuantizedBVHNode> buildQuantizedBVH(const TriangleMesh& mesh);
+
+// the quantized bounds of bounds rounded outwards, false if they lie outside the -1..1 box
+bool quantizeBVHBounds(const BoundingBox& bounds, uint16_t (&min)[3], uint16_t (&max)[3]);
+
+// the closest triangle of mesh the ray hits and its distance in multiples of direction, -1 if there is none. Same hits as TriangleMesh::getIntersectionDistance
+int closestTriangleOnRay(const std::vector<QuantizedBVHNode>& nodes, const TriangleMesh& mesh, const Vec3& origin, const Vec3& direction, double& distance);
+// the number of triangles of mesh the ray hits
+int countTrianglesOnRay(const std::vector<QuantizedBVHNode>& nodes, const TriangleMesh& mesh, const Vec3& origin, const Vec3& direction);
+
+// calls func(triangleIndex) for each triangle whose leaf bounds overlap bounds, which are in the -1..1 box
+template<typename Func>
+void forEachTriangleInBVHBounds(const std::vector<QuantizedBVHNode>& nodes, const BoundingBox& bounds, const Func& func) {
+	uint16_t queryMin[3];
+	uint16_t queryMax[3];
+	if(!quantizeBVHBounds(bounds, queryMin, queryMax)) return;
+
+	int nodeCount = static_cast<int>(nodes.size());
+	int i = 0;
+	while(i < nodeCount) {
+		const QuantizedBVHNode& node = nodes[i];
+		bool overlaps = node.min[0] <= queryMax[0] && node.max[0] >= queryMin[0] &&
+			node.min[1] <= queryMax[1] && node.max[1] >= queryMin[1] &&
+			node.min[2] <= queryMax[2] && node.max[2] >= queryMin[2];
+		if(node.isLeaf()) {
+			if(overlaps) func(node.getTriangleIndex());
+			i++;
+		} else {
+			i = overlaps ? i + 1 : node.triangleOrSkip;
+		}
+	}
+}
+};
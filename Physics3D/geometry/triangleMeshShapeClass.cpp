@@ -0,0 +1,53 @@
+#include "triangleMeshShapeClass.h"
+
+#include "builtinShapeClasses.h"
+#include "polyhedron.h"
+
+#include <stdexcept>
+
+namespace P3D {
+TriangleMeshShapeClass::TriangleMeshShapeClass(TriangleMesh&& mesh) :
+	ShapeClass(8, Vec3(0, 0, 0), ScalableInertialMatrix(Vec3(8.0 / 3.0, 8.0 / 3.0, 8.0 / 3.0), Vec3(0, 0, 0)), TRIANGLE_MESH_CLASS_ID) {
+	if(mesh.triangleCount == 0) throw std::invalid_argument("A triangle mesh shape needs at least one triangle");
+
+	nodes = buildQuantizedBVH(mesh);
+
+	// the triangles are stored in the order of the leaves, so nearby leaves read nearby triangles
+	std::vector<Vec3f> vertices(mesh.vertexCount);
+	mesh.getVertices(vertices.data());
+	std::vector<Triangle> triangles;
+	triangles.reserve(mesh.triangleCount);
+	for(QuantizedBVHNode& node : nodes) {
+		if(!node.isLeaf()) continue;
+		triangles.push_back(mesh.getTriangle(node.getTriangleIndex()));
+		node.triangleOrSkip = ~static_cast<int32_t>(triangles.size() - 1);
+	}
+	this->mesh = TriangleMesh(mesh.vertexCount, mesh.triangleCount, vertices.data(), triangles.data());
+}
+
+bool TriangleMeshShapeClass::containsPoint(Vec3 point) const {
+	return countTrianglesOnRay(nodes, mesh, point, Vec3(0.0, 1.0, 0.0)) % 2 == 1;
+}
+
+double TriangleMeshShapeClass::getIntersectionDistance(Vec3 origin, Vec3 direction) const {
+	double distance;
+	closestTriangleOnRay(nodes, mesh, origin, direction, distance);
+	return distance;
+}
+
+BoundingBox TriangleMeshShapeClass::getBounds(const Rotation& rotation, const DiagonalMat3& scale) const {
+	return mesh.getBounds(Mat3f(rotation.asRotationMatrix() * scale));
+}
+double TriangleMeshShapeClass::getScaledMaxRadius(DiagonalMat3 scale) const {
+	return mesh.getScaledMaxRadius(scale);
+}
+double TriangleMeshShapeClass::getScaledMaxRadiusSq(DiagonalMat3 scale) const {
+	return mesh.getScaledMaxRadiusSq(scale);
+}
+Vec3f TriangleMeshShapeClass::furthestInDirection(const Vec3f& direction) const {
+	return mesh.furthestInDirection(direction);
+}
+Polyhedron TriangleMeshShapeClass::asPolyhedron() const {
+	return Polyhedron(mesh);
+}
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "triangleMesh.h"
+#include "triangleBVH.h"
+#include "shapeClass.h"
+
+#include <vector>
+
+namespace P3D {
+/*
+	A triangle mesh for terrain parts, the mesh does not need to be convex or closed
+
+	Colissions are found against each triangle whose bounds overlap the other shape, ray queries walk the hierarchy
+	Only use it for terrain, it has no meaningful mass: the volume and inertia are those of its bounding box
+	Two triangle meshes never collide, and furthestInDirection gives the support of the convex hull of the mesh
+*/
+class TriangleMeshShapeClass : public ShapeClass {
+	// the triangles are reordered to match the order of the leaves
+	TriangleMesh mesh;
+	std::vector<QuantizedBVHNode> nodes;
+public:
+	// mesh must already fit the -1..1 box, see triangleMeshShape in shapeCreation.h
+	TriangleMeshShapeClass(TriangleMesh&& mesh);
+
+	const TriangleMesh& getMesh() const { return mesh; }
+	const std::vector<QuantizedBVHNode>& getNodes() const { return nodes; }
+
+	// calls func(triangleIndex) for each triangle of getMesh() whose bounds may overlap bounds, which are in the -1..1 space of the class
+	template<typename Func>
+	void forEachTriangleInBounds(const BoundingBox& bounds, const Func& func) const {
+		forEachTriangleInBVHBounds(nodes, bounds, func);
+	}
+
+	// points below an open terrain mesh count as inside, the mesh is crossed an odd number of times going up from them
+	virtual bool containsPoint(Vec3 point) const override;
+	virtual double getIntersectionDistance(Vec3 origin, Vec3 direction) const override;
+	virtual BoundingBox getBounds(const Rotation& rotation, const DiagonalMat3& scale) const override;
+	virtual double getScaledMaxRadius(DiagonalMat3 scale) const override;
+	virtual double getScaledMaxRadiusSq(DiagonalMat3 scale) const override;
+	virtual Vec3f furthestInDirection(const Vec3f& direction) const override;
+	// the triangles of the mesh, the result need not be closed or convex
+	virtual Polyhedron asPolyhedron() const override;
+};
+};
@@ -41,9 +41,9 @@ WorldLayer& WorldLayer::operator=(WorldLayer&& other) noexcept {
 }
 
 void WorldLayer::refresh() {
-	physicsMeasure.mark(PhysicsProcess::UPDATE_TREE_BOUNDS);
+	ProfileZone zone(PhysicsProcess::UPDATE_TREE_BOUNDS);
 	tree.recalculateBounds();
-	physicsMeasure.mark(PhysicsProcess::UPDATE_TREE_STRUCTURE);
+	zone.next(PhysicsProcess::UPDATE_TREE_STRUCTURE);
 	tree.improveStructure();
 }
 
@@ -52,5 +52,27 @@ CPUIDCheck::CPUIDCheck() : available(0) {
 	}
 }
 
+std::string CPUIDCheck::getProcessorName() {
+	CPUID extended(0x80000000, 0);
+	if(extended.EAX() < 0x80000004) {
+		return std::string();
+	}
+
+	char name[49]{};
+	for(unsigned leaf = 0; leaf < 3; leaf++) {
+		CPUID part(0x80000002 + leaf, 0);
+		for(unsigned reg = 0; reg < 4; reg++) {
+			uint32_t value = reg == 0 ? part.EAX() : reg == 1 ? part.EBX() : reg == 2 ? part.ECX() : part.EDX();
+			for(unsigned byte = 0; byte < 4; byte++) {
+				name[leaf * 16 + reg * 4 + byte] = static_cast<char>(value >> (byte * 8));
+			}
+		}
+	}
+
+	std::string result(name);
+	std::size_t first = result.find_first_not_of(' ');
+	return first == std::string::npos ? std::string() : result.substr(first);
+}
+
 CPUIDCheck CPUIDCheck::availableCPUHardware;
 };
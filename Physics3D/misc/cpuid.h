@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 namespace P3D {
 class CPUIDCheck {
 	unsigned int available;
@@ -37,6 +39,9 @@ public:
 	inline static void disableTechnology(unsigned int technologies) {
 		availableCPUHardware.available &= ~technologies;
 	}
+
+	// The brand string of the processor, empty if the processor does not report one
+	static std::string getProcessorName();
 };
 
 };
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace P3D {
+constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+// FNV-1a over a byte range, stable across platforms and runs, for naming and validating cache files. Chain calls by passing the previous hash
+inline std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t hash = FNV_OFFSET_BASIS) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for(std::size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+template<typename T>
+std::uint64_t hashValue(const T& value, std::uint64_t hash = FNV_OFFSET_BASIS) {
+	return hashBytes(&value, sizeof(T), hash);
+}
+};
@@ -24,6 +24,13 @@ const char * intersectionLabels[]{
 	"Part Bound Reject"
 };
 
+const char* counterLabels[]{
+	"Physicals",
+	"Pairs",
+	"Contacts",
+	"Trunk allocations"
+};
+
 const char* iterationLabels[]{
 	"0",
 	"1",
@@ -44,7 +51,8 @@ const char* iterationLabels[]{
 	"MAX",
 };
 
-BreakdownAverageProfiler<PhysicsProcess> physicsMeasure(physicsLabels, 100);
+TickTrace physicsTrace(physicsLabels, static_cast<std::size_t>(PhysicsProcess::COUNT), counterLabels, static_cast<std::size_t>(PhysicsCounter::COUNT), 100);
+ZoneProfiler<PhysicsProcess> physicsMeasure(physicsLabels, 100, PhysicsProcess::OTHER, &physicsTrace);
 HistoricTally<long long, IntersectionResult> intersectionStatistics(intersectionLabels, 1);
 CircularBuffer<int> gjkCollideIterStats(1);
 CircularBuffer<int> gjkNoCollideIterStats(1);
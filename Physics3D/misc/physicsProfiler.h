@@ -1,6 +1,7 @@
 #pragma once
 
 #include "profiling.h"
+#include "zoneProfiler.h"
 
 namespace P3D {
 enum class PhysicsProcess {
@@ -28,6 +29,14 @@ enum class IntersectionResult {
 	COUNT
 };
 
+enum class PhysicsCounter {
+	PHYSICALS,
+	PAIRS,
+	CONTACTS,
+	TRUNK_ALLOCATIONS,
+	COUNT
+};
+
 enum class IterationTime {
 	INSTANT_QUIT = 0,
 	ONE_ITER = 1,
@@ -36,7 +45,8 @@ enum class IterationTime {
 	COUNT = 17
 };
 
-extern BreakdownAverageProfiler<PhysicsProcess> physicsMeasure;
+extern TickTrace physicsTrace;
+extern ZoneProfiler<PhysicsProcess> physicsMeasure;
 extern HistoricTally<long long, IntersectionResult> intersectionStatistics;
 extern CircularBuffer<int> gjkCollideIterStats;
 extern CircularBuffer<int> gjkNoCollideIterStats;
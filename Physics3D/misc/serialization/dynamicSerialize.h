@@ -43,7 +43,9 @@ public:
 		for(const std::pair<std::type_index, const DynamicSerializer*>& item : initList) {
 			const DynamicSerializer* ds = item.second;
 			serializeRegistry.emplace(item.first, ds);
-			if(deserializeRegistry.find(ds->serializerID) != deserializeRegistry.end()) throw std::logic_error("Duplicate serializerID?");
+			// one serializer may be listed for several types, such as the variants of a class
+			auto existing = deserializeRegistry.find(ds->serializerID);
+			if(existing != deserializeRegistry.end() && (*existing).second != ds) throw std::logic_error("Duplicate serializerID?");
 			deserializeRegistry.emplace(ds->serializerID, ds);
 		}
 	}
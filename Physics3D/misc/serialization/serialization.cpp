@@ -8,6 +8,10 @@
 
 #include "../../geometry/polyhedron.h"
 #include "../../geometry/builtinShapeClasses.h"
+#include "../../geometry/triangleMeshShapeClass.h"
+#include "../../geometry/heightfieldShapeClass.h"
+#include "../../geometry/shapeClassCache.h"
+#include "../../geometry/shapeCreation.h"
 #include "../../geometry/shape.h"
 #include "../../geometry/shapeClass.h"
 #include "../../part.h"
@@ -27,18 +31,18 @@ namespace P3D {
 
 #pragma region serializeComponents
 
-void serializePolyhedron(const Polyhedron& poly, std::ostream& ostream) {
-	serializeBasicTypes<int>(poly.vertexCount, ostream);
-	serializeBasicTypes<int>(poly.triangleCount, ostream);
+void serializeTriangleMesh(const TriangleMesh& mesh, std::ostream& ostream) {
+	serializeBasicTypes<int>(mesh.vertexCount, ostream);
+	serializeBasicTypes<int>(mesh.triangleCount, ostream);
 
-	for(int i = 0; i < poly.vertexCount; i++) {
-		serializeBasicTypes<Vec3f>(poly.getVertex(i), ostream);
+	for(int i = 0; i < mesh.vertexCount; i++) {
+		serializeBasicTypes<Vec3f>(mesh.getVertex(i), ostream);
 	}
-	for(int i = 0; i < poly.triangleCount; i++) {
-		serializeBasicTypes<Triangle>(poly.getTriangle(i), ostream);
+	for(int i = 0; i < mesh.triangleCount; i++) {
+		serializeBasicTypes<Triangle>(mesh.getTriangle(i), ostream);
 	}
 }
-Polyhedron deserializePolyhedron(std::istream& istream) {
+TriangleMesh deserializeTriangleMesh(std::istream& istream) {
 	uint32_t vertexCount = deserializeBasicTypes<uint32_t>(istream);
 	uint32_t triangleCount = deserializeBasicTypes<uint32_t>(istream);
 
@@ -52,12 +56,19 @@ Polyhedron deserializePolyhedron(std::istream& istream) {
 		triangles[i] = deserializeBasicTypes<Triangle>(istream);
 	}
 
-	Polyhedron result(vertices, triangles, vertexCount, triangleCount);
+	TriangleMesh result(vertexCount, triangleCount, vertices, triangles);
 	delete[] vertices;
 	delete[] triangles;
 	return result;
 }
 
+void serializePolyhedron(const Polyhedron& poly, std::ostream& ostream) {
+	serializeTriangleMesh(poly, ostream);
+}
+Polyhedron deserializePolyhedron(std::istream& istream) {
+	return Polyhedron(deserializeTriangleMesh(istream));
+}
+
 void ShapeSerializer::include(const Shape& shape) {
 	sharedShapeClassSerializer.include(shape.baseShape.get());
 }
@@ -173,10 +184,36 @@ void serializePolyhedronShapeClass(const PolyhedronShapeClass& polyhedron, std::
 }
 PolyhedronShapeClass* deserializePolyhedronShapeClass(std::istream& istream) {
 	Polyhedron poly = deserializePolyhedron(istream);
-	PolyhedronShapeClass* result = new PolyhedronShapeClass(std::move(poly));
+	PolyhedronShapeClass* result = createPolyhedronShapeClass(std::move(poly));
 	return result;
 }
 
+void serializeTriangleMeshShapeClass(const TriangleMeshShapeClass& meshClass, std::ostream& ostream) {
+	serializeTriangleMesh(meshClass.getMesh(), ostream);
+}
+TriangleMeshShapeClass* deserializeTriangleMeshShapeClass(std::istream& istream) {
+	return new TriangleMeshShapeClass(deserializeTriangleMesh(istream));
+}
+
+void serializeHeightfieldShapeClass(const HeightfieldShapeClass& heightfield, std::ostream& ostream) {
+	serializeBasicTypes<int>(heightfield.getSampleCountX(), ostream);
+	serializeBasicTypes<int>(heightfield.getSampleCountZ(), ostream);
+	for(int z = 0; z < heightfield.getSampleCountZ(); z++) {
+		for(int x = 0; x < heightfield.getSampleCountX(); x++) {
+			serializeBasicTypes<uint16_t>(heightfield.getQuantizedHeight(x, z), ostream);
+		}
+	}
+}
+HeightfieldShapeClass* deserializeHeightfieldShapeClass(std::istream& istream) {
+	int sampleCountX = deserializeBasicTypes<int>(istream);
+	int sampleCountZ = deserializeBasicTypes<int>(istream);
+	std::vector<uint16_t> heights(static_cast<std::size_t>(sampleCountX) * sampleCountZ);
+	for(uint16_t& height : heights) {
+		height = deserializeBasicTypes<uint16_t>(istream);
+	}
+	return new HeightfieldShapeClass(std::move(heights), sampleCountX, sampleCountZ);
+}
+
 void serializeDirectionalGravity(const DirectionalGravity& gravity, std::ostream& ostream) {
 	serializeBasicTypes<Vec3>(gravity.gravity, ostream);
 }
@@ -524,7 +561,11 @@ void SerializationSessionPrototype::serializeCollectedHeaderInformation(std::ost
 
 void DeSerializationSessionPrototype::deserializeAndCollectHeaderInformation(std::istream& istream) {
 	assertVersionCorrect(istream);
-	shapeDeserializer.sharedShapeClassDeserializer.deserializeRegistry([](std::istream& istream) {return dynamicShapeClassSerializer.deserialize(istream); }, istream);
+	shapeDeserializer.sharedShapeClassDeserializer.deserializeRegistry([this](std::istream& istream) {
+		intrusive_ptr<const ShapeClass> shapeClass = ShapeClassCache::intern(intrusive_ptr<const ShapeClass>(dynamicShapeClassSerializer.deserialize(istream)));
+		shapeDeserializer.deserializedShapeClasses.push_back(shapeClass);
+		return shapeClass.get();
+	}, istream);
 }
 
 static const ShapeClass* builtinKnownShapeClasses[]{&CubeClass::instance, &SphereClass::instance, &CylinderClass::instance};
@@ -562,6 +603,10 @@ static DynamicSerializerRegistry<Constraint>::ConcreteDynamicSerializer<BarConst
 
 static DynamicSerializerRegistry<ShapeClass>::ConcreteDynamicSerializer<PolyhedronShapeClass> polyhedronSerializer
 (serializePolyhedronShapeClass, deserializePolyhedronShapeClass, 0);
+static DynamicSerializerRegistry<ShapeClass>::ConcreteDynamicSerializer<TriangleMeshShapeClass> triangleMeshSerializer
+(serializeTriangleMeshShapeClass, deserializeTriangleMeshShapeClass, 1);
+static DynamicSerializerRegistry<ShapeClass>::ConcreteDynamicSerializer<HeightfieldShapeClass> heightfieldSerializer
+(serializeHeightfieldShapeClass, deserializeHeightfieldShapeClass, 2);
 
 static DynamicSerializerRegistry<ExternalForce>::ConcreteDynamicSerializer<DirectionalGravity> gravitySerializer
 (serializeDirectionalGravity, deserializeDirectionalGravity, 0);
@@ -578,7 +623,13 @@ DynamicSerializerRegistry<HardConstraint> dynamicHardConstraintSerializer{
 	{typeid(MotorConstraintTemplate<SineWaveController>), &sinusiodalMotorConstraintSerializer}
 };
 DynamicSerializerRegistry<ShapeClass> dynamicShapeClassSerializer{
-	{typeid(PolyhedronShapeClass), &polyhedronSerializer}
+	{typeid(PolyhedronShapeClass), &polyhedronSerializer},
+	{typeid(PolyhedronShapeClassAVX), &polyhedronSerializer},
+	{typeid(PolyhedronShapeClassSSE), &polyhedronSerializer},
+	{typeid(PolyhedronShapeClassSSE4), &polyhedronSerializer},
+	{typeid(PolyhedronShapeClassFallback), &polyhedronSerializer},
+	{typeid(TriangleMeshShapeClass), &triangleMeshSerializer},
+	{typeid(HeightfieldShapeClass), &heightfieldSerializer}
 };
 DynamicSerializerRegistry<ExternalForce> dynamicExternalForceSerializer{
 	{typeid(DirectionalGravity), &gravitySerializer}
@@ -16,6 +16,7 @@
 #include "../../math/globalCFrame.h"
 #include "../../geometry/polyhedron.h"
 #include "../../geometry/shape.h"
+#include "../../geometry/shapeClass.h"
 #include "../../part.h"
 #include "../../world.h"
 #include "../../physical.h"
@@ -30,6 +31,8 @@
 #include "dynamicSerialize.h"
 
 namespace P3D {
+void serializeTriangleMesh(const TriangleMesh& mesh, std::ostream& ostream);
+TriangleMesh deserializeTriangleMesh(std::istream& istream);
 void serializePolyhedron(const Polyhedron& poly, std::ostream& ostream);
 Polyhedron deserializePolyhedron(std::istream& istream);
 
@@ -56,6 +59,8 @@ public:
 class ShapeDeserializer {
 public:
 	SharedObjectDeserializer<const ShapeClass*> sharedShapeClassDeserializer;
+	// keeps the classes read from the stream alive for as long as the deserializer, they are shared with equal classes already in use
+	std::vector<intrusive_ptr<const ShapeClass>> deserializedShapeClasses;
 	ShapeDeserializer() = default;
 	template<typename List>
 	inline ShapeDeserializer(const List& knownShapeClasses) : sharedShapeClassDeserializer(knownShapeClasses) {}
@@ -0,0 +1,205 @@
+#include "tickTrace.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "debug.h"
+
+namespace P3D {
+TickTrace::TickTrace(char const* const zoneLabels[], std::size_t zoneCount, char const* const counterLabels[], std::size_t counterCount, std::size_t capacity) :
+	zoneLabels(zoneLabels, zoneLabels + zoneCount),
+	counterLabels(counterLabels, counterLabels + counterCount),
+	timelines(capacity),
+	currentCounters(counterCount, 0) {}
+
+TickTrace::~TickTrace() {
+	waitForDumps();
+}
+
+void TickTrace::setRecording(bool recording) {
+	this->recording.store(recording, std::memory_order_relaxed);
+}
+
+void TickTrace::clear() {
+	nextTimeline = 0;
+	recordedTimelines = 0;
+	currentZones.clear();
+	std::lock_guard<std::mutex> lock(settingsMutex);
+	hasDumpedSpike = false;
+}
+
+void TickTrace::finishTick(std::uint32_t tickThread, std::uint64_t start, std::uint64_t end, double nanosecondsPerTick) {
+	TickTimeline& timeline = timelines[nextTimeline];
+	timeline.tickIndex = tickIndex++;
+	timeline.start = start;
+	timeline.end = end;
+	timeline.tickThread = tickThread;
+	timeline.nanosecondsPerTick = nanosecondsPerTick;
+	timeline.zones.swap(currentZones);
+	timeline.counters = currentCounters;
+	currentZones.clear();
+
+	nextTimeline = (nextTimeline + 1) % timelines.size();
+	if(recordedTimelines < timelines.size()) {
+		recordedTimelines++;
+	}
+
+	std::string dumpPath;
+	{
+		std::lock_guard<std::mutex> lock(settingsMutex);
+		dumpPath.swap(requestedDumpPath);
+
+		if(dumpPath.empty() && spikeThreshold.count() != 0 && timeline.duration() > spikeThreshold) {
+			if(!hasDumpedSpike || timeline.tickIndex - lastSpikeDump >= timelines.size()) {
+				hasDumpedSpike = true;
+				lastSpikeDump = timeline.tickIndex;
+				dumpPath = spikeDumpPrefix + "tick" + std::to_string(timeline.tickIndex) + ".json";
+			}
+		}
+	}
+
+	if(!dumpPath.empty()) {
+		startDump(dumpPath);
+	}
+}
+
+void TickTrace::startDump(const std::string& path) {
+	std::vector<TickTimeline> copiedTimelines;
+	copiedTimelines.reserve(recordedTimelines);
+	for(std::size_t i = 0; i < recordedTimelines; i++) {
+		copiedTimelines.push_back(getTimeline(i));
+	}
+
+	// dumps are rare, the previous one has had at least a tick to finish
+	waitForDumps();
+	dumpWriter = std::thread([this, path, copiedTimelines = std::move(copiedTimelines)]() {
+		std::ofstream file(path);
+		if(file.is_open()) {
+			writeTimelines(file, copiedTimelines.size(), [&copiedTimelines](std::size_t index) -> const TickTimeline& { return copiedTimelines[index]; });
+		}
+		if(file.is_open() && file.good()) {
+			Debug::log("Wrote trace of %d ticks to %s", static_cast<int>(copiedTimelines.size()), path.c_str());
+		} else {
+			Debug::logWarn("Could not write trace to %s", path.c_str());
+		}
+	});
+}
+
+void TickTrace::waitForDumps() {
+	if(dumpWriter.joinable()) {
+		dumpWriter.join();
+	}
+}
+
+bool TickTrace::requestDump(const std::string& path) {
+	if(!isRecording()) {
+		Debug::logWarn("Tick trace is not recording, nothing to write to %s", path.c_str());
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(settingsMutex);
+	requestedDumpPath = path;
+	return true;
+}
+
+void TickTrace::dumpSpikes(std::chrono::nanoseconds threshold, const std::string& prefix) {
+	std::lock_guard<std::mutex> lock(settingsMutex);
+	spikeThreshold = threshold;
+	spikeDumpPrefix = prefix;
+}
+
+const TickTimeline& TickTrace::getTimeline(std::size_t index) const {
+	std::size_t oldest = (nextTimeline + timelines.size() - recordedTimelines) % timelines.size();
+	return timelines[(oldest + index) % timelines.size()];
+}
+
+static void writeEscaped(std::ostream& out, const char* text) {
+	out << '"';
+	for(const char* c = text; *c != '\0'; c++) {
+		if(*c == '"' || *c == '\\') {
+			out << '\\';
+		}
+		out << *c;
+	}
+	out << '"';
+}
+
+template<typename GetTimeline>
+void TickTrace::writeTimelines(std::ostream& out, std::size_t timelineCount, const GetTimeline& getTimeline) const {
+	// timestamps are written in microseconds since the start of the earliest zone
+	std::uint64_t origin = timelineCount != 0 ? getTimeline(0).start : 0;
+	std::vector<std::uint32_t> threads;
+	for(std::size_t i = 0; i < timelineCount; i++) {
+		const TickTimeline& timeline = getTimeline(i);
+		origin = std::min(origin, timeline.start);
+		threads.push_back(timeline.tickThread);
+		for(const TracedZone& zone : timeline.zones) {
+			origin = std::min(origin, zone.start);
+			threads.push_back(zone.threadIndex);
+		}
+	}
+	std::sort(threads.begin(), threads.end());
+	threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+
+	std::uint32_t tickThread = timelineCount != 0 ? getTimeline(timelineCount - 1).tickThread : 0;
+
+	std::ios_base::fmtflags oldFlags = out.flags();
+	std::streamsize oldPrecision = out.precision(3);
+	out << std::fixed;
+
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Physics\"}}";
+	for(std::uint32_t thread : threads) {
+		out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread << ",\"args\":{\"name\":\"";
+		if(thread == tickThread) {
+			out << "Tick thread";
+		} else {
+			out << "Thread " << thread;
+		}
+		out << "\"}}";
+	}
+
+	for(std::size_t i = 0; i < timelineCount; i++) {
+		const TickTimeline& timeline = getTimeline(i);
+		double microsecondsPerTick = timeline.nanosecondsPerTick / 1000.0;
+
+		out << ",\n{\"name\":\"Tick " << timeline.tickIndex << "\",\"cat\":\"tick\",\"ph\":\"X\",\"pid\":1,\"tid\":" << timeline.tickThread;
+		out << ",\"ts\":" << (timeline.start - origin) * microsecondsPerTick << ",\"dur\":" << (timeline.end - timeline.start) * microsecondsPerTick << "}";
+
+		for(const TracedZone& zone : timeline.zones) {
+			out << ",\n{\"name\":";
+			if(zone.zone < zoneLabels.size()) {
+				writeEscaped(out, zoneLabels[zone.zone]);
+			} else {
+				out << "\"Zone " << zone.zone << "\"";
+			}
+			out << ",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":1,\"tid\":" << zone.threadIndex;
+			out << ",\"ts\":" << (zone.start - origin) * microsecondsPerTick << ",\"dur\":" << (zone.end - zone.start) * microsecondsPerTick;
+			out << ",\"args\":{\"tick\":" << timeline.tickIndex << ",\"depth\":" << zone.depth << "}}";
+		}
+
+		for(std::size_t counter = 0; counter < timeline.counters.size(); counter++) {
+			out << ",\n{\"name\":";
+			writeEscaped(out, counterLabels[counter]);
+			out << ",\"ph\":\"C\",\"pid\":1,\"ts\":" << (timeline.start - origin) * microsecondsPerTick;
+			out << ",\"args\":{\"value\":" << timeline.counters[counter] << "}}";
+		}
+	}
+	out << "\n]}\n";
+
+	out.flags(oldFlags);
+	out.precision(oldPrecision);
+}
+
+void TickTrace::writeChromeTrace(std::ostream& out) const {
+	writeTimelines(out, recordedTimelines, [this](std::size_t index) -> const TickTimeline& { return getTimeline(index); });
+}
+
+bool TickTrace::writeChromeTrace(const std::string& path) const {
+	std::ofstream file(path);
+	if(!file.is_open()) {
+		return false;
+	}
+	writeChromeTrace(file);
+	return file.good();
+}
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+	Full timelines of the last ticks, for finding out why one specific tick was slow.
+
+	While recording, the profiler passes every zone of a tick to the trace, together with the counters set during the tick.
+	The last ticks are kept and can be written as Chrome trace JSON, which can be opened in chrome://tracing or ui.perfetto.dev.
+	Files are written at the end of a tick, either when requested or when a tick takes longer than a threshold. The ticking thread only
+	copies the recorded ticks, the file is written on a separate thread so the dump does not stall the following ticks.
+*/
+
+namespace P3D {
+struct TracedZone {
+	std::uint64_t start;
+	std::uint64_t end;
+	std::uint32_t threadIndex;
+	std::uint16_t zone;
+	std::uint16_t depth;
+};
+
+struct TickTimeline {
+	std::uint64_t tickIndex = 0;
+	std::uint64_t start = 0;
+	std::uint64_t end = 0;
+	std::uint32_t tickThread = 0;
+	double nanosecondsPerTick = 1.0;
+	std::vector<TracedZone> zones;
+	std::vector<long long> counters;
+
+	inline std::chrono::nanoseconds duration() const {
+		return std::chrono::nanoseconds(static_cast<long long>((end - start) * nanosecondsPerTick));
+	}
+};
+
+class TickTrace {
+	std::vector<const char*> zoneLabels;
+	std::vector<const char*> counterLabels;
+
+	// ring of the last recorded ticks, the timelines are reused so their zone vectors keep their capacity
+	std::vector<TickTimeline> timelines;
+	std::size_t nextTimeline = 0;
+	std::size_t recordedTimelines = 0;
+	std::uint64_t tickIndex = 0;
+
+	std::vector<TracedZone> currentZones;
+	std::vector<long long> currentCounters;
+
+	std::atomic<bool> recording{false};
+
+	// settings changed from other threads, read once per tick
+	std::mutex settingsMutex;
+	std::string requestedDumpPath;
+	std::chrono::nanoseconds spikeThreshold{0};
+	std::string spikeDumpPrefix;
+	std::uint64_t lastSpikeDump = 0;
+	bool hasDumpedSpike = false;
+
+	// writes the copied ticks of the last dump, only touched by the ticking thread
+	std::thread dumpWriter;
+
+	void startDump(const std::string& path);
+
+	// Writes timelineCount ticks as Chrome trace event JSON, getTimeline(i) gives them from oldest to newest
+	template<typename GetTimeline>
+	void writeTimelines(std::ostream& out, std::size_t timelineCount, const GetTimeline& getTimeline) const;
+
+public:
+	TickTrace(char const* const zoneLabels[], std::size_t zoneCount, char const* const counterLabels[], std::size_t counterCount, std::size_t capacity);
+	~TickTrace();
+
+	inline bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+	void setRecording(bool recording);
+
+	// Drops all recorded ticks, must not be called while ticks are running
+	void clear();
+
+	inline void addZone(std::uint64_t start, std::uint64_t end, std::uint32_t threadIndex, std::uint16_t zone, std::uint16_t depth) {
+		currentZones.push_back(TracedZone{start, end, threadIndex, zone, depth});
+	}
+
+	// Counters hold their value until they are set again, they are recorded at the end of every tick
+	template<typename CounterType>
+	inline void setCounter(CounterType counter, long long value) {
+		currentCounters[static_cast<std::size_t>(counter)] = value;
+	}
+
+	// Called by the profiler at the end of every tick, stores the tick and starts writing the trace files that are due
+	void finishTick(std::uint32_t tickThread, std::uint64_t start, std::uint64_t end, double nanosecondsPerTick);
+
+	// Blocks until the trace file started at the end of a tick is written, must be called from the ticking thread or while no ticks are running
+	void waitForDumps();
+
+	// Writes the recorded ticks to the given file at the end of the next tick. Returns false without requesting anything if the trace is not recording
+	bool requestDump(const std::string& path);
+
+	// Writes the recorded ticks to prefix + "tick<index>.json" whenever a tick takes longer than threshold, at most once per full history of ticks. A threshold of zero disables this
+	void dumpSpikes(std::chrono::nanoseconds threshold, const std::string& prefix);
+
+	std::size_t size() const { return recordedTimelines; }
+	// The recorded ticks from oldest to newest, index 0 is the oldest
+	const TickTimeline& getTimeline(std::size_t index) const;
+
+	// Writes all recorded ticks as Chrome trace event JSON
+	void writeChromeTrace(std::ostream& out) const;
+	// Returns false if the file could not be written
+	bool writeChromeTrace(const std::string& path) const;
+};
+};
@@ -0,0 +1,70 @@
+#include "zoneProfiler.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace P3D {
+namespace ProfileClock {
+static const std::uint64_t startTicks = now();
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+double nanosecondsPerTick() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+	std::uint64_t ticks = now() - startTicks;
+	std::chrono::nanoseconds time = std::chrono::steady_clock::now() - startTime;
+	if(ticks == 0) {
+		return 1.0;
+	}
+	return double(time.count()) / ticks;
+#else
+	return 1.0;
+#endif
+}
+};
+
+namespace ZoneRegistry {
+static std::mutex registryMutex;
+static std::vector<std::unique_ptr<ZoneBuffer>> buffers;
+static std::uint32_t nextThreadIndex = 0;
+
+// Marks the buffer of a thread as finished when the thread exits, the buffer itself is owned by the registry
+struct ThreadExitHandle {
+	ZoneBuffer* buffer = nullptr;
+
+	~ThreadExitHandle() {
+		if(buffer != nullptr) {
+			buffer->finished.store(true, std::memory_order_release);
+		}
+	}
+};
+
+static thread_local ThreadExitHandle threadExitHandle;
+
+ZoneBuffer& registerThread() {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	buffers.push_back(std::make_unique<ZoneBuffer>(nextThreadIndex++));
+	threadBuffer = buffers.back().get();
+	threadExitHandle.buffer = threadBuffer;
+	return *threadBuffer;
+}
+
+void readAll(const std::function<void(const ZoneEvent& event, std::uint32_t threadIndex, std::uint64_t selfTicks)>& func) {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	for(std::size_t i = 0; i < buffers.size();) {
+		ZoneBuffer& buffer = *buffers[i];
+		bool finished = buffer.finished.load(std::memory_order_acquire);
+		buffer.read([&func, &buffer](const ZoneEvent& event, std::uint64_t selfTicks) {
+			func(event, buffer.threadIndex, selfTicks);
+		});
+
+		if(finished) {
+			buffers[i] = std::move(buffers.back());
+			buffers.pop_back();
+		} else {
+			i++;
+		}
+	}
+}
+};
+};
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "profiling.h"
+#include "tickTrace.h"
+
+/*
+	Scoped profiling zones, recorded per thread and aggregated per tick.
+
+	Every thread that opens a zone gets its own ring buffer, only that thread writes to it and only the thread ending the tick
+	reads from it, so recording a zone takes no locks. Zones nest, the time of a zone excludes the time of the zones inside it.
+
+	Define DISABLE_PROFILING to compile all zones away. Define ZONE_COUNTERS to let a ZoneCounterSource measure every zone as well,
+	without it zones do not check for one.
+*/
+
+namespace P3D {
+namespace ProfileClock {
+// Timestamps in ticks of the fastest clock available, the time stamp counter on x86
+inline std::uint64_t now() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Measured against steady_clock since the program started, more accurate the longer the program runs
+double nanosecondsPerTick();
+
+inline std::chrono::nanoseconds toNanoseconds(std::uint64_t ticks, double nanosecondsPerTick) {
+	return std::chrono::nanoseconds(static_cast<long long>(ticks * nanosecondsPerTick));
+}
+};
+
+struct ZoneEvent {
+	std::uint64_t start;
+	std::uint64_t end;
+	std::uint16_t zone;
+	std::uint16_t depth;
+};
+
+// Measures something besides time for every zone of a thread, such as hardware counters. Only called on the thread it is set for
+class ZoneCounterSource {
+public:
+	virtual ~ZoneCounterSource() {}
+	virtual void enterZone(std::uint16_t depth) = 0;
+	virtual void exitZone(std::uint16_t zone, std::uint16_t depth) = 0;
+};
+
+class ZoneBuffer {
+public:
+	static constexpr std::size_t CAPACITY = 1 << 14;
+	static constexpr std::size_t MAX_DEPTH = 32;
+
+private:
+	ZoneEvent events[CAPACITY];
+
+	std::atomic<std::size_t> writeIndex{0};
+	std::atomic<std::size_t> readIndex{0};
+
+	// only used by the owning thread, a read index that is known to have been passed, so readIndex is not loaded for every event
+	std::size_t knownReadIndex = 0;
+
+	// only used by the thread reading the buffer, the time spent in already read zones inside the zone that is open at every depth
+	std::uint64_t childTicks[MAX_DEPTH + 1]{};
+
+public:
+	const std::uint32_t threadIndex;
+
+	// only used by the owning thread
+	std::uint16_t depth = 0;
+	ZoneCounterSource* counterSource = nullptr;
+
+	// zones that did not fit because the buffer was not read in time
+	std::atomic<std::size_t> droppedEvents{0};
+
+	// set when the owning thread exits, the buffer is deleted after its last events have been read
+	std::atomic<bool> finished{false};
+
+	explicit ZoneBuffer(std::uint32_t threadIndex) : threadIndex(threadIndex) {}
+
+	inline void push(const ZoneEvent& event) {
+		std::size_t write = writeIndex.load(std::memory_order_relaxed);
+		if(write - knownReadIndex >= CAPACITY) {
+			knownReadIndex = readIndex.load(std::memory_order_acquire);
+			if(write - knownReadIndex >= CAPACITY) {
+				droppedEvents.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+		}
+		events[write & (CAPACITY - 1)] = event;
+		writeIndex.store(write + 1, std::memory_order_release);
+	}
+
+	// Calls func(const ZoneEvent& event, std::uint64_t selfTicks) for all events written since the last read
+	template<typename Func>
+	void read(const Func& func) {
+		std::size_t read = readIndex.load(std::memory_order_relaxed);
+		std::size_t write = writeIndex.load(std::memory_order_acquire);
+		for(; read != write; read++) {
+			const ZoneEvent& event = events[read & (CAPACITY - 1)];
+
+			// zones end before the zone they are in, so the children of an event have all been read before it
+			std::size_t depth = event.depth < MAX_DEPTH ? event.depth : MAX_DEPTH - 1;
+			std::uint64_t duration = event.end - event.start;
+			std::uint64_t children = childTicks[depth + 1];
+			childTicks[depth + 1] = 0;
+			childTicks[depth] += duration;
+
+			func(event, children < duration ? duration - children : 0);
+		}
+		readIndex.store(write, std::memory_order_release);
+	}
+};
+
+namespace ZoneRegistry {
+inline thread_local ZoneBuffer* threadBuffer = nullptr;
+
+// Creates the buffer of the calling thread
+ZoneBuffer& registerThread();
+
+// The buffer of the calling thread, created the first time a thread asks for it
+inline ZoneBuffer& getThreadBuffer() {
+	ZoneBuffer* buffer = threadBuffer;
+	if(buffer == nullptr) {
+		return registerThread();
+	}
+	return *buffer;
+}
+
+#ifdef ZONE_COUNTERS
+constexpr bool COUNTERS_AVAILABLE = true;
+#else
+constexpr bool COUNTERS_AVAILABLE = false;
+#endif
+
+// Measures every zone of the calling thread with the given source as well, nullptr stops measuring. Only has an effect with ZONE_COUNTERS
+inline void setThreadCounterSource(ZoneCounterSource* source) {
+	getThreadBuffer().counterSource = source;
+}
+
+// Reads the new events of all threads, together with the thread they were recorded on and their time without the zones inside them
+void readAll(const std::function<void(const ZoneEvent& event, std::uint32_t threadIndex, std::uint64_t selfTicks)>& func);
+};
+
+#ifndef DISABLE_PROFILING
+/*
+	A zone costs two timestamps, one thread_local lookup and one push to the ring buffer of its thread, the timestamps dominate.
+	Compare the profileZone benchmark with twice the profileClock benchmark for what the rest costs on a machine.
+	The start and the end of a zone both need a timestamp of their own, only next shares one between two zones.
+*/
+class ProfileZone {
+	ZoneBuffer& buffer;
+	std::uint64_t start;
+	std::uint16_t zone;
+	std::uint16_t depth;
+
+public:
+	template<typename ProcessType>
+	inline explicit ProfileZone(ProcessType process) :
+		buffer(ZoneRegistry::getThreadBuffer()),
+		start(ProfileClock::now()),
+		zone(static_cast<std::uint16_t>(process)),
+		depth(buffer.depth++) {
+#ifdef ZONE_COUNTERS
+		if(buffer.counterSource != nullptr) {
+			buffer.counterSource->enterZone(depth);
+		}
+#endif
+	}
+
+	inline ~ProfileZone() {
+		buffer.push(ZoneEvent{start, ProfileClock::now(), zone, depth});
+#ifdef ZONE_COUNTERS
+		if(buffer.counterSource != nullptr) {
+			buffer.counterSource->exitZone(zone, depth);
+		}
+#endif
+		buffer.depth--;
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+	// Ends this zone and continues with the given process in its place
+	template<typename ProcessType>
+	inline void next(ProcessType process) {
+		std::uint64_t time = ProfileClock::now();
+		buffer.push(ZoneEvent{start, time, zone, depth});
+#ifdef ZONE_COUNTERS
+		if(buffer.counterSource != nullptr) {
+			buffer.counterSource->exitZone(zone, depth);
+			buffer.counterSource->enterZone(depth);
+		}
+#endif
+		start = time;
+		zone = static_cast<std::uint16_t>(process);
+	}
+
+	// Changes the process the time of this zone counts for, for when that is only known at the end
+	template<typename ProcessType>
+	inline void setProcess(ProcessType process) {
+		zone = static_cast<std::uint16_t>(process);
+	}
+};
+#else
+class ProfileZone {
+public:
+	template<typename ProcessType>
+	inline explicit ProfileZone(ProcessType process) {}
+
+	template<typename ProcessType>
+	inline void next(ProcessType process) {}
+
+	template<typename ProcessType>
+	inline void setProcess(ProcessType process) {}
+};
+#endif
+
+/*
+	Aggregates the zones of all threads per tick into one tally per process. Time on the ticking thread that is not inside any zone
+	counts for the unaccounted process. Zones on other threads are added on top, so with several threads the total is cpu time.
+
+	When a trace is given and recording, every zone is also passed on to it to keep the full timeline of the tick.
+*/
+template<typename ProcessType>
+class ZoneProfiler : public HistoricTally<std::chrono::nanoseconds, ProcessType> {
+	ProcessType unaccounted;
+	std::uint64_t tickStart = 0;
+	std::uint32_t tickThread = 0;
+
+public:
+	CircularBuffer<std::chrono::high_resolution_clock::time_point> tickHistory;
+	TickTrace* trace;
+
+	inline ZoneProfiler(char const* const labels[static_cast<size_t>(ProcessType::COUNT)], size_t capacity, ProcessType unaccounted, TickTrace* trace = nullptr) :
+		HistoricTally<std::chrono::nanoseconds, ProcessType>(labels, capacity), unaccounted(unaccounted), tickHistory(capacity), trace(trace) {}
+
+	inline void startTick() {
+		tickThread = ZoneRegistry::getThreadBuffer().threadIndex;
+		tickStart = ProfileClock::now();
+	}
+
+	inline void endTick() {
+		std::uint64_t tickEnd = ProfileClock::now();
+		std::uint64_t accountedTicks = 0;
+		double nanosecondsPerTick = ProfileClock::nanosecondsPerTick();
+		TickTrace* tickTrace = trace != nullptr && trace->isRecording() ? trace : nullptr;
+
+		ZoneRegistry::readAll([&](const ZoneEvent& event, std::uint32_t threadIndex, std::uint64_t selfTicks) {
+			if(event.zone < static_cast<std::uint16_t>(ProcessType::COUNT)) {
+				this->addToTally(static_cast<ProcessType>(event.zone), ProfileClock::toNanoseconds(selfTicks, nanosecondsPerTick));
+			}
+			if(threadIndex == tickThread && event.depth == 0 && event.start >= tickStart) {
+				accountedTicks += event.end - event.start;
+			}
+			if(tickTrace != nullptr) {
+				tickTrace->addZone(event.start, event.end, threadIndex, event.zone, event.depth);
+			}
+		});
+
+		std::uint64_t tickTicks = tickEnd - tickStart;
+		if(tickTicks > accountedTicks) {
+			this->addToTally(unaccounted, ProfileClock::toNanoseconds(tickTicks - accountedTicks, nanosecondsPerTick));
+		}
+
+		tickHistory.add(std::chrono::high_resolution_clock::now());
+		this->nextTally();
+
+		if(tickTrace != nullptr) {
+			tickTrace->finishTick(tickThread, tickStart, tickEnd, nanosecondsPerTick);
+		}
+	}
+
+	inline double getAvgTPS() {
+		size_t numTicks = tickHistory.size();
+		if(numTicks != 0) {
+			std::chrono::high_resolution_clock::time_point firstTime = tickHistory.tail();
+			std::chrono::high_resolution_clock::time_point lastTime = tickHistory.front();
+			std::chrono::nanoseconds delta = lastTime - firstTime;
+
+			double timeTaken = delta.count() * 1E-9;
+
+			return (numTicks - 1) / timeTaken;
+		}
+		return 0.0;
+	}
+};
+};
@@ -3,6 +3,8 @@
 #include "physical.h"
 
 #include "geometry/intersection.h"
+#include "geometry/shapeCreation.h"
+#include "geometry/polyhedron.h"
 
 #include "misc/validityHelper.h"
 #include "misc/catchable_assert.h"
@@ -440,4 +442,21 @@ bool Part::isValid() const {
 
 	return true;
 }
+
+std::vector<Part*> createCompoundParts(const std::vector<Polyhedron>& pieces, const GlobalCFrame& cframe, const PartProperties& properties) {
+	std::vector<Part*> parts;
+	Vec3 mainCenter;
+	for(const Polyhedron& piece : pieces) {
+		// polyhedronShape centers the shape on its bounds
+		Vec3 center = piece.getBounds().getCenter();
+		Shape shape = polyhedronShape(piece);
+		if(parts.empty()) {
+			mainCenter = center;
+			parts.push_back(new Part(shape, cframe.localToGlobal(CFrame(center)), properties));
+		} else {
+			parts.push_back(new Part(shape, *parts[0], CFrame(center - mainCenter), properties));
+		}
+	}
+	return parts;
+}
 };
\ No newline at end of file
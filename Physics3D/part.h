@@ -20,6 +20,8 @@ class WorldPrototype;
 #include "math/bounds.h"
 #include "motion.h"
 
+#include <vector>
+
 namespace P3D {
 struct PartProperties {
 	double density;
@@ -151,4 +153,10 @@ public:
 
 	bool isValid() const;
 };
+
+/*
+	A part for every convex piece of a concave shape, see geometry/convexDecomposition.h, attached into one rigid body
+	The pieces are in the coordinates of cframe. The first part is the main part, adding it to a world adds all of them
+*/
+std::vector<Part*> createCompoundParts(const std::vector<Polyhedron>& pieces, const GlobalCFrame& cframe, const PartProperties& properties);
 };
@@ -507,9 +507,10 @@ void Physical::removePart(Part* part) {
 	part->parent = nullptr;
 }
 
-// TODO: this seems to need to update the encompassing MotorizedPhysical as well
 void Physical::notifyPartPropertiesChanged(Part* part) {
 	rigidBody.refreshWithNewParts();
+	// MotorizedPhysical::update only refreshes the cached totals of articulated physicals
+	mainPhysical->refreshPhysicalProperties();
 }
 void Physical::notifyPartStdMoved(Part* oldPartPtr, Part* newPartPtr) noexcept {
 	rigidBody.notifyPartStdMoved(oldPartPtr, newPartPtr);
@@ -638,6 +639,11 @@ void MotorizedPhysical::update(double deltaT) {
 	motionOfCenterOfMass.translation.translation[0] += accel;
 	motionOfCenterOfMass.rotation.rotation[0] += rotAcc;
 
+	if(childPhysicals.empty()) {
+		updateRigid(deltaT, accel);
+		return;
+	}
+
 	Vec3 oldCenterOfMass = this->totalCenterOfMass;
 	Vec3 angularMomentumBefore = getTotalAngularMomentum();
 
@@ -660,6 +666,29 @@ void MotorizedPhysical::update(double deltaT) {
 	updateAttachedPhysicals();
 }
 
+/*
+	Integration for a physical without connected physicals. Nothing inside it can move, so the center of mass, mass and inertia
+	cached by refreshPhysicalProperties are still valid and the COMMotionTree does not have to be rebuilt.
+	The angular momentum correction reduces to the rotation of the inertia of the rigid body.
+*/
+void MotorizedPhysical::updateRigid(double deltaT, const Vec3& accel) {
+	Vec3 angularVelocity = motionOfCenterOfMass.getAngularVelocity();
+	Vec3 angularMomentumBefore = getCFrame().getRotation().localToGlobal(rigidBody.inertia) * angularVelocity;
+
+	Vec3 movementOfCenterOfMass = motionOfCenterOfMass.getVelocity() * deltaT + accel * deltaT * deltaT * 0.5;
+
+	rotateAroundCenterOfMass(Rotation::fromRotationVector(angularVelocity * deltaT));
+	rigidBody.translate(movementOfCenterOfMass);
+
+	Rotation rotationAfter = getCFrame().getRotation();
+	Vec3 angularMomentumAfter = rotationAfter.localToGlobal(rigidBody.inertia) * angularVelocity;
+
+	SymmetricMat3 globalMomentResponse = rotationAfter.localToGlobal(momentResponse);
+
+	Vec3 deltaAngularVelocity = globalMomentResponse * (angularMomentumAfter - angularMomentumBefore);
+	this->motionOfCenterOfMass.rotation.rotation[0] -= deltaAngularVelocity;
+}
+
 #pragma endregion
 
 /*
@@ -235,6 +235,9 @@ public:
 
 	Motion motionOfCenterOfMass;
 
+	// When enabled, the path of this physical is checked each tick so it can not pass through thin parts when it moves fast, see worldPhysics.cpp
+	bool continuousColission = false;
+
 	explicit MotorizedPhysical(Part* mainPart);
 	explicit MotorizedPhysical(RigidBody&& rigidBody);
 	explicit MotorizedPhysical(Physical&& movedPhys);
@@ -288,6 +291,7 @@ public:
 	COMMotionTree getCOMMotionTree(UnmanagedArray<MonotonicTreeNode<RelativeMotion>>&& mem) const noexcept;
 
 	void update(double deltaT);
+	void updateRigid(double deltaT, const Vec3& accel);
 
 	void setCFrame(const GlobalCFrame& newCFrame);
 
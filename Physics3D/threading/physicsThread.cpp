@@ -31,14 +31,13 @@ PhysicsThread::~PhysicsThread() {
 }
 
 void PhysicsThread::runTick() {
-	physicsMeasure.mark(PhysicsProcess::OTHER);
+	physicsMeasure.startTick();
 
 	this->world->tick(this->threadPool);
 
-	physicsMeasure.mark(PhysicsProcess::OTHER);
 	tickFunction(this->world);
 
-	physicsMeasure.end();
+	physicsMeasure.endTick();
 
 	GJKCollidesIterationStatistics.nextTally();
 	GJKNoCollidesIterationStatistics.nextTally();
@@ -100,4 +99,12 @@ void PhysicsThread::toggleRunning() {
 		this->start();
 	}
 }
+void PhysicsThread::traceTicks(std::chrono::milliseconds stallThreshold, const std::string& dumpPrefix) {
+	physicsTrace.dumpSpikes(stallThreshold, dumpPrefix);
+	physicsTrace.setRecording(true);
+}
+void PhysicsThread::stopTracingTicks() {
+	physicsTrace.setRecording(false);
+	physicsTrace.dumpSpikes(std::chrono::milliseconds(0), "");
+}
 }
@@ -2,6 +2,7 @@
 
 #include <thread>
 #include <atomic>
+#include <string>
 
 #include "threadPool.h"
 #include "upgradeableMutex.h"
@@ -39,5 +40,8 @@ public:
 	void toggleRunning();
 	// Starts if isRunning() == false, stopAsync() if isRunning() == true
 	void toggleRunningAsync();
+	// Records the timelines of the last ticks in physicsTrace. Whenever a tick stalls for longer than stallThreshold they are written to dumpPrefix + "tick<index>.json", a threshold of zero only writes them on physicsTrace.requestDump
+	void traceTicks(std::chrono::milliseconds stallThreshold, const std::string& dumpPrefix);
+	void stopTracingTicks();
 };
 }
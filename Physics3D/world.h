@@ -3,6 +3,8 @@
 #include <vector>
 #include <mutex>
 #include <memory>
+#include <optional>
+#include <limits>
 
 #include "part.h"
 #include "physical.h"
@@ -10,6 +12,8 @@
 #include "softlinks/softLink.h"
 #include "externalforces/externalForce.h"
 #include "colissionBuffer.h"
+#include "bodyStore.h"
+#include "math/ray.h"
 
 namespace P3D {
 class Physical;
@@ -20,6 +24,23 @@ class WorldLayer;
 class ColissionLayer;
 class ThreadPool;
 
+struct RayHit {
+	Part* part;
+	// distance along the ray in multiples of its direction
+	double distance;
+	Position point;
+};
+
+struct ShapeCastHit {
+	Part* part;
+	// fraction of the movement at which the shape touches the part, 0 if it already overlaps the part at the start
+	double fraction;
+	// surface normal of the part at the contact, pointing towards the cast shape
+	Vec3 normal;
+	// contact point on the surface of the part
+	Position point;
+};
+
 class WorldPrototype {
 private:
 	friend class Physical;
@@ -62,6 +83,10 @@ public:
 
 	void addLink(SoftLink* link);
 
+	// When enabled, physicals without connected physicals are integrated together in bodyStore instead of one by one
+	bool useBodyStore = false;
+	BodyStore bodyStore;
+
 	ColissionBuffer curColissions;
 	size_t age = 0;
 	size_t objectCount = 0;
@@ -121,6 +146,31 @@ public:
 	// expects a function of the form void(Part& part)
 	template<typename Func, typename Filter>
 	void forEachPartFiltered(const Filter& filter, const Func& funcToRun) const;
+
+	/*
+		Spatial queries over the parts of all layers, see worldQuery.cpp
+		The trees are walked with the bounds of their trunks, parts that pass are tested exactly against their shape
+		Like forEachPart, these read the trees, the caller must make sure the world is not modified meanwhile
+	*/
+
+	// the closest part the ray hits within maxDistance, hits behind the origin of the ray are ignored
+	std::optional<RayHit> raycast(const Ray& ray, double maxDistance = std::numeric_limits<double>::infinity()) const;
+	// every part the ray hits within maxDistance, sorted from nearest to furthest
+	std::vector<RayHit> raycastAll(const Ray& ray, double maxDistance = std::numeric_limits<double>::infinity()) const;
+	// the closest hit of every ray, the rays are walked through the trees together so each trunk is only visited once for all of them
+	std::vector<std::optional<RayHit>> raycastBatch(const std::vector<Ray>& rays, double maxDistance = std::numeric_limits<double>::infinity()) const;
+
+	// all parts whose bounds overlap the given bounds
+	std::vector<Part*> overlapBounds(const Bounds& bounds) const;
+	// all parts that intersect a sphere with the given center and radius
+	std::vector<Part*> overlapSphere(const Position& center, double radius) const;
+	// all parts that intersect the given shape placed at cframe
+	std::vector<Part*> overlapShape(const Shape& shape, const GlobalCFrame& cframe) const;
+	// the first part the shape touches when it is moved from cframe by movement, parts of ignoredPhysical are passed through
+	// with ignoreStartingOverlaps, parts the shape already overlaps at cframe are passed through too
+	std::optional<ShapeCastHit> shapeCast(const Shape& shape, const GlobalCFrame& cframe, const Vec3& movement, const MotorizedPhysical* ignoredPhysical = nullptr, bool ignoreStartingOverlaps = false) const;
+	// the count parts nearest to point, nearest first, measured to the bounds of each part
+	std::vector<Part*> nearestParts(const Position& point, std::size_t count) const;
 };
 
 template<typename T = Part>
@@ -13,6 +13,7 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 #define COLLISSION_DEPTH_FORCE_MULTIPLIER 2000
 
@@ -191,51 +192,51 @@ void WorldPrototype::tick() {
 }
 
 void tickWorldUnsynchronized(WorldPrototype& world, ThreadPool& threadPool) {
-	physicsMeasure.mark(PhysicsProcess::COLISSION_OTHER);
+	ProfileZone zone(PhysicsProcess::COLISSION_OTHER);
 	findColissionsParallel(world, world.curColissions, threadPool);
 
-	physicsMeasure.mark(PhysicsProcess::EXTERNALS);
+	zone.next(PhysicsProcess::EXTERNALS);
 	applyExternalForces(world);
 
-	physicsMeasure.mark(PhysicsProcess::COLISSION_HANDLING);
+	zone.next(PhysicsProcess::COLISSION_HANDLING);
 	handleColissions(world.curColissions);
 
-	physicsMeasure.mark(PhysicsProcess::OTHER);
+	zone.next(PhysicsProcess::OTHER);
 	intersectionStatistics.nextTally();
 
-	physicsMeasure.mark(PhysicsProcess::CONSTRAINTS);
+	zone.next(PhysicsProcess::CONSTRAINTS);
 	handleConstraints(world);
 
-	physicsMeasure.mark(PhysicsProcess::UPDATING);
+	zone.next(PhysicsProcess::UPDATING);
 	update(world);
 }
 
 void tickWorldSynchronized(WorldPrototype& world, ThreadPool& threadPool, UpgradeableMutex& worldMutex) {
-	physicsMeasure.mark(PhysicsProcess::WAIT_FOR_LOCK);
+	ProfileZone zone(PhysicsProcess::WAIT_FOR_LOCK);
 	worldMutex.lock_upgradeable();
 
-	physicsMeasure.mark(PhysicsProcess::COLISSION_OTHER);
+	zone.next(PhysicsProcess::COLISSION_OTHER);
 	findColissionsParallel(world, world.curColissions, threadPool);
 
-	physicsMeasure.mark(PhysicsProcess::EXTERNALS);
+	zone.next(PhysicsProcess::EXTERNALS);
 	applyExternalForces(world);
 
-	physicsMeasure.mark(PhysicsProcess::COLISSION_HANDLING);
+	zone.next(PhysicsProcess::COLISSION_HANDLING);
 	handleColissions(world.curColissions);
 
-	physicsMeasure.mark(PhysicsProcess::OTHER);
+	zone.next(PhysicsProcess::OTHER);
 	intersectionStatistics.nextTally();
 
-	physicsMeasure.mark(PhysicsProcess::CONSTRAINTS);
+	zone.next(PhysicsProcess::CONSTRAINTS);
 	handleConstraints(world);
 
-	physicsMeasure.mark(PhysicsProcess::WAIT_FOR_LOCK);
+	zone.next(PhysicsProcess::WAIT_FOR_LOCK);
 	worldMutex.upgrade();
 
-	physicsMeasure.mark(PhysicsProcess::UPDATING);
+	zone.next(PhysicsProcess::UPDATING);
 	update(world);
 
-	physicsMeasure.mark(PhysicsProcess::WAIT_FOR_LOCK);
+	zone.next(PhysicsProcess::WAIT_FOR_LOCK);
 	worldMutex.unlock();
 }
 
@@ -357,8 +358,12 @@ void findColissions(WorldPrototype& world, ColissionBuffer& curColissions) {
 		getColissionsBetween(world.layers[collidingLayers.first], world.layers[collidingLayers.second], curColissions);
 	}
 
+	physicsTrace.setCounter(PhysicsCounter::PAIRS, curColissions.freePartColissions.size() + curColissions.freeTerrainColissions.size());
+
 	refineColissions(curColissions.freePartColissions);
 	refineColissions(curColissions.freeTerrainColissions);
+
+	physicsTrace.setCounter(PhysicsCounter::CONTACTS, curColissions.freePartColissions.size() + curColissions.freeTerrainColissions.size());
 }
 
 void findColissionsParallel(WorldPrototype& world, ColissionBuffer& curColissions, ThreadPool& threadPool) {
@@ -374,8 +379,12 @@ void findColissionsParallel(WorldPrototype& world, ColissionBuffer& curColission
 		getColissionsBetween(world.layers[collidingLayers.first], world.layers[collidingLayers.second], curColissions);
 	}
 
+	physicsTrace.setCounter(PhysicsCounter::PAIRS, curColissions.freePartColissions.size() + curColissions.freeTerrainColissions.size());
+
 	parallelRefineColissions(threadPool, curColissions.freePartColissions);
 	parallelRefineColissions(threadPool, curColissions.freeTerrainColissions);
+
+	physicsTrace.setCounter(PhysicsCounter::CONTACTS, curColissions.freePartColissions.size() + curColissions.freeTerrainColissions.size());
 }
 
 void handleColissions(ColissionBuffer& curColissions) {
@@ -392,16 +401,133 @@ void handleConstraints(WorldPrototype& world) {
 		group.apply();
 	}
 }
-void update(WorldPrototype& world) {
+/*
+	Continuous colission for physicals with continuousColission enabled
+
+	A physical that moved further than CCD_MOTION_FRACTION of its smallest part this tick may have passed through a thin part,
+	the colissions are only found at the positions after each tick. Each of its parts is cast along the movement of the tick
+	and the physical is put back to where the first part touches something, CCD_CONTACT_DEPTH of its smallest part deep, so
+	the contact is found and handled like any other colission at the start of the next tick. The velocity along the normal of
+	the contact is removed, the velocity along the surface is kept.
+
+	Only the translation is swept, the rotation during the tick is ignored. Slow physicals and physicals without the flag cost nothing.
+*/
+#define CCD_MOTION_FRACTION 0.5
+#define CCD_CONTACT_DEPTH 0.05
+
+struct ContinuousColissionStart {
+	MotorizedPhysical* physical;
+	Position startPosition;
+};
+
+static std::vector<ContinuousColissionStart> getContinuousColissionStarts(const WorldPrototype& world) {
+	std::vector<ContinuousColissionStart> starts;
 	for(MotorizedPhysical* physical : world.physicals) {
-		physical->update(world.deltaT);
+		if(physical->continuousColission) {
+			starts.push_back(ContinuousColissionStart{physical, physical->getCFrame().getPosition()});
+		}
 	}
+	return starts;
+}
 
+static void sweepContinuousColissions(const WorldPrototype& world, const std::vector<ContinuousColissionStart>& starts) {
+	for(const ContinuousColissionStart& start : starts) {
+		MotorizedPhysical* physical = start.physical;
+		Vec3 movement = physical->getCFrame().getPosition() - start.startPosition;
+
+		double smallestRadius = std::numeric_limits<double>::infinity();
+		physical->forEachPart([&smallestRadius](const Part& part) {
+			smallestRadius = std::min(smallestRadius, part.maxRadius);
+		});
+		double distanceMoved = length(movement);
+		if(distanceMoved <= CCD_MOTION_FRACTION * smallestRadius) continue;
+
+		// parts the physical already touches at its start are left to the regular colissions
+		double firstHit = 1.0;
+		Vec3 firstHitNormal;
+		const Part* castPart = nullptr;
+		const Part* hitPart = nullptr;
+		physical->forEachPart([&](const Part& part) {
+			GlobalCFrame partStart(part.getPosition() - movement, part.getCFrame().getRotation());
+			std::optional<ShapeCastHit> hit = world.shapeCast(part.hitbox, partStart, movement, physical, true);
+			if(hit && hit->fraction < firstHit) {
+				firstHit = hit->fraction;
+				firstHitNormal = hit->normal;
+				castPart = &part;
+				hitPart = hit->part;
+			}
+		});
+		if(firstHit == 1.0) continue;
+
+		// moved through setCFrame so the tree, already refreshed for this tick, follows
+		double allowedDistance = std::min(distanceMoved * firstHit + CCD_CONTACT_DEPTH * smallestRadius, distanceMoved);
+		Part* mainPart = physical->getMainPart();
+		GlobalCFrame mainCFrame = mainPart->getCFrame();
+		mainPart->setCFrame(GlobalCFrame(mainCFrame.getPosition() + movement * (allowedDistance / distanceMoved - 1.0), mainCFrame.getRotation()));
+
+		// the velocity into the surface would carry it through on the next tick, before the colission pushes it back
+		// it bounces off like in handleTerrainCollision, with the bouncyness of both parts
+		Vec3 relativeVelocity = physical->getVelocityOfCenterOfMass();
+		if(hitPart->getPhysical() != nullptr) {
+			relativeVelocity -= hitPart->getPhysical()->mainPhysical->getVelocityOfCenterOfMass();
+		}
+		double speedIntoSurface = relativeVelocity * firstHitNormal;
+		if(speedIntoSurface < 0.0) {
+			double combinedBouncyness = castPart->properties.bouncyness * hitPart->properties.bouncyness;
+			physical->motionOfCenterOfMass.translation.translation[0] -= firstHitNormal * (speedIntoSurface * (1.0 + combinedBouncyness));
+		}
+	}
+}
+
+// trunks allocated by the trees of all layers since they were created
+static std::size_t getTotalTrunkAllocations(const WorldPrototype& world) {
+	std::size_t total = 0;
+	for(const ColissionLayer& layer : world.layers) {
+		for(const WorldLayer& subLayer : layer.subLayers) {
+			total += subLayer.tree.getPrototype().getAllocator().getTotalAllocationCount();
+		}
+	}
+	return total;
+}
+
+void update(WorldPrototype& world) {
+	std::size_t trunkAllocationsBefore = getTotalTrunkAllocations(world);
+	std::vector<ContinuousColissionStart> continuousColissionStarts = getContinuousColissionStarts(world);
+
+	if(world.useBodyStore) {
+		BodyStore& store = world.bodyStore;
+		store.clear();
+		for(MotorizedPhysical* physical : world.physicals) {
+			if(physical->childPhysicals.empty()) {
+				store.add(physical);
+				if(store.size() == BodyStore::BLOCK_SIZE) {
+					store.integrate(world.deltaT);
+					store.scatter();
+					store.clear();
+				}
+			} else {
+				physical->update(world.deltaT);
+			}
+		}
+		store.integrate(world.deltaT);
+		store.scatter();
+	} else {
+		for(MotorizedPhysical* physical : world.physicals) {
+			physical->update(world.deltaT);
+		}
+	}
+
+	// the sweeps query the trees, which have to know where the parts moved first
 	for(ColissionLayer& layer : world.layers) {
 		layer.refresh();
 	}
+
+	sweepContinuousColissions(world, continuousColissionStarts);
 	world.age++;
 
+	physicsTrace.setCounter(PhysicsCounter::PHYSICALS, world.physicals.size());
+	physicsTrace.setCounter(PhysicsCounter::TRUNK_ALLOCATIONS, getTotalTrunkAllocations(world) - trunkAllocationsBefore);
+
 	for(SoftLink* springLink : world.softLinks) {
 		springLink->update();
 	}
@@ -0,0 +1,371 @@
+#include "world.h"
+
+#include "layer.h"
+#include "geometry/intersection.h"
+#include "geometry/shapeCreation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+
+namespace P3D {
+namespace {
+// a ray prepared for the slab tests, with the closest hit found so far
+struct TracedRay {
+	Ray ray;
+	PositionTemplate<float> origin;
+	Vec3f inverseDirection;
+	Part* closestPart = nullptr;
+	double closestDistance;
+
+	TracedRay() = default;
+	TracedRay(const Ray& ray, double maxDistance) :
+		ray(ray),
+		origin(ray.origin),
+		inverseDirection(1.0f / static_cast<float>(ray.direction.x), 1.0f / static_cast<float>(ray.direction.y), 1.0f / static_cast<float>(ray.direction.z)),
+		closestDistance(maxDistance) {}
+
+	std::array<float, BRANCH_FACTOR> computeEntryDistances(const TreeTrunk& trunk, int trunkSize, double maxDistance) const {
+#ifdef __AVX__
+		return TrunkSIMDHelperFallback::computeRayEntryDistancesAVX(trunk, trunkSize, origin, inverseDirection, static_cast<float>(maxDistance));
+#else
+		return TrunkSIMDHelperFallback::computeRayEntryDistances(trunk, trunkSize, origin, inverseDirection, static_cast<float>(maxDistance));
+#endif
+	}
+
+	std::optional<RayHit> getClosestHit() const {
+		if(closestPart == nullptr) return std::nullopt;
+		return RayHit{closestPart, closestDistance, ray.origin + ray.direction * closestDistance};
+	}
+};
+
+// exact distance along the ray to the shape of the part, or infinity if it is missed
+double getRayHitDistance(const Part& part, const Ray& ray) {
+	const GlobalCFrame& cframe = part.getCFrame();
+	double distance = part.hitbox.getIntersectionDistance(cframe.globalToLocal(ray.origin), cframe.relativeToLocal(ray.direction));
+
+	// shape classes report a miss as infinity or the largest double, and hits behind the origin as negative distances
+	if(!(distance >= 0.0) || distance == std::numeric_limits<double>::max()) {
+		return std::numeric_limits<double>::infinity();
+	}
+	return distance;
+}
+
+// sorts the subNodes that were hit by their entry distance, returns how many were hit
+int orderByDistance(const std::array<float, BRANCH_FACTOR>& distances, int trunkSize, int (&order)[BRANCH_FACTOR]) {
+	int count = 0;
+	for(int i = 0; i < trunkSize; i++) {
+		if(distances[i] == std::numeric_limits<float>::infinity()) continue;
+		int j = count++;
+		for(; j > 0 && distances[order[j - 1]] > distances[i]; j--) {
+			order[j] = order[j - 1];
+		}
+		order[j] = i;
+	}
+	return count;
+}
+
+// front to back, so subNodes behind the closest hit so far are skipped
+void raycastRecursive(const TreeTrunk& trunk, int trunkSize, TracedRay& tracedRay) {
+	std::array<float, BRANCH_FACTOR> entries = tracedRay.computeEntryDistances(trunk, trunkSize, tracedRay.closestDistance);
+	int order[BRANCH_FACTOR];
+	int count = orderByDistance(entries, trunkSize, order);
+
+	for(int k = 0; k < count; k++) {
+		int i = order[k];
+		if(entries[i] > tracedRay.closestDistance) break;
+
+		const TreeNodeRef& subNode = trunk.subNodes[i];
+		if(subNode.isTrunkNode()) {
+			raycastRecursive(subNode.asTrunk(), subNode.getTrunkSize(), tracedRay);
+		} else {
+			Part* part = static_cast<Part*>(subNode.asObject());
+			double distance = getRayHitDistance(*part, tracedRay.ray);
+			if(distance < tracedRay.closestDistance) {
+				tracedRay.closestDistance = distance;
+				tracedRay.closestPart = part;
+			}
+		}
+	}
+}
+
+void raycastAllRecursive(const TreeTrunk& trunk, int trunkSize, const TracedRay& tracedRay, std::vector<RayHit>& hits) {
+	std::array<float, BRANCH_FACTOR> entries = tracedRay.computeEntryDistances(trunk, trunkSize, tracedRay.closestDistance);
+
+	for(int i = 0; i < trunkSize; i++) {
+		if(entries[i] == std::numeric_limits<float>::infinity()) continue;
+
+		const TreeNodeRef& subNode = trunk.subNodes[i];
+		if(subNode.isTrunkNode()) {
+			raycastAllRecursive(subNode.asTrunk(), subNode.getTrunkSize(), tracedRay, hits);
+		} else {
+			Part* part = static_cast<Part*>(subNode.asObject());
+			double distance = getRayHitDistance(*part, tracedRay.ray);
+			if(distance != std::numeric_limits<double>::infinity() && distance <= tracedRay.closestDistance) {
+				hits.push_back(RayHit{part, distance, tracedRay.ray.origin + tracedRay.ray.direction * distance});
+			}
+		}
+	}
+}
+
+constexpr std::size_t RAY_PACKET_SIZE = 64;
+// distance at which a cast shape counts as touching a part
+constexpr double SHAPE_CAST_TOLERANCE = 0.001;
+
+/*
+	Walks a packet of rays through the tree together, every trunk is loaded once for all rays that reach it
+	The subNodes are visited front to back by the nearest entry of any ray, a ray is dropped from a subNode it enters behind its closest hit so far
+*/
+void raycastPacketRecursive(const TreeTrunk& trunk, int trunkSize, TracedRay* rays, const std::uint16_t* activeRays, std::size_t activeRayCount) {
+	std::uint16_t subNodeRays[BRANCH_FACTOR][RAY_PACKET_SIZE];
+	float subNodeEntries[BRANCH_FACTOR][RAY_PACKET_SIZE];
+	std::size_t subNodeRayCounts[BRANCH_FACTOR]{};
+	std::array<float, BRANCH_FACTOR> nearestEntries;
+	nearestEntries.fill(std::numeric_limits<float>::infinity());
+
+	for(std::size_t r = 0; r < activeRayCount; r++) {
+		const TracedRay& tracedRay = rays[activeRays[r]];
+		std::array<float, BRANCH_FACTOR> entries = tracedRay.computeEntryDistances(trunk, trunkSize, tracedRay.closestDistance);
+		for(int i = 0; i < trunkSize; i++) {
+			if(entries[i] == std::numeric_limits<float>::infinity()) continue;
+			std::size_t index = subNodeRayCounts[i]++;
+			subNodeRays[i][index] = activeRays[r];
+			subNodeEntries[i][index] = entries[i];
+			nearestEntries[i] = std::min(nearestEntries[i], entries[i]);
+		}
+	}
+
+	int order[BRANCH_FACTOR];
+	int count = orderByDistance(nearestEntries, trunkSize, order);
+
+	for(int k = 0; k < count; k++) {
+		int i = order[k];
+
+		// earlier subNodes may have produced closer hits since the entries were computed
+		std::size_t stillActive = 0;
+		for(std::size_t r = 0; r < subNodeRayCounts[i]; r++) {
+			if(subNodeEntries[i][r] <= rays[subNodeRays[i][r]].closestDistance) {
+				subNodeRays[i][stillActive++] = subNodeRays[i][r];
+			}
+		}
+		if(stillActive == 0) continue;
+
+		const TreeNodeRef& subNode = trunk.subNodes[i];
+		if(subNode.isTrunkNode()) {
+			raycastPacketRecursive(subNode.asTrunk(), subNode.getTrunkSize(), rays, subNodeRays[i], stillActive);
+		} else {
+			Part* part = static_cast<Part*>(subNode.asObject());
+			for(std::size_t r = 0; r < stillActive; r++) {
+				TracedRay& tracedRay = rays[subNodeRays[i][r]];
+				double distance = getRayHitDistance(*part, tracedRay.ray);
+				if(distance < tracedRay.closestDistance) {
+					tracedRay.closestDistance = distance;
+					tracedRay.closestPart = part;
+				}
+			}
+		}
+	}
+}
+
+// expects a function of the form void(const TreeTrunk& baseTrunk, int baseTrunkSize)
+template<typename Func>
+void forEachTree(const std::vector<ColissionLayer>& layers, const Func& func) {
+	for(const ColissionLayer& layer : layers) {
+		for(const WorldLayer& subLayer : layer.subLayers) {
+			std::pair<const TreeTrunk&, int> baseTrunk = subLayer.tree.getPrototype().getBaseTrunk();
+			func(baseTrunk.first, baseTrunk.second);
+		}
+	}
+}
+
+struct BoundsOverlapFilter {
+	BoundsTemplate<float> bounds;
+
+	std::array<bool, BRANCH_FACTOR> operator()(const TreeTrunk& trunk, int trunkSize) const {
+		return TrunkSIMDHelperFallback::computeOverlapsWith(trunk, trunkSize, bounds);
+	}
+};
+
+float getDistanceSquaredToBounds(const BoundsTemplate<float>& bounds, const PositionTemplate<float>& point) {
+	float dx = std::max(std::max(bounds.min.x - point.x, point.x - bounds.max.x), 0.0f);
+	float dy = std::max(std::max(bounds.min.y - point.y, point.y - bounds.max.y), 0.0f);
+	float dz = std::max(std::max(bounds.min.z - point.z, point.z - bounds.max.z), 0.0f);
+	return dx * dx + dy * dy + dz * dz;
+}
+
+// fraction of movement at which the swept bounds of the shape enter the bounds of the part, infinity if they never do
+double getSweptEntryFraction(const Bounds& partBounds, const BoundingBox& shapeBounds, const Position& start, const Vec3& movement) {
+	// the part bounds grown by the shape bounds, entered by the point the shape is placed at
+	Position expandedMin = partBounds.min - shapeBounds.max;
+	Position expandedMax = partBounds.max - shapeBounds.min;
+	Vec3 toMin = expandedMin - start;
+	Vec3 toMax = expandedMax - start;
+
+	double entry = 0.0;
+	double exit = 1.0;
+	for(int axis = 0; axis < 3; axis++) {
+		if(movement[axis] == 0.0) {
+			if(toMin[axis] > 0.0 || toMax[axis] < 0.0) return std::numeric_limits<double>::infinity();
+			continue;
+		}
+		double t1 = toMin[axis] / movement[axis];
+		double t2 = toMax[axis] / movement[axis];
+		entry = std::max(entry, std::min(t1, t2));
+		exit = std::min(exit, std::max(t1, t2));
+	}
+	return entry <= exit ? entry : std::numeric_limits<double>::infinity();
+}
+
+struct ShapeCastCandidate {
+	double entryFraction;
+	Part* part;
+};
+
+struct NearestCandidate {
+	float distanceSquared;
+	const TreeNodeRef* node;
+
+	bool operator<(const NearestCandidate& other) const {
+		// std::priority_queue puts the largest first
+		return distanceSquared > other.distanceSquared;
+	}
+};
+};
+
+std::optional<RayHit> WorldPrototype::raycast(const Ray& ray, double maxDistance) const {
+	TracedRay tracedRay(ray, maxDistance);
+	forEachTree(this->layers, [&tracedRay](const TreeTrunk& baseTrunk, int baseTrunkSize) {
+		raycastRecursive(baseTrunk, baseTrunkSize, tracedRay);
+	});
+	return tracedRay.getClosestHit();
+}
+
+std::vector<RayHit> WorldPrototype::raycastAll(const Ray& ray, double maxDistance) const {
+	TracedRay tracedRay(ray, maxDistance);
+	std::vector<RayHit> hits;
+	forEachTree(this->layers, [&tracedRay, &hits](const TreeTrunk& baseTrunk, int baseTrunkSize) {
+		raycastAllRecursive(baseTrunk, baseTrunkSize, tracedRay, hits);
+	});
+	std::sort(hits.begin(), hits.end(), [](const RayHit& a, const RayHit& b) {
+		return a.distance < b.distance;
+	});
+	return hits;
+}
+
+std::vector<std::optional<RayHit>> WorldPrototype::raycastBatch(const std::vector<Ray>& rays, double maxDistance) const {
+	std::vector<std::optional<RayHit>> results;
+	results.reserve(rays.size());
+
+	TracedRay packet[RAY_PACKET_SIZE];
+	std::uint16_t allRays[RAY_PACKET_SIZE];
+	for(std::size_t packetStart = 0; packetStart < rays.size(); packetStart += RAY_PACKET_SIZE) {
+		std::size_t packetSize = std::min(RAY_PACKET_SIZE, rays.size() - packetStart);
+		for(std::size_t i = 0; i < packetSize; i++) {
+			packet[i] = TracedRay(rays[packetStart + i], maxDistance);
+			allRays[i] = static_cast<std::uint16_t>(i);
+		}
+
+		forEachTree(this->layers, [&packet, &allRays, packetSize](const TreeTrunk& baseTrunk, int baseTrunkSize) {
+			raycastPacketRecursive(baseTrunk, baseTrunkSize, packet, allRays, packetSize);
+		});
+
+		for(std::size_t i = 0; i < packetSize; i++) {
+			results.push_back(packet[i].getClosestHit());
+		}
+	}
+	return results;
+}
+
+std::vector<Part*> WorldPrototype::overlapBounds(const Bounds& bounds) const {
+	BoundsOverlapFilter filter{BoundsTemplate<float>(bounds)};
+	std::vector<Part*> result;
+	forEachTree(this->layers, [&filter, &result](const TreeTrunk& baseTrunk, int baseTrunkSize) {
+		forEachFilteredRecurse<Part>(baseTrunk, baseTrunkSize, filter, [&result](Part& part) {
+			result.push_back(&part);
+		});
+	});
+	return result;
+}
+
+std::vector<Part*> WorldPrototype::overlapSphere(const Position& center, double radius) const {
+	return this->overlapShape(sphereShape(radius), GlobalCFrame(center));
+}
+
+std::vector<Part*> WorldPrototype::overlapShape(const Shape& shape, const GlobalCFrame& cframe) const {
+	BoundingBox localBounds = shape.getBounds(cframe.getRotation());
+	BoundsOverlapFilter filter{BoundsTemplate<float>(localBounds + cframe.getPosition())};
+	std::vector<Part*> result;
+	forEachTree(this->layers, [&filter, &result, &shape, &cframe](const TreeTrunk& baseTrunk, int baseTrunkSize) {
+		forEachFilteredRecurse<Part>(baseTrunk, baseTrunkSize, filter, [&result, &shape, &cframe](Part& part) {
+			CFrame relativeTransform = part.getCFrame().globalToLocal(cframe);
+			if(intersectsTransformed(part.hitbox, shape, relativeTransform)) {
+				result.push_back(&part);
+			}
+		});
+	});
+	return result;
+}
+
+std::optional<ShapeCastHit> WorldPrototype::shapeCast(const Shape& shape, const GlobalCFrame& cframe, const Vec3& movement, const MotorizedPhysical* ignoredPhysical, bool ignoreStartingOverlaps) const {
+	BoundingBox shapeBounds = shape.getBounds(cframe.getRotation());
+	Bounds startBounds = shapeBounds + cframe.getPosition();
+	Bounds endBounds = shapeBounds + (cframe.getPosition() + movement);
+	BoundsOverlapFilter filter{BoundsTemplate<float>(unionOfBounds(startBounds, endBounds))};
+
+	std::vector<ShapeCastCandidate> candidates;
+	forEachTree(this->layers, [&](const TreeTrunk& baseTrunk, int baseTrunkSize) {
+		forEachFilteredRecurse<Part>(baseTrunk, baseTrunkSize, filter, [&](Part& part) {
+			if(ignoredPhysical != nullptr && part.getPhysical() != nullptr && part.getMainPhysical() == ignoredPhysical) return;
+			double entryFraction = getSweptEntryFraction(Bounds(part.getBounds()), shapeBounds, cframe.getPosition(), movement);
+			if(entryFraction != std::numeric_limits<double>::infinity()) {
+				candidates.push_back(ShapeCastCandidate{entryFraction, &part});
+			}
+		});
+	});
+	std::sort(candidates.begin(), candidates.end(), [](const ShapeCastCandidate& a, const ShapeCastCandidate& b) {
+		return a.entryFraction < b.entryFraction;
+	});
+
+	std::optional<ShapeCastHit> closestHit;
+	for(const ShapeCastCandidate& candidate : candidates) {
+		// the shape can not touch a part before it enters its bounds
+		if(closestHit && candidate.entryFraction > closestHit->fraction) break;
+
+		const GlobalCFrame& partCFrame = candidate.part->getCFrame();
+		CFrame relativeTransform = partCFrame.globalToLocal(cframe);
+		std::optional<SweepHit> hit = sweepTransformed(candidate.part->hitbox, shape, relativeTransform, partCFrame.relativeToLocal(movement), SHAPE_CAST_TOLERANCE);
+		if(!hit || (ignoreStartingOverlaps && hit->fraction == 0.0)) continue;
+		if(!closestHit || hit->fraction < closestHit->fraction) {
+			closestHit = ShapeCastHit{candidate.part, hit->fraction, partCFrame.localToRelative(hit->normal), partCFrame.localToGlobal(hit->point)};
+		}
+	}
+	return closestHit;
+}
+
+// best first search, candidates are taken from the queue nearest first, a part taken from the queue is nearer than every unopened trunk
+std::vector<Part*> WorldPrototype::nearestParts(const Position& point, std::size_t count) const {
+	std::vector<Part*> result;
+	if(count == 0) return result;
+
+	PositionTemplate<float> floatPoint(point);
+	std::priority_queue<NearestCandidate> candidates;
+	auto addSubNodes = [&candidates, &floatPoint](const TreeTrunk& trunk, int trunkSize) {
+		for(int i = 0; i < trunkSize; i++) {
+			candidates.push(NearestCandidate{getDistanceSquaredToBounds(trunk.getBoundsOfSubNode(i), floatPoint), &trunk.subNodes[i]});
+		}
+	};
+	forEachTree(this->layers, addSubNodes);
+
+	while(!candidates.empty() && result.size() < count) {
+		const TreeNodeRef& node = *candidates.top().node;
+		candidates.pop();
+		if(node.isTrunkNode()) {
+			addSubNodes(node.asTrunk(), node.getTrunkSize());
+		} else {
+			result.push_back(static_cast<Part*>(node.asObject()));
+		}
+	}
+	return result;
+}
+};
@@ -59,6 +59,8 @@
 
 #define TICKS_PER_SECOND 120.0
 #define TICK_SKIP_TIME std::chrono::milliseconds(1000)
+// with -traceTicks, ticks taking longer than this are written as a trace
+#define TICK_TRACE_STALL_TIME std::chrono::milliseconds(50)
 
 namespace P3D::Application {
 
@@ -81,6 +83,9 @@ void init(const ::Util::ParsedArgs& cmdArgs) {
 
 	Log::info(::Util::printAndParseCPUIDArgs(cmdArgs));
 	bool quickBoot = cmdArgs.hasFlag("quickBoot");
+	ResourceManager::setHotReload(cmdArgs.hasFlag("hotReload"));
+	if(cmdArgs.hasFlag("traceTicks"))
+		physicsThread.traceTicks(TICK_TRACE_STALL_TIME, "tickTrace_");
 
 	setupGL();
 
@@ -375,6 +380,16 @@ void runTick() {
 	physicsThread.runTick();
 }
 
+void dumpTickTrace() {
+	if(physicsThread.isRunning()) {
+		physicsTrace.requestDump("tickTrace.json");
+	} else if(!physicsTrace.isRecording() || physicsTrace.size() == 0) {
+		Log::warn("No ticks were traced, start with -traceTicks to record them");
+	} else if(physicsTrace.writeChromeTrace("tickTrace.json")) {
+		Log::info("Wrote trace of the last %d ticks to tickTrace.json", static_cast<int>(physicsTrace.size()));
+	}
+}
+
 void toggleFlying() {
 	// Through using syncModification, we ensure that the creation or deletion of the player shape is not handled by the physics thread, thus avoiding a race condition with the Registry
 	// TODO this is not a proper solution, it should be an asyncModification! But at least it fixes the sporadic crash
@@ -405,6 +420,7 @@ int main(int argc, const char** args) {
 	while (!screen.shouldClose()) {
 		graphicsMeasure.mark(GraphicsProcess::UPDATE);
 
+		ResourceManager::update();
 		screen.onUpdate();
 		screen.onRender();
 
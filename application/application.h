@@ -20,6 +20,8 @@ void unpause();
 bool isPaused();
 void togglePause();
 void runTick();
+// Writes the traced ticks to tickTrace.json, once the current tick ends if the physics are running
+void dumpTickTrace();
 void setSpeed(double newSpeed);
 double getSpeed();
 void stop(int returnCode);
@@ -198,6 +198,10 @@ bool StandardInputHandler::onKeyPress(Engine::KeyPressEvent& event) {
 		}
 	}
 	
+	KEY_BIND(KeyboardOptions::Debug::trace) {
+		dumpTickTrace();
+	}
+	
 	KEY_BIND(KeyboardOptions::Application::close) {
 		Graphics::GLFW::closeWindow();
 	} else if (key == Keyboard::KEY_F11) {
@@ -20,6 +20,7 @@
 #include "../graphics/gui/color.h"
 
 #include <Physics3D/math/linalg/vec.h>
+#include <Physics3D/worldIteration.h>
 #include <Physics3D/boundstree/filters/visibilityFilter.h>
 
 #include "skyboxLayer.h"
@@ -170,7 +171,7 @@ void ModelLayer::onRender(Engine::Registry64& registry) {
 		Comp::Transform transform;
 		Graphics::Comp::Material material;
 		IRef<Graphics::Comp::Mesh> mesh;
-		IRef<Comp::Collider> collider;
+		ExtendedPart* part = nullptr;
 	};
 	
 	std::map<double, EntityInfo> transparentEntities;
@@ -179,26 +180,17 @@ void ModelLayer::onRender(Engine::Registry64& registry) {
 		std::shared_lock<UpgradeableMutex> worldReadLock(*screen->worldMutex);
 		VisibilityFilter filter = VisibilityFilter::forWindow(screen->camera.cframe.position, screen->camera.getForwardDirection(), screen->camera.getUpDirection(), screen->camera.fov, screen->camera.aspect, screen->camera.zfar);
 
-		auto view = registry.view<Graphics::Comp::Mesh>();
-		for (auto entity : view) {
-			EntityInfo info;
-			info.entity = entity;
-			
-			info.mesh = view.get<Graphics::Comp::Mesh>(entity);
-			if (!info.mesh.valid())
-				continue;
+		auto addEntity = [&](Engine::Registry64::entity_type entity, const IRef<Graphics::Comp::Mesh>& mesh, ExtendedPart* part) {
+			if (mesh->id == -1)
+				return;
 
-			if (info.mesh->id == -1)
-				continue;
-
-			if (!info.mesh->visible)
-				continue;
-			
-			info.collider = registry.get<Comp::Collider>(entity);
-			if (info.collider.valid())
-				if (!filter(*info.collider->part))
-					continue;
+			if (!mesh->visible)
+				return;
 
+			EntityInfo info;
+			info.entity = entity;
+			info.mesh = mesh;
+			info.part = part;
 			info.transform = registry.getOr<Comp::Transform>(entity);
 			info.material = registry.getOr<Graphics::Comp::Material>(entity);
 			
@@ -208,11 +200,27 @@ void ModelLayer::onRender(Engine::Registry64& registry) {
 			} else {
 				Mat4f modelMatrix = info.transform.getModelMatrix();
 
-				if (info.collider.valid())
-					info.material.albedo += getAlbedoForPart(screen, info.collider->part);
+				if (info.part != nullptr)
+					info.material.albedo += getAlbedoForPart(screen, info.part);
 				
 				manager->add(info.mesh->id, modelMatrix, info.material);
 			}
+		};
+
+		// Parts in the world are culled per subtree by the bounds trees
+		screen->world->forEachPartFiltered(filter, [&](ExtendedPart& part) {
+			IRef<Graphics::Comp::Mesh> mesh = registry.get<Graphics::Comp::Mesh>(part.entity);
+			if (mesh.valid())
+				addEntity(part.entity, mesh, &part);
+		});
+
+		// Entities without a collider are not in the world, they are always drawn
+		auto view = registry.view<Graphics::Comp::Mesh>();
+		for (auto entity : view) {
+			if (registry.has<Comp::Collider>(entity))
+				continue;
+
+			addEntity(entity, view.get<Graphics::Comp::Mesh>(entity), nullptr);
 		}
 
 		Shaders::instanceShader->bind();
@@ -231,8 +239,8 @@ void ModelLayer::onRender(Engine::Registry64& registry) {
 			if (!info.mesh->visible)
 				continue;
 
-			if (info.collider.valid())
-				info.material.albedo += getAlbedoForPart(screen, info.collider->part);
+			if (info.part != nullptr)
+				info.material.albedo += getAlbedoForPart(screen, info.part);
 
 			Shaders::basicShader->updateMaterial(info.material);
 			Shaders::basicShader->updateModel(info.transform.getModelMatrix());
@@ -5,7 +5,7 @@
 
 #include <Physics3D/world.h>
 #include <Physics3D/worldIteration.h>
-#include <Physics3D/boundstree/filters/visibilityFilter.h>
+#include <Physics3D/boundstree/filters/frustumFilter.h>
 
 #include "view/screen.h"
 #include "../graphics/gui/gui.h"
@@ -70,7 +70,9 @@ void ShadowLayer::renderScene(Engine::Registry64& registry) {
 	std::vector<ExtendedPart*> visibleParts;
 	std::shared_lock<UpgradeableMutex> worldReadLock(*screen.worldMutex);
 
-	screen.world->forEachPart([&visibleParts](ExtendedPart& part) {
+	// Only parts inside the view volume of the light cast shadows onto the shadow map
+	FrustumFilter lightFilter = FrustumFilter::fromMatrix(lighSpaceMatrix);
+	screen.world->forEachPartFiltered(lightFilter, [&visibleParts](ExtendedPart& part) {
 		visibleParts.push_back(&part);
 	});
 
@@ -11,7 +11,7 @@ namespace P3D::Application {
 
 void AttachmentTool::onRegister() {
 	auto path = "../res/textures/icons/" + getName() + ".png";
-	ResourceManager::add<Graphics::TextureResource>(getName(), path);
+	ResourceManager::addAsync<Graphics::TextureResource>(getName(), path);
 }
 
 void AttachmentTool::onDeregister() {
@@ -12,7 +12,7 @@ namespace P3D::Application {
 
 void ElasticLinkTool::onRegister() {
 	auto path = "../res/textures/icons/" + getName() + ".png";
-	ResourceManager::add<Graphics::TextureResource>(getName(), path);
+	ResourceManager::addAsync<Graphics::TextureResource>(getName(), path);
 }
 
 void ElasticLinkTool::onDeregister() {
@@ -14,7 +14,7 @@ namespace P3D::Application {
 
 void MotorConstraintTool::onRegister() {
 	auto path = "../res/textures/icons/" + getName() + ".png";
-	ResourceManager::add<Graphics::TextureResource>(getName(), path);
+	ResourceManager::addAsync<Graphics::TextureResource>(getName(), path);
 }
 
 void MotorConstraintTool::onDeregister() {
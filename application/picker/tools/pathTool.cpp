@@ -16,7 +16,7 @@ static URef<LinePrimitive> deltaLine = nullptr;
 
 void PathTool::onRegister() {
 	auto path = "../res/textures/icons/" + getName() + ".png";
-	ResourceManager::add<Graphics::TextureResource>(getName(), path);
+	ResourceManager::addAsync<Graphics::TextureResource>(getName(), path);
 
 	deltaLine = std::make_unique<LinePrimitive>();
 }
@@ -13,7 +13,7 @@ namespace P3D::Application {
 
 void PistonConstraintTool::onRegister() {
 	auto path = "../res/textures/icons/" + getName() + ".png";
-	ResourceManager::add<Graphics::TextureResource>(getName(), path);
+	ResourceManager::addAsync<Graphics::TextureResource>(getName(), path);
 }
 
 void PistonConstraintTool::onDeregister() {
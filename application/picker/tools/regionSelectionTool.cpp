@@ -24,7 +24,7 @@ namespace P3D::Application {
 
 	void RegionSelectionTool::onRegister() {
 		auto path = "../res/textures/icons/" + getName() + ".png";
-		ResourceManager::add<TextureResource>(getName(), path);
+		ResourceManager::addAsync<TextureResource>(getName(), path);
 	}
 
 	void RegionSelectionTool::onDeregister() {
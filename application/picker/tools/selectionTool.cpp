@@ -33,7 +33,7 @@ std::optional<Position> SelectionTool::intersectedPoint;
 
 void SelectionTool::onRegister() {
 	auto path = "../res/textures/icons/" + getName() + ".png";
-	ResourceManager::add<TextureResource>(getName(), path);
+	ResourceManager::addAsync<TextureResource>(getName(), path);
 }
 
 void SelectionTool::onDeregister() {
@@ -120,8 +120,19 @@ std::optional<std::pair<Engine::Registry64::entity_type, Position>> SelectionToo
 	{
 		auto view = screen.registry.view<Comp::Hitbox, Comp::Transform>();
 		std::shared_lock<UpgradeableMutex> worldReadLock(*screen.worldMutex);
+
+		// parts in the world are found through its trees, only the remaining hitboxes are tested one by one
+		std::optional<RayHit> partHit = screen.world->raycast(ray);
+		if(partHit.has_value()) {
+			closestIntersectionDistance = partHit->distance;
+			intersectedEntity = static_cast<ExtendedPart*>(partHit->part)->entity;
+		}
+
 		for(auto entity : view) {
 			IRef<Comp::Hitbox> hitbox = view.get<Comp::Hitbox>(entity);
+			if(hitbox->isPartAttached() && hitbox->getPart()->layer != nullptr)
+				continue;
+
 			IRef<Comp::Transform> transform = view.get<Comp::Transform>(entity);
 			std::optional<double> distance = intersect(transform->getCFrame(), hitbox);
 			if(distance.has_value() && distance < closestIntersectionDistance) {
@@ -70,7 +70,7 @@ namespace P3D::Application {
 
 		// Load icon
 		std::string path = "../res/textures/icons/" + getName() + ".png";
-		ResourceManager::add<TextureResource>(getName(), path);
+		ResourceManager::addAsync<TextureResource>(getName(), path);
 
 		// Create alignment line
 		deltaLine = std::make_unique<LinePrimitive>();
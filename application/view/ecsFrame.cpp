@@ -30,27 +30,27 @@
 
 namespace P3D::Application {
 
-Graphics::TextureResource* folderIcon;
-Graphics::TextureResource* openFolderIcon;
-Graphics::TextureResource* entityIcon;
-Graphics::TextureResource* colliderIcon;
-Graphics::TextureResource* terrainIcon;
-Graphics::TextureResource* mainColliderIcon;
-Graphics::TextureResource* childColliderIcon;
-Graphics::TextureResource* attachmentsIcon;
-Graphics::TextureResource* hardConstraintsIcon;
-Graphics::TextureResource* softLinksIcon;
-Graphics::TextureResource* cframeIcon;
-Graphics::TextureResource* cubeClassIcon;
-Graphics::TextureResource* sphereClassIcon;
-Graphics::TextureResource* cylinderClassIcon;
-Graphics::TextureResource* cornerClassIcon;
-Graphics::TextureResource* wedgeClassIcon;
-Graphics::TextureResource* polygonClassIcon;
-Graphics::TextureResource* shownIcon;
-Graphics::TextureResource* hiddenIcon;
-Graphics::TextureResource* physicsIcon;
-Graphics::TextureResource* addIcon;
+ResourceHandle<Graphics::TextureResource> folderIcon;
+ResourceHandle<Graphics::TextureResource> openFolderIcon;
+ResourceHandle<Graphics::TextureResource> entityIcon;
+ResourceHandle<Graphics::TextureResource> colliderIcon;
+ResourceHandle<Graphics::TextureResource> terrainIcon;
+ResourceHandle<Graphics::TextureResource> mainColliderIcon;
+ResourceHandle<Graphics::TextureResource> childColliderIcon;
+ResourceHandle<Graphics::TextureResource> attachmentsIcon;
+ResourceHandle<Graphics::TextureResource> hardConstraintsIcon;
+ResourceHandle<Graphics::TextureResource> softLinksIcon;
+ResourceHandle<Graphics::TextureResource> cframeIcon;
+ResourceHandle<Graphics::TextureResource> cubeClassIcon;
+ResourceHandle<Graphics::TextureResource> sphereClassIcon;
+ResourceHandle<Graphics::TextureResource> cylinderClassIcon;
+ResourceHandle<Graphics::TextureResource> cornerClassIcon;
+ResourceHandle<Graphics::TextureResource> wedgeClassIcon;
+ResourceHandle<Graphics::TextureResource> polygonClassIcon;
+ResourceHandle<Graphics::TextureResource> shownIcon;
+ResourceHandle<Graphics::TextureResource> hiddenIcon;
+ResourceHandle<Graphics::TextureResource> physicsIcon;
+ResourceHandle<Graphics::TextureResource> addIcon;
 
 static int nodeIndex = 0;
 static void* selectedNode = nullptr;
@@ -649,27 +649,27 @@ void ECSFrame::renderAttachments(Engine::Registry64& registry,
 }
 
 void ECSFrame::onInit(Engine::Registry64& registry) {
-	folderIcon = ResourceManager::add<Graphics::TextureResource>("folder", "../res/textures/icons/Folder.png");
-	openFolderIcon = ResourceManager::add<Graphics::TextureResource>("folder open", "../res/textures/icons/Folder Open.png");
-	entityIcon = ResourceManager::add<Graphics::TextureResource>("entity", "../res/textures/icons/Entity.png");
-	colliderIcon = ResourceManager::add<Graphics::TextureResource>("collider", "../res/textures/icons/Collider.png");
-	terrainIcon = ResourceManager::add<Graphics::TextureResource>("terrain collider", "../res/textures/icons/Terrain Collider.png");
-	mainColliderIcon = ResourceManager::add<Graphics::TextureResource>("main collider", "../res/textures/icons/Main Collider.png");
-	childColliderIcon = ResourceManager::add<Graphics::TextureResource>("child collider", "../res/textures/icons/Child Collider.png");
-	hardConstraintsIcon = ResourceManager::add<Graphics::TextureResource>("hard constraints", "../res/textures/icons/Hard Constraints.png");
-	softLinksIcon = ResourceManager::add<Graphics::TextureResource>("soft constraints", "../res/textures/icons/Soft Constraints.png");
-	attachmentsIcon = ResourceManager::add<Graphics::TextureResource>("attachments", "../res/textures/icons/Attachments.png");
-	cframeIcon = ResourceManager::add<Graphics::TextureResource>("cframe", "../res/textures/icons/Axes.png");
-	cubeClassIcon = ResourceManager::add<Graphics::TextureResource>("cube", "../res/textures/icons/Cube.png");
-	sphereClassIcon = ResourceManager::add<Graphics::TextureResource>("sphere", "../res/textures/icons/Sphere.png");
-	cylinderClassIcon = ResourceManager::add<Graphics::TextureResource>("cylinder", "../res/textures/icons/Cylinder.png");
-	cornerClassIcon = ResourceManager::add<Graphics::TextureResource>("corner", "../res/textures/icons/Tetrahedron.png");
-	wedgeClassIcon = ResourceManager::add<Graphics::TextureResource>("wedge", "../res/textures/icons/Wedge.png");
-	polygonClassIcon = ResourceManager::add<Graphics::TextureResource>("polygon", "../res/textures/icons/Dodecahedron.png");
-	shownIcon = ResourceManager::add<Graphics::TextureResource>("shown", "../res/textures/icons/Eye.png");
-	hiddenIcon = ResourceManager::add<Graphics::TextureResource>("hidden", "../res/textures/icons/Hidden.png");
-	physicsIcon = ResourceManager::add<Graphics::TextureResource>("physics", "../res/textures/icons/Physics.png");
-	addIcon = ResourceManager::add<Graphics::TextureResource>("add", "../res/textures/icons/Add.png");
+	folderIcon = ResourceManager::addAsync<Graphics::TextureResource>("folder", "../res/textures/icons/Folder.png");
+	openFolderIcon = ResourceManager::addAsync<Graphics::TextureResource>("folder open", "../res/textures/icons/Folder Open.png");
+	entityIcon = ResourceManager::addAsync<Graphics::TextureResource>("entity", "../res/textures/icons/Entity.png");
+	colliderIcon = ResourceManager::addAsync<Graphics::TextureResource>("collider", "../res/textures/icons/Collider.png");
+	terrainIcon = ResourceManager::addAsync<Graphics::TextureResource>("terrain collider", "../res/textures/icons/Terrain Collider.png");
+	mainColliderIcon = ResourceManager::addAsync<Graphics::TextureResource>("main collider", "../res/textures/icons/Main Collider.png");
+	childColliderIcon = ResourceManager::addAsync<Graphics::TextureResource>("child collider", "../res/textures/icons/Child Collider.png");
+	hardConstraintsIcon = ResourceManager::addAsync<Graphics::TextureResource>("hard constraints", "../res/textures/icons/Hard Constraints.png");
+	softLinksIcon = ResourceManager::addAsync<Graphics::TextureResource>("soft constraints", "../res/textures/icons/Soft Constraints.png");
+	attachmentsIcon = ResourceManager::addAsync<Graphics::TextureResource>("attachments", "../res/textures/icons/Attachments.png");
+	cframeIcon = ResourceManager::addAsync<Graphics::TextureResource>("cframe", "../res/textures/icons/Axes.png");
+	cubeClassIcon = ResourceManager::addAsync<Graphics::TextureResource>("cube", "../res/textures/icons/Cube.png");
+	sphereClassIcon = ResourceManager::addAsync<Graphics::TextureResource>("sphere", "../res/textures/icons/Sphere.png");
+	cylinderClassIcon = ResourceManager::addAsync<Graphics::TextureResource>("cylinder", "../res/textures/icons/Cylinder.png");
+	cornerClassIcon = ResourceManager::addAsync<Graphics::TextureResource>("corner", "../res/textures/icons/Tetrahedron.png");
+	wedgeClassIcon = ResourceManager::addAsync<Graphics::TextureResource>("wedge", "../res/textures/icons/Wedge.png");
+	polygonClassIcon = ResourceManager::addAsync<Graphics::TextureResource>("polygon", "../res/textures/icons/Dodecahedron.png");
+	shownIcon = ResourceManager::addAsync<Graphics::TextureResource>("shown", "../res/textures/icons/Eye.png");
+	hiddenIcon = ResourceManager::addAsync<Graphics::TextureResource>("hidden", "../res/textures/icons/Hidden.png");
+	physicsIcon = ResourceManager::addAsync<Graphics::TextureResource>("physics", "../res/textures/icons/Physics.png");
+	addIcon = ResourceManager::addAsync<Graphics::TextureResource>("add", "../res/textures/icons/Add.png");
 }
 
 
@@ -18,10 +18,10 @@
 
 namespace P3D::Application {
 
-Graphics::TextureResource* materialIcon;
-Graphics::TextureResource* hitboxIcon;
-Graphics::TextureResource* lightIcon;
-Graphics::TextureResource* nameIcon;
+ResourceHandle<Graphics::TextureResource> materialIcon;
+ResourceHandle<Graphics::TextureResource> hitboxIcon;
+ResourceHandle<Graphics::TextureResource> lightIcon;
+ResourceHandle<Graphics::TextureResource> nameIcon;
 
 Engine::Registry64::component_type deletedComponentIndex = static_cast<Engine::Registry64::component_type>(-1);
 std::string errorModalMessage = "";
@@ -611,10 +611,10 @@ void renderEntity(Engine::Registry64& registry, Engine::Registry64::entity_type
 
 
 void PropertiesFrame::onInit(Engine::Registry64& registry) {
-	materialIcon = ResourceManager::add<Graphics::TextureResource>("material", "../res/textures/icons/Material.png");
-	hitboxIcon = ResourceManager::add<Graphics::TextureResource>("hitbox", "../res/textures/icons/Hitbox.png");
-	lightIcon = ResourceManager::add<Graphics::TextureResource>("light", "../res/textures/icons/Light.png");
-	nameIcon = ResourceManager::add<Graphics::TextureResource>("name", "../res/textures/icons/Name.png");
+	materialIcon = ResourceManager::addAsync<Graphics::TextureResource>("material", "../res/textures/icons/Material.png");
+	hitboxIcon = ResourceManager::addAsync<Graphics::TextureResource>("hitbox", "../res/textures/icons/Hitbox.png");
+	lightIcon = ResourceManager::addAsync<Graphics::TextureResource>("light", "../res/textures/icons/Light.png");
+	nameIcon = ResourceManager::addAsync<Graphics::TextureResource>("name", "../res/textures/icons/Name.png");
 }
 
 void PropertiesFrame::onRender(Engine::Registry64& registry) {
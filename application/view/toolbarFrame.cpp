@@ -14,10 +14,10 @@ namespace P3D::Application {
 
 void ToolbarFrame::onInit(Engine::Registry64& registry) {
 	std::string path = "../res/textures/icons/";
-	ResourceManager::add<Graphics::TextureResource>("play", path + "Play.png");
-	ResourceManager::add<Graphics::TextureResource>("pause", path + "Pause.png");
-	ResourceManager::add<Graphics::TextureResource>("tick", path + "Tick.png");
-	ResourceManager::add<Graphics::TextureResource>("reset", path + "Reset.png");
+	ResourceManager::addAsync<Graphics::TextureResource>("play", path + "Play.png");
+	ResourceManager::addAsync<Graphics::TextureResource>("pause", path + "Pause.png");
+	ResourceManager::addAsync<Graphics::TextureResource>("tick", path + "Tick.png");
+	ResourceManager::addAsync<Graphics::TextureResource>("reset", path + "Reset.png");
 }
 
 void ToolbarFrame::onRender(Engine::Registry64& registry) {
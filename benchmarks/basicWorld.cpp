@@ -12,6 +12,7 @@ public:
 	BasicWorldBenchmark() : WorldBenchmark("basicWorld", 1000) {}
 
 	void init() {
+		resetWorld();
 		createFloor(50, 50, 10);
 		//Polyhedron cube = ShapeLibrary::createCube(0.9);
 
@@ -3,14 +3,69 @@
 #include <chrono>
 #include <vector>
 #include <iostream>
+#include <iomanip>
+#include <fstream>
 #include <string>
 #include <sstream>
+#include <algorithm>
+#include <cmath>
 
 #include "../util/terminalColor.h"
 #include "../util/parseCPUIDArgs.h"
 
+#include <Physics3D/misc/physicsProfiler.h>
+
+#include "perfCounters.h"
+#include "benchmarkResults.h"
+#include "benchmarkStatistics.h"
+
 std::vector<Benchmark*>* knownBenchmarks = nullptr;
 
+int scenarioSize = 0;
+
+// set with --trace <prefix>, the ticks of every benchmark are traced to <prefix><name>.json
+static std::string tracePrefix;
+// set with --traceSpikes <ms>, ticks slower than this are traced to <prefix><name>_tick<index>.json
+static std::chrono::milliseconds traceSpikeThreshold(0);
+
+// set with --warmup <n> and --repeat <n>, runs before measuring and measured runs of every benchmark
+static std::size_t warmupRuns = 0;
+static std::size_t measuredRuns = 1;
+// set with --json <path> and --csv <path>
+static std::string jsonPath;
+static std::string csvPath;
+
+// opened with -perf, -perfZones also splits the counts over the physics processes when built with ZONE_COUNTERS
+// both only count the main thread, the work of thread pools and other threads is missing from them
+static PerfCounters perfCounters;
+static bool countZones = false;
+
+static void printPerfCounts(const PerfCounters::Values& values) {
+	for(std::size_t i = 0; i < PerfCounters::COUNT; i++) {
+		if(perfCounters.isAvailable(static_cast<PerfCounters::Counter>(i))) {
+			std::cout << "  " << PerfCounters::NAMES[i] << ": " << values.counts[i];
+		}
+	}
+	if(perfCounters.isAvailable(PerfCounters::CYCLES) && perfCounters.isAvailable(PerfCounters::INSTRUCTIONS)) {
+		std::cout << "  IPC: " << std::setprecision(3) << values.instructionsPerCycle() << std::setprecision(6);
+	}
+	std::cout << "\n";
+}
+
+static void printZonePerfCounts() {
+	for(std::size_t i = 0; i < P3D::physicsMeasure.size(); i++) {
+		PerfCounters::Values values = perfCounters.getZoneCounts(i);
+		bool counted = false;
+		for(std::uint64_t count : values.counts) {
+			if(count != 0) counted = true;
+		}
+		if(counted) {
+			std::cout << P3D::physicsMeasure.labels[i] << ":";
+			printPerfCounts(values);
+		}
+	}
+}
+
 Benchmark::Benchmark(const char* name) : name(name) {
 	if(knownBenchmarks == nullptr) { knownBenchmarks = new std::vector<Benchmark*>(); }
 	knownBenchmarks->push_back(this);
@@ -46,25 +101,159 @@ std::vector<std::string> split(std::string str, char splitChar) {
 	return substrings;
 }
 
-static void runBenchmark(Benchmark* bench) {
-	setColor(TerminalColor::CYAN);
+static void printRunStatistics(const BenchmarkResult& result) {
+	SampleStatistics runs = computeStatistics(result.runMillis);
+	setColor(TerminalColor::WHITE);
+	std::cout << runs.count << " runs after " << result.warmupRuns << " warmup runs: median " << runs.median << "ms, p95 " << runs.p95;
+	std::cout << "ms, stddev " << runs.stddev << "ms, min " << runs.min << "ms, max " << runs.max << "ms\n";
 
+	if(!result.tickMillis.empty()) {
+		SampleStatistics ticks = computeStatistics(result.tickMillis);
+		std::cout << ticks.count << " ticks: median " << ticks.median << "ms, p95 " << ticks.p95 << "ms, max " << ticks.max << "ms\n";
+
+		std::vector<std::size_t> histogram = latencyHistogram(result.tickMillis);
+		std::size_t largestBucket = *std::max_element(histogram.begin(), histogram.end());
+		std::size_t firstBucket = 0;
+		while(histogram[firstBucket] == 0) {
+			firstBucket++;
+		}
+		for(std::size_t bucket = firstBucket; bucket < histogram.size(); bucket++) {
+			std::cout << "  < " << std::setw(8) << latencyHistogramBucketEnd(bucket) << "us " << std::setw(8) << histogram[bucket] << " ";
+			setColor(TerminalColor::GREEN);
+			std::size_t barLength = largestBucket != 0 ? (histogram[bucket] * 40 + largestBucket - 1) / largestBucket : 0;
+			for(std::size_t i = 0; i < barLength; i++) {
+				std::cout << '=';
+			}
+			setColor(TerminalColor::WHITE);
+			std::cout << "\n";
+		}
+	}
+}
+
+static double timeInit(Benchmark* bench) {
 	auto createStart = std::chrono::high_resolution_clock::now();
 	bench->init();
 	auto createFinish = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::milli>(createFinish - createStart).count();
+}
+
+static double timeRun(Benchmark* bench) {
+	auto runStart = std::chrono::high_resolution_clock::now();
+	bench->run();
+	auto runFinish = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::milli>(runFinish - runStart).count();
+}
+
+static BenchmarkResult runBenchmark(Benchmark* bench) {
+	BenchmarkResult result;
+	result.name = bench->name;
+	result.warmupRuns = warmupRuns;
+
+	setColor(TerminalColor::CYAN);
+
+	double initMillis = timeInit(bench);
 	std::cout << bench->name << ": ";
 	std::cout.flush();
 	setColor(TerminalColor::YELLOW);
-	std::cout << '(' << (createFinish - createStart).count() / 1000000.0 << "ms)";
+	std::cout << '(' << initMillis << "ms)";
 	std::cout.flush();
-	auto runStart = std::chrono::high_resolution_clock::now();
-	bench->run();
-	auto runFinish = std::chrono::high_resolution_clock::now();
-	double deltaTimeMS = (runFinish - runStart).count() / 1000000.0;
+
+	// every run starts from a freshly initialized benchmark instead of the state the run before it left behind, init is not timed or counted
+	bool initialized = true;
+	auto initRun = [bench, &initialized]() {
+		if(!initialized) {
+			bench->init();
+		}
+		initialized = false;
+	};
+
+	for(std::size_t i = 0; i < warmupRuns; i++) {
+		initRun();
+		timeRun(bench);
+	}
+	bench->tickMillis.clear();
+
+	bool tracing = !tracePrefix.empty();
+	if(tracing) {
+		P3D::physicsTrace.clear();
+		P3D::physicsTrace.dumpSpikes(traceSpikeThreshold, tracePrefix + bench->name + "_");
+	}
+	bool counting = perfCounters.isAvailable();
+	if(counting && countZones) {
+		perfCounters.clearZoneCounts();
+	}
+	PerfCounters::Values counts;
+	for(std::size_t i = 0; i < measuredRuns; i++) {
+		initRun();
+		if(tracing) {
+			P3D::physicsTrace.setRecording(true);
+		}
+		if(counting && countZones) {
+			perfCounters.startCountingZones();
+		}
+		PerfCounters::Values countsBefore = perfCounters.read();
+		result.runMillis.push_back(timeRun(bench));
+		counts += perfCounters.read() - countsBefore;
+		if(counting && countZones) {
+			perfCounters.stopCountingZones();
+		}
+		if(tracing) {
+			P3D::physicsTrace.setRecording(false);
+		}
+	}
+	result.tickMillis.swap(bench->tickMillis);
+
+	double deltaTimeMS = computeStatistics(result.runMillis).median;
 	setColor(TerminalColor::GREEN);
 	std::cout << "  (" << deltaTimeMS << "ms)\n";
 	std::cout.flush();
 	bench->printResults(deltaTimeMS);
+
+	if(measuredRuns > 1 || !result.tickMillis.empty()) {
+		printRunStatistics(result);
+	}
+
+	if(counting) {
+		setColor(TerminalColor::MAGENTA);
+		std::cout << "[Performance Counters, main thread only]\n";
+		setColor(TerminalColor::WHITE);
+		std::cout << "Work done on other threads, such as thread pool workers, is not counted\n";
+		std::cout << "Main thread:";
+		printPerfCounts(counts);
+		if(countZones) {
+			printZonePerfCounts();
+		}
+	}
+
+	if(tracing) {
+		P3D::physicsTrace.waitForDumps();
+	}
+	if(tracing && P3D::physicsTrace.size() != 0) {
+		std::string tracePath = tracePrefix + bench->name + ".json";
+		setColor(TerminalColor::WHITE);
+		if(P3D::physicsTrace.writeChromeTrace(tracePath)) {
+			std::cout << "Wrote trace of the last " << P3D::physicsTrace.size() << " ticks to " << tracePath << "\n";
+		} else {
+			std::cout << "Could not write trace to " << tracePath << "\n";
+		}
+	}
+
+	return result;
+}
+
+static void writeResults(const std::vector<BenchmarkResult>& results) {
+	setColor(TerminalColor::WHITE);
+	MachineInfo machine = MachineInfo::current();
+	if(!jsonPath.empty()) {
+		std::ofstream file(jsonPath);
+		writeResultsJSON(file, machine, results);
+		std::cout << (file.good() ? "Wrote results to " : "Could not write results to ") << jsonPath << "\n";
+	}
+	if(!csvPath.empty()) {
+		std::ofstream file(csvPath);
+		writeResultsCSV(file, machine, results);
+		std::cout << (file.good() ? "Wrote results to " : "Could not write results to ") << csvPath << "\n";
+	}
 }
 
 static void runBenchmarks(const std::vector<std::string>& benchmarks) {
@@ -76,18 +265,144 @@ static void runBenchmarks(const std::vector<std::string>& benchmarks) {
 	std::cout << " [RUNTIME]\n";
 	setColor(TerminalColor::WHITE);
 
+	std::vector<BenchmarkResult> results;
 	for(const std::string& c : benchmarks) {
+		// a name ending in * runs every benchmark starting with it, such as scenario.*
+		if(!c.empty() && c.back() == '*') {
+			std::string prefix = c.substr(0, c.size() - 1);
+			for(Benchmark* b : *knownBenchmarks) {
+				if(std::string(b->name).compare(0, prefix.size(), prefix) == 0) {
+					results.push_back(runBenchmark(b));
+				}
+			}
+			continue;
+		}
 		Benchmark* b = getBenchFor(c);
 		if(b != nullptr) {
-			runBenchmark(b);
+			results.push_back(runBenchmark(b));
 		}
 	}
+
+	writeResults(results);
+}
+
+static bool readResultsFile(const std::string& path, std::vector<BenchmarkResult>& results) {
+	std::ifstream file(path);
+	std::string error;
+	if(!file.is_open()) {
+		error = "could not open file";
+	} else if(readResultsJSON(file, results, error)) {
+		return true;
+	}
+	setColor(TerminalColor::RED);
+	std::cout << path << ": " << error << "\n";
+	setColor(TerminalColor::WHITE);
+	return false;
+}
+
+static const double SIGNIFICANCE_LEVEL = 0.05;
+
+// Returns true if the change is a significant regression
+static bool printComparison(const std::string& name, const char* kind, const std::vector<double>& baseline, const std::vector<double>& current, double threshold) {
+	double baselineMedian = computeStatistics(baseline).median;
+	double currentMedian = computeStatistics(current).median;
+	double change = baselineMedian != 0.0 ? (currentMedian - baselineMedian) / baselineMedian : 0.0;
+	double p = mannWhitneyPValue(baseline, current);
+	bool significant = p < SIGNIFICANCE_LEVEL && std::abs(change) > threshold;
+
+	setColor(TerminalColor::CYAN);
+	std::cout << std::left << std::setw(28) << name << std::setw(6) << kind << std::right;
+	setColor(TerminalColor::WHITE);
+	std::cout << std::setw(12) << baselineMedian << "ms" << std::setw(12) << currentMedian << "ms";
+	std::cout << std::setw(9) << std::fixed << std::setprecision(2) << change * 100 << "%  p=" << std::setprecision(4) << p << std::defaultfloat << std::setprecision(6) << "  ";
+	if(!significant) {
+		std::cout << "no significant change\n";
+		return false;
+	}
+	setColor(change > 0 ? TerminalColor::RED : TerminalColor::GREEN);
+	std::cout << (change > 0 ? "REGRESSION" : "improvement") << "\n";
+	setColor(TerminalColor::WHITE);
+	return change > 0;
+}
+
+// Compares the medians of the benchmarks in both files, returns the number of significant regressions
+static int compareResults(const std::string& baselinePath, const std::string& currentPath, double threshold) {
+	std::vector<BenchmarkResult> baseline;
+	std::vector<BenchmarkResult> current;
+	if(!readResultsFile(baselinePath, baseline) || !readResultsFile(currentPath, current)) {
+		return -1;
+	}
+
+	setColor(TerminalColor::WHITE);
+	std::cout << "Comparing " << currentPath << " against " << baselinePath << ", significant at p < " << SIGNIFICANCE_LEVEL << " and a change above " << threshold * 100 << "%\n";
+
+	int regressions = 0;
+	for(const BenchmarkResult& currentResult : current) {
+		for(const BenchmarkResult& baselineResult : baseline) {
+			if(baselineResult.name != currentResult.name) continue;
+
+			if(baselineResult.runMillis.size() < 2 || currentResult.runMillis.size() < 2) {
+				setColor(TerminalColor::YELLOW);
+				std::cout << currentResult.name << ": needs at least 2 runs on both sides, use --repeat\n";
+				setColor(TerminalColor::WHITE);
+			} else if(printComparison(currentResult.name, "runs", baselineResult.runMillis, currentResult.runMillis, threshold)) {
+				regressions++;
+			}
+			if(!baselineResult.tickMillis.empty() && !currentResult.tickMillis.empty()) {
+				if(printComparison(currentResult.name, "ticks", baselineResult.tickMillis, currentResult.tickMillis, threshold)) {
+					regressions++;
+				}
+			}
+		}
+	}
+	return regressions;
 }
 
 int main(int argc, const char** args) {
 	Util::ParsedArgs pa(argc, args);
 	std::cout << Util::printAndParseCPUIDArgs(pa).c_str() << "\n";
 
+	tracePrefix = pa.getOptional("trace");
+	std::string traceSpikes = pa.getOptional("traceSpikes");
+	if(!traceSpikes.empty()) {
+		traceSpikeThreshold = std::chrono::milliseconds(std::stoi(traceSpikes));
+	}
+
+	if(pa.argCount() >= 1 && pa[0] == "compare") {
+		if(pa.argCount() != 3) {
+			std::cout << "usage: compare <baseline.json> <current.json> [--threshold <percent>]\n";
+			return 1;
+		}
+		std::string threshold = pa.getOptional("threshold");
+		int regressions = compareResults(pa[1], pa[2], threshold.empty() ? 0.02 : std::stod(threshold) / 100.0);
+		setColor(TerminalColor::WHITE);
+		return regressions == 0 ? 0 : 1;
+	}
+
+	std::string repeat = pa.getOptional("repeat");
+	std::string warmup = pa.getOptional("warmup");
+	measuredRuns = repeat.empty() ? 1 : std::max(std::stoi(repeat), 1);
+	warmupRuns = !warmup.empty() ? std::stoi(warmup) : measuredRuns > 1 ? 1 : 0;
+	jsonPath = pa.getOptional("json");
+	csvPath = pa.getOptional("csv");
+	std::string size = pa.getOptional("n");
+	if(!size.empty()) {
+		scenarioSize = std::stoi(size);
+	}
+
+	countZones = pa.hasFlag("perfZones");
+	if(countZones && !P3D::ZoneRegistry::COUNTERS_AVAILABLE) {
+		std::cout << "Zones can not be counted, configure with -DZONE_COUNTERS=ON to count them\n";
+		countZones = false;
+	}
+	if(pa.hasFlag("perf") || pa.hasFlag("perfZones")) {
+		if(!perfCounters.open()) {
+			std::cout << "Performance counters are not available, only measuring time (" << perfCounters.getErrorMessage() << ")\n";
+		} else if(!perfCounters.getErrorMessage().empty()) {
+			std::cout << "Some performance counters are not available (" << perfCounters.getErrorMessage() << ")\n";
+		}
+	}
+
 	if(pa.argCount() >= 1) {
 		runBenchmarks(pa.args());
 	} else {
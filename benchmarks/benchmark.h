@@ -1,10 +1,18 @@
 #pragma once
 
+#include <vector>
+
+// set with --n <count>, the size of the scenario benchmarks instead of their default size
+extern int scenarioSize;
+
 class Benchmark {
 public:
 	const char* name;
+	// benchmarks made of ticks add the time of every tick here in milliseconds, for the tick statistics
+	std::vector<double> tickMillis;
 	Benchmark(const char* name);
 	virtual ~Benchmark() {}
+	// called again before every run and not timed, so it has to undo whatever the previous init and run left behind
 	virtual void init() {}
 	virtual void run() = 0;
 	virtual void printResults(double timeTaken) {}
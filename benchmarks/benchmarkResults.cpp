@@ -0,0 +1,281 @@
+#include "benchmarkResults.h"
+
+#include "benchmarkStatistics.h"
+
+#include <Physics3D/misc/cpuid.h>
+
+#include <cctype>
+#include <cstdlib>
+#include <iterator>
+#include <thread>
+#include <utility>
+
+MachineInfo MachineInfo::current() {
+	MachineInfo machine;
+	machine.processor = P3D::CPUIDCheck::getProcessorName();
+	machine.threads = std::thread::hardware_concurrency();
+	for(int i = 0; i < P3D::CPUIDCheck::TECHNOLOGY_COUNT; i++) {
+		if(P3D::CPUIDCheck::hasTechnology(1U << i)) {
+			machine.technologies.push_back(P3D::CPUIDCheck::NAMES[i]);
+		}
+	}
+#if defined(__clang__)
+	machine.compiler = "Clang " __clang_version__;
+#elif defined(__GNUC__)
+	machine.compiler = "GCC " __VERSION__;
+#elif defined(_MSC_VER)
+	machine.compiler = "MSVC " + std::to_string(_MSC_VER);
+#endif
+#ifdef NDEBUG
+	machine.debugBuild = false;
+#else
+	machine.debugBuild = true;
+#endif
+	return machine;
+}
+
+static void writeString(std::ostream& out, const std::string& text) {
+	out << '"';
+	for(char c : text) {
+		if(c == '"' || c == '\\') {
+			out << '\\' << c;
+		} else if(static_cast<unsigned char>(c) >= 0x20) {
+			out << c;
+		}
+	}
+	out << '"';
+}
+
+static void writeNumbers(std::ostream& out, const std::vector<double>& numbers) {
+	out << '[';
+	for(std::size_t i = 0; i < numbers.size(); i++) {
+		if(i != 0) out << ',';
+		out << numbers[i];
+	}
+	out << ']';
+}
+
+static void writeStatistics(std::ostream& out, const SampleStatistics& statistics) {
+	out << "\"count\":" << statistics.count << ",\"mean\":" << statistics.mean << ",\"stddev\":" << statistics.stddev;
+	out << ",\"min\":" << statistics.min << ",\"median\":" << statistics.median << ",\"p95\":" << statistics.p95 << ",\"max\":" << statistics.max;
+}
+
+void writeResultsJSON(std::ostream& out, const MachineInfo& machine, const std::vector<BenchmarkResult>& results) {
+	std::streamsize oldPrecision = out.precision(9);
+
+	out << "{\n\"machine\":{\"processor\":";
+	writeString(out, machine.processor);
+	out << ",\"threads\":" << machine.threads << ",\"technologies\":[";
+	for(std::size_t i = 0; i < machine.technologies.size(); i++) {
+		if(i != 0) out << ',';
+		writeString(out, machine.technologies[i]);
+	}
+	out << "],\"compiler\":";
+	writeString(out, machine.compiler);
+	out << ",\"build\":\"" << (machine.debugBuild ? "debug" : "release") << "\"},\n\"benchmarks\":[";
+
+	for(std::size_t i = 0; i < results.size(); i++) {
+		const BenchmarkResult& result = results[i];
+		out << (i != 0 ? ",\n" : "\n") << "{\"name\":";
+		writeString(out, result.name);
+		out << ",\"warmupRuns\":" << result.warmupRuns << ",\n\"runs\":{";
+		writeStatistics(out, computeStatistics(result.runMillis));
+		out << ",\"millis\":";
+		writeNumbers(out, result.runMillis);
+		out << '}';
+		if(!result.tickMillis.empty()) {
+			out << ",\n\"ticks\":{";
+			writeStatistics(out, computeStatistics(result.tickMillis));
+			out << ",\"histogram\":[";
+			std::vector<std::size_t> histogram = latencyHistogram(result.tickMillis);
+			for(std::size_t bucket = 0; bucket < histogram.size(); bucket++) {
+				if(bucket != 0) out << ',';
+				out << "{\"upToMicros\":" << latencyHistogramBucketEnd(bucket) << ",\"count\":" << histogram[bucket] << '}';
+			}
+			out << "],\"millis\":";
+			writeNumbers(out, result.tickMillis);
+			out << '}';
+		}
+		out << '}';
+	}
+	out << "\n]}\n";
+
+	out.precision(oldPrecision);
+}
+
+static void writeStatisticsCSV(std::ostream& out, const std::vector<double>& samples) {
+	SampleStatistics statistics = computeStatistics(samples);
+	out << ',' << statistics.count << ',' << statistics.mean << ',' << statistics.stddev << ',' << statistics.min;
+	out << ',' << statistics.median << ',' << statistics.p95 << ',' << statistics.max;
+}
+
+void writeResultsCSV(std::ostream& out, const MachineInfo& machine, const std::vector<BenchmarkResult>& results) {
+	std::streamsize oldPrecision = out.precision(9);
+
+	out << "# processor: " << machine.processor << ", threads: " << machine.threads << ", compiler: " << machine.compiler;
+	out << ", build: " << (machine.debugBuild ? "debug" : "release") << ", technologies:";
+	for(const std::string& technology : machine.technologies) {
+		out << ' ' << technology;
+	}
+	out << '\n';
+
+	out << "name,warmupRuns,runs,runMean,runStddev,runMin,runMedian,runP95,runMax,ticks,tickMean,tickStddev,tickMin,tickMedian,tickP95,tickMax\n";
+	for(const BenchmarkResult& result : results) {
+		out << result.name << ',' << result.warmupRuns;
+		writeStatisticsCSV(out, result.runMillis);
+		writeStatisticsCSV(out, result.tickMillis);
+		out << '\n';
+	}
+
+	out.precision(oldPrecision);
+}
+
+namespace {
+// Only as much JSON as the result files use: objects, arrays, strings, numbers and literals
+struct JSONValue {
+	enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+	Type type = NUL;
+	double number = 0.0;
+	std::string string;
+	std::vector<JSONValue> elements;
+	std::vector<std::pair<std::string, JSONValue>> members;
+
+	const JSONValue* get(const char* key) const {
+		for(const std::pair<std::string, JSONValue>& member : members) {
+			if(member.first == key) {
+				return &member.second;
+			}
+		}
+		return nullptr;
+	}
+};
+
+class JSONParser {
+	const std::string& text;
+	std::size_t position = 0;
+
+	void skipWhitespace() {
+		while(position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) {
+			position++;
+		}
+	}
+
+	bool expect(char c) {
+		skipWhitespace();
+		if(position < text.size() && text[position] == c) {
+			position++;
+			return true;
+		}
+		return false;
+	}
+
+	bool parseString(std::string& result) {
+		if(!expect('"')) return false;
+		while(position < text.size() && text[position] != '"') {
+			if(text[position] == '\\') {
+				position++;
+				if(position >= text.size()) return false;
+			}
+			result.push_back(text[position++]);
+		}
+		return expect('"');
+	}
+
+public:
+	explicit JSONParser(const std::string& text) : text(text) {}
+
+	std::size_t getPosition() const { return position; }
+
+	bool parse(JSONValue& value) {
+		skipWhitespace();
+		if(position >= text.size()) return false;
+
+		char c = text[position];
+		if(c == '{') {
+			position++;
+			value.type = JSONValue::OBJECT;
+			if(expect('}')) return true;
+			do {
+				std::pair<std::string, JSONValue> member;
+				if(!parseString(member.first) || !expect(':') || !parse(member.second)) return false;
+				value.members.push_back(std::move(member));
+			} while(expect(','));
+			return expect('}');
+		} else if(c == '[') {
+			position++;
+			value.type = JSONValue::ARRAY;
+			if(expect(']')) return true;
+			do {
+				value.elements.emplace_back();
+				if(!parse(value.elements.back())) return false;
+			} while(expect(','));
+			return expect(']');
+		} else if(c == '"') {
+			value.type = JSONValue::STRING;
+			return parseString(value.string);
+		} else if(text.compare(position, 4, "true") == 0 || text.compare(position, 4, "null") == 0) {
+			value.type = c == 't' ? JSONValue::BOOL : JSONValue::NUL;
+			value.number = c == 't' ? 1.0 : 0.0;
+			position += 4;
+			return true;
+		} else if(text.compare(position, 5, "false") == 0) {
+			value.type = JSONValue::BOOL;
+			position += 5;
+			return true;
+		} else {
+			const char* start = text.c_str() + position;
+			char* end;
+			value.type = JSONValue::NUMBER;
+			value.number = std::strtod(start, &end);
+			if(end == start) return false;
+			position += end - start;
+			return true;
+		}
+	}
+};
+};
+
+static std::vector<double> readNumbers(const JSONValue* samples) {
+	std::vector<double> numbers;
+	if(samples != nullptr) {
+		const JSONValue* millis = samples->get("millis");
+		if(millis != nullptr) {
+			for(const JSONValue& element : millis->elements) {
+				numbers.push_back(element.number);
+			}
+		}
+	}
+	return numbers;
+}
+
+bool readResultsJSON(std::istream& in, std::vector<BenchmarkResult>& results, std::string& error) {
+	std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	JSONValue root;
+	JSONParser parser(text);
+	if(!parser.parse(root)) {
+		error = "invalid JSON near character " + std::to_string(parser.getPosition());
+		return false;
+	}
+
+	const JSONValue* benchmarks = root.get("benchmarks");
+	if(benchmarks == nullptr || benchmarks->type != JSONValue::ARRAY) {
+		error = "no benchmarks in file";
+		return false;
+	}
+
+	for(const JSONValue& benchmark : benchmarks->elements) {
+		const JSONValue* name = benchmark.get("name");
+		if(name == nullptr || name->type != JSONValue::STRING) {
+			error = "benchmark without a name";
+			return false;
+		}
+		BenchmarkResult result;
+		result.name = name->string;
+		const JSONValue* warmupRuns = benchmark.get("warmupRuns");
+		result.warmupRuns = warmupRuns != nullptr ? static_cast<std::size_t>(warmupRuns->number) : 0;
+		result.runMillis = readNumbers(benchmark.get("runs"));
+		result.tickMillis = readNumbers(benchmark.get("ticks"));
+		results.push_back(std::move(result));
+	}
+	return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct BenchmarkResult {
+	std::string name;
+	std::size_t warmupRuns = 0;
+	// the time of every measured run
+	std::vector<double> runMillis;
+	// the time of every tick of all measured runs, only for benchmarks made of ticks
+	std::vector<double> tickMillis;
+};
+
+struct MachineInfo {
+	std::string processor;
+	unsigned int threads = 0;
+	std::vector<std::string> technologies;
+	std::string compiler;
+	bool debugBuild = false;
+
+	static MachineInfo current();
+};
+
+void writeResultsJSON(std::ostream& out, const MachineInfo& machine, const std::vector<BenchmarkResult>& results);
+// One row per benchmark with the statistics of its runs and ticks
+void writeResultsCSV(std::ostream& out, const MachineInfo& machine, const std::vector<BenchmarkResult>& results);
+
+// Reads the benchmarks of a file written by writeResultsJSON, returns false and sets error if it can't be read
+bool readResultsJSON(std::istream& in, std::vector<BenchmarkResult>& results, std::string& error);
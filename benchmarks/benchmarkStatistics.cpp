@@ -0,0 +1,113 @@
+#include "benchmarkStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+SampleStatistics computeStatistics(std::vector<double> samples) {
+	SampleStatistics result;
+	result.count = samples.size();
+	if(samples.empty()) {
+		return result;
+	}
+
+	std::sort(samples.begin(), samples.end());
+
+	double total = 0.0;
+	for(double sample : samples) {
+		total += sample;
+	}
+	result.mean = total / samples.size();
+
+	double squaredDeviations = 0.0;
+	for(double sample : samples) {
+		squaredDeviations += (sample - result.mean) * (sample - result.mean);
+	}
+	result.stddev = samples.size() > 1 ? std::sqrt(squaredDeviations / (samples.size() - 1)) : 0.0;
+
+	result.min = samples.front();
+	result.max = samples.back();
+	result.median = percentile(samples, 0.5);
+	result.p95 = percentile(samples, 0.95);
+	return result;
+}
+
+double percentile(const std::vector<double>& sortedSamples, double fraction) {
+	if(sortedSamples.empty()) {
+		return 0.0;
+	}
+	double position = fraction * (sortedSamples.size() - 1);
+	std::size_t below = static_cast<std::size_t>(position);
+	if(below + 1 >= sortedSamples.size()) {
+		return sortedSamples.back();
+	}
+	double weight = position - below;
+	return sortedSamples[below] * (1.0 - weight) + sortedSamples[below + 1] * weight;
+}
+
+double mannWhitneyPValue(const std::vector<double>& a, const std::vector<double>& b) {
+	std::size_t n1 = a.size();
+	std::size_t n2 = b.size();
+	if(n1 == 0 || n2 == 0) {
+		return 1.0;
+	}
+
+	// rank all samples together, tied samples share the average of their ranks
+	std::vector<std::pair<double, bool>> all;
+	all.reserve(n1 + n2);
+	for(double sample : a) all.emplace_back(sample, true);
+	for(double sample : b) all.emplace_back(sample, false);
+	std::sort(all.begin(), all.end(), [](const std::pair<double, bool>& first, const std::pair<double, bool>& second) {
+		return first.first < second.first;
+	});
+
+	double rankSumA = 0.0;
+	double tieCorrection = 0.0;
+	for(std::size_t i = 0; i < all.size();) {
+		std::size_t tieEnd = i + 1;
+		while(tieEnd < all.size() && all[tieEnd].first == all[i].first) {
+			tieEnd++;
+		}
+		double tiedCount = double(tieEnd - i);
+		double averageRank = (i + 1 + tieEnd) / 2.0;
+		for(std::size_t j = i; j < tieEnd; j++) {
+			if(all[j].second) {
+				rankSumA += averageRank;
+			}
+		}
+		tieCorrection += tiedCount * tiedCount * tiedCount - tiedCount;
+		i = tieEnd;
+	}
+
+	double u = rankSumA - n1 * (n1 + 1) / 2.0;
+	double n = double(n1 + n2);
+	double meanU = n1 * n2 / 2.0;
+	double varianceU = n1 * n2 / 12.0 * ((n + 1) - tieCorrection / (n * (n - 1)));
+	if(varianceU <= 0.0) {
+		return 1.0;
+	}
+
+	// continuity correction, then the two sided tail of the standard normal distribution
+	double z = (std::abs(u - meanU) - 0.5) / std::sqrt(varianceU);
+	if(z < 0.0) {
+		return 1.0;
+	}
+	return std::erfc(z / std::sqrt(2.0));
+}
+
+std::vector<std::size_t> latencyHistogram(const std::vector<double>& millis) {
+	std::vector<std::size_t> buckets;
+	for(double sample : millis) {
+		double micros = sample * 1000.0;
+		std::size_t bucket = micros < 2.0 ? 0 : static_cast<std::size_t>(std::log2(micros));
+		if(bucket >= buckets.size()) {
+			buckets.resize(bucket + 1, 0);
+		}
+		buckets[bucket]++;
+	}
+	return buckets;
+}
+
+double latencyHistogramBucketEnd(std::size_t bucket) {
+	return std::ldexp(1.0, static_cast<int>(bucket) + 1);
+}
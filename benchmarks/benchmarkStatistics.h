@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+struct SampleStatistics {
+	std::size_t count = 0;
+	double mean = 0.0;
+	double stddev = 0.0;
+	double min = 0.0;
+	double median = 0.0;
+	double p95 = 0.0;
+	double max = 0.0;
+};
+
+SampleStatistics computeStatistics(std::vector<double> samples);
+
+// Linearly interpolated percentile of sorted samples, fraction between 0 and 1
+double percentile(const std::vector<double>& sortedSamples, double fraction);
+
+/*
+	Two sided p-value of the Mann-Whitney U test, the chance of samples this different if both come from the same distribution.
+
+	Unlike a t-test it does not assume normal distributions, which benchmark times rarely follow, a few slow runs do not dominate it.
+	Uses the normal approximation with tie correction, which is reasonable from about 5 samples per side.
+*/
+double mannWhitneyPValue(const std::vector<double>& a, const std::vector<double>& b);
+
+// Bucket i counts the samples from 2^i up to 2^(i+1) microseconds, the first bucket also counts everything below a microsecond
+std::vector<std::size_t> latencyHistogram(const std::vector<double>& millis);
+// Upper bound of the given bucket of latencyHistogram in microseconds
+double latencyHistogramBucketEnd(std::size_t bucket);
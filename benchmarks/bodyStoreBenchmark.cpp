@@ -0,0 +1,129 @@
+#include "benchmark.h"
+
+#include <Physics3D/bodyStore.h>
+#include <Physics3D/physical.h>
+#include <Physics3D/geometry/shapeCreation.h>
+#include <Physics3D/math/linalg/trigonometry.h>
+#include "../util/log.h"
+
+#include <vector>
+#include <memory>
+
+namespace P3D {
+#define BODY_STORE_BENCH_SIZE 100000
+#define BODY_STORE_BENCH_TICKS 100
+
+
+
+
+static const double BODY_STORE_BENCH_DELTA_T = 1.0 / 100.0;
+
+// Single part physicals spread over memory the way a world allocates them
+class SinglePartBodies {
+protected:
+	std::vector<std::unique_ptr<Part>> parts;
+	std::vector<MotorizedPhysical*> physicals;
+
+	void createBodies() {
+		physicals.clear();
+		parts.clear();
+		parts.reserve(BODY_STORE_BENCH_SIZE);
+		physicals.reserve(BODY_STORE_BENCH_SIZE);
+		for(int i = 0; i < BODY_STORE_BENCH_SIZE; i++) {
+			GlobalCFrame cframe(i % 100 * 2.0, i / 10000 * 2.0, i / 100 % 100 * 2.0, Rotation::fromEulerAngles(i * 0.1, i * 0.2, i * 0.3));
+			parts.push_back(std::make_unique<Part>(boxShape(1.0, 0.5 + i % 7 * 0.1, 2.0), cframe, PartProperties{1.0, 0.7, 0.5}));
+
+			parts.back()->ensureHasPhysical();
+			MotorizedPhysical* physical = parts.back()->getMainPhysical();
+			physical->motionOfCenterOfMass = Motion(Vec3(0.0, 1.0, 0.0), Vec3(0.3, i % 5 * 0.2, 0.1));
+			physicals.push_back(physical);
+		}
+	}
+
+	void printBodyResults(double timeTaken) {
+		double bodiesPerSecond = double(BODY_STORE_BENCH_SIZE) * BODY_STORE_BENCH_TICKS / (timeTaken / 1000.0);
+		Log::print("%d bodies, %d ticks, %.1f million body updates per second\n", BODY_STORE_BENCH_SIZE, BODY_STORE_BENCH_TICKS, bodiesPerSecond / 1000000.0);
+	}
+};
+
+class PhysicalUpdateBenchmark : public Benchmark, public SinglePartBodies {
+public:
+	PhysicalUpdateBenchmark() : Benchmark("physicalUpdate") {}
+
+	void init() override {
+		createBodies();
+	}
+
+	void run() override {
+		for(int tick = 0; tick < BODY_STORE_BENCH_TICKS; tick++) {
+			for(MotorizedPhysical* physical : physicals) {
+				physical->applyForceAtCenterOfMass(Vec3(0.0, -9.81, 0.0) * physical->totalMass);
+				physical->update(BODY_STORE_BENCH_DELTA_T);
+			}
+		}
+	}
+
+	void printResults(double timeTaken) override {
+		printBodyResults(timeTaken);
+	}
+} physicalUpdateBenchmark;
+
+class BodyStoreUpdateBenchmark : public Benchmark, public SinglePartBodies {
+	BodyStore store;
+
+public:
+	BodyStoreUpdateBenchmark() : Benchmark("bodyStoreUpdate") {}
+
+	void init() override {
+		createBodies();
+	}
+
+	void run() override {
+		for(int tick = 0; tick < BODY_STORE_BENCH_TICKS; tick++) {
+			store.clear();
+			for(MotorizedPhysical* physical : physicals) {
+				physical->applyForceAtCenterOfMass(Vec3(0.0, -9.81, 0.0) * physical->totalMass);
+				store.add(physical);
+				if(store.size() == BodyStore::BLOCK_SIZE) {
+					store.integrate(BODY_STORE_BENCH_DELTA_T);
+					store.scatter();
+					store.clear();
+				}
+			}
+			store.integrate(BODY_STORE_BENCH_DELTA_T);
+			store.scatter();
+		}
+	}
+
+	void printResults(double timeTaken) override {
+		printBodyResults(timeTaken);
+	}
+} bodyStoreUpdateBenchmark;
+
+// Only the integration over the store, the part that stays contiguous
+class BodyStoreIntegrateBenchmark : public Benchmark, public SinglePartBodies {
+	BodyStore store;
+
+public:
+	BodyStoreIntegrateBenchmark() : Benchmark("bodyStoreIntegrate") {}
+
+	void init() override {
+		createBodies();
+		store.clear();
+		store.reserve(physicals.size());
+		for(MotorizedPhysical* physical : physicals) {
+			store.add(physical);
+		}
+	}
+
+	void run() override {
+		for(int tick = 0; tick < BODY_STORE_BENCH_TICKS; tick++) {
+			store.integrate(BODY_STORE_BENCH_DELTA_T);
+		}
+	}
+
+	void printResults(double timeTaken) override {
+		printBodyResults(timeTaken);
+	}
+} bodyStoreIntegrateBenchmark;
+};
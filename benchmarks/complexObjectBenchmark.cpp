@@ -11,6 +11,7 @@ public:
 	ComplexObjectBenchmark() : WorldBenchmark("complexObject", 10000) {}
 
 	void init() {
+		resetWorld();
 		createFloor(50, 50, 10);
 		Polyhedron object = ShapeLibrary::icosahedron;
 		world.addPart(new Part(polyhedronShape(ShapeLibrary::createSphere(1.0, 7)), GlobalCFrame(0, 2.0, 0), basicProperties));
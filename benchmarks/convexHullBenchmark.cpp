@@ -0,0 +1,90 @@
+#include "benchmark.h"
+
+#include <Physics3D/geometry/convexHull.h>
+#include <Physics3D/geometry/convexDecomposition.h>
+#include <Physics3D/geometry/shapeLibrary.h>
+#include <Physics3D/threading/threadPool.h>
+#include "../util/log.h"
+
+#include <vector>
+#include <memory>
+#include <random>
+
+namespace P3D {
+// Hulls of points spread through a ball, most of them end up inside and are dropped on the way
+class ConvexHullBenchmark : public Benchmark {
+	int pointCount;
+	bool parallel;
+	std::vector<Vec3f> points;
+	std::unique_ptr<ThreadPool> threadPool;
+	int hullVertexCount = 0;
+
+public:
+	ConvexHullBenchmark(const char* name, int pointCount, bool parallel) : Benchmark(name), pointCount(pointCount), parallel(parallel) {}
+
+	void init() override {
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+		points.clear();
+		while(static_cast<int>(points.size()) < pointCount) {
+			Vec3f point(coordinate(random), coordinate(random), coordinate(random));
+			if(lengthSquared(point) <= 1.0f) points.push_back(point);
+		}
+		if(parallel && !threadPool) threadPool = std::make_unique<ThreadPool>();
+	}
+	void run() override {
+		Polyhedron hull = parallel ? convexHull(points.data(), pointCount, *threadPool) : convexHull(points.data(), pointCount);
+		hullVertexCount = hull.vertexCount;
+	}
+	void printResults(double timeTaken) override {
+		Log::print("%d points, %d hull vertices\n", pointCount, hullVertexCount);
+	}
+};
+
+ConvexHullBenchmark convexHull1k("convexHull1k", 1000, false);
+ConvexHullBenchmark convexHull100k("convexHull100k", 100000, false);
+ConvexHullBenchmark convexHull1M("convexHull1M", 1000000, false);
+ConvexHullBenchmark convexHull1MParallel("convexHull1MParallel", 1000000, true);
+
+// Every vertex of a detailed sphere is on its hull, the worst case for the number of faces replaced per point
+class SphereHullBenchmark : public Benchmark {
+	Polyhedron sphere;
+	int hullVertexCount = 0;
+
+public:
+	SphereHullBenchmark() : Benchmark("convexHullSphere") {}
+
+	void init() override {
+		sphere = ShapeLibrary::createSphere(1.0f, 5);
+	}
+	void run() override {
+		hullVertexCount = convexHull(sphere).vertexCount;
+	}
+	void printResults(double timeTaken) override {
+		Log::print("%d vertices, %d hull vertices\n", sphere.vertexCount, hullVertexCount);
+	}
+} sphereHullBenchmark;
+
+// A torus split into convex pieces, with the default settings
+class ConvexDecompositionBenchmark : public Benchmark {
+	Polyhedron torus;
+	std::vector<Polyhedron> pieces;
+
+public:
+	ConvexDecompositionBenchmark() : Benchmark("convexDecompositionTorus") {}
+
+	void init() override {
+		torus = ShapeLibrary::createTorus(1.0f, 0.4f, 64, 32);
+	}
+	void run() override {
+		pieces = convexDecomposition(torus);
+	}
+	void printResults(double timeTaken) override {
+		double volume = 0.0;
+		for(const Polyhedron& piece : pieces) {
+			volume += piece.getVolume();
+		}
+		Log::print("%d pieces, %.3f volume of pieces, %.3f volume of torus\n", static_cast<int>(pieces.size()), volume, torus.getVolume());
+	}
+} convexDecompositionBenchmark;
+};
@@ -1,8 +1,22 @@
 #include "benchmark.h"
+
+#include <cmath>
+#include <vector>
+
 #include "../engine/ecs/registry.h"
 #include "../util/log.h"
 
 namespace P3D::Engine {
+// Destroys the entities of the previous init, init runs again before every run
+static void clearRegistry(Registry64& registry) {
+	std::vector<Registry64::entity_type> entities;
+	for (auto entity : registry)
+		entities.push_back(registry.getSelf(entity));
+
+	for (Registry64::entity_type entity : entities)
+		registry.destroy(entity);
+}
+
 class ECSGetFromRegistryBenchmark : public Benchmark {
 public:
 	ECSGetFromRegistryBenchmark() : Benchmark("ecsGetFromRegistryBenchmark") {}
@@ -18,6 +32,7 @@ public:
 	};
 
 	void init() override {
+		clearRegistry(registry);
 		int amount = 1000000;
 		for(int i = 0; i < amount; i++) {
 			auto id = registry.create();
@@ -52,6 +67,7 @@ public:
 	struct A : public RC { int i; A(int i) : i(i) {} };
 
 	void init() override {
+		clearRegistry(registry);
 		int amount = 1000000;
 		for(int i = 0; i < amount; i++) {
 			auto id = registry.create();
@@ -76,6 +92,129 @@ public:
 
 } ecsGetFromViewConjunctionBenchmark;
 
+class ECSMultiComponentViewBenchmark : public Benchmark {
+public:
+	ECSMultiComponentViewBenchmark() : Benchmark("ecsMultiComponentViewBenchmark") {}
+
+	Registry64 registry;
+	int errors = 0;
+
+	struct A : public RC { int i; A(int i) : i(i) {} };
+	struct B : public RC { int i; B(int i) : i(i) {} };
+	struct C : public RC { int i; C(int i) : i(i) {} };
+
+	void init() override {
+		clearRegistry(registry);
+		int amount = 1000000;
+		for (int i = 0; i < amount; i++) {
+			auto id = registry.create();
+			registry.add<A>(id, i);
+			if (i % 2 == 0)
+				registry.add<B>(id, i);
+			registry.add<C>(id, i);
+		}
+	}
+
+	void run() override {
+		auto view = registry.view<A, B, C>();
+		for (auto entity : view) {
+			auto a = view.get<A>(entity);
+			auto b = view.get<B>(entity);
+			auto c = view.get<C>(entity);
+			if (a->i != b->i || b->i != c->i)
+				errors++;
+		}
+	}
+
+	void printResults(double timeTaken) override {
+		Log::error("Amount of errors: %d\n", errors);
+	}
+
+} ecsMultiComponentViewBenchmark;
+
+class ECSAddRemoveBenchmark : public Benchmark {
+public:
+	ECSAddRemoveBenchmark() : Benchmark("ecsAddRemoveBenchmark") {}
+
+	Registry64 registry;
+	std::vector<Registry64::entity_type> entities;
+	int errors = 0;
+
+	struct A : public RC { int i; A(int i) : i(i) {} };
+
+	void init() override {
+		clearRegistry(registry);
+		entities.clear();
+		int amount = 1000000;
+		entities.reserve(amount);
+		for (int i = 0; i < amount; i++)
+			entities.push_back(registry.create());
+	}
+
+	void run() override {
+		for (std::size_t i = 0; i < entities.size(); i++)
+			registry.add<A>(entities[i], static_cast<int>(i));
+
+		for (std::size_t i = 0; i < entities.size(); i += 2)
+			if (!registry.remove<A>(entities[i]))
+				errors++;
+
+		for (std::size_t i = 0; i < entities.size(); i++)
+			if (registry.has<A>(entities[i]) != (i % 2 == 1))
+				errors++;
+
+		// Leave the registry as it was found, so every run adds to entities without components
+		for (std::size_t i = 1; i < entities.size(); i += 2)
+			if (!registry.remove<A>(entities[i]))
+				errors++;
+	}
+
+	void printResults(double timeTaken) override {
+		Log::error("Amount of errors: %d\n", errors);
+	}
+
+} ecsAddRemoveBenchmark;
+
+class ECSParallelEachBenchmark : public Benchmark {
+public:
+	ECSParallelEachBenchmark() : Benchmark("ecsParallelEachBenchmark") {}
+
+	Registry64 registry;
+	ThreadPool threadPool;
+	int errors = 0;
+
+	struct A : public RC { double value; A(double value) : value(value) {} };
+	struct B : public RC { double value = 0.0; };
+
+	void init() override {
+		clearRegistry(registry);
+		int amount = 1000000;
+		for (int i = 0; i < amount; i++) {
+			auto id = registry.create();
+			registry.add<A>(id, i);
+			registry.add<B>(id);
+		}
+	}
+
+	void run() override {
+		for (int iteration = 0; iteration < 10; iteration++) {
+			registry.parallel_each<const A, B>(&threadPool, [](Registry64::entity_type entity, const A& a, B& b) {
+				b.value = std::sqrt(a.value) + b.value * 0.5;
+			});
+		}
+
+		registry.each<const A, const B>([this](Registry64::entity_type entity, const A& a, const B& b) {
+			if (b.value < std::sqrt(a.value))
+				errors++;
+		});
+	}
+
+	void printResults(double timeTaken) override {
+		Log::error("Amount of errors: %d\n", errors);
+	}
+
+} ecsParallelEachBenchmark;
+
 /*class ECSGetFromViewDisjunctionBenchmark : public Benchmark {
 public:
 	ECSGetFromViewDisjunctionBenchmark() : Benchmark("ecsGetFromViewDisjunctionBenchmark") {}
@@ -0,0 +1,40 @@
+#include "benchmark.h"
+
+#include <Physics3D/geometry/indexedShape.h>
+#include <Physics3D/geometry/shapeLibrary.h>
+#include "../util/log.h"
+
+#include <vector>
+
+namespace P3D {
+#define NEIGHBOR_BENCH_ROUNDS 20
+
+// Neighbor tables of detailed spheres, the size of scanned hulls
+class FillNeighborBufBenchmark : public Benchmark {
+	int sphereSteps;
+	std::vector<Triangle> triangles;
+	std::vector<TriangleNeighbors> neighbors;
+
+public:
+	FillNeighborBufBenchmark(const char* name, int sphereSteps) : Benchmark(name), sphereSteps(sphereSteps) {}
+
+	void init() override {
+		Polyhedron sphere = ShapeLibrary::createSphere(1.0f, sphereSteps);
+		triangles.resize(sphere.triangleCount);
+		sphere.getTriangles(triangles.data());
+		neighbors.resize(sphere.triangleCount);
+	}
+	void run() override {
+		for(int round = 0; round < NEIGHBOR_BENCH_ROUNDS; round++) {
+			fillNeighborBuf(triangles.data(), static_cast<int>(triangles.size()), neighbors.data());
+		}
+	}
+	void printResults(double timeTaken) override {
+		Log::print("%d triangles, %.3fms per table\n", static_cast<int>(triangles.size()), timeTaken / NEIGHBOR_BENCH_ROUNDS);
+	}
+};
+
+FillNeighborBufBenchmark fillNeighborBuf1k("fillNeighborBuf1k", 3);
+FillNeighborBufBenchmark fillNeighborBuf20k("fillNeighborBuf20k", 5);
+FillNeighborBufBenchmark fillNeighborBuf80k("fillNeighborBuf80k", 6);
+};
@@ -12,6 +12,7 @@ public:
 	ManyCubesBenchmark() : WorldBenchmark("manyCubes", 10000) {}
 
 	void init() {
+		resetWorld();
 		createFloor(50, 50, 10);
 
 		int minX = -5;
@@ -0,0 +1,55 @@
+#include "benchmark.h"
+
+#include <Physics3D/geometry/shape.h>
+#include <Physics3D/geometry/shapeCreation.h>
+#include <Physics3D/geometry/shapeLibrary.h>
+#include <Physics3D/geometry/intersection.h>
+#include <Physics3D/math/linalg/trigonometry.h>
+#include "../util/log.h"
+
+#include <vector>
+#include <random>
+
+namespace P3D {
+// Narrowphase on pairs of convex shapes with random orientations, placed so they overlap by a given fraction of their size
+class NarrowphaseBenchmark : public Benchmark {
+	double overlap;
+	std::vector<Shape> shapes;
+	std::vector<int> firstShapes;
+	std::vector<int> secondShapes;
+	std::vector<CFrame> transforms;
+	int hitCount = 0;
+
+public:
+	NarrowphaseBenchmark(const char* name, double overlap) : Benchmark(name), overlap(overlap) {}
+
+	void init() override {
+		shapes = std::vector<Shape>{boxShape(1.0, 1.0, 1.0), sphereShape(0.5), cylinderShape(0.5, 1.0), polyhedronShape(ShapeLibrary::createSphere(0.5f, 2))};
+		std::mt19937 random(1);
+		std::uniform_int_distribution<int> shapeIndex(0, static_cast<int>(shapes.size()) - 1);
+		std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+		std::uniform_real_distribution<double> angle(-3.14159, 3.14159);
+		firstShapes.clear();
+		secondShapes.clear();
+		transforms.clear();
+		for(int i = 0; i < 100000; i++) {
+			Vec3 direction = normalize(Vec3(coordinate(random), coordinate(random), coordinate(random)));
+			firstShapes.push_back(shapeIndex(random));
+			secondShapes.push_back(shapeIndex(random));
+			transforms.push_back(CFrame(direction * (1.0 - overlap), Rotation::fromEulerAngles(angle(random), angle(random), angle(random))));
+		}
+	}
+	void run() override {
+		hitCount = 0;
+		for(std::size_t i = 0; i < transforms.size(); i++) {
+			if(intersectsTransformed(shapes[firstShapes[i]], shapes[secondShapes[i]], transforms[i])) hitCount++;
+		}
+	}
+	void printResults(double timeTaken) override {
+		Log::print("%d pairs, %d intersecting, %.3fus per pair\n", static_cast<int>(transforms.size()), hitCount, timeTaken * 1000.0 / transforms.size());
+	}
+};
+
+NarrowphaseBenchmark narrowphaseShallow("narrowphaseShallow", 0.05);
+NarrowphaseBenchmark narrowphaseDeep("narrowphaseDeep", 0.6);
+};
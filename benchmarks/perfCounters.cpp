@@ -0,0 +1,193 @@
+#include "perfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+const char* const PerfCounters::NAMES[COUNT]{
+	"Cycles",
+	"Instructions",
+	"L1D misses",
+	"LLC misses",
+	"Branch misses"
+};
+
+PerfCounters::Values& PerfCounters::Values::operator+=(const Values& other) {
+	for(std::size_t i = 0; i < COUNT; i++) {
+		counts[i] += other.counts[i];
+	}
+	return *this;
+}
+
+PerfCounters::Values PerfCounters::Values::operator-(const Values& other) const {
+	Values result;
+	for(std::size_t i = 0; i < COUNT; i++) {
+		result.counts[i] = counts[i] - other.counts[i];
+	}
+	return result;
+}
+
+double PerfCounters::Values::instructionsPerCycle() const {
+	return counts[CYCLES] != 0 ? double(counts[INSTRUCTIONS]) / counts[CYCLES] : 0.0;
+}
+
+PerfCounters::PerfCounters() {
+	for(std::size_t i = 0; i < COUNT; i++) {
+		fds[i] = -1;
+		groupIndex[i] = 0;
+	}
+}
+
+PerfCounters::~PerfCounters() {
+	close();
+}
+
+#ifdef __linux__
+static const std::uint32_t counterTypes[PerfCounters::COUNT]{
+	PERF_TYPE_HARDWARE,
+	PERF_TYPE_HARDWARE,
+	PERF_TYPE_HW_CACHE,
+	PERF_TYPE_HARDWARE,
+	PERF_TYPE_HARDWARE
+};
+
+static const std::uint64_t counterConfigs[PerfCounters::COUNT]{
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+	PERF_COUNT_HW_CACHE_MISSES,
+	PERF_COUNT_HW_BRANCH_MISSES
+};
+
+bool PerfCounters::open() {
+	close();
+	for(std::size_t i = 0; i < COUNT; i++) {
+		perf_event_attr attributes;
+		std::memset(&attributes, 0, sizeof(attributes));
+		attributes.size = sizeof(attributes);
+		attributes.type = counterTypes[i];
+		attributes.config = counterConfigs[i];
+		attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attributes.disabled = groupFd == -1 ? 1 : 0;
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+
+		int fd = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, groupFd, 0));
+		if(fd == -1) {
+			if(!errorMessage.empty()) errorMessage.append(", ");
+			errorMessage.append(NAMES[i]).append(": ").append(std::strerror(errno));
+			continue;
+		}
+		if(groupFd == -1) {
+			groupFd = fd;
+		}
+		fds[i] = fd;
+		groupIndex[i] = openCount++;
+	}
+
+	if(groupFd == -1) {
+		return false;
+	}
+	ioctl(groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	return true;
+}
+
+void PerfCounters::close() {
+	for(std::size_t i = 0; i < COUNT; i++) {
+		if(fds[i] != -1) {
+			::close(fds[i]);
+			fds[i] = -1;
+		}
+	}
+	groupFd = -1;
+	openCount = 0;
+	errorMessage.clear();
+}
+
+PerfCounters::Values PerfCounters::read() const {
+	Values result;
+	if(groupFd == -1) {
+		return result;
+	}
+
+	// nr, time enabled, time running, then the value of every counter in the group
+	std::uint64_t buffer[3 + COUNT];
+	if(::read(groupFd, buffer, sizeof(buffer)) < static_cast<ssize_t>((3 + openCount) * sizeof(std::uint64_t))) {
+		return result;
+	}
+	std::uint64_t timeEnabled = buffer[1];
+	std::uint64_t timeRunning = buffer[2];
+	if(timeRunning == 0) {
+		return result;
+	}
+
+	double scale = double(timeEnabled) / timeRunning;
+	for(std::size_t i = 0; i < COUNT; i++) {
+		if(fds[i] != -1) {
+			std::uint64_t value = buffer[3 + groupIndex[i]];
+			result.counts[i] = timeEnabled == timeRunning ? value : static_cast<std::uint64_t>(value * scale);
+		}
+	}
+	return result;
+}
+#else
+bool PerfCounters::open() {
+	errorMessage = "hardware counters are only supported on Linux";
+	return false;
+}
+
+void PerfCounters::close() {}
+
+PerfCounters::Values PerfCounters::read() const {
+	return Values();
+}
+#endif
+
+void PerfCounters::startCountingZones() {
+	for(Values& values : childCounts) {
+		values = Values();
+	}
+	P3D::ZoneRegistry::setThreadCounterSource(this);
+}
+
+void PerfCounters::stopCountingZones() {
+	P3D::ZoneRegistry::setThreadCounterSource(nullptr);
+}
+
+void PerfCounters::clearZoneCounts() {
+	zoneCounts.clear();
+}
+
+PerfCounters::Values PerfCounters::getZoneCounts(std::size_t zone) const {
+	return zone < zoneCounts.size() ? zoneCounts[zone] : Values();
+}
+
+void PerfCounters::enterZone(std::uint16_t depth) {
+	std::size_t index = depth < P3D::ZoneBuffer::MAX_DEPTH ? depth : P3D::ZoneBuffer::MAX_DEPTH - 1;
+	zoneStart[index] = read();
+}
+
+void PerfCounters::exitZone(std::uint16_t zone, std::uint16_t depth) {
+	std::size_t index = depth < P3D::ZoneBuffer::MAX_DEPTH ? depth : P3D::ZoneBuffer::MAX_DEPTH - 1;
+	Values total = read() - zoneStart[index];
+
+	// like the time of zones, the counts of a zone exclude the zones inside it, scaled counts may make the children slightly larger
+	Values self;
+	for(std::size_t i = 0; i < COUNT; i++) {
+		std::uint64_t children = childCounts[index + 1].counts[i];
+		self.counts[i] = total.counts[i] > children ? total.counts[i] - children : 0;
+	}
+	childCounts[index + 1] = Values();
+	childCounts[index] += total;
+
+	if(zone >= zoneCounts.size()) {
+		zoneCounts.resize(zone + 1);
+	}
+	zoneCounts[zone] += self;
+}
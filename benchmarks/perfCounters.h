@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <Physics3D/misc/zoneProfiler.h>
+
+/*
+	Hardware performance counters of the calling thread, read with perf_event_open on Linux. Other threads are not counted,
+	including threads started by the calling thread.
+
+	Counters the kernel or the cpu does not allow are left out, on other platforms none are available.
+	Only user space is counted, so reading the counters for every zone slows the benchmark down but does not change the counts much.
+*/
+class PerfCounters : public P3D::ZoneCounterSource {
+public:
+	enum Counter {
+		CYCLES,
+		INSTRUCTIONS,
+		L1D_MISSES,
+		LLC_MISSES,
+		BRANCH_MISSES,
+		COUNT
+	};
+
+	static const char* const NAMES[COUNT];
+
+	struct Values {
+		std::uint64_t counts[COUNT]{};
+
+		Values& operator+=(const Values& other);
+		Values operator-(const Values& other) const;
+		double instructionsPerCycle() const;
+	};
+
+private:
+	int groupFd = -1;
+	int fds[COUNT];
+	// position of every available counter in a read of the group
+	std::size_t groupIndex[COUNT];
+	std::size_t openCount = 0;
+	std::string errorMessage;
+
+	Values zoneStart[P3D::ZoneBuffer::MAX_DEPTH + 1];
+	Values childCounts[P3D::ZoneBuffer::MAX_DEPTH + 2];
+	std::vector<Values> zoneCounts;
+
+public:
+	PerfCounters();
+	~PerfCounters();
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	// Opens all counters that can be opened, returns false if there are none
+	bool open();
+	void close();
+
+	bool isAvailable() const { return openCount != 0; }
+	bool isAvailable(Counter counter) const { return fds[counter] != -1; }
+	// Why counters are missing, empty if all counters could be opened
+	const std::string& getErrorMessage() const { return errorMessage; }
+
+	// The counts since open, scaled up if the kernel had to share the counters with other events
+	Values read() const;
+
+	// Counts every zone of the calling thread, by the zone it was in without the zones inside it, until stopped. Counts add up over every start and stop
+	void startCountingZones();
+	void stopCountingZones();
+	void clearZoneCounts();
+	// The counts of the given zone, zones that were never entered have all counts zero
+	Values getZoneCounts(std::size_t zone) const;
+
+	void enterZone(std::uint16_t depth) override;
+	void exitZone(std::uint16_t zone, std::uint16_t depth) override;
+};
@@ -0,0 +1,59 @@
+#include "benchmark.h"
+
+#include <Physics3D/geometry/shape.h>
+#include <Physics3D/geometry/shapeClass.h>
+#include <Physics3D/geometry/shapeCreation.h>
+#include <Physics3D/geometry/shapeLibrary.h>
+#include "../util/log.h"
+
+#include <vector>
+#include <limits>
+#include <random>
+
+namespace P3D {
+// Rays and containment tests against a polyhedron shape class, or against its Polyhedron directly to compare with the brute force scan over all triangles
+class PolyhedronQueryBenchmark : public Benchmark {
+	bool convex;
+	bool bruteForce;
+	Shape shape;
+	Polyhedron poly;
+	std::vector<Vec3> origins;
+	std::vector<Vec3> directions;
+	int hitCount = 0;
+	int insideCount = 0;
+
+public:
+	PolyhedronQueryBenchmark(const char* name, bool convex, bool bruteForce) : Benchmark(name), convex(convex), bruteForce(bruteForce) {}
+
+	void init() override {
+		shape = polyhedronShape(convex ? ShapeLibrary::createSphere(1.0f, 3) : ShapeLibrary::createTorus(0.6f, 0.35f, 64, 32));
+		poly = shape.baseShape->asPolyhedron();
+		std::mt19937 random(1);
+		std::uniform_real_distribution<double> coordinate(-1.5, 1.5);
+		origins.clear();
+		directions.clear();
+		for(int i = 0; i < (bruteForce ? 2000 : 100000); i++) {
+			origins.push_back(Vec3(coordinate(random), coordinate(random), coordinate(random)));
+			directions.push_back(normalize(Vec3(coordinate(random), coordinate(random), coordinate(random))));
+		}
+	}
+	void run() override {
+		hitCount = 0;
+		insideCount = 0;
+		for(std::size_t i = 0; i < origins.size(); i++) {
+			double distance = bruteForce ? poly.getIntersectionDistance(origins[i], directions[i]) : shape.baseShape->getIntersectionDistance(origins[i], directions[i]);
+			if(distance != std::numeric_limits<double>::max()) hitCount++;
+			bool inside = bruteForce ? poly.containsPoint(origins[i]) : shape.baseShape->containsPoint(origins[i]);
+			if(inside) insideCount++;
+		}
+	}
+	void printResults(double timeTaken) override {
+		Log::print("%d triangles, %d queries, %d hits, %d inside, %.3fus per ray and containment test\n", poly.triangleCount, static_cast<int>(origins.size()), hitCount, insideCount, timeTaken * 1000.0 / origins.size());
+	}
+};
+
+PolyhedronQueryBenchmark convexPolyhedronQueries("convexPolyhedronQueries", true, false);
+PolyhedronQueryBenchmark convexPolyhedronQueriesBruteForce("convexPolyhedronQueriesBruteForce", true, true);
+PolyhedronQueryBenchmark concavePolyhedronQueries("concavePolyhedronQueries", false, false);
+PolyhedronQueryBenchmark concavePolyhedronQueriesBruteForce("concavePolyhedronQueriesBruteForce", false, true);
+};
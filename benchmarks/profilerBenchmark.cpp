@@ -0,0 +1,48 @@
+#include "benchmark.h"
+
+#include <Physics3D/misc/physicsProfiler.h>
+#include "../util/log.h"
+
+namespace P3D {
+#define PROFILER_BENCH_ZONES 10000000
+#define PROFILER_BENCH_ZONES_PER_TICK 10000
+#define PROFILER_BENCH_TIMESTAMPS 10000000
+
+class ProfileZoneBenchmark : public Benchmark {
+public:
+	ProfileZoneBenchmark() : Benchmark("profileZone") {}
+
+	void run() override {
+		for(int tick = 0; tick < PROFILER_BENCH_ZONES / PROFILER_BENCH_ZONES_PER_TICK; tick++) {
+			physicsMeasure.startTick();
+			for(int i = 0; i < PROFILER_BENCH_ZONES_PER_TICK / 2; i++) {
+				ProfileZone outer(PhysicsProcess::UPDATING);
+				ProfileZone inner(PhysicsProcess::UPDATE_TREE_BOUNDS);
+			}
+			physicsMeasure.endTick();
+		}
+	}
+
+	void printResults(double timeTaken) override {
+		Log::print("%.2f ns per zone, including reading them every %d zones\n", timeTaken * 1000000.0 / PROFILER_BENCH_ZONES, PROFILER_BENCH_ZONES_PER_TICK);
+	}
+} profileZoneBenchmark;
+
+// A zone takes two timestamps, compare with profileZone to see how much of a zone is spent on the clock
+class ProfileClockBenchmark : public Benchmark {
+public:
+	std::uint64_t sum = 0;
+
+	ProfileClockBenchmark() : Benchmark("profileClock") {}
+
+	void run() override {
+		for(int i = 0; i < PROFILER_BENCH_TIMESTAMPS; i++) {
+			sum += ProfileClock::now();
+		}
+	}
+
+	void printResults(double timeTaken) override {
+		Log::print("%.2f ns per timestamp (%llu)\n", timeTaken * 1000000.0 / PROFILER_BENCH_TIMESTAMPS, static_cast<unsigned long long>(sum));
+	}
+} profileClockBenchmark;
+};
@@ -0,0 +1,247 @@
+#include "worldBenchmark.h"
+
+#include "../util/log.h"
+
+#include <Physics3D/world.h>
+#include <Physics3D/geometry/shapeLibrary.h>
+#include <Physics3D/geometry/shapeCreation.h>
+#include <Physics3D/math/linalg/trigonometry.h>
+#include <Physics3D/constraints/ballConstraint.h>
+#include <Physics3D/constraints/hingeConstraint.h>
+#include <Physics3D/hardconstraints/motorConstraint.h>
+#include <Physics3D/softlinks/springLink.h>
+#include <Physics3D/softlinks/elasticLink.h>
+
+#include <cmath>
+#include <random>
+
+namespace P3D {
+/*
+	Worlds that each put the load on a different stage of the tick, built with a size n that defaults per scenario.
+
+	Run them with a larger n, set with --n, to find which stage breaks down first. The breakdown printed per stage is the
+	average of the last ticks from physicsMeasure.
+*/
+class ScenarioBenchmark : public WorldBenchmark {
+	int defaultSize;
+	int size = 0;
+
+public:
+	ScenarioBenchmark(const char* name, int tickCount, int defaultSize) : WorldBenchmark(name, tickCount), defaultSize(defaultSize) {}
+
+	void init() override {
+		size = scenarioSize != 0 ? scenarioSize : defaultSize;
+		resetWorld();
+		build(size);
+	}
+
+	void printResults(double timeTaken) override {
+		Log::print("n = %d, %d parts in %d physicals\n", size, static_cast<int>(world.getPartCount()), static_cast<int>(world.physicals.size()));
+		WorldBenchmark::printResults(timeTaken);
+	}
+
+	virtual void build(int n) = 0;
+};
+
+// A single tower of n boxes, each turned a little more than the one below it so the tower topples over its own contacts
+class BoxStackScenario : public ScenarioBenchmark {
+public:
+	BoxStackScenario() : ScenarioBenchmark("scenario.boxStack", 1000, 20) {}
+
+	void build(int n) override {
+		createFloor(20, 20, 2);
+		Shape box = boxShape(1.0, 1.0, 1.0);
+		for(int i = 0; i < n; i++) {
+			world.addPart(new Part(box, GlobalCFrame(Position(0.0, 1.0 + i * 1.001, 0.0), Rotation::rotY(i * 0.1)), basicProperties));
+		}
+	}
+} boxStackScenario;
+
+// A pyramid with n boxes along the bottom row, every box rests on two others
+class BoxPyramidScenario : public ScenarioBenchmark {
+public:
+	BoxPyramidScenario() : ScenarioBenchmark("scenario.boxPyramid", 1000, 15) {}
+
+	void build(int n) override {
+		createFloor(40, 20, 2);
+		Shape box = boxShape(1.0, 1.0, 1.0);
+		for(int row = 0; row < n; row++) {
+			int boxesInRow = n - row;
+			for(int i = 0; i < boxesInRow; i++) {
+				double x = (i - (boxesInRow - 1) / 2.0) * 1.05;
+				world.addPart(new Part(box, GlobalCFrame(x, 1.0 + row * 1.001, 0.0), basicProperties));
+			}
+		}
+	}
+} boxPyramidScenario;
+
+// n spheres and spike balls dropped into a walled area, many-vertex shapes for GJK and EPA
+class ConvexPileScenario : public ScenarioBenchmark {
+public:
+	ConvexPileScenario() : ScenarioBenchmark("scenario.convexPile", 1000, 200) {}
+
+	void build(int n) override {
+		createFloor(6, 6, 10);
+		Shape sphere = polyhedronShape(ShapeLibrary::createSphere(0.5f, 2));
+		Shape spikeBall = polyhedronShape(ShapeLibrary::createSpikeBall(0.35f, 0.6f, 2, 1));
+
+		std::mt19937 random(1);
+		std::uniform_real_distribution<double> angle(0.0, 3.1415);
+		int side = 6;
+		for(int i = 0; i < n; i++) {
+			int x = i % side;
+			int z = i / side % side;
+			int y = i / (side * side);
+			GlobalCFrame cframe(x * 1.5 - 3.75, 2.0 + y * 1.5, z * 1.5 - 3.75, Rotation::fromEulerAngles(angle(random), angle(random), angle(random)));
+			world.addPart(new Part(i % 2 == 0 ? sphere : spikeBall, cframe, basicProperties));
+		}
+	}
+} convexPileScenario;
+
+// A chain of n links connected by constraints that falls onto the floor, the constraint solver with growing groups
+template<typename ConstraintType>
+class ChainScenario : public ScenarioBenchmark {
+public:
+	ChainScenario(const char* name) : ScenarioBenchmark(name, 1000, 50) {}
+
+	ConstraintType* createLink() const;
+
+	void build(int n) override {
+		createFloor(50, 20, 2);
+		Shape link = boxShape(0.8, 0.3, 0.3);
+		ConstraintGroup group;
+		Part* previous = nullptr;
+		for(int i = 0; i < n; i++) {
+			Part* current = new Part(link, GlobalCFrame(i * 1.0 - n / 2.0, 5.0, 0.0), basicProperties);
+			world.addPart(current);
+			if(previous != nullptr) {
+				group.add(previous, current, createLink());
+			}
+			previous = current;
+		}
+		world.constraints.push_back(group);
+	}
+};
+
+template<>
+BallConstraint* ChainScenario<BallConstraint>::createLink() const {
+	return new BallConstraint(Vec3(0.5, 0.0, 0.0), Vec3(-0.5, 0.0, 0.0));
+}
+
+template<>
+HingeConstraint* ChainScenario<HingeConstraint>::createLink() const {
+	return new HingeConstraint(Vec3(0.5, 0.0, 0.0), Vec3(0.0, 0.0, 1.0), Vec3(-0.5, 0.0, 0.0), Vec3(0.0, 0.0, 1.0));
+}
+
+ChainScenario<BallConstraint> ballChainScenario("scenario.ballChain");
+ChainScenario<HingeConstraint> hingeChainScenario("scenario.hingeChain");
+
+// n cars driven by motorized wheels, physicals made of several parts connected by hard constraints
+class VehiclesScenario : public ScenarioBenchmark {
+public:
+	VehiclesScenario() : ScenarioBenchmark("scenario.vehicles", 1000, 20) {}
+
+	void build(int n) override {
+		createFloor(60, 60, 2);
+		Shape body = boxShape(1.0, 0.4, 2.0);
+		Shape wheel = cylinderShape(0.5, 0.2);
+		double turnSpeed = 10.0;
+		for(int i = 0; i < n; i++) {
+			Part* carBody = new Part(body, GlobalCFrame(i % 10 * 3.0 - 15.0, 1.0, i / 10 * 4.0 - 20.0), basicProperties);
+			Part* frontLeft = new Part(wheel, GlobalCFrame(), basicProperties);
+			Part* frontRight = new Part(wheel, GlobalCFrame(), basicProperties);
+			Part* backLeft = new Part(wheel, GlobalCFrame(), basicProperties);
+			Part* backRight = new Part(wheel, GlobalCFrame(), basicProperties);
+
+			carBody->attach(frontLeft, new ConstantSpeedMotorConstraint(turnSpeed), CFrame(Vec3(0.55, 0.0, 1.0), Rotation::Predefined::Y_90), CFrame(Vec3(0.0, 0.0, 0.15), Rotation::Predefined::Y_180));
+			carBody->attach(backLeft, new ConstantSpeedMotorConstraint(turnSpeed), CFrame(Vec3(0.55, 0.0, -1.0), Rotation::Predefined::Y_90), CFrame(Vec3(0.0, 0.0, 0.15), Rotation::Predefined::Y_180));
+			carBody->attach(frontRight, new ConstantSpeedMotorConstraint(-turnSpeed), CFrame(Vec3(-0.55, 0.0, 1.0), Rotation::Predefined::Y_270), CFrame(Vec3(0.0, 0.0, 0.15), Rotation::Predefined::Y_180));
+			carBody->attach(backRight, new ConstantSpeedMotorConstraint(-turnSpeed), CFrame(Vec3(-0.55, 0.0, -1.0), Rotation::Predefined::Y_270), CFrame(Vec3(0.0, 0.0, 0.15), Rotation::Predefined::Y_180));
+
+			world.addPart(carBody);
+		}
+	}
+} vehiclesScenario;
+
+// An n by n grid of parts held together by springs along x and elastic links along z, many soft links per physical
+class SoftLinkMeshScenario : public ScenarioBenchmark {
+public:
+	SoftLinkMeshScenario() : ScenarioBenchmark("scenario.softLinkMesh", 1000, 12) {}
+
+	void build(int n) override {
+		createFloor(30, 30, 2);
+		Shape node = boxShape(0.4, 0.4, 0.4);
+		std::vector<Part*> nodes;
+		for(int x = 0; x < n; x++) {
+			for(int z = 0; z < n; z++) {
+				Part* part = new Part(node, GlobalCFrame(x - n / 2.0, 4.0, z - n / 2.0), basicProperties);
+				world.addPart(part);
+				nodes.push_back(part);
+			}
+		}
+		for(int x = 0; x < n; x++) {
+			for(int z = 0; z < n; z++) {
+				Part* part = nodes[x * n + z];
+				if(x + 1 < n) {
+					world.addLink(new SpringLink({CFrame(), part}, {CFrame(), nodes[(x + 1) * n + z]}, 1.0, 20.0));
+				}
+				if(z + 1 < n) {
+					world.addLink(new ElasticLink({CFrame(), part}, {CFrame(), nodes[x * n + z + 1]}, 1.0, 20.0));
+				}
+			}
+		}
+	}
+} softLinkMeshScenario;
+
+// An n by n field of rocks as terrain with a fixed number of boxes bouncing over it, the tree of terrain parts grows with n
+class TerrainScenario : public ScenarioBenchmark {
+public:
+	TerrainScenario() : ScenarioBenchmark("scenario.terrain", 1000, 40) {}
+
+	void build(int n) override {
+		Shape rock = polyhedronShape(ShapeLibrary::icosahedron.scaled(4.0f, 4.0f, 4.0f));
+		std::mt19937 random(1);
+		std::uniform_real_distribution<double> unit(0.0, 1.0);
+		for(int x = 0; x < n; x++) {
+			for(int z = 0; z < n; z++) {
+				Position position((x - n / 2.0 + unit(random)) * 3.0, unit(random), (z - n / 2.0 + unit(random)) * 3.0);
+				GlobalCFrame cframe(position, Rotation::fromEulerAngles(unit(random) * 3.1415, unit(random) * 3.1415, unit(random) * 3.1415));
+				world.addTerrainPart(new Part(rock, cframe, {1.0, 1.0, 0.3}));
+			}
+		}
+
+		Shape box = boxShape(0.8, 0.8, 0.8);
+		for(int i = 0; i < 100; i++) {
+			world.addPart(new Part(box, GlobalCFrame(i % 10 * 2.0 - 10.0, 6.0, i / 10 * 2.0 - 10.0), basicProperties));
+		}
+	}
+} terrainScenario;
+
+// Four layers of n boxes each that only collide with the next layer, the colissionMask between layers instead of within one tree
+class MultiLayerScenario : public ScenarioBenchmark {
+public:
+	MultiLayerScenario() : ScenarioBenchmark("scenario.multiLayer", 1000, 100) {}
+
+	void build(int n) override {
+		static const int LAYER_COUNT = 4;
+		// the layers stay when the world is reset for the next run
+		while(world.getLayerCount() < LAYER_COUNT) {
+			world.createLayer(true, false);
+		}
+		for(int layer = 0; layer < LAYER_COUNT; layer++) {
+			world.setLayersCollide(layer, (layer + 1) % LAYER_COUNT, true);
+		}
+
+		Shape floor = boxShape(40.0, 1.0, 40.0);
+		Shape box = boxShape(0.9, 0.9, 0.9);
+		int side = static_cast<int>(std::ceil(std::sqrt(n)));
+		for(int layer = 0; layer < LAYER_COUNT; layer++) {
+			world.addTerrainPart(new Part(floor, GlobalCFrame(0.0, 0.0, 0.0), basicProperties), layer);
+			for(int i = 0; i < n; i++) {
+				GlobalCFrame cframe(i % side * 1.2 - side * 0.6 + layer * 0.3, 1.0 + layer * 1.0, i / side * 1.2 - side * 0.6);
+				world.addPart(new Part(box, cframe, basicProperties), layer);
+			}
+		}
+	}
+} multiLayerScenario;
+};
@@ -0,0 +1,155 @@
+#include "worldBenchmark.h"
+
+#include <Physics3D/geometry/shape.h>
+#include <Physics3D/geometry/shapeCreation.h>
+#include <Physics3D/geometry/triangleMesh.h>
+#include "../util/log.h"
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace P3D {
+// size x size unit cells of rolling hills in the xz plane, centered on the origin
+static TriangleMesh createHillsMesh(int size) {
+	EditableMesh mesh((size + 1) * (size + 1), 2 * size * size);
+	for(int z = 0; z <= size; z++) {
+		for(int x = 0; x <= size; x++) {
+			float height = 2.0f * std::sin(x * 0.2f) * std::cos(z * 0.15f);
+			mesh.setVertex(z * (size + 1) + x, x - size / 2.0f, height, z - size / 2.0f);
+		}
+	}
+	for(int z = 0; z < size; z++) {
+		for(int x = 0; x < size; x++) {
+			int corner = z * (size + 1) + x;
+			mesh.setTriangle(2 * (z * size + x), corner, corner + size + 1, corner + 1);
+			mesh.setTriangle(2 * (z * size + x) + 1, corner + 1, corner + size + 1, corner + size + 2);
+		}
+	}
+	return TriangleMesh(std::move(mesh));
+}
+
+// the heights of createHillsMesh, indexed [z * (size + 1) + x]
+static std::vector<float> createHillsHeights(int size) {
+	std::vector<float> heights((size + 1) * (size + 1));
+	for(int z = 0; z <= size; z++) {
+		for(int x = 0; x <= size; x++) {
+			heights[z * (size + 1) + x] = 2.0f * std::sin(x * 0.2f) * std::cos(z * 0.15f);
+		}
+	}
+	return heights;
+}
+
+// Rays cast down at a 256x256 terrain from random points above it, through the hierarchy of the shape or over every triangle
+class TerrainMeshRaycastBenchmark : public Benchmark {
+	bool bruteForce;
+	TriangleMesh mesh;
+	Shape shape;
+	std::vector<Vec3> origins;
+	std::vector<Vec3> directions;
+	int hitCount = 0;
+
+public:
+	TerrainMeshRaycastBenchmark(const char* name, bool bruteForce) : Benchmark(name), bruteForce(bruteForce) {}
+
+	void init() override {
+		mesh = createHillsMesh(256);
+		shape = triangleMeshShape(mesh);
+		std::mt19937 random(1);
+		std::uniform_real_distribution<double> coordinate(-128.0, 128.0);
+		std::uniform_real_distribution<double> slope(-0.5, 0.5);
+		int rayCount = bruteForce ? 100 : 100000;
+		origins.clear();
+		directions.clear();
+		for(int i = 0; i < rayCount; i++) {
+			origins.push_back(Vec3(coordinate(random), 10.0, coordinate(random)));
+			directions.push_back(normalize(Vec3(slope(random), -1.0, slope(random))));
+		}
+	}
+	void run() override {
+		// the shape is centered on the bounds of the mesh, which only differ in height
+		Vec3 center = mesh.getBounds().getCenter();
+		hitCount = 0;
+		for(std::size_t i = 0; i < origins.size(); i++) {
+			double distance = bruteForce ? mesh.getIntersectionDistance(origins[i], directions[i]) : shape.getIntersectionDistance(origins[i] - center, directions[i]);
+			if(distance != std::numeric_limits<double>::max()) hitCount++;
+		}
+	}
+	void printResults(double timeTaken) override {
+		Log::print("%d rays against %d triangles, %d hits, %.3fus per ray\n", static_cast<int>(origins.size()), mesh.triangleCount, hitCount, timeTaken * 1000.0 / origins.size());
+	}
+};
+
+TerrainMeshRaycastBenchmark terrainMeshRaycast("terrainMeshRaycast", false);
+TerrainMeshRaycastBenchmark terrainMeshRaycastBruteForce("terrainMeshRaycastBruteForce", true);
+
+// The rays of terrainMeshRaycast against the same hills as a heightfield
+class HeightfieldRaycastBenchmark : public Benchmark {
+	Shape shape;
+	Vec3 center;
+	std::vector<Vec3> origins;
+	std::vector<Vec3> directions;
+	int hitCount = 0;
+
+public:
+	HeightfieldRaycastBenchmark() : Benchmark("heightfieldRaycast") {}
+
+	void init() override {
+		std::vector<float> heights = createHillsHeights(256);
+		shape = heightfieldShape(heights.data(), 257, 257, 1.0);
+		center = createHillsMesh(256).getBounds().getCenter();
+		std::mt19937 random(1);
+		std::uniform_real_distribution<double> coordinate(-128.0, 128.0);
+		std::uniform_real_distribution<double> slope(-0.5, 0.5);
+		origins.clear();
+		directions.clear();
+		for(int i = 0; i < 100000; i++) {
+			origins.push_back(Vec3(coordinate(random), 10.0, coordinate(random)));
+			directions.push_back(normalize(Vec3(slope(random), -1.0, slope(random))));
+		}
+	}
+	void run() override {
+		hitCount = 0;
+		for(std::size_t i = 0; i < origins.size(); i++) {
+			if(shape.getIntersectionDistance(origins[i] - center, directions[i]) != std::numeric_limits<double>::max()) hitCount++;
+		}
+	}
+	void printResults(double timeTaken) override {
+		Log::print("%d rays, %d hits, %.3fus per ray\n", static_cast<int>(origins.size()), hitCount, timeTaken * 1000.0 / origins.size());
+	}
+} heightfieldRaycast;
+
+// Boxes dropped onto a single 128x128 triangle mesh terrain part
+class TerrainMeshWorldBenchmark : public WorldBenchmark {
+public:
+	TerrainMeshWorldBenchmark() : WorldBenchmark("terrainMeshWorld", 1000) {}
+
+	void init() override {
+		resetWorld();
+		for(int x = -5; x < 5; x++) {
+			for(int z = -5; z < 5; z++) {
+				world.addPart(new Part(boxShape(1.0, 1.0, 1.0), GlobalCFrame(x * 3.0, 5.0, z * 3.0, Rotation::fromEulerAngles(0.3 * x, 0.2, 0.3 * z)), basicProperties));
+			}
+		}
+		world.addTerrainPart(new Part(triangleMeshShape(createHillsMesh(128)), GlobalCFrame(), basicProperties));
+	}
+} terrainMeshWorld;
+
+// The boxes of terrainMeshWorld dropped onto the same hills as a heightfield
+class HeightfieldWorldBenchmark : public WorldBenchmark {
+public:
+	HeightfieldWorldBenchmark() : WorldBenchmark("heightfieldWorld", 1000) {}
+
+	void init() override {
+		resetWorld();
+		for(int x = -5; x < 5; x++) {
+			for(int z = -5; z < 5; z++) {
+				world.addPart(new Part(boxShape(1.0, 1.0, 1.0), GlobalCFrame(x * 3.0, 5.0, z * 3.0, Rotation::fromEulerAngles(0.3 * x, 0.2, 0.3 * z)), basicProperties));
+			}
+		}
+		std::vector<float> heights = createHillsHeights(128);
+		world.addTerrainPart(new Part(heightfieldShape(heights.data(), 129, 129, 1.0), GlobalCFrame(), basicProperties));
+	}
+} heightfieldWorld;
+};
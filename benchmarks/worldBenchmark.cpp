@@ -4,6 +4,7 @@
 #include "../util/terminalColor.h"
 #include <iostream>
 #include <sstream>
+#include <chrono>
 #include <cstddef>
 #include <Physics3D/externalforces/directionalGravity.h>
 
@@ -14,6 +15,7 @@
 #include <Physics3D/geometry/shapeLibrary.h>
 #include <Physics3D/boundstree/filters/outOfBoundsFilter.h>
 #include <Physics3D/misc/physicsProfiler.h>
+#include <Physics3D/softlinks/softLink.h>
 
 #include <Physics3D/world.h>
 #include <Physics3D/worldIteration.h>
@@ -40,11 +42,13 @@ void WorldBenchmark::run() {
 			Log::print("%d/%d parts out of bounds!\n", partsOutOfBounds, world.getPartCount());
 		}
 
-		physicsMeasure.mark(PhysicsProcess::OTHER);
+		auto tickStart = std::chrono::high_resolution_clock::now();
+		physicsMeasure.startTick();
 
 		world.tick();
 
-		physicsMeasure.end();
+		physicsMeasure.endTick();
+		tickMillis.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tickStart).count());
 
 		GJKCollidesIterationStatistics.nextTally();
 		GJKNoCollidesIterationStatistics.nextTally();
@@ -158,7 +162,7 @@ void WorldBenchmark::printResults(double timeTakenMillis) {
 	double millis[physicsMeasure.size()];
 
 	for(std::size_t i = 0; i < physicsMeasure.size(); i++) {
-		millis[i] = physicsBreakdown[i].count() / 1000000.0;
+		millis[i] = std::chrono::duration<double, std::milli>(physicsBreakdown[i]).count();
 	}
 
 	setColor(TerminalColor::WHITE);
@@ -176,6 +180,17 @@ void WorldBenchmark::printResults(double timeTakenMillis) {
 }
 
 
+void WorldBenchmark::resetWorld() {
+	for(SoftLink* link : world.softLinks) {
+		delete link;
+	}
+	world.softLinks.clear();
+	std::vector<ExternalForce*> forces = world.externalForces;
+	world.clear();
+	world.externalForces = forces;
+	world.age = 0;
+}
+
 void WorldBenchmark::createFloor(double w, double h, double wallHeight) {
 	world.addTerrainPart(new Part(boxShape(w, 1.0, h), GlobalCFrame(0.0, 0.0, 0.0), basicProperties));
 	world.addTerrainPart(new Part(boxShape(0.8, wallHeight, h), GlobalCFrame(w, wallHeight / 2, 0.0), basicProperties));
@@ -16,6 +16,8 @@ public:
 	virtual void run() override;
 	virtual void printResults(double timeTaken) override;
 
+	// removes everything the previous init added, keeps the gravity
+	void resetWorld();
 	void createFloor(double w, double h, double wallHeight);
 };
 };
@@ -1,15 +1,22 @@
 #pragma once
 
-#include <set>
+#include <array>
 #include <queue>
+#include <atomic>
+#include <memory>
+#include <thread>
 #include <vector>
+#include <cassert>
 #include <cstdint>
+#include <utility>
+#include <algorithm>
 #include <type_traits>
 #include <unordered_map>
 #include "../util/typetraits.h"
 #include "../util/iteratorUtils.h"
 #include "../util/stringUtil.h"
 #include "../Physics3D/datastructures/smartPointers.h"
+#include "../Physics3D/threading/threadPool.h"
 
 namespace P3D::Engine {
 
@@ -90,23 +97,216 @@ public:
 	// Member types                                                                        //
 	//-------------------------------------------------------------------------------------//
 
-private:
-	struct entity_compare {
-		bool operator()(const representation_type& left, const representation_type& right) const noexcept {
-			return self(left) < self(right);
+public:
+	/**
+	 * Sparse set of the components of a single type. The owners and components are stored in dense arrays, the sparse array maps
+	 * the self id of an entity to the first of its components in the dense arrays. Multiple components of the same type on one
+	 * entity are chained through the next array, in the order in which they were added.
+	 */
+	struct component_pool {
+		// self id -> dense index + 1 of the first component of the entity, 0 if the entity has no such component
+		std::vector<std::size_t> sparse;
+
+		std::vector<entity_type> dense;
+		std::vector<IRef<RC>> values;
+
+		// dense index -> dense index + 1 of the next component of the same entity, 0 if this is the last one
+		std::vector<std::size_t> next;
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			return dense.size();
+		}
+
+		[[nodiscard]] std::size_t first(const entity_type& entity) const noexcept {
+			return entity < sparse.size() ? sparse[entity] : 0;
+		}
+
+		[[nodiscard]] bool contains(const entity_type& entity) const noexcept {
+			return first(entity) != 0;
+		}
+
+		/**
+		 * Returns whether the component at the given dense index is the first component of its entity
+		 */
+		[[nodiscard]] bool isFirst(std::size_t index) const noexcept {
+			return sparse[dense[index]] == index + 1;
+		}
+
+		[[nodiscard]] std::size_t count(const entity_type& entity) const noexcept {
+			std::size_t result = 0;
+			for (std::size_t slot = first(entity); slot != 0; slot = next[slot - 1])
+				result++;
+
+			return result;
+		}
+
+		void insert(const entity_type& entity, IRef<RC>&& value) {
+			if (entity >= sparse.size())
+				sparse.resize(static_cast<std::size_t>(entity) + 1, 0);
+
+			dense.push_back(entity);
+			values.push_back(std::move(value));
+			next.push_back(0);
+
+			// Append to the end of the chain to keep the insertion order
+			std::size_t* link = &sparse[entity];
+			while (*link != 0)
+				link = &next[*link - 1];
+			*link = dense.size();
+		}
+
+		/**
+		 * Removes the first component of the given entity, returns whether a component was removed
+		 */
+		bool eraseFirst(const entity_type& entity) noexcept {
+			std::size_t slot = first(entity);
+			if (slot == 0)
+				return false;
+
+			sparse[entity] = next[slot - 1];
+			erase(slot - 1);
+
+			return true;
+		}
+
+		void eraseAll(const entity_type& entity) noexcept {
+			while (eraseFirst(entity));
+		}
+
+	private:
+		// Fills the hole left by an unlinked component with the last component
+		void erase(std::size_t index) noexcept {
+			std::size_t last = dense.size() - 1;
+			if (index != last) {
+				std::size_t* link = &sparse[dense[last]];
+				while (*link != last + 1)
+					link = &next[*link - 1];
+				*link = index + 1;
+
+				dense[index] = dense[last];
+				values[index] = std::move(values[last]);
+				next[index] = next[last];
+			}
+
+			dense.pop_back();
+			values.pop_back();
+			next.pop_back();
+		}
+	};
+
+	/**
+	 * Iterates backwards over the owners in the dense array of a component pool, starting at the given index. Removing the
+	 * components of the current entity only moves already visited components into its place, and components added while
+	 * iterating are not visited. The end iterator has index npos, one before the first element.
+	 * Removing the components of any other entity is not supported, it may move an already visited entity in front of the
+	 * iterator, which is then visited a second time. Collect such entities and remove them after iterating.
+	 */
+	struct component_pool_iterator {
+		static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+		const component_pool* pool = nullptr;
+		std::size_t index = npos;
+
+		component_pool_iterator() = default;
+		component_pool_iterator(const component_pool* pool, std::size_t index) : pool(pool), index(index) {}
+
+		component_pool_iterator& operator++() noexcept {
+			// the pool may have shrunk below the current index, 0 - 1 wraps around to npos
+			index = std::min(index, pool->size()) - 1;
+
+			return *this;
+		}
+
+		bool operator!=(const component_pool_iterator& other) const noexcept {
+			return index != other.index;
+		}
+
+		bool operator==(const component_pool_iterator& other) const noexcept {
+			return !(*this != other);
+		}
+
+		const entity_type& operator*() const noexcept {
+			return pool->dense[index];
+		}
+	};
+
+	/**
+	 * Iterates over the chain of components of a single entity in a component pool
+	 */
+	struct component_chain_iterator {
+		const component_pool* pool = nullptr;
+		std::size_t slot = 0;
+
+		component_chain_iterator() = default;
+		component_chain_iterator(const component_pool* pool, std::size_t slot) : pool(pool), slot(slot) {}
+
+		component_chain_iterator& operator++() noexcept {
+			slot = pool->next[slot - 1];
+
+			return *this;
+		}
+
+		bool operator!=(const component_chain_iterator& other) const noexcept {
+			return slot != other.slot;
+		}
+
+		bool operator==(const component_chain_iterator& other) const noexcept {
+			return slot == other.slot;
+		}
+
+		const IRef<RC>& operator*() const noexcept {
+			return pool->values[slot - 1];
+		}
+	};
+
+	using entity_vector = std::vector<representation_type>;
+
+	/**
+	 * Iterates over the alive entities in order of their self id, stays valid when new entities are created
+	 */
+	struct entity_iterator {
+		const entity_vector* entities = nullptr;
+		std::size_t index = 0;
+
+		entity_iterator() = default;
+		entity_iterator(const entity_vector* entities, std::size_t index) : entities(entities), index(index) {
+			skip();
+		}
+
+		entity_iterator& operator++() noexcept {
+			++index;
+			skip();
+
+			return *this;
+		}
+
+		bool operator!=(const entity_iterator& other) const noexcept {
+			return index != other.index && index < entities->size();
+		}
+
+		bool operator==(const entity_iterator& other) const noexcept {
+			return !(*this != other);
+		}
+
+		const representation_type& operator*() const noexcept {
+			return (*entities)[index];
+		}
+
+	private:
+		// Free ids are stored as 0
+		void skip() noexcept {
+			while (index < entities->size() && (*entities)[index] == 0)
+				++index;
 		}
 	};
 
-public:
-	using entity_set = std::set<representation_type, entity_compare>;
 	using entity_queue = std::queue<entity_type>;
-	using entity_map = std::unordered_multimap<entity_type, IRef<RC>>;
 	using type_map = std::unordered_map<component_type, std::string>;
-	using component_vector = std::vector<entity_map*>;
+	using component_vector = std::vector<std::unique_ptr<component_pool>>;
 
 	using component_vector_iterator = decltype(std::declval<component_vector>().begin());
-	using component_map_iterator = decltype(std::declval<entity_map>().begin());
-	using entity_set_iterator = decltype(std::declval<entity_set>().begin());
+	using component_map_iterator = component_chain_iterator;
+	using entity_set_iterator = entity_iterator;
 
 	// Null entity
 	inline static entity_type null_entity = static_cast<entity_type>(0u);
@@ -117,7 +317,8 @@ public:
 	//-------------------------------------------------------------------------------------//
 
 private:
-	entity_set entities;
+	// self id -> entity representation, 0 for free ids
+	entity_vector entities;
 	component_vector components;
 	type_map type_mapping;
 
@@ -137,7 +338,7 @@ private:
 	template <typename Type>
 	struct type_index {
 		static Type next() noexcept {
-			static Type value{};
+			static std::atomic<Type> value{};
 			return value++;
 		}
 	};
@@ -168,23 +369,6 @@ private:
 	}
 
 
-	//-------------------------------------------------------------------------------------//
-	// View iterators                                                                      //
-	//-------------------------------------------------------------------------------------//
-
-public:
-	struct component_iterator : component_map_iterator {
-	public:
-		component_iterator() = default;
-
-		explicit component_iterator(component_map_iterator&& iterator) : component_map_iterator(std::move(iterator)) {}
-
-		auto& operator*() const {
-			return component_map_iterator::operator*().first;
-		}
-	};
-
-
 	//-------------------------------------------------------------------------------------//
 	// View types                                                                          //
 	//-------------------------------------------------------------------------------------//
@@ -210,12 +394,8 @@ public:
 	struct only {
 		template <typename UnsafeComponent>
 		static IRef<UnsafeComponent> get(Registry<Entity>* registry, const entity_type& entity) {
-			if (std::is_same_v<UnsafeComponent, Component>) {
-				component_type index = registry->getComponentIndex<Component>();
-				entity_map* map = registry->components[index];
-
-				auto component_iterator = map->find(entity);
-				return intrusive_cast<UnsafeComponent>(component_iterator->second);
+			if constexpr (std::is_same_v<UnsafeComponent, Component>) {
+				return registry->getFirst<UnsafeComponent>(entity);
 			} else {
 				return registry->get<UnsafeComponent>(entity);
 			}
@@ -231,12 +411,8 @@ public:
 	struct conj {
 		template <typename Component>
 		static IRef<Component> get(Registry<Entity>* registry, const entity_type& entity) {
-			if (is_part_of<Component, Components...>) {
-				component_type index = registry->getComponentIndex<Component>();
-				entity_map* map = registry->components[index];
-
-				auto component_iterator = map->find(entity);
-				return intrusive_cast<Component>(component_iterator->second);
+			if constexpr (is_part_of<Component, Components...>) {
+				return registry->getFirst<Component>(entity);
 			} else {
 				return registry->get<Component>(entity);
 			}
@@ -269,6 +445,112 @@ public:
 	struct neg;
 
 
+	//-------------------------------------------------------------------------------------//
+	// Component access                                                                    //
+	//-------------------------------------------------------------------------------------//
+
+public:
+	template <typename... Components>
+	struct reads {};
+
+	template <typename... Components>
+	struct writes {};
+
+	/**
+	 * The components a system reads and writes, two systems may only run concurrently if neither writes a component the other one accesses
+	 */
+	struct component_access {
+		std::vector<component_type> read_components;
+		std::vector<component_type> write_components;
+
+		[[nodiscard]] bool canRead(const component_type& component) const noexcept {
+			return canWrite(component) || std::find(read_components.begin(), read_components.end(), component) != read_components.end();
+		}
+
+		[[nodiscard]] bool canWrite(const component_type& component) const noexcept {
+			return std::find(write_components.begin(), write_components.end(), component) != write_components.end();
+		}
+
+		[[nodiscard]] bool conflictsWith(const component_access& other) const noexcept {
+			for (component_type component : write_components) {
+				if (other.canRead(component))
+					return true;
+			}
+
+			for (component_type component : other.write_components) {
+				if (canRead(component))
+					return true;
+			}
+
+			return false;
+		}
+	};
+
+	/**
+	 * Marks the given access as the access of the system running on this thread until the scope ends. In debug builds the registry
+	 * asserts that the running system only touches the components it declared and does not create or destroy entities.
+	 */
+	class access_scope {
+	private:
+		const component_access* previous;
+
+	public:
+		explicit access_scope(const component_access* access) : previous(active_access) {
+			active_access = access;
+		}
+
+		~access_scope() {
+			active_access = previous;
+		}
+
+		access_scope(const access_scope&) = delete;
+		access_scope& operator=(const access_scope&) = delete;
+	};
+
+private:
+	inline static thread_local const component_access* active_access = nullptr;
+
+	// Registers the components as well, so a running system never has to add a component type to the registry
+	template <typename... Components>
+	void collect_components(type<reads<Components...>>, std::vector<component_type>& result) {
+		(result.push_back(getComponentIndex<Components>()), ...);
+	}
+
+	template <typename... Components>
+	void collect_components(type<writes<Components...>>, std::vector<component_type>& result) {
+		(result.push_back(getComponentIndex<Components>()), ...);
+	}
+
+	void checkAccess([[maybe_unused]] const component_type& component, [[maybe_unused]] bool write) const noexcept {
+#ifndef NDEBUG
+		if (active_access == nullptr)
+			return;
+
+		if (write)
+			assert(active_access->canWrite(component) && "The running system writes a component it did not declare");
+		else
+			assert(active_access->canRead(component) && "The running system reads a component it did not declare");
+#endif
+	}
+
+	void checkStructuralChange() const noexcept {
+		assert(active_access == nullptr && "Entities can not be created, destroyed or reparented by a running system");
+	}
+
+public:
+	/**
+	 * Returns the access of a system reading the components in Reads and writing the components in Writes
+	 */
+	template <typename Reads, typename Writes = writes<>>
+	[[nodiscard]] component_access access() {
+		component_access result;
+		collect_components(type<Reads>{}, result.read_components);
+		collect_components(type<Writes>{}, result.write_components);
+
+		return result;
+	}
+
+
 	//-------------------------------------------------------------------------------------//
 	// Basic view                                                                          //
 	//-------------------------------------------------------------------------------------//
@@ -306,14 +588,23 @@ public:
 		auto getAll(const entity_type& entity) {
 			return ViewType::template getAll<Component>(this->registry, entity);
 		}
+
+		/**
+		 * Calls the given function with every entity in this view
+		 */
+		template <typename Function>
+		void each(Function&& function) const {
+			for (auto iterator = start; iterator != stop; ++iterator)
+				function(*iterator);
+		}
 	};
 
 	entity_set_iterator begin() noexcept {
-		return entities.begin();
+		return entity_set_iterator(&this->entities, 0);
 	}
 
 	entity_set_iterator end() noexcept {
-		return entities.end();
+		return entity_set_iterator(&this->entities, this->entities.size());
 	}
 
 
@@ -347,22 +638,73 @@ private:
 		extract_smallest_component<Components...>(smallest_component, smallest_size, other_components);
 	}
 
-	template <typename... Components>
-	std::enable_if_t<sizeof...(Components) == 0> insert_entities(entity_set& entities) {}
+	/**
+	 * Returns the component pool of the given type
+	 */
+	template <typename Component>
+	[[nodiscard]] component_pool& getPool(bool write = false) {
+		component_type index = getComponentIndex<Component>();
+		checkAccess(index, write);
 
-	template <typename Component, typename... Components>
-	void insert_entities(entity_set& entities) noexcept {
-		std::size_t component = getComponentIndex<Component>();
+		return *this->components[index];
+	}
 
-		entity_map* map = this->components[component];
-		if (map != nullptr) {
-			component_iterator first(map->begin());
-			component_iterator last(map->end());
+	template <typename... Components, typename Function, std::size_t... Indices>
+	static void invoke_each(Function& function, const entity_type& entity, const std::array<component_pool*, sizeof...(Components)>& pools, std::index_sequence<Indices...>) {
+		function(entity, static_cast<Components&>(*pools[Indices]->values[pools[Indices]->first(entity) - 1])...);
+	}
 
-			entities.insert(first, last);
+	/**
+	 * Calls the function for every entity with all components whose first component lies in the given dense range of the leading pool.
+	 * The range is walked backwards, so the function may remove the components of the entity it is called for, but not those of other entities, see component_pool_iterator.
+	 */
+	template <typename... Components, typename Function>
+	static void each_in_range(Function& function, const std::array<component_pool*, sizeof...(Components)>& pools, std::size_t lead, std::size_t first, std::size_t last) {
+		const component_pool& leading_pool = *pools[lead];
+		for (std::size_t index = last; index > first;) {
+			index = std::min(index, leading_pool.size());
+			if (index-- <= first)
+				break;
+
+			if (!leading_pool.isFirst(index))
+				continue;
+
+			entity_type entity = leading_pool.dense[index];
+			bool matches = true;
+			for (const component_pool* pool : pools) {
+				if (!pool->contains(entity)) {
+					matches = false;
+					break;
+				}
+			}
+
+			if (matches)
+				invoke_each<Components...>(function, entity, pools, std::index_sequence_for<Components...>{});
+		}
+	}
+
+	template <typename... Components>
+	[[nodiscard]] static std::size_t smallest_pool(const std::array<component_pool*, sizeof...(Components)>& pools) noexcept {
+		std::size_t lead = 0;
+		for (std::size_t index = 1; index < pools.size(); index++) {
+			if (pools[index]->size() < pools[lead]->size())
+				lead = index;
 		}
 
-		insert_entities<Components...>(entities);
+		return lead;
+	}
+
+	/**
+	 * Returns the first component of the given type from an entity which is known to have one
+	 */
+	template <typename Component>
+	[[nodiscard]] IRef<Component> getFirst(const entity_type& entity) {
+		component_pool& pool = getPool<Component>();
+		std::size_t slot = pool.first(entity);
+		if (slot == 0)
+			return IRef<Component>();
+
+		return intrusive_cast<Component>(pool.values[slot - 1]);
 	}
 
 	template <typename ViewType, typename Iterator, typename Filter>
@@ -460,16 +802,21 @@ public:
 	*/
 	template <typename Component>
 	[[nodiscard]] component_type getComponentIndex() {
-		component_type index = component_index<Component>::index();
+		using component = std::remove_const_t<Component>;
+
+		component_type index = component_index<component>::index();
+		if (index >= this->type_mapping.size() || index >= this->components.size())
+			assert(active_access == nullptr && "Component types must be registered before systems run, declare them in the access of the system");
+
 		if (index >= this->type_mapping.size()) {
-			std::string fullName = Util::typeName<Component>();
+			std::string fullName = Util::typeName<component>();
 			std::string camelCase = Util::demangle(fullName);
 			std::string name = Util::decamel(camelCase);
 			this->type_mapping.insert(std::make_pair(index, name));
 		}
 
 		while (index >= this->components.size())
-			this->components.push_back(new entity_map());
+			this->components.push_back(std::make_unique<component_pool>());
 
 		return index;
 	}
@@ -503,6 +850,8 @@ public:
 	 * Creates a new entity with an empty parent and adds it to the registry
 	 */
 	[[nodiscard]] entity_type create(const entity_type& parent = null_entity) noexcept {
+		checkStructuralChange();
+
 		representation_type id;
 		if (this->id_queue.empty()) {
 			id = merge(parent, nextID());
@@ -514,9 +863,12 @@ public:
 			this->id_queue.pop();
 		}
 
-		this->entities.insert(id);
+		entity_type entity = self(id);
+		if (entity >= this->entities.size())
+			this->entities.resize(static_cast<std::size_t>(entity) + 1, 0);
+		this->entities[entity] = id;
 
-		return static_cast<entity_type>(id);
+		return entity;
 	}
 
 	/**
@@ -526,18 +878,15 @@ public:
 		if (entity == null_entity)
 			return null_entity;
 
-		auto entities_iterator = this->entities.find(static_cast<representation_type>(entity));
-		if (entities_iterator != this->entities.end()) {
-			this->entities.erase(entities_iterator);
+		checkStructuralChange();
+
+		if (contains(entity)) {
+			this->entities[entity] = 0;
 			id_queue.push(entity);
 
-			for (entity_map* map : this->components) {
-				auto component_iterator = map->find(entity);
-				if (component_iterator != map->end()) {
-					// the component's intrusive_ptr will clean up the component
-					map->erase(component_iterator);
-				}
-			}
+			// the component's intrusive_ptr will clean up the component
+			for (std::unique_ptr<component_pool>& pool : this->components)
+				pool->eraseAll(entity);
 
 			return null_entity;
 		}
@@ -550,15 +899,11 @@ public:
 	 */
 	template <typename Component, typename... Args>
 	IRef<Component> add(const entity_type& entity, Args&&... args) noexcept {
-		auto entities_iterator = this->entities.find(static_cast<representation_type>(entity));
-		if (entities_iterator == this->entities.end())
+		if (!contains(entity))
 			return IRef<Component>();
 
 		IRef<Component> component = make_intrusive<Component>(std::forward<Args>(args)...);
-		component_type index = getComponentIndex<Component>();
-
-		entity_map* map = this->components[index];
-		auto result = map->insert(std::make_pair(entity, intrusive_cast<RC>(component)));
+		getPool<Component>(true).insert(entity, intrusive_cast<RC>(component));
 
 		return component;
 	}
@@ -570,19 +915,13 @@ public:
 		if (index >= this->components.size())
 			return false;
 
-		auto entities_iterator = this->entities.find(static_cast<representation_type>(entity));
-		if (entities_iterator == this->entities.end())
+		if (!contains(entity))
 			return false;
 
-		entity_map* map = this->components[index];
-		auto component_iterator = map->find(entity);
-		if (component_iterator == map->end())
-			return false;
+		checkAccess(index, true);
 
-		map->erase(component_iterator);
 		// Todo check if really destroyed
-
-		return true;
+		return this->components[index]->eraseFirst(entity);
 	}
 
 
@@ -605,20 +944,10 @@ public:
 	 */
 	template <typename Component>
 	[[nodiscard]] IRef<Component> get(const entity_type& entity) noexcept {
-		if (entity == null_entity)
-			return IRef<Component>();
-
-		auto entities_iterator = this->entities.find(static_cast<representation_type>(entity));
-		if (entities_iterator == this->entities.end())
-			return IRef<Component>();
-
-		component_type index = getComponentIndex<Component>();
-		entity_map* map = this->components[index];
-		auto component_iterator = map->find(entity);
-		if (component_iterator == map->end())
+		if (!contains(entity))
 			return IRef<Component>();
 
-		return intrusive_cast<Component>(component_iterator->second);
+		return getFirst<Component>(entity);
 	}
 
 	/**
@@ -627,24 +956,15 @@ public:
 	template <typename Component>
 	[[nodiscard]] auto getAll(const entity_type& entity) noexcept {
 		auto transform = [](const component_map_iterator& iterator) {
-			return intrusive_cast<Component>(iterator->second);
+			return intrusive_cast<Component>(*iterator);
 		};
 
-		if (entity == null_entity)
-			return transform_view<only<Component>>(component_map_iterator{}, component_map_iterator{}, transform);
-
-		auto entities_iterator = this->entities.find(static_cast<representation_type>(entity));
-		if (entities_iterator == this->entities.end())
-			return transform_view<only<Component>>(component_map_iterator{}, component_map_iterator{}, transform);
-
-		component_type index = getComponentIndex<Component>();
-		entity_map* map = this->components[index];
-		auto component_range = map->equal_range(entity);
-		if (component_range.first == map->end())
+		if (!contains(entity))
 			return transform_view<only<Component>>(component_map_iterator{}, component_map_iterator{}, transform);
 
-		component_map_iterator first(component_range.first);
-		component_map_iterator last(component_range.second);
+		component_pool& pool = getPool<Component>();
+		component_map_iterator first(&pool, pool.first(entity));
+		component_map_iterator last(&pool, 0);
 
 		return transform_view<only<Component>>(first, last, transform);
 	}
@@ -654,22 +974,20 @@ public:
 	 */
 	template <typename Component, typename... Args>
 	[[nodiscard]] IRef<Component> getOrAdd(const entity_type& entity, Args&&... args) {
-		auto entities_iterator = this->entities.find(static_cast<representation_type>(entity));
-		if (entities_iterator == this->entities.end())
+		if (!contains(entity))
 			return IRef<Component>();
 
-		component_type index = getComponentIndex<Component>();;
-		entity_map* map = this->components[index];
-		auto component_iterator = map->find(entity);
-		if (component_iterator == map->end()) {
+		component_pool& pool = getPool<Component>(true);
+		std::size_t slot = pool.first(entity);
+		if (slot == 0) {
 			IRef<Component> component = make_intrusive<Component>(std::forward<Args>(args)...);
 
-			map->insert(std::make_pair(entity, intrusive_cast<RC>(component)));
+			pool.insert(entity, intrusive_cast<RC>(component));
 
 			return component;
 		}
 
-		return intrusive_cast<Component>(component_iterator->second);
+		return intrusive_cast<Component>(pool.values[slot - 1]);
 	}
 
 	/**
@@ -688,7 +1006,7 @@ public:
 	 * Returns whether the registry contains the given entity
 	 */
 	[[nodiscard]] bool contains(const entity_type& entity) noexcept {
-		return this->entities.find(static_cast<representation_type>(entity)) != entities.end();
+		return entity != null_entity && entity < this->entities.size() && this->entities[entity] != 0;
 	}
 
 	/**
@@ -720,12 +1038,10 @@ public:
 	  *  Returns the number of components with the given component index
 	  */
 	[[nodiscard]] std::size_t count(const entity_type& entity, const component_type& index) noexcept {
-		auto entities_iterator = this->entities.find(static_cast<representation_type>(entity));
-		if (entities_iterator == this->entities.end())
+		if (index >= this->components.size() || !contains(entity))
 			return 0;
 
-		entity_map* map = this->components[index];
-		return map->count(entity);
+		return this->components[index]->count(entity);
 	}
 
 
@@ -744,9 +1060,8 @@ public:
 	 * Returns the parent of the given entity
 	 */
 	[[nodiscard]] constexpr entity_type getParent(const entity_type& entity) {
-		entity_set_iterator iterator = this->entities.find(static_cast<representation_type>(entity));
-		if (iterator != this->entities.end())
-			return parent(*iterator);
+		if (contains(entity))
+			return parent(this->entities[entity]);
 
 		return null_entity;
 	}
@@ -769,21 +1084,15 @@ public:
 	 * Sets the parent of the given entity to the given parent, returns true if successful, returns false if the entity does not exist.
 	 */
 	bool setParent(const entity_type& entity, const entity_type& parent) noexcept {
-		auto entity_iterator = this->entities.find(static_cast<representation_type>(entity));
-		if (entity_iterator == this->entities.end())
+		checkStructuralChange();
+
+		if (!contains(entity))
 			return false;
 
-		if (parent != null_entity) {
-			auto parent_iterator = this->entities.find(parent);
-			if (parent_iterator == this->entities.end())
-				return false;
-		}
+		if (parent != null_entity && !contains(parent))
+			return false;
 
-		representation_type newEntity = merge(parent, entity);
-		auto hint_iterator = entity_iterator;
-		++hint_iterator;
-		this->entities.erase(entity_iterator);
-		this->entities.insert(hint_iterator, newEntity);
+		this->entities[entity] = merge(parent, entity);
 
 		return true;
 	}
@@ -792,10 +1101,10 @@ public:
 	 * Returns the children of the given parent entity
 	 */
 	[[nodiscard]] auto getChildren(const entity_type& entity) noexcept {
-		entity_set_iterator first = this->entities.begin();
-		entity_set_iterator last = this->entities.end();
+		entity_set_iterator first = begin();
+		entity_set_iterator last = end();
 
-		auto filter = [this, entity](const entity_set_iterator& iterator) {
+		auto filter = [entity](const entity_set_iterator& iterator) {
 			return parent(*iterator) == entity;
 		};
 
@@ -827,8 +1136,16 @@ public:
 private:
 	template <typename Component>
 	[[nodiscard]] auto view(type<only<Component>>) noexcept {
-		// Todo make more efficient
-		return view(type<disj<Component>>{});
+		component_pool* pool = &getPool<Component>();
+
+		// Entities with multiple components of this type are only visited once
+		auto filter = [](const component_pool_iterator& iterator) {
+			return iterator.pool->isFirst(iterator.index);
+		};
+
+		component_pool_iterator first(pool, pool->size() - 1);
+		component_pool_iterator last(pool, component_pool_iterator::npos);
+		return filter_view<only<Component>>(first, last, filter);
 	}
 
 	template <typename Component, typename... Components>
@@ -843,23 +1160,30 @@ private:
 
 		extract_smallest_component<Components...>(smallest_component, smallest_size, other_components);
 
-		auto filter = [this, other_components](const component_map_iterator& iterator) {
-			for (component_type component : other_components) {
-				auto component_iterator = this->components[component]->find(iterator->first);
-				if (component_iterator == this->components[component]->end())
+		std::vector<const component_pool*> other_pools;
+		other_pools.reserve(other_components.size());
+		for (component_type component : other_components)
+			other_pools.push_back(this->components[component].get());
+
+		auto filter = [other_pools](const component_pool_iterator& iterator) {
+			if (!iterator.pool->isFirst(iterator.index))
+				return false;
+
+			for (const component_pool* pool : other_pools) {
+				if (!pool->contains(*iterator))
 					return false;
 			}
 
 			return true;
 		};
 
-		auto transform = [](const component_map_iterator& iterator) {
-			return iterator->first;
+		auto transform = [](const component_pool_iterator& iterator) {
+			return *iterator;
 		};
 
-		entity_map* map = this->components[smallest_component];
-		component_map_iterator first(map->begin());
-		component_map_iterator last(map->end());
+		component_pool* pool = this->components[smallest_component].get();
+		component_pool_iterator first(pool, pool->size() - 1);
+		component_pool_iterator last(pool, component_pool_iterator::npos);
 		return filter_transform_view<conj<Component, Components...>>(first, last, filter, transform);
 	}
 
@@ -869,14 +1193,18 @@ private:
 	template <typename... Components>
 	[[nodiscard]] auto view(type<disj<Components...>>) noexcept {
 		static_assert(unique_types<Components...>);
-		entity_set entities;
-		insert_entities<Components...>(entities);
+		std::vector<const component_pool*> pools { &getPool<Components>()... };
+
+		auto filter = [pools](const entity_set_iterator& iterator) {
+			for (const component_pool* pool : pools) {
+				if (pool->contains(self(*iterator)))
+					return true;
+			}
 
-		auto filter = [entities](const entity_set_iterator& iterator) {
-			return entities.find(*iterator) != entities.end();
+			return false;
 		};
 
-		return filter_view<disj<Components...>>(this->entities.begin(), this->entities.end(), filter);
+		return filter_view<disj<Components...>>(begin(), end(), filter);
 	}
 
 public:
@@ -888,20 +1216,17 @@ public:
 		component_vector_iterator last = components.end();
 
 		auto filter = [entity](const component_vector_iterator& iterator) {
-			entity_map* map = *iterator;
-
-			return map->find(entity) != map->end();
+			return (*iterator)->contains(entity);
 		};
 
 		auto transform = [this, first, entity](const component_vector_iterator& iterator) {
-			entity_map* map = *iterator;
-			auto component_range = map->equal_range(entity);
+			const component_pool* pool = iterator->get();
 
-			component_map_iterator firstComponent(component_range.first);
-			component_map_iterator lastComponent(component_range.second);
+			component_map_iterator firstComponent(pool, pool->first(entity));
+			component_map_iterator lastComponent(pool, 0);
 
 			auto component_transform = [](const component_map_iterator& iterator) {
-				return iterator->second;
+				return *iterator;
 			};
 
 			auto result = std::make_pair(std::distance(first, iterator), transform_view<no_type>(firstComponent, lastComponent, component_transform));
@@ -916,8 +1241,8 @@ public:
 	 */
 	template <typename Filter>
 	[[nodiscard]] auto filter(const Filter& filter) {
-		entity_set_iterator first = this->entities.begin();
-		entity_set_iterator last = this->entities.end();
+		entity_set_iterator first = begin();
+		entity_set_iterator last = end();
 
 		return filter_view<no_type, entity_set_iterator>(first, last, filter);
 	}
@@ -927,8 +1252,8 @@ public:
 	 */
 	template <typename Filter>
 	[[nodiscard]] auto filter() {
-		entity_set_iterator first = this->entities.begin();
-		entity_set_iterator last = this->entities.end();
+		entity_set_iterator first = begin();
+		entity_set_iterator last = end();
 
 		auto filter = [this](const entity_set_iterator& iterator) {
 			return !match<Filter>()(*this, *iterator);
@@ -942,8 +1267,8 @@ public:
 	 */
 	template <typename Transform>
 	[[nodiscard]] auto transform(const Transform& transform) {
-		entity_set_iterator first = this->entities.begin();
-		entity_set_iterator last = this->entities.end();
+		entity_set_iterator first = begin();
+		entity_set_iterator last = end();
 
 		return transform_view<no_type, entity_set_iterator>(first, last, transform);
 	}
@@ -953,8 +1278,8 @@ public:
 	 */
 	template <typename Filter, typename Transform>
 	[[nodiscard]] auto filter_transform(const Filter& filter, const Transform& transform) {
-		entity_set_iterator first = this->entities.begin();
-		entity_set_iterator last = this->entities.end();
+		entity_set_iterator first = begin();
+		entity_set_iterator last = end();
 
 		return filter_transform_view<no_type, entity_set_iterator>(first, last, filter, transform);
 	}
@@ -964,8 +1289,8 @@ public:
 	 */
 	template <typename Filter, typename Transform>
 	[[nodiscard]] auto filter_transform(const Transform& transform) {
-		entity_set_iterator first = this->entities.begin();
-		entity_set_iterator last = this->entities.end();
+		entity_set_iterator first = begin();
+		entity_set_iterator last = end();
 
 		auto filter = [](const entity_set_iterator& iterator) {
 			return !match<Filter>()(*iterator);
@@ -974,8 +1299,59 @@ public:
 		return filter_transform_view<no_type, entity_set_iterator>(first, last, filter, transform);
 	}
 
+	/**
+	 * Calls function(entity, Components&...) for every entity having all the given components, in reverse dense order of the smallest component pool.
+	 * The function may remove the components of the entity it is called for, removing those of other entities may visit an entity twice.
+	 * Components passed as const only need read access, the others are handed out mutable and need write access.
+	 */
+	template <typename Component, typename... Components, typename Function>
+	void each(Function&& function) {
+		std::array<component_pool*, sizeof...(Components) + 1> pools { &getPool<Component>(!std::is_const_v<Component>), &getPool<Components>(!std::is_const_v<Components>)... };
+		std::size_t lead = smallest_pool<Component, Components...>(pools);
+
+		each_in_range<Component, Components...>(function, pools, lead, 0, pools[lead]->size());
+	}
+
+	/**
+	 * Like each, but splits the dense range of the smallest component pool over the threads of the given thread pool. The function must be safe to call
+	 * concurrently for different entities, and may not add or remove components of the iterated types. Runs on the calling thread if no thread pool is given.
+	 */
+	template <typename Component, typename... Components, typename Function>
+	void parallel_each(ThreadPool* threadPool, Function&& function) {
+		// Below this many components per chunk the scheduling overhead outweighs the work
+		constexpr std::size_t min_chunk_size = 1024;
+
+		std::array<component_pool*, sizeof...(Components) + 1> pools { &getPool<Component>(!std::is_const_v<Component>), &getPool<Components>(!std::is_const_v<Components>)... };
+		std::size_t lead = smallest_pool<Component, Components...>(pools);
+		std::size_t size = pools[lead]->size();
+
+		if (threadPool == nullptr || size <= min_chunk_size) {
+			each_in_range<Component, Components...>(function, pools, lead, 0, size);
+			return;
+		}
+
+		// A few chunks per thread balance the load when entities are unevenly distributed
+		std::size_t thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+		std::size_t chunk_size = std::max(min_chunk_size, size / (thread_count * 4) + 1);
+		std::size_t chunk_count = (size + chunk_size - 1) / chunk_size;
+
+		std::atomic<std::size_t> next_chunk(0);
+		const component_access* access = active_access;
+		threadPool->doInParallel([&]() {
+			access_scope scope(access);
+
+			std::size_t chunk;
+			while ((chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) < chunk_count) {
+				std::size_t first = chunk * chunk_size;
+				std::size_t last = std::min(first + chunk_size, size);
+				each_in_range<Component, Components...>(function, pools, lead, first, last);
+			}
+		});
+	}
+
 	/**
 	 * Returns an iterator which iterates over all entities which satisfy the view type
+	 * While iterating only the components of the current entity may be removed, see component_pool_iterator.
 	 */
 	template <typename... Type>
 	[[nodiscard]] auto view() noexcept {
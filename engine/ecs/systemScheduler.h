@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <functional>
+#include <string_view>
+#include "registry.h"
+#include "../Physics3D/threading/threadPool.h"
+
+namespace P3D::Engine {
+
+/**
+ * Runs systems over a registry in stages. Every system declares the components it reads and writes, systems in the same stage
+ * do not conflict and run concurrently, conflicting systems keep the order in which they were added.
+ */
+template <typename Entity>
+class SystemScheduler {
+public:
+	using registry_type = Registry<Entity>;
+	using access_type = typename registry_type::component_access;
+
+	// The thread pool is only given to a system running alone in its stage, it may use it for registry.parallel_each
+	using system_function = std::function<void(registry_type&, ThreadPool*)>;
+
+private:
+	struct System {
+		std::string name;
+		access_type access;
+		system_function function;
+		std::size_t stage;
+	};
+
+	registry_type& registry;
+	std::vector<System> systems;
+	std::vector<std::vector<std::size_t>> stages;
+
+	void run(System& system, ThreadPool* threadPool) {
+		typename registry_type::access_scope scope(&system.access);
+		system.function(registry, threadPool);
+	}
+
+public:
+	explicit SystemScheduler(registry_type& registry) : registry(registry) {}
+
+	/**
+	 * Adds a system reading the components in Reads and writing the components in Writes, for example
+	 * scheduler.add<Registry64::reads<Transform>, Registry64::writes<Light>>("lights", function)
+	 * The components are registered here, so no system adds a component type while others run. A system iterates the components
+	 * it only reads as const, registry.each<const Transform, Light>(...)
+	 */
+	template <typename Reads, typename Writes = typename registry_type::template writes<>>
+	void add(const std::string& name, const system_function& function) {
+		access_type access = registry.template access<Reads, Writes>();
+
+		std::size_t stage = 0;
+		for (const System& system : systems) {
+			if (system.stage >= stage && system.access.conflictsWith(access))
+				stage = system.stage + 1;
+		}
+
+		if (stage == stages.size())
+			stages.emplace_back();
+		stages[stage].push_back(systems.size());
+
+		systems.push_back(System { name, std::move(access), function, stage });
+	}
+
+	/**
+	 * Runs all systems, stage after stage
+	 */
+	void run(ThreadPool& threadPool) {
+		for (const std::vector<std::size_t>& stage : stages) {
+			if (stage.size() == 1) {
+				run(systems[stage.front()], &threadPool);
+				continue;
+			}
+
+			std::atomic<std::size_t> next(0);
+			threadPool.doInParallel([&]() {
+				std::size_t index;
+				while ((index = next.fetch_add(1, std::memory_order_relaxed)) < stage.size())
+					run(systems[stage[index]], nullptr);
+			});
+		}
+	}
+
+	[[nodiscard]] const std::vector<std::vector<std::size_t>>& getStages() const noexcept {
+		return stages;
+	}
+
+	[[nodiscard]] std::string_view getName(std::size_t system) const {
+		return systems[system].name;
+	}
+};
+
+typedef SystemScheduler<std::uint16_t> SystemScheduler16;
+typedef SystemScheduler<std::uint32_t> SystemScheduler32;
+typedef SystemScheduler<std::uint64_t> SystemScheduler64;
+
+};
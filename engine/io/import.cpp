@@ -4,8 +4,16 @@
 
 #include <fstream>
 #include <optional>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+#include <thread>
 
 #include "../util/stringUtil.h"
+#include "../util/fileUtils.h"
+#include "../util/mappedFile.h"
+#include <Physics3D/threading/threadPool.h>
 #include <Physics3D/physical.h>
 #include "../graphics/extendedTriangleMesh.h"
 
@@ -114,45 +122,77 @@ T Import::read(std::istream& input) {
 */
 
 struct Vertex {
+	// Zero based indices, -1 if the attribute is absent
 	int position;
-	std::optional<int> normal;
-	std::optional<int> uv;
+	int normal;
+	int uv;
 
-	Vertex() : position(0), normal(std::nullopt), uv(std::nullopt) {}
+	Vertex() : position(0), normal(-1), uv(-1) {}
 
-	Vertex(const std::string_view& line) {
-		std::vector<std::string_view> tokens = Util::split_view(line, '/');
-		size_t length = tokens.size();
+	bool operator==(const Vertex& other) const {
+		return position == other.position && normal == other.normal && uv == other.uv;
+	}
+};
 
-		// Positions
-		position = std::stoi(std::string(tokens[0])) - 1;
+/*
+	Open addressing map from position - uv - normal tuples to their index in the final mesh, indices are handed out in order of first appearance
+*/
+class VertexIndexMap {
+	std::vector<int> slots;
+	std::size_t mask;
+
+	static std::size_t hash(const Vertex& vertex) {
+		uint64_t key = static_cast<uint32_t>(vertex.position);
+		key = key * 0x9E3779B97F4A7C15ULL ^ static_cast<uint32_t>(vertex.uv);
+		key = key * 0x9E3779B97F4A7C15ULL ^ static_cast<uint32_t>(vertex.normal);
+		key ^= key >> 31;
+		key *= 0xBF58476D1CE4E5B9ULL;
+		key ^= key >> 29;
+		return static_cast<std::size_t>(key);
+	}
 
-		// Uvs
-		if (length > 1 && !tokens[1].empty())
-			uv = std::stoi(std::string(tokens[1])) - 1;
+	void grow() {
+		std::size_t capacity = slots.size() * 2;
+		slots.assign(capacity, -1);
+		mask = capacity - 1;
 
-		// Normals
-		if (length > 2 && !tokens[2].empty())
-			normal = std::stoi(std::string(tokens[2])) - 1;
+		for (int index = 0; index < static_cast<int>(vertices.size()); index++) {
+			std::size_t slot = hash(vertices[index]) & mask;
+			while (slots[slot] != -1)
+				slot = (slot + 1) & mask;
+			slots[slot] = index;
+		}
 	}
 
-	bool operator==(const Vertex& other) const {
-		return position == other.position && normal == other.normal && uv == other.uv;
-	}
-};
+public:
+	std::vector<Vertex> vertices;
+
+	explicit VertexIndexMap(std::size_t expectedSize) {
+		std::size_t capacity = 16;
+		while (capacity < expectedSize * 2)
+			capacity *= 2;
 
-struct VertexHasher {
-	size_t operator()(const P3D::Vertex& vertex) const {
+		slots.assign(capacity, -1);
+		mask = capacity - 1;
+		vertices.reserve(expectedSize);
+	}
 
-		size_t result = std::hash<int>()(vertex.position);
+	int getIndex(const Vertex& vertex) {
+		std::size_t slot = hash(vertex) & mask;
+		while (slots[slot] != -1) {
+			if (vertices[slots[slot]] == vertex)
+				return slots[slot];
+			slot = (slot + 1) & mask;
+		}
 
-		if (vertex.normal.has_value())
-			result = result >> 1 ^ std::hash<int>()(vertex.normal.value()) << 1;
+		int index = static_cast<int>(vertices.size());
+		slots[slot] = index;
+		vertices.push_back(vertex);
 
-		if (vertex.uv.has_value())
-			result = result >> 1 ^ std::hash<int>()(vertex.uv.value()) << 1;
+		if (vertices.size() * 2 > slots.size())
+			grow();
 
-		return result;
+		return index;
 	}
 };
 
@@ -213,8 +253,8 @@ Graphics::ExtendedTriangleMesh reorderWithoutSharedVerticesSupport(const std::ve
 		if (uvArray) {
 			Vec3f edge1 = positions[face.vertices[1].position] - positions[face.vertices[0].position];
 			Vec3f edge2 = positions[face.vertices[2].position] - positions[face.vertices[0].position];
-			Vec2f dUV1 = uvs[*face.vertices[1].uv] - uvs[*face.vertices[0].uv];
-			Vec2f dUV2 = uvs[*face.vertices[2].uv] - uvs[*face.vertices[0].uv];
+			Vec2f dUV1 = uvs[face.vertices[1].uv] - uvs[face.vertices[0].uv];
+			Vec2f dUV2 = uvs[face.vertices[2].uv] - uvs[face.vertices[0].uv];
 
 			float f = 1.0f / (dUV1.x * dUV2.y - dUV2.x * dUV1.y);
 
@@ -233,12 +273,12 @@ Graphics::ExtendedTriangleMesh reorderWithoutSharedVerticesSupport(const std::ve
 			const Vertex& vertex = face[vertexIndex];
 
 			// Save normal
-			if (normalArray && vertex.normal.has_value())
-				normalArray[vertex.position] = normals[*vertex.normal];
+			if (normalArray && vertex.normal != -1)
+				normalArray[vertex.position] = normals[vertex.normal];
 
 			// Save uv, tangent and bitangent
-			if (uvArray && vertex.uv.has_value()) {
-				uvArray[vertex.position] = uvs[*vertex.uv];
+			if (uvArray && vertex.uv != -1) {
+				uvArray[vertex.position] = uvs[vertex.uv];
 				tangentArray[vertex.position] = tangent;
 				bitangentArray[vertex.position] = bitangent;
 			}
@@ -255,43 +295,27 @@ Graphics::ExtendedTriangleMesh reorderWithoutSharedVerticesSupport(const std::ve
 }
 
 Graphics::ExtendedTriangleMesh reorderWithSharedVerticesSupport(const std::vector<Vec3f>& positions, const std::vector<Vec3f>& normals, const std::vector<Vec2f>& uvs, const std::vector<Face>& faces) {
-	std::unordered_map<Vertex, int, VertexHasher> mapping;
-
 	// Get index of each vertex - uv - normal tuple
-	auto getIndex = [&mapping] (const Vertex& vertex) -> int {
-		auto iterator = mapping.find(vertex);
-		if (iterator == mapping.end()) {
-			int index = static_cast<int>(mapping.size());
-			mapping.emplace(vertex, index);
-
-			return index;
-		}
-
-		return iterator->second;
-	};
+	VertexIndexMap mapping(positions.size());
 
 	// Fill triangle array
-	Triangle* triangleArray = new Triangle[faces.size()];
+	std::vector<Triangle> triangles(faces.size());
 	for (std::size_t faceIndex = 0; faceIndex < faces.size(); faceIndex++) {
 		const Face& face = faces[faceIndex];
 
-		const Vertex& v0 = face.vertices[0];
-		const Vertex& v1 = face.vertices[1];
-		const Vertex& v2 = face.vertices[2];
-
-		int i0 = getIndex(v0);
-		int i1 = getIndex(v1);
-		int i2 = getIndex(v2);
+		int i0 = mapping.getIndex(face.vertices[0]);
+		int i1 = mapping.getIndex(face.vertices[1]);
+		int i2 = mapping.getIndex(face.vertices[2]);
 
 		// Save triangle
-		triangleArray[faceIndex] = Triangle { i0, i1, i2 };
+		triangles[faceIndex] = Triangle { i0, i1, i2 };
 	}
 
 	// Array size
-	std::size_t size = mapping.size();
+	std::size_t size = mapping.vertices.size();
 
 	// Positions
-	Vec3f* positionArray = new Vec3f[size];
+	std::vector<Vec3f> positionArray(size);
 
 	// Normals
 	Vec3f* normalArray = nullptr;
@@ -304,20 +328,22 @@ Graphics::ExtendedTriangleMesh reorderWithSharedVerticesSupport(const std::vecto
 		uvArray = new Vec2f[size];
 
 	// Fill arrays
-	for (const auto& [vertex, index] : mapping) {
+	for (std::size_t index = 0; index < size; index++) {
+		const Vertex& vertex = mapping.vertices[index];
+
 		// Store position
 		positionArray[index] = positions[vertex.position];
 		
 		// Store normal
-		if (normalArray && vertex.normal.has_value())
-			normalArray[index] = normals[*vertex.normal];
+		if (normalArray && vertex.normal != -1)
+			normalArray[index] = normals[vertex.normal];
 
 		// Store uv
-		if (uvArray && vertex.uv.has_value()) 
-			uvArray[index] = uvs[*vertex.uv];
+		if (uvArray && vertex.uv != -1) 
+			uvArray[index] = uvs[vertex.uv];
 	}
 
-	Graphics::ExtendedTriangleMesh result(positionArray, size, triangleArray, static_cast<int>(faces.size()));
+	Graphics::ExtendedTriangleMesh result(positionArray.data(), static_cast<int>(size), triangles.data(), static_cast<int>(triangles.size()));
 	result.setNormalBuffer(SRef<const Vec3f[]>(normalArray));
 	result.setUVBuffer(SRef<const Vec2f[]>(uvArray));
 
@@ -406,51 +432,430 @@ Graphics::ExtendedTriangleMesh loadBinaryObj(std::istream& input) {
 	return result;
 }
 
-Graphics::ExtendedTriangleMesh loadNonBinaryObj(std::istream& input) {
+/*
+	Text OBJ parsing, the input is split into chunks at line boundaries which are parsed concurrently.
+	Positive face indices are absolute, so the chunks can simply be concatenated in order afterwards. Negative indices count back
+	from the last element defined before the face, a chunk resolves them against its own elements and they are shifted by the
+	elements of the preceding chunks once those are known.
+*/
+
+enum RelativeAttributes : uint8_t {
+	Relative_Position = 1 << 0,
+	Relative_UV       = 1 << 1,
+	Relative_Normal   = 1 << 2
+};
+
+// A face vertex with indices relative to the start of its chunk
+struct RelativeReference {
+	std::size_t face;
+	uint8_t corner;
+	uint8_t attributes;
+};
+
+struct OBJChunk {
 	std::vector<Vec3f> vertices;
 	std::vector<Vec3f> normals;
 	std::vector<Vec2f> uvs;
 	std::vector<Face> faces;
+	std::vector<RelativeReference> relativeReferences;
+};
 
-	std::string line;
-	while (getline(input, line)) {
-		std::vector<std::string_view> tokens = Util::split_view(line, ' ');
+// Chunks smaller than this are not worth handing to another thread
+constexpr std::size_t MIN_OBJ_CHUNK_SIZE = 1 << 18;
 
-		if (tokens.empty())
-			continue;
+static inline bool isBlank(char character) {
+	return character == ' ' || character == '\t' || character == '\r';
+}
+
+static inline const char* skipBlanks(const char* cursor, const char* end) {
+	while (cursor != end && isBlank(*cursor))
+		cursor++;
 
-		if (tokens[0] == "v") {
-			float x = std::stof(std::string(tokens[1]));
-			float y = std::stof(std::string(tokens[2]));
-			float z = std::stof(std::string(tokens[3]));
+	return cursor;
+}
 
-			vertices.emplace_back(x, y, z);
-		} else if (tokens[0] == "f") {
-			Vertex v1(tokens[1]);
-			Vertex v2(tokens[2]);
-			Vertex v3(tokens[3]);
+static inline const char* parseOBJFloat(const char* cursor, const char* end, float& value) {
+	cursor = skipBlanks(cursor, end);
+	if (cursor != end && *cursor == '+')
+		cursor++;
+
+	auto [next, error] = std::from_chars(cursor, end, value);
+	if (error != std::errc()) {
+		value = 0.0f;
+		return cursor;
+	}
+
+	return next;
+}
+
+// Negative indices are resolved against the count elements defined so far in the chunk and mark the attribute as relative
+static inline const char* parseOBJIndex(const char* cursor, const char* end, int& index, std::size_t count, uint8_t attribute, uint8_t& relative) {
+	int value;
+	auto [next, error] = std::from_chars(cursor, end, value);
+	if (error != std::errc())
+		return cursor;
+
+	if (value < 0) {
+		index = static_cast<int>(count) + value;
+		relative |= attribute;
+	} else {
+		index = value - 1;
+	}
+
+	return next;
+}
+
+// Parses a face vertex of the form p, p/t, p//n or p/t/n
+static inline const char* parseOBJFaceVertex(const char* cursor, const char* end, const OBJChunk& chunk, Vertex& vertex, uint8_t& relative) {
+	const char* next = parseOBJIndex(cursor, end, vertex.position, chunk.vertices.size(), Relative_Position, relative);
+	if (next == cursor)
+		return nullptr;
+
+	cursor = next;
+	if (cursor != end && *cursor == '/') {
+		cursor = parseOBJIndex(cursor + 1, end, vertex.uv, chunk.uvs.size(), Relative_UV, relative);
+
+		if (cursor != end && *cursor == '/')
+			cursor = parseOBJIndex(cursor + 1, end, vertex.normal, chunk.normals.size(), Relative_Normal, relative);
+	}
+
+	return cursor;
+}
 
-			faces.emplace_back(v1, v2, v3);
+static void parseOBJChunk(const char* cursor, const char* end, OBJChunk& chunk) {
+	std::vector<Vertex> polygon;
+	std::vector<uint8_t> polygonRelative;
 
-			if (tokens.size() > 4)
-				faces.emplace_back(v1, v3, Vertex(tokens[4]));
-		} else if (tokens[0] == "vt") {
-			float u = std::stof(std::string(tokens[1]));
-			float v = 1.0f - std::stof(std::string(tokens[2]));
+	while (cursor < end) {
+		const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+		if (lineEnd == nullptr)
+			lineEnd = end;
 
-			uvs.emplace_back(u, v);
-		} else if (tokens[0] == "vn") {
-			float x = std::stof(std::string(tokens[1]));
-			float y = std::stof(std::string(tokens[2]));
-			float z = std::stof(std::string(tokens[3]));
+		const char* line = skipBlanks(cursor, lineEnd);
+		cursor = lineEnd + 1;
 
-			normals.emplace_back(x, y, z);
+		if (lineEnd - line < 2)
+			continue;
+
+		if (line[0] == 'v' && isBlank(line[1])) {
+			Vec3f vertex;
+			const char* next = parseOBJFloat(line + 2, lineEnd, vertex.x);
+			next = parseOBJFloat(next, lineEnd, vertex.y);
+			parseOBJFloat(next, lineEnd, vertex.z);
+
+			chunk.vertices.push_back(vertex);
+		} else if (line[0] == 'f' && isBlank(line[1])) {
+			polygon.clear();
+			polygonRelative.clear();
+
+			const char* next = skipBlanks(line + 2, lineEnd);
+			while (next != lineEnd) {
+				Vertex vertex;
+				uint8_t relative = 0;
+				next = parseOBJFaceVertex(next, lineEnd, chunk, vertex, relative);
+				if (next == nullptr)
+					break;
+
+				polygon.push_back(vertex);
+				polygonRelative.push_back(relative);
+				next = skipBlanks(next, lineEnd);
+			}
+
+			// Triangulate polygons as a fan around the first vertex
+			for (std::size_t index = 2; index < polygon.size(); index++) {
+				const std::size_t corners[3] { 0, index - 1, index };
+				for (uint8_t corner = 0; corner < 3; corner++) {
+					if (polygonRelative[corners[corner]] != 0)
+						chunk.relativeReferences.push_back(RelativeReference { chunk.faces.size(), corner, polygonRelative[corners[corner]] });
+				}
+
+				chunk.faces.emplace_back(polygon[0], polygon[index - 1], polygon[index]);
+			}
+		} else if (line[0] == 'v' && line[1] == 't' && lineEnd - line > 2 && isBlank(line[2])) {
+			float u;
+			float v;
+			const char* next = parseOBJFloat(line + 3, lineEnd, u);
+			parseOBJFloat(next, lineEnd, v);
+
+			chunk.uvs.emplace_back(u, 1.0f - v);
+		} else if (line[0] == 'v' && line[1] == 'n' && lineEnd - line > 2 && isBlank(line[2])) {
+			Vec3f normal;
+			const char* next = parseOBJFloat(line + 3, lineEnd, normal.x);
+			next = parseOBJFloat(next, lineEnd, normal.y);
+			parseOBJFloat(next, lineEnd, normal.z);
+
+			chunk.normals.push_back(normal);
+		}
+	}
+}
+
+// Shifts the relative indices of every chunk by the elements defined in the chunks before it
+static void resolveRelativeReferences(std::vector<OBJChunk>& chunks) {
+	int vertexOffset = 0;
+	int uvOffset = 0;
+	int normalOffset = 0;
+	for (OBJChunk& chunk : chunks) {
+		for (const RelativeReference& reference : chunk.relativeReferences) {
+			Vertex& vertex = chunk.faces[reference.face].vertices[reference.corner];
+			if (reference.attributes & Relative_Position)
+				vertex.position += vertexOffset;
+			if (reference.attributes & Relative_UV)
+				vertex.uv += uvOffset;
+			if (reference.attributes & Relative_Normal)
+				vertex.normal += normalOffset;
 		}
+
+		vertexOffset += static_cast<int>(chunk.vertices.size());
+		uvOffset += static_cast<int>(chunk.uvs.size());
+		normalOffset += static_cast<int>(chunk.normals.size());
+	}
+}
+
+template<typename T>
+static std::vector<T> concatenate(std::vector<OBJChunk>& chunks, std::vector<T> OBJChunk::* member) {
+	if (chunks.size() == 1)
+		return std::move(chunks[0].*member);
+
+	std::size_t size = 0;
+	for (const OBJChunk& chunk : chunks)
+		size += (chunk.*member).size();
+
+	std::vector<T> result;
+	result.reserve(size);
+	for (OBJChunk& chunk : chunks) {
+		result.insert(result.end(), (chunk.*member).begin(), (chunk.*member).end());
+		(chunk.*member) = std::vector<T>();
+	}
+
+	return result;
+}
+
+Graphics::ExtendedTriangleMesh loadNonBinaryObj(const char* begin, const char* end) {
+	std::size_t size = end - begin;
+	unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+	std::size_t chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(size / MIN_OBJ_CHUNK_SIZE, threadCount * 4));
+
+	// Split at line boundaries
+	std::vector<const char*> boundaries { begin };
+	for (std::size_t chunkIndex = 1; chunkIndex < chunkCount; chunkIndex++) {
+		const char* boundary = std::max(begin + size * chunkIndex / chunkCount, boundaries.back());
+		const char* newline = static_cast<const char*>(std::memchr(boundary, '\n', end - boundary));
+		if (newline == nullptr)
+			break;
+
+		boundaries.push_back(newline + 1);
+	}
+	boundaries.push_back(end);
+
+	std::vector<OBJChunk> chunks(boundaries.size() - 1);
+	if (chunks.size() == 1) {
+		parseOBJChunk(begin, end, chunks[0]);
+	} else {
+		ThreadPool threadPool(std::min(threadCount, static_cast<unsigned int>(chunks.size())));
+		std::atomic<std::size_t> nextChunk = 0;
+
+		threadPool.doInParallel([&] {
+			while (true) {
+				std::size_t chunkIndex = nextChunk++;
+				if (chunkIndex >= chunks.size())
+					break;
+
+				parseOBJChunk(boundaries[chunkIndex], boundaries[chunkIndex + 1], chunks[chunkIndex]);
+			}
+		});
 	}
 
+	resolveRelativeReferences(chunks);
+
+	std::vector<Vec3f> vertices = concatenate(chunks, &OBJChunk::vertices);
+	std::vector<Vec3f> normals = concatenate(chunks, &OBJChunk::normals);
+	std::vector<Vec2f> uvs = concatenate(chunks, &OBJChunk::uvs);
+	std::vector<Face> faces = concatenate(chunks, &OBJChunk::faces);
+
 	return reorderWithSharedVerticesSupport(vertices, normals, uvs, faces);
 }
 
+Graphics::ExtendedTriangleMesh loadNonBinaryObj(std::istream& input) {
+	std::string content { std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+
+	return loadNonBinaryObj(content.data(), content.data() + content.size());
+}
+
+/*
+	Mesh cache, parsed text meshes are stored next to their source in a binary layout which can be loaded with a single read.
+	An entry belongs to the path of its source and is used when the size and modification time of the source still match, without
+	reading the source. When only the modification time differs, such as after a checkout or a copy, the hash of the source decides,
+	and the entry is updated to the new modification time when it still matches.
+*/
+
+bool OBJImport::cacheEnabled = true;
+
+enum MeshCacheFlags : uint32_t {
+	MeshCache_Normals    = 1 << 0,
+	MeshCache_UVs        = 1 << 1,
+	MeshCache_Tangents   = 1 << 2,
+	MeshCache_Bitangents = 1 << 3
+};
+
+struct MeshCacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t sourceHash;
+	uint64_t sourceSize;
+	int64_t sourceWriteTime;
+	int32_t vertexCount;
+	int32_t triangleCount;
+	uint32_t flags;
+	uint32_t reserved;
+};
+
+constexpr char MESH_CACHE_MAGIC[4] { 'P', '3', 'D', 'M' };
+constexpr uint32_t MESH_CACHE_VERSION = 2;
+
+static std::string getMeshCacheDirectory(const std::string& file) {
+	std::size_t separator = file.find_last_of("/\\");
+	if (separator == std::string::npos)
+		return ".meshcache";
+
+	return file.substr(0, separator + 1) + ".meshcache";
+}
+
+static std::string getMeshCachePath(const std::string& file, uint64_t hash) {
+	char name[32];
+	std::snprintf(name, sizeof(name), "/%016llx.mesh", static_cast<unsigned long long>(hash));
+
+	return getMeshCacheDirectory(file) + name;
+}
+
+static std::size_t getMeshCacheSize(const MeshCacheHeader& header) {
+	std::size_t vertexCount = header.vertexCount;
+	std::size_t size = sizeof(MeshCacheHeader) + vertexCount * sizeof(Vec3f) + header.triangleCount * sizeof(Triangle);
+	if (header.flags & MeshCache_Normals)
+		size += vertexCount * sizeof(Vec3f);
+	if (header.flags & MeshCache_UVs)
+		size += vertexCount * sizeof(Vec2f);
+	if (header.flags & MeshCache_Tangents)
+		size += vertexCount * sizeof(Vec3f);
+	if (header.flags & MeshCache_Bitangents)
+		size += vertexCount * sizeof(Vec3f);
+
+	return size;
+}
+
+template<typename T>
+static SRef<const T[]> readMeshCacheBuffer(const char*& cursor, std::size_t count) {
+	T* buffer = new T[count];
+	std::memcpy(buffer, cursor, count * sizeof(T));
+	cursor += count * sizeof(T);
+
+	return SRef<const T[]>(buffer);
+}
+
+static std::optional<Graphics::ExtendedTriangleMesh> loadCachedMesh(const std::string& path, const std::string& file, long long sourceSize, long long sourceWriteTime, bool& sourceTouched) {
+	Util::MappedFile cache(path);
+	if (!cache.isOpen() || cache.getSize() < sizeof(MeshCacheHeader))
+		return std::nullopt;
+
+	MeshCacheHeader header;
+	std::memcpy(&header, cache.begin(), sizeof(MeshCacheHeader));
+	if (std::memcmp(header.magic, MESH_CACHE_MAGIC, 4) != 0 || header.version != MESH_CACHE_VERSION)
+		return std::nullopt;
+
+	if (sourceSize < 0 || header.sourceSize != static_cast<uint64_t>(sourceSize))
+		return std::nullopt;
+
+	sourceTouched = header.sourceWriteTime != sourceWriteTime;
+	if (sourceTouched) {
+		Util::MappedFile source(file);
+		if (!source.isOpen() || header.sourceHash != Util::hashBytes(source.begin(), source.getSize()))
+			return std::nullopt;
+	}
+
+	if (header.vertexCount < 0 || header.triangleCount < 0 || getMeshCacheSize(header) != cache.getSize())
+		return std::nullopt;
+
+	const char* cursor = cache.begin() + sizeof(MeshCacheHeader);
+	const Vec3f* vertices = reinterpret_cast<const Vec3f*>(cursor);
+	cursor += header.vertexCount * sizeof(Vec3f);
+	const Triangle* triangles = reinterpret_cast<const Triangle*>(cursor);
+	cursor += header.triangleCount * sizeof(Triangle);
+
+	Graphics::ExtendedTriangleMesh result(vertices, header.vertexCount, triangles, header.triangleCount);
+	if (header.flags & MeshCache_Normals)
+		result.setNormalBuffer(readMeshCacheBuffer<Vec3f>(cursor, header.vertexCount));
+	if (header.flags & MeshCache_UVs)
+		result.setUVBuffer(readMeshCacheBuffer<Vec2f>(cursor, header.vertexCount));
+	if (header.flags & MeshCache_Tangents)
+		result.setTangentBuffer(readMeshCacheBuffer<Vec3f>(cursor, header.vertexCount));
+	if (header.flags & MeshCache_Bitangents)
+		result.setBitangentBuffer(readMeshCacheBuffer<Vec3f>(cursor, header.vertexCount));
+
+	return result;
+}
+
+static void updateCachedMeshWriteTime(const std::string& path, long long sourceWriteTime) {
+	int64_t writeTime = sourceWriteTime;
+	std::fstream output(path, std::ios::binary | std::ios::in | std::ios::out);
+	output.seekp(offsetof(MeshCacheHeader, sourceWriteTime));
+	output.write(reinterpret_cast<const char*>(&writeTime), sizeof(writeTime));
+}
+
+static void saveCachedMesh(const std::string& file, const std::string& path, const Util::MappedFile& source, long long sourceWriteTime, const Graphics::ExtendedTriangleMesh& mesh) {
+	if (!Util::createDirectory(getMeshCacheDirectory(file))) {
+		Log::warn("Could not create mesh cache directory for %s", file.c_str());
+		return;
+	}
+
+	MeshCacheHeader header {};
+	std::memcpy(header.magic, MESH_CACHE_MAGIC, 4);
+	header.version = MESH_CACHE_VERSION;
+	header.sourceHash = Util::hashBytes(source.begin(), source.getSize());
+	header.sourceSize = source.getSize();
+	header.sourceWriteTime = sourceWriteTime;
+	header.vertexCount = mesh.vertexCount;
+	header.triangleCount = mesh.triangleCount;
+	header.flags = (mesh.normals != nullptr ? MeshCache_Normals : 0)
+		| (mesh.uvs != nullptr ? MeshCache_UVs : 0)
+		| (mesh.tangents != nullptr ? MeshCache_Tangents : 0)
+		| (mesh.bitangents != nullptr ? MeshCache_Bitangents : 0);
+
+	std::vector<char> buffer(getMeshCacheSize(header));
+	char* cursor = buffer.data();
+	auto append = [&cursor] (const void* data, std::size_t size) {
+		std::memcpy(cursor, data, size);
+		cursor += size;
+	};
+
+	append(&header, sizeof(MeshCacheHeader));
+	for (int index = 0; index < mesh.vertexCount; index++) {
+		Vec3f vertex = mesh.getVertex(index);
+		append(&vertex, sizeof(Vec3f));
+	}
+	for (int index = 0; index < mesh.triangleCount; index++) {
+		Triangle triangle = mesh.getTriangle(index);
+		append(&triangle, sizeof(Triangle));
+	}
+	if (mesh.normals != nullptr)
+		append(mesh.normals.get(), mesh.vertexCount * sizeof(Vec3f));
+	if (mesh.uvs != nullptr)
+		append(mesh.uvs.get(), mesh.vertexCount * sizeof(Vec2f));
+	if (mesh.tangents != nullptr)
+		append(mesh.tangents.get(), mesh.vertexCount * sizeof(Vec3f));
+	if (mesh.bitangents != nullptr)
+		append(mesh.bitangents.get(), mesh.vertexCount * sizeof(Vec3f));
+
+	// Write to a temporary file first so a concurrent reader never sees a partial cache entry
+	std::string temporaryPath = path + ".tmp";
+	std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+	output.write(buffer.data(), buffer.size());
+	output.close();
+
+	if (output.fail() || !Util::replaceFile(temporaryPath, path)) {
+		std::remove(temporaryPath.c_str());
+		Log::warn("Could not write mesh cache for %s", file.c_str());
+	}
+}
+
 Graphics::ExtendedTriangleMesh OBJImport::load(std::istream& file, bool binary) {
 	if (binary)
 		return loadBinaryObj(file);
@@ -471,16 +876,39 @@ Graphics::ExtendedTriangleMesh OBJImport::load(const std::string& file) {
 }
 
 Graphics::ExtendedTriangleMesh OBJImport::load(const std::string& file, bool binary) {
-	std::ifstream input;
+	if (binary) {
+		std::ifstream input(file, std::ios::binary);
 
-	if (binary)
-		input.open(file, std::ios::binary);
-	else
-		input.open(file);
+		return load(input, true);
+	}
 
-	Graphics::ExtendedTriangleMesh shape = load(input, binary);
+	long long sourceWriteTime = 0;
+	std::string cachePath;
+	if (cacheEnabled) {
+		long long sourceSize = Util::getFileSize(file);
+		sourceWriteTime = Util::getLastWriteTime(file);
+		cachePath = getMeshCachePath(file, Util::hashBytes(file.data(), file.size()));
+
+		bool sourceTouched = false;
+		std::optional<Graphics::ExtendedTriangleMesh> cached = loadCachedMesh(cachePath, file, sourceSize, sourceWriteTime, sourceTouched);
+		if (cached.has_value()) {
+			if (sourceTouched)
+				updateCachedMeshWriteTime(cachePath, sourceWriteTime);
+
+			return std::move(*cached);
+		}
+	}
+
+	Util::MappedFile source(file);
+	if (!source.isOpen()) {
+		Log::error("Could not open %s", file.c_str());
+
+		return Graphics::ExtendedTriangleMesh();
+	}
 
-	input.close();
+	Graphics::ExtendedTriangleMesh shape = loadNonBinaryObj(source.begin(), source.end());
+	if (cacheEnabled)
+		saveCachedMesh(file, cachePath, source, sourceWriteTime, shape);
 
 	return shape;
 }
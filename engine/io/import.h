@@ -27,6 +27,9 @@ namespace Import {
 };
 
 namespace OBJImport {
+	// Parsed text meshes are cached in a .meshcache directory next to their source file, checked against the size, modification time and hash of the file
+	extern bool cacheEnabled;
+
 	Graphics::ExtendedTriangleMesh load(std::istream& file, bool binary = false);
 	Graphics::ExtendedTriangleMesh load(const std::string& file, bool binary);
 	Graphics::ExtendedTriangleMesh load(const std::string& file);
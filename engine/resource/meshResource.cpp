@@ -12,4 +12,13 @@ MeshResource* MeshAllocator::load(const std::string& name, const std::string& pa
 	return new MeshResource(name, path, shape);
 }
 
+std::function<MeshResource*()> MeshAllocator::decode(const std::string& name, const std::string& path) {
+	// A mesh resource only holds CPU side data, so the whole load can happen on the loader thread
+	SRef<Graphics::ExtendedTriangleMesh> shape = std::make_shared<Graphics::ExtendedTriangleMesh>(OBJImport::load(path));
+
+	return [name, path, shape] () -> MeshResource* {
+		return new MeshResource(name, path, *shape);
+	};
+}
+
 };
\ No newline at end of file
@@ -12,6 +12,7 @@ class MeshResource;
 class MeshAllocator : public ResourceAllocator<MeshResource> {
 public:
 	virtual MeshResource* load(const std::string& name, const std::string& path) override;
+	virtual std::function<MeshResource*()> decode(const std::string& name, const std::string& path) override;
 };
 
 class MeshResource : public Resource {
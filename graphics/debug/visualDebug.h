@@ -3,6 +3,7 @@
 #include "profilerUI.h"
 #include "guiDebug.h"
 #include <Physics3D/datastructures/buffers.h>
+#include <Physics3D/misc/zoneProfiler.h>
 
 namespace P3D::Graphics {
 
@@ -59,8 +60,8 @@ void addDebugField(Vec2 dimension, Graphics::Font* font, const char* varName, T
 	addDebugField(dimension, font, varName, std::to_string(value), unit);
 }
 
-template<typename EnumType>
-PieChart toPieChart(BreakdownAverageProfiler<EnumType>& profiler, const char* title, Vec2f piePosition, float pieSize) {
+template<typename Profiler>
+PieChart timeBreakdownToPieChart(Profiler& profiler, const char* title, Vec2f piePosition, float pieSize) {
 	auto results = profiler.history.avg();
 	auto averageTotalTime = results.sum();
 
@@ -74,6 +75,16 @@ PieChart toPieChart(BreakdownAverageProfiler<EnumType>& profiler, const char* ti
 	return chart;
 }
 
+template<typename EnumType>
+PieChart toPieChart(BreakdownAverageProfiler<EnumType>& profiler, const char* title, Vec2f piePosition, float pieSize) {
+	return timeBreakdownToPieChart(profiler, title, piePosition, pieSize);
+}
+
+template<typename EnumType>
+PieChart toPieChart(ZoneProfiler<EnumType>& profiler, const char* title, Vec2f piePosition, float pieSize) {
+	return timeBreakdownToPieChart(profiler, title, piePosition, pieSize);
+}
+
 template<typename Unit, typename EnumType>
 PieChart toPieChart(HistoricTally<Unit, EnumType>& tally, const char* title, Vec2f piePosition, float pieSize) {
 	int sum = 0;
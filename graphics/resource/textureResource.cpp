@@ -14,4 +14,19 @@ TextureResource* TextureAllocator::load(const std::string& name, const std::stri
 	}
 }
 
+std::function<TextureResource*()> TextureAllocator::decode(const std::string& name, const std::string& path) {
+	Texture::Image image = Texture::decode(path);
+
+	return [name, path, image] () -> TextureResource* {
+		if (!image.pixels) {
+			Log::subject s(path);
+			Log::error("Failed to load texture");
+
+			return nullptr;
+		}
+
+		return new TextureResource(name, path, Texture::upload(image));
+	};
+}
+
 };
\ No newline at end of file
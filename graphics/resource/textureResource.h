@@ -11,6 +11,7 @@ class TextureResource;
 class TextureAllocator : public ResourceAllocator<TextureResource> {
 public:
 	virtual TextureResource* load(const std::string& name, const std::string& path) override;
+	virtual std::function<TextureResource*()> decode(const std::string& name, const std::string& path) override;
 };
 
 class TextureResource : public Resource, public Texture {
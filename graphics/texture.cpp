@@ -53,22 +53,10 @@ int getFormatFromChannels(int channels) {
 }
 
 Texture Texture::load(const std::string& name) {
-	int width;
-	int height;
-	int channels;
+	Image image = decode(name);
 
-	//stbi_set_flip_vertically_on_load(true);
-
-	unsigned char* data = stbi_load(name.c_str(), &width, &height, &channels, 0);
-
-	if (data) {
-		int format = getFormatFromChannels(channels);
-
-		Texture texture(width, height, data, format);
-
-		stbi_image_free(data);
-
-		return texture;
+	if (image.pixels) {
+		return upload(image);
 	} else {
 		Log::subject s(name);
 		Log::error("Failed to load texture");
@@ -77,6 +65,25 @@ Texture Texture::load(const std::string& name) {
 	}
 }
 
+Texture::Image Texture::decode(const std::string& name) {
+	Image image;
+
+	//stbi_set_flip_vertically_on_load(true);
+
+	unsigned char* data = stbi_load(name.c_str(), &image.width, &image.height, &image.channels, 0);
+
+	if (data)
+		image.pixels = SRef<unsigned char>(data, stbi_image_free);
+
+	return image;
+}
+
+Texture Texture::upload(const Image& image) {
+	int format = getFormatFromChannels(image.channels);
+
+	return Texture(image.width, image.height, image.pixels.get(), format);
+}
+
 SRef<Texture> Texture::white() {
 	if (_white == nullptr) {
 		Color buffer = Colors::WHITE;
@@ -6,6 +6,15 @@
 namespace P3D::Graphics {
 
 class Texture : public Bindable {
+public:
+	// Decoded pixel data, can be read on any thread and uploaded later on the thread owning the GL context
+	struct Image {
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		SRef<unsigned char> pixels;
+	};
+
 private:
 	static SRef<Texture> _white;
 
@@ -48,6 +57,8 @@ public:
 	void generateMipmap();
 
 	static Texture load(const std::string& name);
+	static Image decode(const std::string& name);
+	static Texture upload(const Image& image);
 	static SRef<Texture> white();
 
 	[[nodiscard]] float getAspect() const;
@@ -8,9 +8,16 @@
 #include "generators.h"
 #include <Physics3D/misc/toString.h>
 #include <Physics3D/misc/validityHelper.h>
+#include <Physics3D/math/linalg/trigonometry.h>
+#include <Physics3D/boundstree/filters/frustumFilter.h>
+#include <Physics3D/boundstree/filters/visibilityFilter.h>
 
 #include <vector>
 #include <set>
+#include <array>
+#include <limits>
+#include <utility>
+#include <cmath>
 
 using namespace P3D;
 
@@ -381,6 +388,154 @@ TEST_CASE(testForEachColission) {
 	}
 }
 
+/*
+	Tests the box against a convex volume given as half spaces, margins(corner) gives for every half space how far the corner lies on its inside.
+	Like the filters the box is only rejected if all of its corners lie outside of the same half space.
+	Returns false for boxes that are too close to deciding the other way to compare against the float filters.
+*/
+template<std::size_t N, typename Margins>
+static bool boxTouchesHalfSpaces(const BoundsTemplate<float>& bounds, const Margins& margins, bool& isInside) {
+	std::array<double, N> largestMargins;
+	std::array<double, N> scales;
+	largestMargins.fill(-std::numeric_limits<double>::infinity());
+	scales.fill(0.0);
+	for(int corner = 0; corner < 8; corner++) {
+		Vec3 point(
+			(corner & 1) ? bounds.max.x : bounds.min.x,
+			(corner & 2) ? bounds.max.y : bounds.min.y,
+			(corner & 4) ? bounds.max.z : bounds.min.z
+		);
+		std::array<std::pair<double, double>, N> marginsAndScales = margins(point);
+		for(std::size_t i = 0; i < N; i++) {
+			largestMargins[i] = std::max(largestMargins[i], marginsAndScales[i].first);
+			scales[i] = std::max(scales[i], marginsAndScales[i].second);
+		}
+	}
+
+	isInside = true;
+	for(std::size_t i = 0; i < N; i++) {
+		if(std::abs(largestMargins[i]) <= 0.00001 * (scales[i] + 1.0))
+			return false;
+		if(largestMargins[i] < 0.0)
+			isInside = false;
+	}
+	return true;
+}
+
+template<typename Filter, typename BruteForce>
+static void testFilterMatchesBruteForce(const Filter& filter, const BruteForce& bruteForce) {
+	BoundsTree<BasicBounded> tree;
+
+	constexpr int itemCount = 1000;
+
+	std::vector<BasicBounded> allItems = generateBoundsTreeItems(itemCount);
+	for(BasicBounded& item : allItems) {
+		tree.add(&item);
+	}
+
+	std::set<BasicBounded*> found;
+	tree.forEachFiltered(filter, [&](BasicBounded& item) {
+		ASSERT_FALSE(found.find(&item) != found.end());
+		found.insert(&item);
+	});
+
+	int insideCount = 0;
+	int comparedCount = 0;
+	for(BasicBounded& item : allItems) {
+		bool shouldBeFound;
+		if(!bruteForce(item.bounds, shouldBeFound))
+			continue;
+		bool wasFound = found.find(&item) != found.end();
+		ASSERT_STRICT(wasFound == shouldBeFound);
+		comparedCount++;
+		if(shouldBeFound)
+			insideCount++;
+	}
+
+	// make sure the volume actually splits the items
+	ASSERT_TRUE(comparedCount > itemCount * 9 / 10);
+	ASSERT_TRUE(insideCount > 0 && insideCount < comparedCount);
+}
+
+// Tests the corners in clip space, -w <= x, y, z <= w
+static void testFrustumFilterMatchesMatrix(const Mat4f& projectionView) {
+	testFilterMatchesBruteForce(FrustumFilter::fromMatrix(projectionView), [&projectionView](const BoundsTemplate<float>& bounds, bool& isInside) {
+		return boxTouchesHalfSpaces<6>(bounds, [&projectionView](const Vec3& point) {
+			double clip[4];
+			double clipScale[4];
+			for(int row = 0; row < 4; row++) {
+				clip[row] = projectionView(row, 3);
+				clipScale[row] = std::abs(projectionView(row, 3));
+				for(int col = 0; col < 3; col++) {
+					clip[row] += projectionView(row, col) * point[col];
+					clipScale[row] += std::abs(projectionView(row, col) * point[col]);
+				}
+			}
+
+			std::array<std::pair<double, double>, 6> margins;
+			for(int axis = 0; axis < 3; axis++) {
+				double scale = clipScale[3] + clipScale[axis];
+				margins[axis * 2] = std::make_pair(clip[3] + clip[axis], scale);
+				margins[axis * 2 + 1] = std::make_pair(clip[3] - clip[axis], scale);
+			}
+			return margins;
+		}, isInside);
+	});
+}
+
+TEST_CASE(testFrustumFilterBoundsTree) {
+	Mat4f projection = perspective(1.0f, 1.5f, 0.1f, 120.0f);
+	Mat4f view = lookAt(Vec3f(-80.0f, 20.0f, -60.0f), Vec3f(0.0f, 0.0f, 0.0f));
+	testFrustumFilterMatchesMatrix(projection * view);
+
+	Mat4f lightProjection = ortho(-40.0f, 40.0f, -40.0f, 40.0f, 0.1f, 200.0f);
+	Mat4f lightView = lookAt(Vec3f(-50.0f, 50.0f, -50.0f), Vec3f(0.0f, 0.0f, 0.0f));
+	testFrustumFilterMatchesMatrix(lightProjection * lightView);
+}
+
+TEST_CASE(testVisibilityFilterBoundsTree) {
+	Position origin(-80.0, 20.0, -60.0);
+	Vec3 cameraForward(80.0, -20.0, 60.0);
+	// the filter takes up as given, so it has to be perpendicular to forward for the window to be the one of a camera
+	Vec3 cameraUp = cameraForward % (Vec3(0.0, 1.0, 0.0) % cameraForward);
+	double fov = 1.0;
+	double aspect = 1.5;
+	double maxDepth = 120.0;
+	VisibilityFilter filter = VisibilityFilter::forWindow(origin, cameraForward, cameraUp, fov, aspect, maxDepth);
+
+	// Tests the corners in camera space, no deeper than maxDepth and within the field of view
+	Vec3 forward = normalize(cameraForward);
+	Vec3 up = normalize(cameraUp);
+	Vec3 right = normalize(cameraUp % cameraForward);
+	double tanVertical = tan(fov / 2);
+	double tanHorizontal = tanVertical * aspect;
+	auto bruteForce = [&](const BoundsTemplate<float>& bounds, bool& isInside) {
+		return boxTouchesHalfSpaces<5>(bounds, [&](const Vec3& point) {
+			Vec3 relativePos = Vec3(Position(point.x, point.y, point.z) - origin);
+			double depth = relativePos * forward;
+			double height = relativePos * up;
+			double width = relativePos * right;
+			double scale = length(relativePos);
+
+			return std::array<std::pair<double, double>, 5>{
+				std::make_pair(maxDepth - depth, scale + maxDepth),
+				std::make_pair(tanVertical * depth - height, scale),
+				std::make_pair(tanVertical * depth + height, scale),
+				std::make_pair(tanHorizontal * depth - width, scale),
+				std::make_pair(tanHorizontal * depth + width, scale)
+			};
+		}, isInside);
+	};
+
+	testFilterMatchesBruteForce([&filter](const auto& trunkOrBounds, auto... trunkSize) {
+		if constexpr(sizeof...(trunkSize) == 0) {
+			return filter(Bounds(trunkOrBounds));
+		} else {
+			return filter(trunkOrBounds, trunkSize...);
+		}
+	}, bruteForce);
+}
+
 TEST_CASE(testForEachColissionBetween) {
 	BoundsTree<BasicBounded> tree1;
 	BoundsTree<BasicBounded> tree2;
@@ -498,3 +653,63 @@ TEST_CASE(testImproveStructureValidity) {
 		}
 	}
 }
+
+#ifdef __AVX__
+TEST_CASE(testRayEntryDistancesAVXMatchesFallback) {
+	TreeTrunk trunk;
+	for(int i = 0; i < BRANCH_FACTOR; i++) {
+		trunk.setBoundsOfSubNode(i, generateBoundsTreeBounds());
+	}
+
+	for(int iter = 0; iter < 100; iter++) {
+		PositionTemplate<float> origin(generateFloat(-150.0f, 150.0f), generateFloat(-150.0f, 150.0f), generateFloat(-150.0f, 150.0f));
+		Vec3f direction(generateFloat(-1.0f, 1.0f), generateFloat(-1.0f, 1.0f), generateFloat(-1.0f, 1.0f));
+		if(iter % 10 == 0) direction.y = 0.0f;
+		Vec3f inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+		float maxDistance = iter % 2 == 0 ? std::numeric_limits<float>::infinity() : generateFloat(0.0f, 300.0f);
+
+		std::array<float, BRANCH_FACTOR> fallback = TrunkSIMDHelperFallback::computeRayEntryDistances(trunk, BRANCH_FACTOR, origin, inverseDirection, maxDistance);
+		std::array<float, BRANCH_FACTOR> avx = TrunkSIMDHelperFallback::computeRayEntryDistancesAVX(trunk, BRANCH_FACTOR, origin, inverseDirection, maxDistance);
+		for(int i = 0; i < BRANCH_FACTOR; i++) {
+			ASSERT_STRICT(fallback[i] == avx[i]);
+
+			// a ray that enters a box must pass through its bounds right after entering
+			if(fallback[i] != std::numeric_limits<float>::infinity()) {
+				BoundsTemplate<float> bounds = trunk.getBoundsOfSubNode(i);
+				PositionTemplate<float> entryPoint = origin + direction * fallback[i];
+				ASSERT_TRUE(bounds.expanded(0.01f).contains(entryPoint));
+				ASSERT_TRUE(fallback[i] <= maxDistance);
+			}
+		}
+	}
+}
+#endif
+
+TEST_CASE(testRayEntryDistancesParallelOnBoundsPlane) {
+	TreeTrunk trunk;
+	trunk.setBoundsOfSubNode(0, BoundsTemplate<float>(PositionTemplate<float>(0.0f, 0.0f, 0.0f), PositionTemplate<float>(1.0f, 1.0f, 1.0f)));
+	trunk.setBoundsOfSubNode(1, BoundsTemplate<float>(PositionTemplate<float>(0.0f, 1.0f, 0.0f), PositionTemplate<float>(1.0f, 2.0f, 1.0f)));
+	trunk.setBoundsOfSubNode(2, BoundsTemplate<float>(PositionTemplate<float>(3.0f, 0.0f, 0.0f), PositionTemplate<float>(4.0f, 1.0f, 1.0f)));
+	constexpr int trunkSize = 3;
+
+	// runs along the plane y = 1 shared by the first two boxes, with a direction of +0 and -0 along y
+	for(float directionY : {0.0f, -0.0f}) {
+		PositionTemplate<float> origin(0.5f, 1.0f, -5.0f);
+		Vec3f inverseDirection(std::numeric_limits<float>::infinity(), 1.0f / directionY, 1.0f);
+
+		std::array<float, BRANCH_FACTOR> distances = TrunkSIMDHelperFallback::computeRayEntryDistances(trunk, trunkSize, origin, inverseDirection, 100.0f);
+		ASSERT_STRICT(distances[0] == 5.0f);
+		ASSERT_STRICT(distances[1] == 5.0f);
+		ASSERT_STRICT(distances[2] == std::numeric_limits<float>::infinity());
+
+#ifdef __AVX__
+		std::array<float, BRANCH_FACTOR> avx = TrunkSIMDHelperFallback::computeRayEntryDistancesAVX(trunk, trunkSize, origin, inverseDirection, 100.0f);
+		for(int i = 0; i < trunkSize; i++) {
+			ASSERT_STRICT(avx[i] == distances[i]);
+		}
+		for(int i = trunkSize; i < BRANCH_FACTOR; i++) {
+			ASSERT_STRICT(avx[i] == std::numeric_limits<float>::infinity());
+		}
+#endif
+	}
+}
@@ -2,6 +2,7 @@
 
 #include <Physics3D/datastructures/smartPointers.h>
 #include "../engine/ecs/registry.h"
+#include "../engine/ecs/systemScheduler.h"
 #include "../application/ecs/components.h"
 
 namespace P3D {
@@ -137,4 +138,203 @@ TEST_CASE(getFromView) {
 		ASSERT_TRUE(component->idx > 0 && component->idx < 4);
 	}
 }
+
+TEST_CASE(removeComponent) {
+	using namespace P3D::Engine;
+	Registry16 registry;
+
+	struct A : public RC {
+		int idx = 0;
+		A(int idx) : idx(idx) {}
+	};
+
+	auto id1 = registry.create();
+	auto id2 = registry.create();
+	auto id3 = registry.create();
+
+	registry.add<A>(id1, 1);
+	registry.add<A>(id2, 2);
+	registry.add<A>(id2, 3);
+	registry.add<A>(id3, 4);
+
+	registry.remove<A>(id1);
+	registry.remove<A>(id2);
+
+	ASSERT_FALSE(registry.has<A>(id1));
+	ASSERT_TRUE(registry.get<A>(id2)->idx == 3);
+	ASSERT_TRUE(registry.get<A>(id3)->idx == 4);
+
+	registry.destroy(id2);
+
+	std::size_t count = 0;
+	for(auto entity : registry.view<A>()) {
+		ASSERT_TRUE(entity == id3);
+		count++;
+	}
+
+	ASSERT_TRUE(count == 1);
+}
+
+TEST_CASE(removeWhileIterating) {
+	using namespace P3D::Engine;
+	Registry64 registry;
+
+	struct A : public RC {
+		int value;
+		A(int value) : value(value) {}
+	};
+	struct B : public RC {};
+
+	for (int i = 0; i < 100; i++) {
+		auto id = registry.create();
+		registry.add<A>(id, i);
+		registry.add<B>(id);
+	}
+
+	// Removing the current component must not skip the component moved into its place
+	std::size_t visited = 0;
+	for (auto entity : registry.view<A>()) {
+		if (registry.get<A>(entity)->value % 2 == 0)
+			registry.remove<A>(entity);
+		visited++;
+	}
+	ASSERT_TRUE(visited == 100);
+
+	visited = 0;
+	for (auto entity : registry.view<A, B>()) {
+		registry.remove<B>(entity);
+		visited++;
+	}
+	ASSERT_TRUE(visited == 50);
+
+	visited = 0;
+	registry.each<A>([&registry, &visited](Registry64::entity_type entity, A& a) {
+		registry.remove<A>(entity);
+		visited++;
+	});
+	ASSERT_TRUE(visited == 50);
+
+	std::size_t remaining = 0;
+	for (auto entity : registry.view<A>())
+		remaining++;
+	ASSERT_TRUE(remaining == 0);
+	for (auto entity : registry.view<B>())
+		remaining++;
+	ASSERT_TRUE(remaining == 50);
+}
+
+TEST_CASE(parallelEach) {
+	using namespace P3D::Engine;
+	Registry64 registry;
+
+	struct A : public RC {
+		int value;
+		A(int value) : value(value) {}
+	};
+	struct B : public RC {
+		int value = 0;
+	};
+
+	for(int i = 0; i < 10000; i++) {
+		auto id = registry.create();
+		registry.add<A>(id, i);
+		if(i % 3 == 0)
+			registry.add<B>(id);
+	}
+
+	ThreadPool threadPool(4);
+	registry.parallel_each<const A, B>(&threadPool, [](Registry64::entity_type entity, const A& a, B& b) {
+		b.value = a.value * 2;
+	});
+
+	std::size_t count = 0;
+	registry.each<B, A>([&count](Registry64::entity_type entity, B& b, A& a) {
+		ASSERT_TRUE(b.value == a.value * 2);
+		count++;
+	});
+
+	ASSERT_TRUE(count == 3334);
+}
+
+TEST_CASE(systemStages) {
+	using namespace P3D::Engine;
+	Registry64 registry;
+
+	struct A : public RC {};
+	struct B : public RC {};
+	struct C : public RC {};
+
+	SystemScheduler64 scheduler(registry);
+	auto noop = [](Registry64& registry, ThreadPool* threadPool) {};
+	scheduler.add<Registry64::reads<A>, Registry64::writes<B>>("first", noop);
+	scheduler.add<Registry64::reads<A>, Registry64::writes<C>>("second", noop);
+	scheduler.add<Registry64::reads<B, C>>("third", noop);
+	scheduler.add<Registry64::reads<A>>("fourth", noop);
+
+	const auto& stages = scheduler.getStages();
+	ASSERT_TRUE(stages.size() == 2);
+	ASSERT_TRUE(stages[0].size() == 3);
+	ASSERT_TRUE(stages[1].size() == 1);
+	ASSERT_TRUE(scheduler.getName(stages[1][0]) == "third");
+
+	std::atomic<int> ran = 0;
+	auto count = [&ran](Registry64& registry, ThreadPool* threadPool) { ran++; };
+	SystemScheduler64 counting(registry);
+	counting.add<Registry64::reads<A>, Registry64::writes<B>>("first", count);
+	counting.add<Registry64::reads<A>, Registry64::writes<C>>("second", count);
+	counting.add<Registry64::reads<B, C>>("third", count);
+
+	ThreadPool threadPool(4);
+	counting.run(threadPool);
+	ASSERT_TRUE(ran == 3);
+}
+
+TEST_CASE(systemsEachDeclaredComponents) {
+	using namespace P3D::Engine;
+	Registry64 registry;
+
+	struct A : public RC {
+		int value;
+		A(int value) : value(value) {}
+	};
+	struct B : public RC {
+		int value = 0;
+	};
+	struct C : public RC {
+		int value = 0;
+	};
+
+	for(int i = 0; i < 5000; i++) {
+		auto id = registry.create();
+		registry.add<A>(id, i);
+		registry.add<B>(id);
+		registry.add<C>(id);
+	}
+
+	// Both systems only read A, so they share a stage and iterate it concurrently
+	SystemScheduler64 scheduler(registry);
+	scheduler.add<Registry64::reads<A>, Registry64::writes<B>>("first", [](Registry64& registry, ThreadPool* threadPool) {
+		registry.each<const A, B>([](Registry64::entity_type entity, const A& a, B& b) {
+			b.value = a.value + 1;
+		});
+	});
+	scheduler.add<Registry64::reads<A>, Registry64::writes<C>>("second", [](Registry64& registry, ThreadPool* threadPool) {
+		registry.parallel_each<const A, C>(threadPool, [](Registry64::entity_type entity, const A& a, C& c) {
+			c.value = a.value + 2;
+		});
+	});
+	ASSERT_TRUE(scheduler.getStages().size() == 1);
+
+	ThreadPool threadPool(4);
+	scheduler.run(threadPool);
+
+	std::size_t count = 0;
+	registry.each<const A, const B, const C>([&count](Registry64::entity_type entity, const A& a, const B& b, const C& c) {
+		ASSERT_TRUE(b.value == a.value + 1);
+		ASSERT_TRUE(c.value == a.value + 2);
+		count++;
+	});
+
+	ASSERT_TRUE(count == 5000);
+}
 };
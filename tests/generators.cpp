@@ -1,6 +1,7 @@
 #include "generators.h"
 
 #include <vector>
+#include <cmath>
 
 #include <Physics3D/hardconstraints/motorConstraint.h>
 #include <Physics3D/hardconstraints/sinusoidalPistonConstraint.h>
@@ -101,6 +102,37 @@ TriangleMesh generateTriangleMesh() {
 	return TriangleMesh(std::move(mesh));
 }
 
+std::vector<float> generateTerrainHeights(int size, float bumpHeight) {
+	std::vector<float> heights((size + 1) * (size + 1));
+	for(int z = 0; z <= size; z++) {
+		for(int x = 0; x <= size; x++) {
+			heights[z * (size + 1) + x] = bumpHeight * std::sin(x * 0.5f) * std::cos(z * 0.3f);
+		}
+	}
+	return heights;
+}
+
+TriangleMesh generateTerrainMesh(int size, float bumpHeight) {
+	EditableMesh mesh((size + 1) * (size + 1), 2 * size * size);
+	std::vector<float> heights = generateTerrainHeights(size, bumpHeight);
+
+	for(int z = 0; z <= size; z++) {
+		for(int x = 0; x <= size; x++) {
+			mesh.setVertex(z * (size + 1) + x, float(x), heights[z * (size + 1) + x], float(z));
+		}
+	}
+
+	for(int z = 0; z < size; z++) {
+		for(int x = 0; x < size; x++) {
+			int corner = z * (size + 1) + x;
+			mesh.setTriangle(2 * (z * size + x), corner, corner + size + 1, corner + 1);
+			mesh.setTriangle(2 * (z * size + x) + 1, corner + 1, corner + size + 1, corner + size + 2);
+		}
+	}
+
+	return TriangleMesh(std::move(mesh));
+}
+
 PositionTemplate<float> generatePositionf() {
 	return PositionTemplate<float>(generateFloat(), generateFloat(), generateFloat());
 }
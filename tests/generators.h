@@ -3,6 +3,7 @@
 #include <random>
 #include <utility>
 #include <cstdint>
+#include <vector>
 
 #include <Physics3D/math/linalg/vec.h>
 #include <Physics3D/math/linalg/mat.h>
@@ -86,6 +87,10 @@ bool generateBool();
 Shape generateShape();
 Polyhedron generateConvexPolyhedron();
 TriangleMesh generateTriangleMesh();
+// a size x size grid of unit cells in the xz plane facing up, with sinusoidal bumps
+TriangleMesh generateTerrainMesh(int size, float bumpHeight);
+// the (size + 1) x (size + 1) heights of generateTerrainMesh, indexed [z * (size + 1) + x]
+std::vector<float> generateTerrainHeights(int size, float bumpHeight);
 template<typename T, std::size_t Size>
 Vector<T, Size> generateVector() {
 	Vector<T, Size> result;
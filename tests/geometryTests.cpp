@@ -13,12 +13,29 @@
 #include <Physics3D/geometry/shape.h>
 
 #include <Physics3D/geometry/shapeLibrary.h>
+#include <Physics3D/geometry/shapeCreation.h>
 
 #include "testValues.h"
 #include "generators.h"
 
 #include <Physics3D/misc/cpuid.h>
 #include <Physics3D/geometry/builtinShapeClasses.h>
+#include <Physics3D/geometry/convexHull.h>
+#include <Physics3D/geometry/convexDecomposition.h>
+#include <Physics3D/geometry/triangleMeshShapeClass.h>
+#include <Physics3D/geometry/heightfieldShapeClass.h>
+#include <Physics3D/geometry/shapeClassCache.h>
+#include <Physics3D/geometry/facePlanes.h>
+#include <Physics3D/geometry/intersection.h>
+#include <Physics3D/part.h>
+#include <Physics3D/physical.h>
+#include <Physics3D/threading/threadPool.h>
+#include <Physics3D/misc/validityHelper.h>
+
+#include <vector>
+#include <stdexcept>
+#include <cstdio>
+#include <fstream>
 
 using namespace P3D;
 #define ASSERT(condition) ASSERT_TOLERANT(condition, 0.00001)
@@ -293,3 +310,538 @@ TEST_CASE(testTriangleMeshOptimizedFurthestInDirection) {
 	}
 }
 
+// both polyhedra in one, moved apart by the given offsets
+static Polyhedron combinePolyhedra(const Polyhedron& first, Vec3f firstOffset, const Polyhedron& second, Vec3f secondOffset) {
+	std::vector<Vec3f> vertices;
+	std::vector<Triangle> triangles;
+	for(int i = 0; i < first.vertexCount; i++) vertices.push_back(first.getVertex(i) + firstOffset);
+	for(int i = 0; i < second.vertexCount; i++) vertices.push_back(second.getVertex(i) + secondOffset);
+	for(int i = 0; i < first.triangleCount; i++) triangles.push_back(first.getTriangle(i));
+	for(int i = 0; i < second.triangleCount; i++) {
+		Triangle triangle = second.getTriangle(i);
+		triangles.push_back(Triangle{triangle.firstIndex + first.vertexCount, triangle.secondIndex + first.vertexCount, triangle.thirdIndex + first.vertexCount});
+	}
+	return Polyhedron(vertices.data(), triangles.data(), static_cast<int>(vertices.size()), static_cast<int>(triangles.size()));
+}
+
+TEST_CASE(testPolyhedronHillClimbingMatchesScan) {
+	Shape detailedSphere = polyhedronShape(ShapeLibrary::createSphere(1.0f, 3));
+	Shape spikeBall = polyhedronShape(ShapeLibrary::createSpikeBall(0.35f, 0.6f, 3, 1));
+	const PolyhedronShapeClass& sphereClass = static_cast<const PolyhedronShapeClass&>(*detailedSphere.baseShape);
+	const PolyhedronShapeClass& spikeBallClass = static_cast<const PolyhedronShapeClass&>(*spikeBall.baseShape);
+
+	ASSERT_TRUE(sphereClass.usesHillClimbing());
+	// not convex, climbing could get stuck on a spike
+	ASSERT_FALSE(spikeBallClass.usesHillClimbing());
+	// climbing would never leave the piece it starts on
+	Polyhedron twoSpheres = combinePolyhedra(ShapeLibrary::createSphere(1.0f, 3), Vec3f(-2.0f, 0.0f, 0.0f), ShapeLibrary::createSphere(1.0f, 3), Vec3f(2.0f, 0.0f, 0.0f));
+	Shape twoSpheresShape = polyhedronShape(twoSpheres);
+	const PolyhedronShapeClass& twoSpheresClass = static_cast<const PolyhedronShapeClass&>(*twoSpheresShape.baseShape);
+	ASSERT_FALSE(twoSpheresClass.usesHillClimbing());
+
+	Polyhedron spherePoly = sphereClass.asPolyhedron();
+	Polyhedron spikeBallPoly = spikeBallClass.asPolyhedron();
+	Polyhedron twoSpheresPoly = twoSpheresClass.asPolyhedron();
+	ASSERT_TRUE(spikeBallPoly.vertexCount >= HILL_CLIMBING_VERTEX_THRESHOLD);
+	// interleaved queries with their own hints, as concurrent colissions against one shared class would make
+	int firstHint = 0;
+	int secondHint = 0;
+	for(int iter = 0; iter < 1000; iter++) {
+		Vec3f dir = generateVec3f();
+		ASSERT(sphereClass.furthestInDirection(dir) * dir == spherePoly.furthestInDirectionFallback(dir) * dir);
+		ASSERT(spikeBallClass.furthestInDirection(dir) * dir == spikeBallPoly.furthestInDirectionFallback(dir) * dir);
+		ASSERT(twoSpheresClass.furthestInDirection(dir) * dir == twoSpheresPoly.furthestInDirectionFallback(dir) * dir);
+		ASSERT(sphereClass.furthestInDirectionFrom(dir, firstHint) * dir == spherePoly.furthestInDirectionFallback(dir) * dir);
+		ASSERT(sphereClass.furthestInDirectionFrom(-dir, secondHint) * -dir == spherePoly.furthestInDirectionFallback(-dir) * -dir);
+		ASSERT_STRICT(spherePoly.getVertex(firstHint) * dir == spherePoly.furthestInDirectionFallback(dir) * dir);
+	}
+}
+
+template<typename Class>
+static void assertPolyhedronClassQueriesMatch(const Polyhedron& poly) {
+	Class shapeClass{Polyhedron(poly)};
+	int hitCount = 0;
+	int insideCount = 0;
+	for(int i = 0; i < 1000; i++) {
+		Vec3 origin(generateDouble(-1.5, 1.5), generateDouble(-1.5, 1.5), generateDouble(-1.5, 1.5));
+		Vec3 direction = normalize(Vec3(generateDouble(-1.0, 1.0), generateDouble(-1.0, 1.0), generateDouble(-1.0, 1.0)));
+		double expected = poly.getIntersectionDistance(origin, direction);
+		double found = shapeClass.getIntersectionDistance(origin, direction);
+		if(expected == std::numeric_limits<double>::max()) {
+			ASSERT_STRICT(found == std::numeric_limits<double>::max());
+		} else {
+			hitCount++;
+			ASSERT_TOLERANT(found == expected, 0.0001);
+		}
+
+		bool inside = poly.containsPoint(origin);
+		if(inside) insideCount++;
+		ASSERT_STRICT(shapeClass.containsPoint(origin) == inside);
+	}
+	ASSERT_TRUE(hitCount > 100);
+	ASSERT_TRUE(insideCount > 20);
+}
+
+TEST_CASE(polyhedronClassAcceleratedQueries) {
+	Polyhedron sphere = ShapeLibrary::createSphere(1.0f, 2);
+	Polyhedron box = ShapeLibrary::createCube(2.0f);
+	Polyhedron torus = ShapeLibrary::createTorus(0.6f, 0.35f, 32, 16);
+
+	ASSERT_STRICT(FacePlanes(box).getPlaneCount() == 6);
+	// the two triangles of a face are not listed next to each other
+	std::vector<Vec3f> boxVertices(box.vertexCount);
+	box.getVertices(boxVertices.data());
+	std::vector<Triangle> boxTriangles;
+	for(int start : {0, 1}) {
+		for(int i = start; i < box.triangleCount; i += 2) {
+			boxTriangles.push_back(box.getTriangle(i));
+		}
+	}
+	ASSERT_STRICT(FacePlanes(Polyhedron(boxVertices.data(), boxTriangles.data(), box.vertexCount, box.triangleCount)).getPlaneCount() == 6);
+	ASSERT_TRUE(PolyhedronShapeClassFallback(Polyhedron(sphere)).usesFacePlanes());
+	PolyhedronShapeClassFallback torusClass{Polyhedron(torus)};
+	ASSERT_FALSE(torusClass.usesFacePlanes());
+	ASSERT_TRUE(torusClass.usesTriangleBVH());
+	// every piece is convex, but the whole is not
+	Polyhedron twoBoxes = combinePolyhedra(ShapeLibrary::createCube(1.0f), Vec3f(-1.0f, 0.0f, 0.0f), ShapeLibrary::createCube(1.0f), Vec3f(1.0f, 0.0f, 0.0f));
+	ASSERT_FALSE(PolyhedronShapeClassFallback(Polyhedron(twoBoxes)).usesFacePlanes());
+
+	for(const Polyhedron* poly : {&sphere, &box, &torus, &twoBoxes}) {
+		assertPolyhedronClassQueriesMatch<PolyhedronShapeClassFallback>(*poly);
+		if(CPUIDCheck::hasTechnology(CPUIDCheck::SSE | CPUIDCheck::SSE2)) {
+			assertPolyhedronClassQueriesMatch<PolyhedronShapeClassSSE>(*poly);
+		}
+		if(CPUIDCheck::hasTechnology(CPUIDCheck::AVX | CPUIDCheck::AVX2 | CPUIDCheck::FMA)) {
+			assertPolyhedronClassQueriesMatch<PolyhedronShapeClassAVX>(*poly);
+		}
+	}
+}
+
+static bool isHullOf(const Polyhedron& hull, const std::vector<Vec3f>& points, float tolerance) {
+	if(!isValid(hull)) return false;
+	for(int i = 0; i < hull.triangleCount; i++) {
+		Triangle triangle = hull.getTriangle(i);
+		Vec3f a = hull.getVertex(triangle[0]);
+		Vec3f normal = normalize(hull.getNormalVecOfTriangle(triangle));
+		for(const Vec3f& point : points) {
+			if((point - a) * normal > tolerance) return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE(convexHullOfPointCloud) {
+	std::vector<Vec3f> points;
+	for(int i = 0; i < 2000; i++) {
+		points.push_back(Vec3f(generateFloat(-1.0f, 1.0f), generateFloat(-1.0f, 1.0f), generateFloat(-1.0f, 1.0f)));
+	}
+	Polyhedron hull = convexHull(points.data(), static_cast<int>(points.size()));
+	ASSERT_TRUE(isHullOf(hull, points, 0.0001f));
+
+	// the corners of a box hide every point inside of it, coplanar points on its faces included
+	std::vector<Vec3f> boxPoints = points;
+	for(int corner = 0; corner < 8; corner++) {
+		boxPoints.push_back(Vec3f(corner & 1 ? 2.0f : -2.0f, corner & 2 ? 2.0f : -2.0f, corner & 4 ? 2.0f : -2.0f));
+	}
+	for(int i = 0; i < 100; i++) {
+		boxPoints.push_back(Vec3f(2.0f, generateFloat(-2.0f, 2.0f), generateFloat(-2.0f, 2.0f)));
+	}
+	Polyhedron box = convexHull(boxPoints.data(), static_cast<int>(boxPoints.size()));
+	ASSERT_TRUE(isHullOf(box, boxPoints, 0.0001f));
+	ASSERT_STRICT(box.vertexCount == 8);
+	ASSERT(box.getVolume() == 64.0);
+}
+
+TEST_CASE(convexHullOfMesh) {
+	Polyhedron spikeBall = ShapeLibrary::createSpikeBall(0.35f, 0.6f, 2, 1);
+	std::vector<Vec3f> vertices(spikeBall.vertexCount);
+	spikeBall.getVertices(vertices.data());
+
+	Polyhedron hull = convexHull(spikeBall);
+	ASSERT_TRUE(isHullOf(hull, vertices, 0.0001f));
+	ASSERT_TRUE(hull.getVolume() >= spikeBall.getVolume());
+
+	Polyhedron simplified = convexHull(spikeBall, 16);
+	ASSERT_TRUE(isValid(simplified));
+	ASSERT_STRICT(simplified.vertexCount == 16);
+	ASSERT_TRUE(simplified.getVolume() <= hull.getVolume());
+
+	Vec3f flat[5]{Vec3f(0.0f, 0.0f, 0.0f), Vec3f(1.0f, 0.0f, 0.0f), Vec3f(0.0f, 1.0f, 0.0f), Vec3f(1.0f, 1.0f, 0.0f), Vec3f(0.5f, 0.2f, 0.0f)};
+	bool threw = false;
+	try {
+		convexHull(flat, 5);
+	} catch(std::invalid_argument&) {
+		threw = true;
+	}
+	ASSERT_TRUE(threw);
+}
+
+TEST_CASE(convexHullParallelMatchesSerial) {
+	std::vector<Vec3f> points;
+	for(int i = 0; i < 100000; i++) {
+		Vec3f direction = normalize(Vec3f(generateFloat(-1.0f, 1.0f), generateFloat(-1.0f, 1.0f), generateFloat(-1.0f, 1.0f)));
+		points.push_back(direction * generateFloat(0.0f, 1.0f));
+	}
+	ThreadPool threadPool(4);
+	Polyhedron serial = convexHull(points.data(), static_cast<int>(points.size()));
+	Polyhedron parallel = convexHull(points.data(), static_cast<int>(points.size()), threadPool);
+	ASSERT_TRUE(isHullOf(parallel, points, 0.0001f));
+	ASSERT_STRICT(parallel.vertexCount == serial.vertexCount);
+	ASSERT(parallel.getVolume() == serial.getVolume());
+}
+
+TEST_CASE(convexDecompositionOfTorus) {
+	Polyhedron torus = ShapeLibrary::createTorus(1.0f, 0.4f, 32, 16);
+	std::vector<Polyhedron> pieces = convexDecomposition(torus);
+	ASSERT_TRUE(pieces.size() > 1);
+
+	double piecesVolume = 0.0;
+	for(const Polyhedron& piece : pieces) {
+		ASSERT_TRUE(isValid(piece));
+		piecesVolume += piece.getVolume();
+	}
+	// about a voxel thicker than the torus, but a single hull would fill its hole
+	ASSERT_TRUE(piecesVolume > torus.getVolume() * 0.9 && piecesVolume < torus.getVolume() * 1.6);
+	ASSERT_TRUE(convexHull(torus).containsPoint(Vec3f(0.0f, 0.0f, 0.0f)));
+	for(const Polyhedron& piece : pieces) {
+		ASSERT_FALSE(piece.containsPoint(Vec3f(0.0f, 0.0f, 0.0f)));
+	}
+
+	std::vector<Part*> parts = createCompoundParts(pieces, GlobalCFrame(1.0, 2.0, 3.0), PartProperties{1.0, 0.5, 0.5});
+	ASSERT_STRICT(parts.size() == pieces.size());
+	ASSERT_TRUE(parts[0]->isMainPart());
+	for(Part* part : parts) {
+		ASSERT_TRUE(part->getMainPhysical() == parts[0]->getMainPhysical());
+	}
+	Vec3 firstCenter = pieces[0].getBounds().getCenter();
+	ASSERT(parts[0]->getCFrame().getPosition() == Position(1.0, 2.0, 3.0) + firstCenter);
+	for(Part* part : parts) {
+		delete part;
+	}
+}
+
+TEST_CASE(convexDecompositionCache) {
+	Polyhedron torus = ShapeLibrary::createTorus(1.0f, 0.4f, 24, 12);
+	ConvexDecompositionSettings settings;
+	settings.resolution = 16;
+	std::string cacheFile = getConvexDecompositionCacheFile(torus, ".", settings);
+	std::remove(cacheFile.c_str());
+
+	std::vector<Polyhedron> computed = cachedConvexDecomposition(torus, ".", settings);
+	ASSERT_TRUE(std::ifstream(cacheFile).is_open());
+	std::vector<Polyhedron> loaded = cachedConvexDecomposition(torus, ".", settings);
+
+	ASSERT_STRICT(loaded.size() == computed.size());
+	for(std::size_t i = 0; i < computed.size(); i++) {
+		ASSERT_STRICT(loaded[i].vertexCount == computed[i].vertexCount);
+		ASSERT(loaded[i].getVolume() == computed[i].getVolume());
+	}
+
+	// counts that don't fit in the file are rejected before anything is allocated for them, and the file is written again
+	{
+		std::ofstream damaged(cacheFile, std::ios::binary | std::ios::trunc);
+		int counts[3]{1, 0x7fffffff, 0};
+		damaged.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+	}
+	ASSERT_STRICT(cachedConvexDecomposition(torus, ".", settings).size() == computed.size());
+	ASSERT_STRICT(cachedConvexDecomposition(torus, ".", settings).size() == computed.size());
+
+	// a mesh without volume decomposes into no pieces, which is a valid cache entry
+	{
+		std::ofstream empty(cacheFile, std::ios::binary | std::ios::trunc);
+		int pieceCount = 0;
+		empty.write(reinterpret_cast<const char*>(&pieceCount), sizeof(pieceCount));
+	}
+	ASSERT_TRUE(cachedConvexDecomposition(torus, ".", settings).empty());
+	std::remove(cacheFile.c_str());
+
+	settings.resolution = 17;
+	ASSERT_TRUE(getConvexDecompositionCacheFile(torus, ".", settings) != cacheFile);
+}
+
+TEST_CASE(polyhedronShapesShareClasses) {
+	std::size_t initialCount = ShapeClassCache::getInternedClassCount();
+	{
+		Shape first = polyhedronShape(ShapeLibrary::createPrism(13, 0.7f, 1.3f));
+		Shape second = polyhedronShape(ShapeLibrary::createPrism(13, 0.7f, 1.3f));
+		Shape scaled = polyhedronShape(ShapeLibrary::createPrism(13, 0.7f, 1.3f).scaled(2.0f, 2.0f, 2.0f));
+		// not a power of two, the normalized vertices differ in their last bits
+		Shape roundedScale = polyhedronShape(ShapeLibrary::createPrism(13, 0.7f, 1.3f).scaled(0.3f, 0.3f, 0.3f));
+		Shape other = polyhedronShape(ShapeLibrary::createPrism(14, 0.7f, 1.3f));
+		ASSERT_TRUE(first.baseShape == second.baseShape);
+		ASSERT_TRUE(first.baseShape == scaled.baseShape);
+		ASSERT_TOLERANT(scaled.getWidth() == 2.0 * first.getWidth(), 0.00001);
+		ASSERT_TRUE(first.baseShape == roundedScale.baseShape);
+		ASSERT_TOLERANT(roundedScale.getWidth() == 0.3 * first.getWidth(), 0.00001);
+		ASSERT_FALSE(first.baseShape == other.baseShape);
+		ASSERT_STRICT(ShapeClassCache::getInternedClassCount() == initialCount + 2);
+
+		// a class made elsewhere joins the cache, or is replaced by the class already in it
+		intrusive_ptr<const ShapeClass> separate(createPolyhedronShapeClass(Polyhedron(first.baseShape->asPolyhedron())));
+		ASSERT_TRUE(ShapeClassCache::intern(separate) == first.baseShape);
+		intrusive_ptr<const ShapeClass> cube(&CubeClass::instance);
+		ASSERT_TRUE(ShapeClassCache::intern(cube) == cube);
+	}
+	ASSERT_STRICT(ShapeClassCache::getInternedClassCount() == initialCount);
+}
+
+TEST_CASE(epaDeepPenetration) {
+	Shape cube = boxShape(2.0, 2.0, 2.0);
+	std::optional<Intersection> cubes = intersectsTransformed(cube, cube, CFrame(Vec3(0.3, 0.1, -0.05)));
+	ASSERT_TRUE(cubes.has_value());
+	ASSERT_TOLERANT(std::abs(cubes->exitVector.x) == 1.7, 0.01);
+	ASSERT_TOLERANT(cubes->exitVector.y == 0.0, 0.01);
+	ASSERT_TOLERANT(cubes->exitVector.z == 0.0, 0.01);
+
+	// curved shapes need many expansions before the nearest face stops moving
+	Shape sphere = sphereShape(1.0);
+	Vec3 offset = normalize(Vec3(0.3, 0.5, -0.2)) * 0.5;
+	std::optional<Intersection> spheres = intersectsTransformed(sphere, sphere, CFrame(offset));
+	ASSERT_TRUE(spheres.has_value());
+	ASSERT_TOLERANT(length(spheres->exitVector) == 1.5, 0.02);
+	ASSERT_TOLERANT(std::abs(normalize(spheres->exitVector) * normalize(offset)) == 1.0, 0.01);
+}
+
+TEST_CASE(narrowphaseScaledRotatedPair) {
+	// the long box lies along z after the rotation and sinks 0.3 into the top of the cube
+	Shape cube = boxShape(2.0, 2.0, 2.0);
+	Shape plank = boxShape(4.0, 1.0, 1.0);
+	CFrame onTop(Vec3(0.2, 1.2, -0.1), Rotation::rotY(PI / 2));
+	std::optional<Intersection> result = intersectsTransformed(cube, plank, onTop);
+	ASSERT_TRUE(result.has_value());
+	ASSERT_TOLERANT(result->exitVector == Vec3(0.0, 0.3, 0.0), 0.005);
+
+	std::optional<Intersection> swapped = intersectsTransformed(plank, cube, ~onTop);
+	ASSERT_TRUE(swapped.has_value());
+	ASSERT_TOLERANT(onTop.localToRelative(swapped->exitVector) == Vec3(0.0, -0.3, 0.0), 0.005);
+}
+
+TEST_CASE(triangleMeshShapeRayQueries) {
+	TriangleMesh terrain = generateTerrainMesh(40, 2.0f);
+	Shape shape = triangleMeshShape(terrain);
+	// the shape is centered on the bounds of the mesh
+	TriangleMesh centered = terrain.translated(-Vec3f(terrain.getBounds().getCenter()));
+
+	int hitCount = 0;
+	for(int i = 0; i < 500; i++) {
+		Vec3 origin(generateDouble(-25.0, 25.0), generateDouble(-5.0, 5.0), generateDouble(-25.0, 25.0));
+		Vec3 direction = normalize(Vec3(generateDouble(-1.0, 1.0), generateDouble(-1.0, 1.0), generateDouble(-1.0, 1.0)));
+		double expected = centered.getIntersectionDistance(origin, direction);
+		double found = shape.getIntersectionDistance(origin, direction);
+		if(expected == std::numeric_limits<double>::max()) {
+			ASSERT_STRICT(found == std::numeric_limits<double>::max());
+		} else {
+			hitCount++;
+			ASSERT_TOLERANT(found == expected, 0.0001);
+		}
+	}
+	ASSERT_TRUE(hitCount > 50);
+
+	for(int i = 0; i < 100; i++) {
+		double x = generateDouble(-19.5, 19.5);
+		double z = generateDouble(-19.5, 19.5);
+		double height = 10.0 - centered.getIntersectionDistance(Vec3(x, 10.0, z), Vec3(0.0, -1.0, 0.0));
+		ASSERT_TRUE(shape.containsPoint(Vec3(x, height - 0.1, z)));
+		ASSERT_FALSE(shape.containsPoint(Vec3(x, height + 0.1, z)));
+	}
+}
+
+TEST_CASE(triangleMeshShapeAsPolyhedronKeepsTriangles) {
+	TriangleMesh terrain = generateTerrainMesh(16, 2.0f);
+	Shape shape = triangleMeshShape(terrain);
+	const TriangleMeshShapeClass& meshClass = static_cast<const TriangleMeshShapeClass&>(*shape.baseShape);
+
+	Polyhedron poly = meshClass.asPolyhedron();
+	ASSERT_STRICT(poly.triangleCount == terrain.triangleCount);
+	ASSERT_STRICT(poly.vertexCount == terrain.vertexCount);
+}
+
+TEST_CASE(triangleMeshShapeFindsOverlappingTriangles) {
+	Shape shape = triangleMeshShape(generateTerrainMesh(40, 2.0f));
+	const TriangleMeshShapeClass& meshClass = static_cast<const TriangleMeshShapeClass&>(*shape.baseShape);
+	const TriangleMesh& mesh = meshClass.getMesh();
+	ASSERT_STRICT(meshClass.getNodes().size() == 2 * mesh.triangleCount - 1);
+
+	for(int i = 0; i < 100; i++) {
+		Vec3 center(generateDouble(-1.0, 1.0), generateDouble(-1.0, 1.0), generateDouble(-1.0, 1.0));
+		BoundingBox query(center - Vec3(0.1, 0.2, 0.1), center + Vec3(0.1, 0.2, 0.1));
+
+		std::vector<bool> found(mesh.triangleCount, false);
+		int foundCount = 0;
+		meshClass.forEachTriangleInBounds(query, [&](int triangleIndex) {
+			found[triangleIndex] = true;
+			foundCount++;
+		});
+		ASSERT_TRUE(foundCount < mesh.triangleCount / 4);
+		for(int t = 0; t < mesh.triangleCount; t++) {
+			Triangle triangle = mesh.getTriangle(t);
+			BoundingBox bounds = BoundingBox(Vec3(mesh.getVertex(triangle.firstIndex)), Vec3(mesh.getVertex(triangle.firstIndex)))
+				.expanded(Vec3(mesh.getVertex(triangle.secondIndex))).expanded(Vec3(mesh.getVertex(triangle.thirdIndex)));
+			if(bounds.intersects(query)) {
+				ASSERT_TRUE(found[t]);
+			}
+		}
+	}
+}
+
+TEST_CASE(triangleMeshShapeColission) {
+	// flat ground 16 wide, centered on the origin
+	Shape ground = triangleMeshShape(generateTerrainMesh(16, 0.0f));
+	Shape cube = boxShape(1.0, 1.0, 1.0);
+
+	CFrame sunken(Vec3(0.3, 0.4, -1.2), Rotation::rotY(0.3));
+	std::optional<Intersection> result = intersectsTransformed(ground, cube, sunken);
+	ASSERT_TRUE(result.has_value());
+	ASSERT_TOLERANT(result->exitVector == Vec3(0.0, 0.1, 0.0), 0.001);
+
+	std::optional<Intersection> swapped = intersectsTransformed(cube, ground, ~sunken);
+	ASSERT_TRUE(swapped.has_value());
+	ASSERT_TOLERANT(sunken.localToRelative(swapped->exitVector) == Vec3(0.0, -0.1, 0.0), 0.001);
+
+	ASSERT_FALSE(intersectsTransformed(ground, cube, CFrame(Vec3(0.3, 0.6, -1.2))).has_value());
+	ASSERT_FALSE(intersectsTransformed(ground, cube, CFrame(Vec3(8.7, 0.4, -1.2))).has_value());
+	ASSERT_FALSE(intersectsTransformed(ground, ground, CFrame(Vec3(0.0, 0.0, 0.0))).has_value());
+
+	CFrame above(Vec3(0.3, 3.0, -1.2));
+	std::optional<SweepHit> hit = sweepTransformed(ground, cube, above, Vec3(0.0, -5.0, 0.0), 0.001);
+	ASSERT_TRUE(hit.has_value());
+	ASSERT_TOLERANT(hit->fraction * 5.0 == 2.5, 0.002);
+	ASSERT_TOLERANT(hit->normal == Vec3(0.0, 1.0, 0.0), 0.001);
+
+	std::optional<SweepHit> swappedHit = sweepTransformed(cube, ground, ~above, Vec3(0.0, 5.0, 0.0), 0.001);
+	ASSERT_TRUE(swappedHit.has_value());
+	ASSERT_TOLERANT(swappedHit->fraction * 5.0 == 2.5, 0.002);
+	ASSERT_TOLERANT(swappedHit->normal == Vec3(0.0, -1.0, 0.0), 0.001);
+	ASSERT_TOLERANT(swappedHit->point.y == -0.5, 0.002);
+
+	ASSERT_FALSE(sweepTransformed(ground, cube, above, Vec3(0.0, -2.0, 0.0), 0.001).has_value());
+}
+
+// the surface of a heightfield shape as a triangle mesh, with the same quantized heights and placement
+static TriangleMesh heightfieldSurfaceMesh(const Shape& shape) {
+	const HeightfieldShapeClass& heightfield = static_cast<const HeightfieldShapeClass&>(*shape.baseShape);
+	int sampleCountX = heightfield.getSampleCountX();
+	EditableMesh mesh(sampleCountX * heightfield.getSampleCountZ(), 2 * heightfield.getCellCountX() * heightfield.getCellCountZ());
+	for(int z = 0; z < heightfield.getSampleCountZ(); z++) {
+		for(int x = 0; x < sampleCountX; x++) {
+			Vec3f vertex = heightfield.getVertex(x, z);
+			mesh.setVertex(z * sampleCountX + x, vertex.x * float(shape.scale[0]), vertex.y * float(shape.scale[1]), vertex.z * float(shape.scale[2]));
+		}
+	}
+	for(int z = 0; z < heightfield.getCellCountZ(); z++) {
+		for(int x = 0; x < heightfield.getCellCountX(); x++) {
+			int corner = z * sampleCountX + x;
+			int cell = z * heightfield.getCellCountX() + x;
+			mesh.setTriangle(2 * cell, corner, corner + sampleCountX, corner + 1);
+			mesh.setTriangle(2 * cell + 1, corner + 1, corner + sampleCountX, corner + sampleCountX + 1);
+		}
+	}
+	return TriangleMesh(std::move(mesh));
+}
+
+TEST_CASE(heightfieldShapeRayQueries) {
+	std::vector<float> heights = generateTerrainHeights(40, 2.0f);
+	Shape shape = heightfieldShape(heights.data(), 41, 41, 1.0);
+	TriangleMesh surface = heightfieldSurfaceMesh(shape);
+	ASSERT_TOLERANT(shape.scale[0] == 20.0, 0.000001);
+
+	int hitCount = 0;
+	for(int i = 0; i < 500; i++) {
+		Vec3 origin(generateDouble(-25.0, 25.0), generateDouble(-5.0, 5.0), generateDouble(-25.0, 25.0));
+		Vec3 direction = normalize(Vec3(generateDouble(-1.0, 1.0), generateDouble(-1.0, 1.0), generateDouble(-1.0, 1.0)));
+		double expected = surface.getIntersectionDistance(origin, direction);
+		double found = shape.getIntersectionDistance(origin, direction);
+		if(expected == std::numeric_limits<double>::max()) {
+			ASSERT_STRICT(found == std::numeric_limits<double>::max());
+		} else {
+			hitCount++;
+			ASSERT_TOLERANT(found == expected, 0.0001);
+		}
+	}
+	ASSERT_TRUE(hitCount > 50);
+
+	for(int i = 0; i < 100; i++) {
+		double x = generateDouble(-19.5, 19.5);
+		double z = generateDouble(-19.5, 19.5);
+		double height = 10.0 - surface.getIntersectionDistance(Vec3(x, 10.0, z), Vec3(0.0, -1.0, 0.0));
+		ASSERT_TRUE(shape.containsPoint(Vec3(x, height - 0.01, z)));
+		ASSERT_FALSE(shape.containsPoint(Vec3(x, height + 0.01, z)));
+	}
+	ASSERT_FALSE(shape.containsPoint(Vec3(0.0, -shape.scale[1] - 0.01, 0.0)));
+
+	Polyhedron solid = shape.asPolyhedron();
+	ASSERT_TRUE(isValid(solid));
+	ASSERT_TRUE(solid.getVolume() > 0.0 && solid.getVolume() < shape.getVolume());
+}
+
+TEST_CASE(heightfieldShapeHeightRanges) {
+	std::vector<float> heights = generateTerrainHeights(37, 2.0f);
+	Shape shape = heightfieldShape(heights.data(), 38, 38, 0.5);
+	const HeightfieldShapeClass& heightfield = static_cast<const HeightfieldShapeClass&>(*shape.baseShape);
+
+	for(int i = 0; i < 100; i++) {
+		int cellX0 = static_cast<int>(generateSize_t(37));
+		int cellZ0 = static_cast<int>(generateSize_t(37));
+		int cellX1 = cellX0 + static_cast<int>(generateSize_t(37 - cellX0));
+		int cellZ1 = cellZ0 + static_cast<int>(generateSize_t(37 - cellZ0));
+
+		uint16_t exactMin = 65535;
+		uint16_t exactMax = 0;
+		for(int z = cellZ0; z <= cellZ1 + 1; z++) {
+			for(int x = cellX0; x <= cellX1 + 1; x++) {
+				exactMin = std::min(exactMin, heightfield.getQuantizedHeight(x, z));
+				exactMax = std::max(exactMax, heightfield.getQuantizedHeight(x, z));
+			}
+		}
+		uint16_t min;
+		uint16_t max;
+		heightfield.getHeightRange(cellX0, cellZ0, cellX1, cellZ1, min, max);
+		ASSERT_TRUE(min <= exactMin && max >= exactMax);
+	}
+
+	uint16_t min;
+	uint16_t max;
+	heightfield.getHeightRange(0, 0, 36, 36, min, max);
+	ASSERT_STRICT(min == 0);
+	ASSERT_STRICT(max == 65535);
+}
+
+TEST_CASE(heightfieldShapeColission) {
+	// flat ground 16 wide, centered on the origin
+	std::vector<float> flatHeights(17 * 17, 0.0f);
+	Shape ground = heightfieldShape(flatHeights.data(), 17, 17, 1.0);
+	Shape cube = boxShape(1.0, 1.0, 1.0);
+
+	CFrame sunken(Vec3(0.3, 0.4, -1.2), Rotation::rotY(0.3));
+	std::optional<Intersection> result = intersectsTransformed(ground, cube, sunken);
+	ASSERT_TRUE(result.has_value());
+	ASSERT_TOLERANT(result->exitVector == Vec3(0.0, 0.1, 0.0), 0.001);
+
+	std::optional<Intersection> swapped = intersectsTransformed(cube, ground, ~sunken);
+	ASSERT_TRUE(swapped.has_value());
+	ASSERT_TOLERANT(sunken.localToRelative(swapped->exitVector) == Vec3(0.0, -0.1, 0.0), 0.001);
+
+	ASSERT_FALSE(intersectsTransformed(ground, cube, CFrame(Vec3(0.3, 0.6, -1.2))).has_value());
+	ASSERT_FALSE(intersectsTransformed(ground, cube, CFrame(Vec3(8.7, 0.4, -1.2))).has_value());
+	ASSERT_FALSE(intersectsTransformed(ground, triangleMeshShape(generateTerrainMesh(16, 0.0f)), CFrame(Vec3(0.0, 0.0, 0.0))).has_value());
+
+	CFrame above(Vec3(0.3, 3.0, -1.2));
+	std::optional<SweepHit> hit = sweepTransformed(ground, cube, above, Vec3(0.0, -5.0, 0.0), 0.001);
+	ASSERT_TRUE(hit.has_value());
+	ASSERT_TOLERANT(hit->fraction * 5.0 == 2.5, 0.002);
+	ASSERT_TOLERANT(hit->normal == Vec3(0.0, 1.0, 0.0), 0.001);
+
+	// the same contacts as the triangle mesh of the surface on bumpy ground
+	std::vector<float> bumpyHeights = generateTerrainHeights(16, 1.0f);
+	Shape bumpy = heightfieldShape(bumpyHeights.data(), 17, 17, 1.0);
+	Shape bumpyMesh = triangleMeshShape(heightfieldSurfaceMesh(bumpy));
+	for(int i = 0; i < 50; i++) {
+		CFrame placement(Vec3(generateDouble(-7.0, 7.0), generateDouble(-1.0, 1.0), generateDouble(-7.0, 7.0)), generateRotation());
+		std::optional<Intersection> fromHeightfield = intersectsTransformed(bumpy, cube, placement);
+		std::optional<Intersection> fromMesh = intersectsTransformed(bumpyMesh, cube, placement);
+		ASSERT_STRICT(fromHeightfield.has_value() == fromMesh.has_value());
+		if(fromHeightfield) {
+			ASSERT_TOLERANT(fromHeightfield->exitVector == fromMesh->exitVector, 0.001);
+		}
+	}
+}
@@ -0,0 +1,121 @@
+#include "testsMain.h"
+
+#include "../engine/core.h"
+#include "../engine/io/import.h"
+#include "../graphics/extendedTriangleMesh.h"
+#include "../util/fileUtils.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace P3D;
+
+static bool isTriangleOf(const Graphics::ExtendedTriangleMesh& mesh, int triangleIndex, float x) {
+	Triangle triangle = mesh.getTriangle(triangleIndex);
+	Vec3f a = mesh.getVertex(triangle.firstIndex);
+	Vec3f b = mesh.getVertex(triangle.secondIndex);
+	Vec3f c = mesh.getVertex(triangle.thirdIndex);
+
+	return a == Vec3f(x, 0.0f, 0.0f) && b == Vec3f(x, 1.0f, 0.0f) && c == Vec3f(x, 0.0f, 1.0f);
+}
+
+static void writeTriangleVertices(std::ostream& obj, int triangle) {
+	obj << "v " << triangle << " 0 0\n";
+	obj << "v " << triangle << " 1 0\n";
+	obj << "v " << triangle << " 0 1\n";
+}
+
+TEST_CASE(objFacesSpanningChunks) {
+	// Large enough to be split into several chunks, the faces of the first part refer to vertices of earlier chunks
+	constexpr int sharedCount = 20000;
+	constexpr int interleavedCount = 20000;
+
+	std::stringstream obj;
+	for (int triangle = 0; triangle < sharedCount; triangle++)
+		writeTriangleVertices(obj, triangle);
+
+	for (int triangle = 0; triangle < sharedCount; triangle++) {
+		int first = 3 * triangle;
+		if (triangle % 2 == 0)
+			obj << "f " << first + 1 << " " << first + 2 << " " << first + 3 << "\n";
+		else
+			obj << "f " << first - 3 * sharedCount << " " << first + 1 - 3 * sharedCount << "   " << first + 2 - 3 * sharedCount << "\n";
+	}
+
+	// Relative indices for every attribute, resolved against the elements defined right before the face
+	for (int triangle = sharedCount; triangle < sharedCount + interleavedCount; triangle++) {
+		writeTriangleVertices(obj, triangle);
+		obj << "vn 0 0 1\n";
+		obj << "f -3//-1 -2//-1 -1//-1\n";
+	}
+
+	Graphics::ExtendedTriangleMesh mesh = OBJImport::load(obj, false);
+
+	ASSERT_TRUE(mesh.triangleCount == sharedCount + interleavedCount);
+	ASSERT_TRUE(mesh.normals != nullptr);
+	for (int triangle = 0; triangle < mesh.triangleCount; triangle++) {
+		ASSERT_TRUE(isTriangleOf(mesh, triangle, static_cast<float>(triangle)));
+	}
+	for (int triangle = sharedCount; triangle < mesh.triangleCount; triangle++) {
+		ASSERT_TRUE(mesh.normals[mesh.getTriangle(triangle).firstIndex] == Vec3f(0.0f, 0.0f, 1.0f));
+	}
+}
+
+TEST_CASE(objPolygonsAreFanTriangulated) {
+	std::stringstream obj("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 0.5 1.5 0\nf 1 2 3 4 -1\n");
+
+	Graphics::ExtendedTriangleMesh mesh = OBJImport::load(obj, false);
+
+	ASSERT_TRUE(mesh.triangleCount == 3);
+	ASSERT_TRUE(mesh.vertexCount == 5);
+	for (int triangle = 0; triangle < mesh.triangleCount; triangle++) {
+		ASSERT_TRUE(mesh.getVertex(mesh.getTriangle(triangle).firstIndex) == Vec3f(0.0f, 0.0f, 0.0f));
+	}
+	ASSERT_TRUE(mesh.getVertex(mesh.getTriangle(2).thirdIndex) == Vec3f(0.5f, 1.5f, 0.0f));
+}
+
+TEST_CASE(objMeshCacheFollowsSource) {
+	const std::string directory = "objMeshCacheFollowsSource";
+	const std::string path = directory + "/triangle.obj";
+	Util::createDirectory(directory);
+
+	auto write = [&path] (float x) {
+		std::ofstream file(path);
+		file << "v " << x << " 0 0\nv " << x << " 1 0\nv " << x << " 0 1\nf 1 2 3\n";
+	};
+
+	write(1.0f);
+	Graphics::ExtendedTriangleMesh parsed = OBJImport::load(path);
+	ASSERT_TRUE(std::filesystem::exists(directory + "/.meshcache"));
+	ASSERT_FALSE(std::filesystem::is_empty(directory + "/.meshcache"));
+
+	Graphics::ExtendedTriangleMesh cached = OBJImport::load(path);
+	ASSERT_TRUE(parsed.triangleCount == 1 && cached.triangleCount == 1);
+	ASSERT_TRUE(isTriangleOf(cached, 0, 1.0f));
+
+	// Only the modification time changed, the hash shows the entry still matches and it is kept
+	std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path);
+	std::filesystem::last_write_time(path, writeTime + std::chrono::seconds(10));
+	ASSERT_TRUE(isTriangleOf(OBJImport::load(path), 0, 1.0f));
+
+	// Same size, another modification time, only the hash of the content tells the entry is stale
+	write(2.0f);
+	std::filesystem::last_write_time(path, writeTime + std::chrono::seconds(20));
+	ASSERT_TRUE(isTriangleOf(OBJImport::load(path), 0, 2.0f));
+
+	// Size and modification time match, the entry is used without reading the source
+	std::filesystem::file_time_type cachedWriteTime = std::filesystem::last_write_time(path);
+	write(4.0f);
+	std::filesystem::last_write_time(path, cachedWriteTime);
+	ASSERT_TRUE(isTriangleOf(OBJImport::load(path), 0, 2.0f));
+
+	// The stale entry is replaced
+	write(3.0f);
+	ASSERT_TRUE(isTriangleOf(OBJImport::load(path), 0, 3.0f));
+	ASSERT_TRUE(isTriangleOf(OBJImport::load(path), 0, 3.0f));
+
+	std::filesystem::remove_all(directory);
+}
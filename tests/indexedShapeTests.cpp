@@ -9,6 +9,9 @@
 #include <Physics3D/geometry/shapeLibrary.h>
 #include <Physics3D/misc/validityHelper.h>
 
+#include <vector>
+#include <cmath>
+
 using namespace P3D;
 TEST_CASE(testIndexedShape) {
 	Vec3f verts[]{Vec3f(0.0, 0.0, 0.0), Vec3f(1.0, 0.0, 0.0), Vec3f(0.0, 0.0, 1.0), Vec3f(0.0, 1.0, 0.0)};
@@ -90,3 +93,83 @@ TEST_CASE(buildConvexShape) {
 
 	ASSERT_TRUE(isValid(icosaBuilder.toIndexedShape()));
 }
+
+TEST_CASE(convexShapeBuilderReportsChangedTriangles) {
+	int builderRemovalBuffer[1000];
+	EdgePiece builderAddingBuffer[1000];
+
+	Vec3f verts[300]{Vec3f(0.0, 0.0, 0.0), Vec3f(1.0, 0.0, 0.0), Vec3f(0.0, 0.0, 1.0), Vec3f(0.0, 1.0, 0.0)};
+	Triangle triangles[600]{{0,1,2},{0,3,1},{0,2,3},{1,3,2}};
+	TriangleNeighbors neighBuf[600];
+
+	ConvexShapeBuilder builder(verts, triangles, 4, 4, neighBuf, builderRemovalBuffer, builderAddingBuffer);
+
+	// a copy of the triangles that is only updated at the reported indices must stay equal to the builder
+	std::vector<Triangle> known(triangles, triangles + 4);
+	for(int i = 0; i < 200; i++) {
+		float angle = i * 2.4f;
+		float height = 1.0f - (i + 0.5f) / 100.0f;
+		float radius = std::sqrt(1.0f - height * height);
+		Vec3f point = Vec3f(radius * std::cos(angle), height, radius * std::sin(angle)) * 3.0f;
+
+		int above = -1;
+		for(int t = 0; t < builder.triangleCount; t++) {
+			if(builder.isAbove(point, triangles[t])) {
+				above = t;
+				break;
+			}
+		}
+		if(above == -1) continue;
+
+		int changedCount = builder.addPoint(point, above);
+		known.resize(builder.triangleCount);
+		for(int c = 0; c < changedCount; c++) {
+			int changed = builderRemovalBuffer[c];
+			ASSERT_TRUE(changed < builder.triangleCount);
+			known[changed] = triangles[changed];
+		}
+		for(int t = 0; t < builder.triangleCount; t++) {
+			ASSERT_TRUE(known[t] == triangles[t]);
+		}
+	}
+	ASSERT_TRUE(isValid(builder.toIndexedShape()));
+}
+
+TEST_CASE(fillNeighborBufLargeMesh) {
+	// more triangles than fit on the stack
+	Polyhedron sphere = ShapeLibrary::createSphere(1.0f, 3);
+	std::vector<Triangle> triangles(sphere.triangleCount);
+	sphere.getTriangles(triangles.data());
+	std::vector<TriangleNeighbors> neighBuf(sphere.triangleCount);
+
+	ASSERT_STRICT(fillNeighborBuf(triangles.data(), sphere.triangleCount, neighBuf.data()) == 0);
+	for(int i = 0; i < sphere.triangleCount; i++) {
+		for(int side = 0; side < 3; side++) {
+			// the neighbor across side i, opposite vertex i+2, has the edge the other way around
+			const Triangle& neighbor = triangles[neighBuf[i][(side + 2) % 3]];
+			int from = triangles[i][side];
+			int to = triangles[i][(side + 1) % 3];
+			bool hasTwin = false;
+			for(int neighborSide = 0; neighborSide < 3; neighborSide++) {
+				if(neighbor[neighborSide] == to && neighbor[(neighborSide + 1) % 3] == from) hasTwin = true;
+			}
+			ASSERT_TRUE(hasTwin);
+		}
+	}
+	ASSERT_TRUE(isValid(IndexedShape(Polyhedron(sphere), neighBuf.data())));
+}
+
+TEST_CASE(fillNeighborBufReportsUnmatchedEdges) {
+	// a tetrahedron without its last face leaves the three sides around the hole unmatched
+	Triangle openTriangles[]{{0,1,2},{0,3,1},{0,2,3}};
+	TriangleNeighbors openNeighBuf[3]{{-1, -1, -1}, {-1, -1, -1}, {-1, -1, -1}};
+	ASSERT_STRICT(fillNeighborBuf(openTriangles, 3, openNeighBuf) == 3);
+	ASSERT_STRICT(openNeighBuf[0].BC_Neighbor == -1);
+	ASSERT_STRICT(openNeighBuf[0].CA_Neighbor == 2);
+	ASSERT_STRICT(openNeighBuf[0].AB_Neighbor == 1);
+
+	// a fin on edge 0-1 of a closed tetrahedron makes that edge non-manifold, its three sides along the edge and its two open sides are unmatched
+	Triangle nonManifoldTriangles[]{{0,1,2},{0,3,1},{0,2,3},{1,3,2},{1,0,4}};
+	TriangleNeighbors nonManifoldNeighBuf[5];
+	ASSERT_STRICT(fillNeighborBuf(nonManifoldTriangles, 5, nonManifoldNeighBuf) == 5);
+}
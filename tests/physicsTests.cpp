@@ -6,6 +6,7 @@
 #include "generators.h"
 
 #include <Physics3D/world.h>
+#include <Physics3D/bodyStore.h>
 #include <Physics3D/inertia.h>
 #include <Physics3D/math/linalg/trigonometry.h>
 #include <Physics3D/math/linalg/eigen.h>
@@ -964,6 +965,209 @@ TEST_CASE(conservationOfAngularMomentum) {
 	}
 }
 
+TEST_CASE(rigidUpdateMatchesArticulatedUpdate) {
+	// the same body, once rigidly attached and once attached through a FixedConstraint, the first takes the rigid fast path
+	Part mainPart1(boxShape(1.0, 2.0, 0.5), GlobalCFrame(), basicProperties);
+	Part attachedPart1(boxShape(0.7, 0.3, 1.5), mainPart1,
+					   CFrame(1.5, 0.3, -0.2, Rotation::fromEulerAngles(0.3, 0.5, 0.1)), basicProperties);
+
+	Part mainPart2(boxShape(1.0, 2.0, 0.5), GlobalCFrame(), basicProperties);
+	Part attachedPart2(boxShape(0.7, 0.3, 1.5), mainPart2,
+					   new FixedConstraint(),
+					   CFrame(1.5, 0.3, -0.2, Rotation::fromEulerAngles(0.3, 0.5, 0.1)),
+					   CFrame(0.0, 0.0, 0.0, Rotation::Predefined::IDENTITY), basicProperties);
+
+	MotorizedPhysical* rigidPhys = mainPart1.getMainPhysical();
+	MotorizedPhysical* articulatedPhys = mainPart2.getMainPhysical();
+
+	ASSERT(rigidPhys->childPhysicals.empty());
+	ASSERT(!articulatedPhys->childPhysicals.empty());
+
+	rigidPhys->motionOfCenterOfMass = Motion(Vec3(2.0, 3.0, 1.0), Vec3(-1.7, 3.3, 12.0));
+	articulatedPhys->motionOfCenterOfMass = Motion(Vec3(2.0, 3.0, 1.0), Vec3(-1.7, 3.3, 12.0));
+
+	Vec3 initialAngularMomentum = rigidPhys->getTotalAngularMomentum();
+
+	for(int i = 0; i < TICKS; i++) {
+		rigidPhys->applyForceAtCenterOfMass(Vec3(0.0, -9.81, 0.0) * rigidPhys->totalMass);
+		articulatedPhys->applyForceAtCenterOfMass(Vec3(0.0, -9.81, 0.0) * articulatedPhys->totalMass);
+
+		rigidPhys->update(DELTA_T);
+		articulatedPhys->update(DELTA_T);
+
+		ASSERT(initialAngularMomentum == rigidPhys->getTotalAngularMomentum());
+		ASSERT(rigidPhys->getCenterOfMass() == articulatedPhys->getCenterOfMass());
+		ASSERT(attachedPart1.getCFrame() == attachedPart2.getCFrame());
+		ASSERT(rigidPhys->motionOfCenterOfMass == articulatedPhys->motionOfCenterOfMass);
+	}
+}
+
+TEST_CASE(bodyStoreMatchesPhysicalUpdate) {
+	Part part1(boxShape(1.0, 2.0, 0.5), GlobalCFrame(0.0, 0.0, 0.0, Rotation::fromEulerAngles(0.3, 0.5, 0.1)), basicProperties);
+	Part attachedPart1(boxShape(0.7, 0.3, 1.5), part1, CFrame(1.5, 0.3, -0.2, Rotation::fromEulerAngles(0.3, 0.5, 0.1)), basicProperties);
+	Part part2(boxShape(1.0, 2.0, 0.5), GlobalCFrame(0.0, 0.0, 0.0, Rotation::fromEulerAngles(0.3, 0.5, 0.1)), basicProperties);
+	Part attachedPart2(boxShape(0.7, 0.3, 1.5), part2, CFrame(1.5, 0.3, -0.2, Rotation::fromEulerAngles(0.3, 0.5, 0.1)), basicProperties);
+
+	MotorizedPhysical* updatedPhys = part1.getMainPhysical();
+	MotorizedPhysical* storedPhys = part2.getMainPhysical();
+
+	updatedPhys->motionOfCenterOfMass = Motion(Vec3(2.0, 3.0, 1.0), Vec3(-1.7, 3.3, 12.0));
+	storedPhys->motionOfCenterOfMass = Motion(Vec3(2.0, 3.0, 1.0), Vec3(-1.7, 3.3, 12.0));
+
+	BodyStore store;
+	for(int i = 0; i < TICKS; i++) {
+		updatedPhys->applyForceAtCenterOfMass(Vec3(0.0, -9.81, 0.0) * updatedPhys->totalMass);
+		updatedPhys->applyMoment(Vec3(0.1, 0.0, -0.2));
+		updatedPhys->update(DELTA_T);
+
+		storedPhys->applyForceAtCenterOfMass(Vec3(0.0, -9.81, 0.0) * storedPhys->totalMass);
+		storedPhys->applyMoment(Vec3(0.1, 0.0, -0.2));
+		store.clear();
+		store.add(storedPhys);
+		store.integrate(DELTA_T);
+		store.scatter();
+
+		ASSERT(updatedPhys->getCenterOfMass() == storedPhys->getCenterOfMass());
+		ASSERT(attachedPart1.getCFrame() == attachedPart2.getCFrame());
+		ASSERT(updatedPhys->motionOfCenterOfMass == storedPhys->motionOfCenterOfMass);
+	}
+}
+
+// spinning close to the middle axis of inertia the body tumbles, the angular velocity changes every tick and differences between the paths would grow
+TEST_CASE(bodyStoreMatchesPhysicalUpdateWhileTumbling) {
+	Part part1(boxShape(0.3, 1.0, 2.5), GlobalCFrame(0.0, 0.0, 0.0, Rotation::fromEulerAngles(0.2, -0.4, 0.7)), basicProperties);
+	Part part2(boxShape(0.3, 1.0, 2.5), GlobalCFrame(0.0, 0.0, 0.0, Rotation::fromEulerAngles(0.2, -0.4, 0.7)), basicProperties);
+	part1.ensureHasPhysical();
+	part2.ensureHasPhysical();
+
+	MotorizedPhysical* updatedPhys = part1.getMainPhysical();
+	MotorizedPhysical* storedPhys = part2.getMainPhysical();
+
+	Vec3 spin = part1.getCFrame().localToRelative(Vec3(0.05, 10.0, 0.05));
+	updatedPhys->motionOfCenterOfMass = Motion(Vec3(0.0, 0.0, 0.0), spin);
+	storedPhys->motionOfCenterOfMass = Motion(Vec3(0.0, 0.0, 0.0), spin);
+
+	BodyStore store;
+	for(int i = 0; i < TICKS; i++) {
+		updatedPhys->update(DELTA_T);
+
+		store.clear();
+		store.add(storedPhys);
+		store.integrate(DELTA_T);
+		store.scatter();
+
+		ASSERT(part1.getCFrame() == part2.getCFrame());
+		ASSERT(updatedPhys->motionOfCenterOfMass == storedPhys->motionOfCenterOfMass);
+	}
+	// it did tumble
+	ASSERT_FALSE(part1.getCFrame().localToRelative(Vec3(0.0, 1.0, 0.0)) == spin / length(spin));
+}
+
+static double getBulletPositionAfterTicks(bool continuousColission, int ticks) {
+	WorldPrototype world(DELTA_T);
+	Part wall(boxShape(0.05, 10.0, 10.0), GlobalCFrame(5.0, 0.0, 0.0), basicProperties);
+	Part bullet(sphereShape(0.1), GlobalCFrame(0.0, 0.0, 0.0), basicProperties);
+	world.addTerrainPart(&wall);
+	world.addPart(&bullet);
+
+	// moves 3 per tick, far more than the thickness of the wall
+	bullet.setVelocity(Vec3(300.0, 0.0, 0.0));
+	bullet.getMainPhysical()->continuousColission = continuousColission;
+	for(int i = 0; i < ticks; i++) {
+		world.tick();
+	}
+	return static_cast<double>(bullet.getPosition().x);
+}
+
+TEST_CASE(continuousColissionStopsTunneling) {
+	ASSERT_TRUE(getBulletPositionAfterTicks(false, 5) > 5.0);
+	// the second tick would pass the wall, the bullet is put back against it
+	double stoppedPosition = getBulletPositionAfterTicks(true, 2);
+	ASSERT_TRUE(stoppedPosition > 4.85 && stoppedPosition < 4.9);
+	ASSERT_TRUE(getBulletPositionAfterTicks(true, 20) < 5.0);
+}
+
+static Vec3 getBulletVelocityAfterHittingWall(double bouncyness) {
+	WorldPrototype world(DELTA_T);
+	Part wall(boxShape(0.05, 10.0, 10.0), GlobalCFrame(5.0, 0.0, 0.0), basicProperties);
+	Part bullet(sphereShape(0.1), GlobalCFrame(0.0, 0.0, 0.0), basicProperties);
+	wall.setBouncyness(bouncyness);
+	bullet.setBouncyness(1.0);
+	world.addTerrainPart(&wall);
+	world.addPart(&bullet);
+
+	bullet.setVelocity(Vec3(300.0, 0.0, 30.0));
+	bullet.getMainPhysical()->continuousColission = true;
+	for(int i = 0; i < 2; i++) {
+		world.tick();
+	}
+	ASSERT_TRUE(static_cast<double>(bullet.getPosition().x) < 5.0);
+	return bullet.getVelocity();
+}
+
+TEST_CASE(continuousColissionBouncesOffSurface) {
+	// stopped against the wall, but still sliding along it
+	Vec3 stoppedVelocity = getBulletVelocityAfterHittingWall(0.0);
+	ASSERT_TOLERANT(stoppedVelocity.x == 0.0, 0.0001);
+	ASSERT_TOLERANT(stoppedVelocity.z == 30.0, 0.0001);
+
+	// the speed into the wall is reversed and scaled by the bouncyness of both parts
+	Vec3 bouncedVelocity = getBulletVelocityAfterHittingWall(0.5);
+	ASSERT_TOLERANT(bouncedVelocity.x == -150.0, 0.0001);
+	ASSERT_TOLERANT(bouncedVelocity.z == 30.0, 0.0001);
+}
+
+TEST_CASE(partsRestOnTriangleMeshTerrain) {
+	WorldPrototype world(DELTA_T);
+	world.addExternalForce(new DirectionalGravity(Vec3(0, -10, 0)));
+
+	// centered on the origin, the flat ground lies at y = 0
+	Part flatGround(triangleMeshShape(generateTerrainMesh(20, 0.0f)), GlobalCFrame(), basicProperties);
+	Part bumpyGround(triangleMeshShape(generateTerrainMesh(20, 0.5f)), GlobalCFrame(40.0, 0.0, 0.0), basicProperties);
+	Part box(boxShape(1.0, 1.0, 1.0), GlobalCFrame(0.3, 2.0, -1.2), basicProperties);
+	Part sphere(sphereShape(0.5), GlobalCFrame(40.3, 2.0, -1.2), basicProperties);
+	world.addTerrainPart(&flatGround);
+	world.addTerrainPart(&bumpyGround);
+	world.addPart(&box);
+	world.addPart(&sphere);
+
+	for(int i = 0; i < 500; i++) {
+		world.tick();
+	}
+
+	ASSERT_TOLERANT(static_cast<double>(box.getPosition().y) == 0.5, 0.02);
+	ASSERT_TOLERANT(box.getVelocity() == Vec3(0.0, 0.0, 0.0), 0.05);
+	// the sphere did not sink through the bumpy ground, the ground is more than 5 below a point 5 above it
+	Vec3 sphereAbove = bumpyGround.getCFrame().globalToLocal(sphere.getPosition()) + Vec3(0.0, 5.0, 0.0);
+	ASSERT_TRUE(bumpyGround.hitbox.getIntersectionDistance(sphereAbove, Vec3(0.0, -1.0, 0.0)) > 5.0);
+}
+
+TEST_CASE(partsRestOnHeightfieldTerrain) {
+	WorldPrototype world(DELTA_T);
+	world.addExternalForce(new DirectionalGravity(Vec3(0, -10, 0)));
+
+	// centered on its bounds, the flat ground has its surface at y = 0
+	std::vector<float> flatHeights = generateTerrainHeights(20, 0.0f);
+	std::vector<float> bumpyHeights = generateTerrainHeights(20, 0.5f);
+	Part flatGround(heightfieldShape(flatHeights.data(), 21, 21, 1.0), GlobalCFrame(), basicProperties);
+	Part bumpyGround(heightfieldShape(bumpyHeights.data(), 21, 21, 1.0), GlobalCFrame(40.0, 0.0, 0.0), basicProperties);
+	Part box(boxShape(1.0, 1.0, 1.0), GlobalCFrame(0.3, 2.0, -1.2), basicProperties);
+	Part sphere(sphereShape(0.5), GlobalCFrame(40.3, 2.0, -1.2), basicProperties);
+	world.addTerrainPart(&flatGround);
+	world.addTerrainPart(&bumpyGround);
+	world.addPart(&box);
+	world.addPart(&sphere);
+
+	for(int i = 0; i < 500; i++) {
+		world.tick();
+	}
+
+	ASSERT_TOLERANT(static_cast<double>(box.getPosition().y) == 0.5, 0.02);
+	ASSERT_TOLERANT(box.getVelocity() == Vec3(0.0, 0.0, 0.0), 0.05);
+	Vec3 sphereAbove = bumpyGround.getCFrame().globalToLocal(sphere.getPosition()) + Vec3(0.0, 5.0, 0.0);
+	ASSERT_TRUE(bumpyGround.hitbox.getIntersectionDistance(sphereAbove, Vec3(0.0, -1.0, 0.0)) > 5.0);
+}
+
 TEST_CASE(conservationOfCenterOfMass) {
 	std::vector<Part> phys = produceMotorizedPhysical();
 
@@ -0,0 +1,265 @@
+#include "testsMain.h"
+
+#include <Physics3D/misc/zoneProfiler.h>
+#include <Physics3D/misc/physicsProfiler.h>
+#include <Physics3D/threading/physicsThread.h>
+#include <Physics3D/world.h>
+#include <Physics3D/geometry/shapeCreation.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace P3D;
+
+enum class TestProcess {
+	OUTER,
+	INNER,
+	OTHER,
+	COUNT
+};
+
+static const char* testProcessLabels[]{
+	"Outer",
+	"Inner",
+	"Other"
+};
+
+enum class TestCounter {
+	STEPS,
+	COUNT
+};
+
+static const char* testCounterLabels[]{
+	"Steps"
+};
+
+static void spinFor(std::chrono::microseconds duration) {
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + duration;
+	while(std::chrono::steady_clock::now() < end);
+}
+
+static std::chrono::microseconds timeOf(ZoneProfiler<TestProcess>& profiler, TestProcess process) {
+	return std::chrono::duration_cast<std::chrono::microseconds>(profiler.history.front()[static_cast<std::size_t>(process)]);
+}
+
+// Zones left over from other tests would be counted for the wrong process
+static void clearPendingZones(ZoneProfiler<TestProcess>& profiler) {
+	profiler.startTick();
+	profiler.endTick();
+}
+
+TEST_CASE(nestedZonesExcludeInnerZones) {
+	ZoneProfiler<TestProcess> profiler(testProcessLabels, 10, TestProcess::OTHER);
+	clearPendingZones(profiler);
+
+	profiler.startTick();
+	{
+		ProfileZone outer(TestProcess::OUTER);
+		spinFor(std::chrono::microseconds(2000));
+		{
+			ProfileZone inner(TestProcess::INNER);
+			spinFor(std::chrono::microseconds(3000));
+		}
+	}
+	profiler.endTick();
+
+	ASSERT_TRUE(timeOf(profiler, TestProcess::INNER).count() >= 2900);
+	ASSERT_TRUE(timeOf(profiler, TestProcess::OUTER).count() >= 1900);
+	ASSERT_TRUE(timeOf(profiler, TestProcess::OUTER).count() < 2900);
+}
+
+TEST_CASE(timeOutsideZonesIsUnaccounted) {
+	ZoneProfiler<TestProcess> profiler(testProcessLabels, 10, TestProcess::OTHER);
+	clearPendingZones(profiler);
+
+	profiler.startTick();
+	spinFor(std::chrono::microseconds(2000));
+	{
+		ProfileZone zone(TestProcess::OUTER);
+		spinFor(std::chrono::microseconds(1000));
+	}
+	profiler.endTick();
+
+	ASSERT_TRUE(timeOf(profiler, TestProcess::OTHER).count() >= 1900);
+	ASSERT_TRUE(timeOf(profiler, TestProcess::OUTER).count() >= 900);
+	ASSERT_TRUE(timeOf(profiler, TestProcess::OUTER).count() < 1900);
+}
+
+TEST_CASE(zoneNextAndSetProcess) {
+	ZoneProfiler<TestProcess> profiler(testProcessLabels, 10, TestProcess::OTHER);
+	clearPendingZones(profiler);
+
+	profiler.startTick();
+	{
+		ProfileZone zone(TestProcess::OUTER);
+		spinFor(std::chrono::microseconds(1000));
+		zone.next(TestProcess::OUTER);
+		spinFor(std::chrono::microseconds(1000));
+		zone.setProcess(TestProcess::INNER);
+	}
+	profiler.endTick();
+
+	ASSERT_TRUE(timeOf(profiler, TestProcess::OUTER).count() >= 900);
+	ASSERT_TRUE(timeOf(profiler, TestProcess::OUTER).count() < 1900);
+	ASSERT_TRUE(timeOf(profiler, TestProcess::INNER).count() >= 900);
+}
+
+TEST_CASE(zonesOfAllThreadsAreCounted) {
+	ZoneProfiler<TestProcess> profiler(testProcessLabels, 10, TestProcess::OTHER);
+	clearPendingZones(profiler);
+
+	profiler.startTick();
+	std::vector<std::thread> threads;
+	for(int i = 0; i < 4; i++) {
+		threads.emplace_back([]() {
+			for(int j = 0; j < 1000; j++) {
+				ProfileZone zone(TestProcess::INNER);
+				spinFor(std::chrono::microseconds(1));
+			}
+			ProfileZone zone(TestProcess::OUTER);
+			spinFor(std::chrono::microseconds(1000));
+		});
+	}
+	for(std::thread& thread : threads) {
+		thread.join();
+	}
+	profiler.endTick();
+
+	// the buffers of the exited threads have been read and removed, a second tick finds nothing of them
+	ASSERT_TRUE(timeOf(profiler, TestProcess::OUTER).count() >= 4 * 900);
+	ASSERT_TRUE(timeOf(profiler, TestProcess::INNER).count() >= 4 * 900);
+
+	profiler.startTick();
+	profiler.endTick();
+
+	ASSERT_TRUE(timeOf(profiler, TestProcess::OUTER).count() == 0);
+	ASSERT_TRUE(timeOf(profiler, TestProcess::INNER).count() == 0);
+}
+
+TEST_CASE(traceRecordsZonesAndCounters) {
+	TickTrace trace(testProcessLabels, static_cast<std::size_t>(TestProcess::COUNT), testCounterLabels, static_cast<std::size_t>(TestCounter::COUNT), 10);
+	ZoneProfiler<TestProcess> profiler(testProcessLabels, 10, TestProcess::OTHER, &trace);
+	clearPendingZones(profiler);
+	trace.setRecording(true);
+
+	for(int tick = 0; tick < 3; tick++) {
+		profiler.startTick();
+		{
+			ProfileZone outer(TestProcess::OUTER);
+			ProfileZone inner(TestProcess::INNER);
+			trace.setCounter(TestCounter::STEPS, tick * 10);
+		}
+		profiler.endTick();
+	}
+
+	ASSERT_TRUE(trace.size() == 3);
+	for(std::size_t i = 0; i < trace.size(); i++) {
+		const TickTimeline& timeline = trace.getTimeline(i);
+		ASSERT_TRUE(timeline.zones.size() == 2);
+		ASSERT_TRUE(timeline.counters[0] == static_cast<long long>(i) * 10);
+		for(const TracedZone& zone : timeline.zones) {
+			ASSERT_TRUE(zone.start >= timeline.start && zone.end <= timeline.end);
+		}
+	}
+
+	std::stringstream json;
+	trace.writeChromeTrace(json);
+	std::string text = json.str();
+	ASSERT_TRUE(text.find("\"traceEvents\"") != std::string::npos);
+	ASSERT_TRUE(text.find("\"name\":\"Outer\",\"cat\":\"zone\",\"ph\":\"X\"") != std::string::npos);
+	ASSERT_TRUE(text.find("\"name\":\"Steps\",\"ph\":\"C\"") != std::string::npos);
+	ASSERT_TRUE(text.find("\"value\":20") != std::string::npos);
+}
+
+TEST_CASE(traceKeepsOnlyTheLastTicks) {
+	TickTrace trace(testProcessLabels, static_cast<std::size_t>(TestProcess::COUNT), testCounterLabels, static_cast<std::size_t>(TestCounter::COUNT), 2);
+	ZoneProfiler<TestProcess> profiler(testProcessLabels, 10, TestProcess::OTHER, &trace);
+
+	// ticks are only traced while recording
+	profiler.startTick();
+	profiler.endTick();
+	ASSERT_TRUE(trace.size() == 0);
+
+	trace.setRecording(true);
+	for(int tick = 0; tick < 5; tick++) {
+		profiler.startTick();
+		profiler.endTick();
+	}
+
+	ASSERT_TRUE(trace.size() == 2);
+	ASSERT_TRUE(trace.getTimeline(0).tickIndex == 3);
+	ASSERT_TRUE(trace.getTimeline(1).tickIndex == 4);
+}
+
+TEST_CASE(traceDumpsSlowTicks) {
+	TickTrace trace(testProcessLabels, static_cast<std::size_t>(TestProcess::COUNT), testCounterLabels, static_cast<std::size_t>(TestCounter::COUNT), 4);
+	ZoneProfiler<TestProcess> profiler(testProcessLabels, 10, TestProcess::OTHER, &trace);
+	trace.setRecording(true);
+	trace.dumpSpikes(std::chrono::milliseconds(2), "traceDumpsSlowTicks_");
+
+	profiler.startTick();
+	profiler.endTick();
+	profiler.startTick();
+	spinFor(std::chrono::microseconds(3000));
+	profiler.endTick();
+	trace.waitForDumps();
+
+	std::ifstream fastTick("traceDumpsSlowTicks_tick0.json");
+	ASSERT_FALSE(fastTick.is_open());
+	std::ifstream slowTick("traceDumpsSlowTicks_tick1.json");
+	ASSERT_TRUE(slowTick.is_open());
+	std::string firstLine;
+	std::getline(slowTick, firstLine);
+	slowTick.close();
+	std::remove("traceDumpsSlowTicks_tick1.json");
+
+	ASSERT_TRUE(firstLine.find("traceEvents") != std::string::npos);
+}
+
+TEST_CASE(traceRefusesDumpWhileNotRecording) {
+	TickTrace trace(testProcessLabels, static_cast<std::size_t>(TestProcess::COUNT), testCounterLabels, static_cast<std::size_t>(TestCounter::COUNT), 4);
+	ZoneProfiler<TestProcess> profiler(testProcessLabels, 10, TestProcess::OTHER, &trace);
+
+	ASSERT_FALSE(trace.requestDump("traceRefusesDumpWhileNotRecording.json"));
+	trace.setRecording(true);
+	profiler.startTick();
+	profiler.endTick();
+	trace.waitForDumps();
+	std::ifstream notRequested("traceRefusesDumpWhileNotRecording.json");
+	ASSERT_FALSE(notRequested.is_open());
+
+	ASSERT_TRUE(trace.requestDump("traceRefusesDumpWhileNotRecording.json"));
+	profiler.startTick();
+	profiler.endTick();
+	trace.waitForDumps();
+	std::ifstream requested("traceRefusesDumpWhileNotRecording.json");
+	ASSERT_TRUE(requested.is_open());
+	requested.close();
+	std::remove("traceRefusesDumpWhileNotRecording.json");
+}
+
+TEST_CASE(physicsThreadTracesTicks) {
+	WorldPrototype world(0.005);
+	UpgradeableMutex worldMutex;
+	Part ground(boxShape(10.0, 1.0, 10.0), GlobalCFrame(0.0, 0.0, 0.0), PartProperties{1.0, 0.7, 0.3});
+	world.addTerrainPart(&ground);
+
+	PhysicsThread physicsThread(&world, &worldMutex, std::chrono::milliseconds(1000), 1);
+	physicsTrace.clear();
+	physicsThread.traceTicks(std::chrono::milliseconds(0), "physicsThreadTracesTicks_");
+	physicsThread.runTick();
+	physicsThread.runTick();
+	physicsThread.stopTracingTicks();
+
+	ASSERT_TRUE(physicsTrace.size() == 2);
+	// the ground has trunks, but none are allocated while it lies still
+	const TickTimeline& timeline = physicsTrace.getTimeline(1);
+	ASSERT_TRUE(timeline.counters[static_cast<std::size_t>(PhysicsCounter::TRUNK_ALLOCATIONS)] == 0);
+	ASSERT_FALSE(physicsTrace.isRecording());
+	physicsTrace.clear();
+}
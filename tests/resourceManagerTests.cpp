@@ -0,0 +1,151 @@
+#include "testsMain.h"
+
+#include "../util/resource/resourceManager.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+class TextResource;
+
+class TextAllocator : public ResourceAllocator<TextResource> {
+public:
+	virtual TextResource* load(const std::string& name, const std::string& path) override;
+	virtual std::function<TextResource*()> decode(const std::string& name, const std::string& path) override;
+};
+
+class TextResource : public Resource {
+public:
+	DEFINE_RESOURCE(None, "resourceManagerTests_default.txt");
+
+	std::string text;
+	static int closeCount;
+
+	TextResource(const std::string& name, const std::string& path, const std::string& text) : Resource(name, path), text(text) {}
+
+	virtual void close() override {
+		closeCount++;
+	}
+
+	static TextAllocator getAllocator() {
+		return TextAllocator();
+	}
+};
+
+int TextResource::closeCount = 0;
+
+static bool readText(const std::string& path, std::string& text) {
+	std::ifstream file(path);
+	if (!file.is_open())
+		return false;
+
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	text = buffer.str();
+	return true;
+}
+
+static void writeText(const std::string& path, const std::string& text) {
+	std::ofstream file(path);
+	file << text;
+}
+
+TextResource* TextAllocator::load(const std::string& name, const std::string& path) {
+	std::string text;
+	if (!readText(path, text))
+		return nullptr;
+
+	return new TextResource(name, path, text);
+}
+
+// A file containing "throw" fails while finishing on the main thread, like a failing GPU upload
+std::function<TextResource*()> TextAllocator::decode(const std::string& name, const std::string& path) {
+	std::string text;
+	bool found = readText(path, text);
+
+	return [name, path, text, found] () -> TextResource* {
+		if (!found)
+			return nullptr;
+		if (text == "throw")
+			throw std::runtime_error("upload failed");
+
+		return new TextResource(name, path, text);
+	};
+}
+
+TEST_CASE(asyncLoadFinishesOnUpdate) {
+	writeText("asyncLoadFinishesOnUpdate.txt", "loaded");
+
+	ResourceHandle<TextResource> handle = ResourceManager::addAsync<TextResource>("asyncLoadFinishesOnUpdate", "asyncLoadFinishesOnUpdate.txt");
+	// the value is only installed by update on this thread
+	ASSERT_TRUE(handle.isLoading());
+
+	TextResource* resource = ResourceManager::wait(handle);
+	ASSERT_TRUE(handle.isReady());
+	ASSERT_TRUE(resource != nullptr);
+	ASSERT_TRUE(resource->text == "loaded");
+	ASSERT_TRUE(ResourceManager::get<TextResource>("asyncLoadFinishesOnUpdate") == resource);
+
+	ResourceHandle<TextResource> second = ResourceManager::addAsync<TextResource>("asyncLoadFinishesOnUpdate", "asyncLoadFinishesOnUpdate.txt");
+	ASSERT_TRUE(second.get() == resource);
+
+	ResourceManager::close();
+	std::remove("asyncLoadFinishesOnUpdate.txt");
+}
+
+TEST_CASE(reloadKeepsOldValuesAlive) {
+	writeText("reloadKeepsOldValuesAlive.txt", "first");
+
+	ResourceHandle<TextResource> handle = ResourceManager::addAsync<TextResource>("reloadKeepsOldValuesAlive", "reloadKeepsOldValuesAlive.txt");
+	TextResource* first = ResourceManager::wait(handle);
+	unsigned int generation = handle.getGeneration();
+
+	writeText("reloadKeepsOldValuesAlive.txt", "second");
+	ResourceManager::reload("reloadKeepsOldValuesAlive");
+	ASSERT_TRUE(handle.get() == first);
+	ResourceManager::waitForAll();
+
+	ASSERT_TRUE(handle.getGeneration() == generation + 1);
+	ASSERT_TRUE(handle->text == "second");
+	ASSERT_TRUE(ResourceManager::get<TextResource>("reloadKeepsOldValuesAlive") == handle.get());
+	// a pointer taken before the reload still points to the old value during this frame
+	ASSERT_TRUE(first->text == "first");
+
+	// the old value is deleted a few frames later, not kept until close
+	int closeCount = TextResource::closeCount;
+	for (int frame = 0; frame < 3; frame++)
+		ResourceManager::update();
+	ASSERT_TRUE(TextResource::closeCount == closeCount + 1);
+	ASSERT_TRUE(handle->text == "second");
+
+	ResourceManager::close();
+	std::remove("reloadKeepsOldValuesAlive.txt");
+}
+
+TEST_CASE(failedLoadsAreReported) {
+	ResourceHandle<TextResource> missing = ResourceManager::addAsync<TextResource>("failedLoadsAreReported_missing", "failedLoadsAreReported_missing.txt");
+	writeText("failedLoadsAreReported.txt", "throw");
+	ResourceHandle<TextResource> throwing = ResourceManager::addAsync<TextResource>("failedLoadsAreReported", "failedLoadsAreReported.txt");
+	ResourceManager::waitForAll();
+
+	ASSERT_TRUE(missing.hasFailed());
+	ASSERT_TRUE(throwing.hasFailed());
+	ASSERT_FALSE(ResourceManager::exists("failedLoadsAreReported"));
+
+	// a failed reload keeps the value that was loaded before
+	writeText("failedLoadsAreReported.txt", "loaded");
+	ResourceManager::reload("failedLoadsAreReported");
+	ResourceManager::waitForAll();
+	ASSERT_TRUE(throwing.isReady());
+
+	writeText("failedLoadsAreReported.txt", "throw");
+	ResourceManager::reload("failedLoadsAreReported");
+	ResourceManager::waitForAll();
+	ASSERT_TRUE(throwing.isReady());
+	ASSERT_TRUE(throwing->text == "loaded");
+
+	ResourceManager::close();
+	std::remove("failedLoadsAreReported.txt");
+}
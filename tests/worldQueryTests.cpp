@@ -0,0 +1,325 @@
+#include "testsMain.h"
+
+#include "compare.h"
+#include "generators.h"
+
+#include <Physics3D/world.h>
+#include <Physics3D/geometry/shape.h>
+#include <Physics3D/geometry/shapeCreation.h>
+#include <Physics3D/geometry/shapeLibrary.h>
+#include <Physics3D/geometry/intersection.h>
+#include <Physics3D/geometry/genericIntersection.h>
+#include <Physics3D/geometry/shapeClass.h>
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <set>
+
+using namespace P3D;
+
+static const PartProperties basicProperties{1.0, 0.7, 0.5};
+
+// fills the world with boxes, spheres and icosahedra spread over two layers, free parts and terrain
+static void fillQueryWorld(WorldPrototype& world, std::vector<Part>& parts, std::size_t count) {
+	Shape shapes[]{boxShape(1.0, 2.0, 0.5), sphereShape(0.7), polyhedronShape(ShapeLibrary::icosahedron)};
+	world.createLayer(true, true);
+	parts.reserve(count);
+	for(std::size_t i = 0; i < count; i++) {
+		Position position(generateDouble(-20.0, 20.0), generateDouble(-20.0, 20.0), generateDouble(-20.0, 20.0));
+		parts.emplace_back(shapes[i % 3], GlobalCFrame(position, generateRotation()), basicProperties);
+		if(i % 4 == 0) {
+			world.addTerrainPart(&parts.back(), static_cast<int>(i % 2));
+		} else {
+			world.addPart(&parts.back(), static_cast<int>(i % 2));
+		}
+	}
+}
+
+static double bruteForceHitDistance(const Part& part, const Ray& ray) {
+	const GlobalCFrame& cframe = part.getCFrame();
+	double distance = part.hitbox.getIntersectionDistance(cframe.globalToLocal(ray.origin), cframe.relativeToLocal(ray.direction));
+	if(!(distance >= 0.0) || distance == std::numeric_limits<double>::max()) {
+		return std::numeric_limits<double>::infinity();
+	}
+	return distance;
+}
+
+static Ray generateQueryRay() {
+	Position origin(generateDouble(-30.0, 30.0), generateDouble(-30.0, 30.0), generateDouble(-30.0, 30.0));
+	// aim roughly at the parts so most rays hit something
+	Position target(generateDouble(-10.0, 10.0), generateDouble(-10.0, 10.0), generateDouble(-10.0, 10.0));
+	return Ray{origin, normalize(Vec3(target - origin))};
+}
+
+TEST_CASE(raycastFindsClosestPart) {
+	WorldPrototype world(0.005);
+	std::vector<Part> parts;
+	fillQueryWorld(world, parts, 300);
+
+	int hitCount = 0;
+	for(int i = 0; i < 200; i++) {
+		Ray ray = generateQueryRay();
+
+		const Part* expectedPart = nullptr;
+		double expectedDistance = std::numeric_limits<double>::infinity();
+		for(const Part& part : parts) {
+			double distance = bruteForceHitDistance(part, ray);
+			if(distance < expectedDistance) {
+				expectedDistance = distance;
+				expectedPart = &part;
+			}
+		}
+
+		std::optional<RayHit> hit = world.raycast(ray);
+		ASSERT_TRUE(hit.has_value() == (expectedPart != nullptr));
+		if(hit) {
+			hitCount++;
+			ASSERT_TRUE(hit->part == expectedPart);
+			ASSERT_TOLERANT(hit->distance == expectedDistance, 0.000001);
+		}
+	}
+	ASSERT_TRUE(hitCount > 50);
+}
+
+TEST_CASE(raycastRespectsMaxDistance) {
+	WorldPrototype world(0.005);
+	Part near(boxShape(1.0, 1.0, 1.0), GlobalCFrame(5.0, 0.0, 0.0), basicProperties);
+	Part far(boxShape(1.0, 1.0, 1.0), GlobalCFrame(10.0, 0.0, 0.0), basicProperties);
+	Part behind(boxShape(1.0, 1.0, 1.0), GlobalCFrame(-5.0, 0.0, 0.0), basicProperties);
+	world.addPart(&near);
+	world.addPart(&far);
+	world.addTerrainPart(&behind);
+
+	Ray ray{Position(0.0, 0.0, 0.0), Vec3(1.0, 0.0, 0.0)};
+	std::optional<RayHit> hit = world.raycast(ray);
+	ASSERT_TRUE(hit.has_value());
+	ASSERT_TRUE(hit->part == &near);
+	ASSERT_TOLERANT(hit->distance == 4.5, 0.000001);
+	ASSERT_TOLERANT(hit->point == Position(4.5, 0.0, 0.0), 0.000001);
+
+	ASSERT_FALSE(world.raycast(ray, 4.0).has_value());
+
+	std::vector<RayHit> allHits = world.raycastAll(ray);
+	ASSERT_STRICT(allHits.size() == 2);
+	ASSERT_TRUE(allHits[0].part == &near);
+	ASSERT_TRUE(allHits[1].part == &far);
+	ASSERT_STRICT(world.raycastAll(ray, 7.0).size() == 1);
+}
+
+TEST_CASE(raycastAllFindsEveryPart) {
+	WorldPrototype world(0.005);
+	std::vector<Part> parts;
+	fillQueryWorld(world, parts, 300);
+
+	for(int i = 0; i < 100; i++) {
+		Ray ray = generateQueryRay();
+
+		std::set<const Part*> expected;
+		for(const Part& part : parts) {
+			if(bruteForceHitDistance(part, ray) != std::numeric_limits<double>::infinity()) {
+				expected.insert(&part);
+			}
+		}
+
+		std::vector<RayHit> hits = world.raycastAll(ray);
+		ASSERT_STRICT(hits.size() == expected.size());
+		for(std::size_t h = 0; h < hits.size(); h++) {
+			ASSERT_TRUE(expected.count(hits[h].part) == 1);
+			if(h != 0) ASSERT_TRUE(hits[h - 1].distance <= hits[h].distance);
+		}
+	}
+}
+
+TEST_CASE(raycastBatchMatchesSingleRays) {
+	WorldPrototype world(0.005);
+	std::vector<Part> parts;
+	fillQueryWorld(world, parts, 300);
+
+	// more than one packet, the last one partially filled
+	std::vector<Ray> rays;
+	for(int i = 0; i < 150; i++) {
+		rays.push_back(generateQueryRay());
+	}
+
+	std::vector<std::optional<RayHit>> batch = world.raycastBatch(rays, 40.0);
+	ASSERT_STRICT(batch.size() == rays.size());
+	for(std::size_t i = 0; i < rays.size(); i++) {
+		std::optional<RayHit> single = world.raycast(rays[i], 40.0);
+		ASSERT_TRUE(batch[i].has_value() == single.has_value());
+		if(single) {
+			ASSERT_TRUE(batch[i]->part == single->part);
+			ASSERT_STRICT(batch[i]->distance == single->distance);
+		}
+	}
+}
+
+TEST_CASE(overlapQueriesMatchBruteForce) {
+	WorldPrototype world(0.005);
+	std::vector<Part> parts;
+	fillQueryWorld(world, parts, 300);
+
+	for(int i = 0; i < 50; i++) {
+		Position center(generateDouble(-20.0, 20.0), generateDouble(-20.0, 20.0), generateDouble(-20.0, 20.0));
+		double radius = generateDouble(0.5, 6.0);
+
+		Bounds bounds(center - Vec3(radius, radius, radius), center + Vec3(radius, radius, radius));
+		std::vector<Part*> inBounds = world.overlapBounds(bounds);
+		std::size_t expectedInBounds = 0;
+		for(const Part& part : parts) {
+			if(intersects(part.getBounds(), BoundsTemplate<float>(bounds))) expectedInBounds++;
+		}
+		ASSERT_STRICT(inBounds.size() == expectedInBounds);
+
+		Shape sphere = sphereShape(radius);
+		std::vector<Part*> inSphere = world.overlapSphere(center, radius);
+		std::set<Part*> inSphereSet(inSphere.begin(), inSphere.end());
+		ASSERT_STRICT(inSphereSet.size() == inSphere.size());
+		for(Part& part : parts) {
+			bool expected = intersectsTransformed(part.hitbox, sphere, part.getCFrame().globalToLocal(GlobalCFrame(center))).has_value();
+			ASSERT_TRUE(inSphereSet.count(&part) == (expected ? 1 : 0));
+		}
+	}
+}
+
+TEST_CASE(nearestPartsAreSortedByDistance) {
+	WorldPrototype world(0.005);
+	std::vector<Part> parts;
+	fillQueryWorld(world, parts, 300);
+
+	for(int i = 0; i < 50; i++) {
+		Position point(generateDouble(-25.0, 25.0), generateDouble(-25.0, 25.0), generateDouble(-25.0, 25.0));
+		PositionTemplate<float> floatPoint(point);
+		auto distanceToBounds = [&floatPoint](const Part& part) {
+			BoundsTemplate<float> bounds = part.getBounds();
+			float dx = std::max(std::max(bounds.min.x - floatPoint.x, floatPoint.x - bounds.max.x), 0.0f);
+			float dy = std::max(std::max(bounds.min.y - floatPoint.y, floatPoint.y - bounds.max.y), 0.0f);
+			float dz = std::max(std::max(bounds.min.z - floatPoint.z, floatPoint.z - bounds.max.z), 0.0f);
+			return dx * dx + dy * dy + dz * dz;
+		};
+
+		std::vector<float> expected;
+		for(const Part& part : parts) {
+			expected.push_back(distanceToBounds(part));
+		}
+		std::sort(expected.begin(), expected.end());
+
+		std::vector<Part*> nearest = world.nearestParts(point, 10);
+		ASSERT_STRICT(nearest.size() == 10);
+		for(std::size_t n = 0; n < nearest.size(); n++) {
+			ASSERT_STRICT(distanceToBounds(*nearest[n]) == expected[n]);
+		}
+	}
+}
+
+TEST_CASE(gjkDistanceBetweenSeparatedShapes) {
+	Shape box = boxShape(2.0, 2.0, 2.0);
+	Shape sphere = sphereShape(0.5);
+	for(int i = 0; i < 50; i++) {
+		double gap = generateDouble(0.1, 5.0);
+		CFrame relativeTransform(Vec3(0.0, 1.0 + 0.5 + gap, 0.0));
+		ColissionPair pair{*box.baseShape, *sphere.baseShape, relativeTransform, box.scale, sphere.scale};
+		GJKDistance distance = runGJKDistanceTransformed(pair, Vec3f(0.0f, 1.0f, 0.0f));
+		ASSERT_TOLERANT(distance.distance == gap, 0.001);
+		ASSERT_TOLERANT(distance.closest.originFirst.y == 1.0, 0.001);
+	}
+
+	CFrame overlapping(Vec3(0.0, 1.2, 0.0));
+	ColissionPair pair{*box.baseShape, *sphere.baseShape, overlapping, box.scale, sphere.scale};
+	ASSERT_STRICT(runGJKDistanceTransformed(pair, Vec3f(0.0f, 1.0f, 0.0f)).distance == 0.0f);
+}
+
+TEST_CASE(shapeCastFindsFirstContact) {
+	WorldPrototype world(0.005);
+	Part near(boxShape(2.0, 2.0, 2.0), GlobalCFrame(10.0, 0.0, 0.0), basicProperties);
+	Part far(boxShape(2.0, 2.0, 2.0), GlobalCFrame(20.0, 0.0, 0.0), basicProperties);
+	Part aside(boxShape(2.0, 2.0, 2.0), GlobalCFrame(5.0, 5.0, 0.0), basicProperties);
+	world.addPart(&near);
+	world.addPart(&far);
+	world.addTerrainPart(&aside);
+
+	Shape cube = boxShape(1.0, 1.0, 1.0);
+	std::optional<ShapeCastHit> hit = world.shapeCast(cube, GlobalCFrame(0.0, 0.0, 0.0), Vec3(30.0, 0.0, 0.0));
+	ASSERT_TRUE(hit.has_value());
+	ASSERT_TRUE(hit->part == &near);
+	// the cube touches the near box once it has moved 10 - 1 - 0.5
+	ASSERT_TOLERANT(hit->fraction * 30.0 == 8.5, 0.002);
+	ASSERT_TOLERANT(hit->normal == Vec3(-1.0, 0.0, 0.0), 0.001);
+	ASSERT_TOLERANT(static_cast<double>(hit->point.x) == 9.0, 0.002);
+
+	ASSERT_FALSE(world.shapeCast(cube, GlobalCFrame(0.0, 0.0, 0.0), Vec3(8.0, 0.0, 0.0)).has_value());
+	ASSERT_FALSE(world.shapeCast(cube, GlobalCFrame(0.0, 0.0, 0.0), Vec3(-30.0, 0.0, 0.0)).has_value());
+	ASSERT_FALSE(world.shapeCast(cube, GlobalCFrame(0.0, 0.0, 3.0), Vec3(30.0, 0.0, 0.0)).has_value());
+
+	std::optional<ShapeCastHit> skipped = world.shapeCast(cube, GlobalCFrame(0.0, 0.0, 0.0), Vec3(30.0, 0.0, 0.0), near.getMainPhysical());
+	ASSERT_TRUE(skipped.has_value());
+	ASSERT_TRUE(skipped->part == &far);
+
+	std::optional<ShapeCastHit> sphereHit = world.shapeCast(sphereShape(0.5), GlobalCFrame(5.0, 0.0, 0.0), Vec3(0.0, 10.0, 0.0));
+	ASSERT_TRUE(sphereHit.has_value());
+	ASSERT_TRUE(sphereHit->part == &aside);
+	ASSERT_TOLERANT(sphereHit->fraction * 10.0 == 3.5, 0.002);
+	ASSERT_TOLERANT(sphereHit->normal == Vec3(0.0, -1.0, 0.0), 0.001);
+
+	std::optional<ShapeCastHit> overlapping = world.shapeCast(cube, GlobalCFrame(10.5, 0.0, 0.0), Vec3(1.0, 0.0, 0.0));
+	ASSERT_TRUE(overlapping.has_value());
+	ASSERT_STRICT(overlapping->fraction == 0.0);
+}
+
+TEST_CASE(shapeCastMatchesOverlapAlongPath) {
+	WorldPrototype world(0.005);
+	std::vector<Part> parts;
+	fillQueryWorld(world, parts, 300);
+
+	Shape shapes[]{boxShape(0.5, 1.0, 0.7), sphereShape(0.4), polyhedronShape(ShapeLibrary::icosahedron.scaled(0.5f, 0.5f, 0.5f))};
+	for(int i = 0; i < 50; i++) {
+		const Shape& shape = shapes[i % 3];
+		Ray ray = generateQueryRay();
+		GlobalCFrame start(ray.origin, generateRotation());
+		Vec3 movement = ray.direction * 30.0;
+
+		std::optional<ShapeCastHit> hit = world.shapeCast(shape, start, movement);
+		double end = hit ? hit->fraction : 1.0;
+		// nothing is touched before the hit, and the hit part is touched at it
+		for(int step = 0; step < 20; step++) {
+			double fraction = end * step / 20.0 - 0.001;
+			if(fraction < 0.0) continue;
+			GlobalCFrame cframe(start.getPosition() + movement * fraction, start.getRotation());
+			ASSERT_STRICT(world.overlapShape(shape, cframe).size() == 0);
+		}
+		if(hit) {
+			GlobalCFrame touching(start.getPosition() + movement * hit->fraction, start.getRotation());
+			CFrame relativeTransform = hit->part->getCFrame().globalToLocal(touching);
+			ColissionPair pair{*hit->part->hitbox.baseShape, *shape.baseShape, relativeTransform, hit->part->hitbox.scale, shape.scale};
+			ASSERT_TRUE(runGJKDistanceTransformed(pair, relativeTransform.position).distance <= 0.002f);
+		}
+	}
+}
+
+TEST_CASE(shapeCastPassesJustPastFace) {
+	Shape walls[]{boxShape(4.0, 2.0, 4.0), polyhedronShape(ShapeLibrary::icosahedron.scaled(2.0f, 2.0f, 2.0f))};
+	Shape shapes[]{boxShape(0.5, 1.0, 0.7), sphereShape(0.4), polyhedronShape(ShapeLibrary::icosahedron.scaled(0.5f, 0.5f, 0.5f))};
+	for(int i = 0; i < 10000; i++) {
+		const Shape& wallShape = walls[i % 2];
+		const Shape& shape = shapes[(i / 2) % 3];
+		WorldPrototype world(0.005);
+		Part wall(wallShape, GlobalCFrame(generateDouble(-5.0, 5.0), generateDouble(-5.0, 5.0), generateDouble(-5.0, 5.0), generateRotation()), basicProperties);
+		world.addTerrainPart(&wall);
+
+		// the whole wall lies behind the plane of any of its faces
+		Polyhedron wallPoly = wallShape.asPolyhedron();
+		Triangle face = wallPoly.getTriangle(static_cast<int>(generateDouble(0.0, wallPoly.triangleCount - 0.001)));
+		Vec3 normal = wall.getCFrame().getRotation().localToGlobal(Vec3(normalize(wallPoly.getNormalVecOfTriangle(face))));
+		Position facePoint = wall.getCFrame().localToGlobal(Vec3(wallPoly.getVertex(face.firstIndex)));
+
+		Rotation rotation = generateRotation();
+		Vec3 localDown = rotation.globalToLocal(-normal);
+		Vec3 lowest = rotation.localToGlobal(shape.scale * Vec3(shape.baseShape->furthestInDirection(Vec3f(shape.scale * localDown))));
+		double gap = generateDouble(0.002, 0.02);
+		Position start = facePoint + normal * (gap - lowest * normal);
+
+		// sliding along the plane keeps the shape a small gap above it, the first distance is measured right next to the face
+		Vec3 tangent = normalize(generateVec3() % normal);
+		ASSERT_FALSE(world.shapeCast(shape, GlobalCFrame(start, rotation), tangent * 2.0).has_value());
+	}
+}
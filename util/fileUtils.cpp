@@ -6,6 +6,7 @@
 
 #ifdef _WIN32
 	#include <direct.h>
+	#include <errno.h>
 	#include <Windows.h>
 
 	bool Util::doesFileExist(const std::string& fileName) {
@@ -15,6 +16,31 @@
 		}
 		return false;
 	}
+
+	bool Util::createDirectory(const std::string& path) {
+		return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+	}
+
+	bool Util::replaceFile(const std::string& from, const std::string& to) {
+		// rename refuses to overwrite an existing file on Windows
+		return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+	}
+
+	long long Util::getLastWriteTime(const std::string& fileName) {
+		struct stat buffer;
+		if (stat(fileName.c_str(), &buffer) != 0)
+			return 0;
+
+		return static_cast<long long>(buffer.st_mtime);
+	}
+
+	long long Util::getFileSize(const std::string& fileName) {
+		struct _stat64 buffer;
+		if (_stat64(fileName.c_str(), &buffer) != 0)
+			return -1;
+
+		return static_cast<long long>(buffer.st_size);
+	}
 	
 	std::string Util::getFullPath(const std::string& fileName) {
 		TCHAR buf[MAX_PATH] = TEXT("");
@@ -25,6 +51,7 @@
 
 #else
 	#include <stdlib.h>
+	#include <cstdio>
 	// for some reason gcc still does not support <filesystem>
 	#if __GNUC__ >= 8
 	#include <filesystem>
@@ -38,6 +65,34 @@
 		return fs::exists(fileName);
 	}
 
+	bool Util::createDirectory(const std::string& path) {
+		std::error_code error;
+		fs::create_directory(path, error);
+		return !error;
+	}
+
+	bool Util::replaceFile(const std::string& from, const std::string& to) {
+		return std::rename(from.c_str(), to.c_str()) == 0;
+	}
+
+	long long Util::getLastWriteTime(const std::string& fileName) {
+		std::error_code error;
+		auto time = fs::last_write_time(fileName, error);
+		if (error)
+			return 0;
+
+		return static_cast<long long>(time.time_since_epoch().count());
+	}
+
+	long long Util::getFileSize(const std::string& fileName) {
+		std::error_code error;
+		auto size = fs::file_size(fileName, error);
+		if (error)
+			return -1;
+
+		return static_cast<long long>(size);
+	}
+
 	std::string Util::getFullPath(const std::string& fileName) {
 		char* path = realpath(fileName.c_str(), NULL);
 		std::string result(path);
@@ -5,6 +5,13 @@
 namespace Util {
 
 bool doesFileExist(const std::string& fileName);
+bool createDirectory(const std::string& path);
+// Moves a file to a new path, replacing the file that may already be there
+bool replaceFile(const std::string& from, const std::string& to);
+// Modification time of a file in an unspecified clock, 0 if the file does not exist
+long long getLastWriteTime(const std::string& fileName);
+// Size of a file in bytes, -1 if the file does not exist
+long long getFileSize(const std::string& fileName);
 void warnIfFileExists(const std::string& fileName);
 std::string parseFile(const std::string& path);
 std::string getFullPath(const std::string& filename);
@@ -0,0 +1,190 @@
+#include "mappedFile.h"
+
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+namespace Util {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return;
+	}
+
+	this->fileHandle = file;
+	this->size = static_cast<std::size_t>(fileSize.QuadPart);
+	this->opened = true;
+
+	// Empty files cannot be mapped, they are represented as an open file without data
+	if (this->size == 0)
+		return;
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL) {
+		close();
+		return;
+	}
+
+	this->mappingHandle = mapping;
+	this->data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (this->data == nullptr)
+		close();
+}
+
+void MappedFile::close() {
+	if (data != nullptr)
+		UnmapViewOfFile(data);
+	if (mappingHandle != nullptr)
+		CloseHandle(mappingHandle);
+	if (fileHandle != nullptr)
+		CloseHandle(fileHandle);
+
+	data = nullptr;
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+	size = 0;
+	opened = false;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+	data(std::exchange(other.data, nullptr)),
+	size(std::exchange(other.size, 0)),
+	opened(std::exchange(other.opened, false)),
+	fileHandle(std::exchange(other.fileHandle, nullptr)),
+	mappingHandle(std::exchange(other.mappingHandle, nullptr)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		close();
+		data = std::exchange(other.data, nullptr);
+		size = std::exchange(other.size, 0);
+		opened = std::exchange(other.opened, false);
+		fileHandle = std::exchange(other.fileHandle, nullptr);
+		mappingHandle = std::exchange(other.mappingHandle, nullptr);
+	}
+
+	return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return;
+
+	struct stat status;
+	if (fstat(file, &status) != 0) {
+		::close(file);
+		return;
+	}
+
+	this->size = static_cast<std::size_t>(status.st_size);
+	this->opened = true;
+
+	// Empty files cannot be mapped, they are represented as an open file without data
+	if (this->size != 0) {
+		void* mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapping == MAP_FAILED) {
+			this->size = 0;
+			this->opened = false;
+		} else {
+			madvise(mapping, this->size, MADV_SEQUENTIAL);
+			this->data = static_cast<const char*>(mapping);
+		}
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	::close(file);
+}
+
+void MappedFile::close() {
+	if (data != nullptr)
+		munmap(const_cast<char*>(data), size);
+
+	data = nullptr;
+	size = 0;
+	opened = false;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+	data(std::exchange(other.data, nullptr)),
+	size(std::exchange(other.size, 0)),
+	opened(std::exchange(other.opened, false)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		close();
+		data = std::exchange(other.data, nullptr);
+		size = std::exchange(other.size, 0);
+		opened = std::exchange(other.opened, false);
+	}
+
+	return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+static inline uint64_t mix(uint64_t value) {
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdULL;
+	value ^= value >> 33;
+	value *= 0xc4ceb9fe1a85ec53ULL;
+	value ^= value >> 33;
+	return value;
+}
+
+uint64_t hashBytes(const void* data, std::size_t size, uint64_t seed) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint64_t hash = mix(seed ^ (size * 0x9e3779b97f4a7c15ULL));
+
+	// Four independent lanes keep the multiplications from serializing on large inputs
+	uint64_t lanes[4] { hash, hash + 1, hash + 2, hash + 3 };
+	std::size_t index = 0;
+	for (; index + 32 <= size; index += 32) {
+		for (int lane = 0; lane < 4; lane++) {
+			uint64_t word;
+			std::memcpy(&word, bytes + index + lane * 8, 8);
+			lanes[lane] = (lanes[lane] ^ word) * 0x9e3779b97f4a7c15ULL;
+			lanes[lane] ^= lanes[lane] >> 29;
+		}
+	}
+
+	for (int lane = 0; lane < 4; lane++)
+		hash = mix(hash ^ lanes[lane]);
+
+	for (; index + 8 <= size; index += 8) {
+		uint64_t word;
+		std::memcpy(&word, bytes + index, 8);
+		hash = mix(hash ^ word);
+	}
+
+	uint64_t tail = 0;
+	for (std::size_t shift = 0; index < size; index++, shift += 8)
+		tail |= static_cast<uint64_t>(bytes[index]) << shift;
+
+	return mix(hash ^ tail);
+}
+
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace Util {
+
+/*
+	Read-only view of a whole file, memory mapped where the platform allows it
+*/
+class MappedFile {
+	const char* data = nullptr;
+	std::size_t size = 0;
+	bool opened = false;
+
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+
+	void close();
+
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool isOpen() const { return opened; }
+	std::size_t getSize() const { return size; }
+	const char* begin() const { return data; }
+	const char* end() const { return data + size; }
+};
+
+// 64 bit non-cryptographic hash over a byte range, stable across platforms and runs
+uint64_t hashBytes(const void* data, std::size_t size, uint64_t seed = 0);
+
+};
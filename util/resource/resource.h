@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <functional>
 
 class ResourceManager;
 
@@ -16,6 +17,14 @@ protected:
 
 public:
 	virtual T* load(const std::string& name, const std::string& path) = 0;
+
+	// Asynchronous loads call this on a loader thread, it may only read files and decode them. The returned function finishes
+	// the resource on the main thread, where GPU uploads are allowed. By default the whole load is deferred to the main thread.
+	virtual std::function<T*()> decode(const std::string& name, const std::string& path) {
+		return [name, path] () -> T* {
+			return T::getAllocator().load(name, path);
+		};
+	}
 };
 
 #pragma endregion
@@ -43,6 +52,8 @@ protected:
 	Resource(const std::string& name, const std::string& path);
 
 public:
+	virtual ~Resource() = default;
+
 	virtual ResourceType getType() const = 0;
 	virtual std::string getTypeName() const = 0;
 	virtual void close() = 0;
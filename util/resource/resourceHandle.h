@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "resource.h"
+
+enum class ResourceState {
+	Loading,
+	Ready,
+	Failed
+};
+
+// Shared by all handles to a resource, the value is replaced in place when the resource is reloaded. Only accessed from the main thread.
+struct ResourceSlot {
+	std::string name;
+	std::string path;
+
+	Resource* value = nullptr;
+	ResourceState state = ResourceState::Loading;
+
+	// Incremented every time a new value is installed
+	unsigned int generation = 0;
+
+	// Whether the resource manager loaded this value and may reload and delete it
+	bool owned = false;
+	long long lastWriteTime = 0;
+	void (*reload)(const std::shared_ptr<ResourceSlot>&) = nullptr;
+};
+
+//! ResourceHandle
+template<typename T>
+class ResourceHandle {
+private:
+	std::shared_ptr<ResourceSlot> slot;
+
+public:
+	ResourceHandle() = default;
+	explicit ResourceHandle(std::shared_ptr<ResourceSlot> slot) : slot(std::move(slot)) {}
+
+	bool isReady() const {
+		return slot != nullptr && slot->state == ResourceState::Ready;
+	}
+
+	bool isLoading() const {
+		return slot != nullptr && slot->state == ResourceState::Loading;
+	}
+
+	bool hasFailed() const {
+		return slot != nullptr && slot->state == ResourceState::Failed;
+	}
+
+	unsigned int getGeneration() const {
+		return slot != nullptr ? slot->generation : 0;
+	}
+
+	// Returns the loaded resource, the previous value while reloading, or the default resource of this type while nothing has been loaded yet
+	T* get() const;
+
+	T* operator->() const {
+		return get();
+	}
+
+	T& operator*() const {
+		return *get();
+	}
+
+	explicit operator bool() const {
+		return slot != nullptr;
+	}
+};
@@ -1,7 +1,26 @@
 #include "resourceManager.h"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 std::unordered_map<ResourceType, Resource*> ResourceManager::defaultResources = {};
 std::unordered_map<std::string, ResourceManager::CountedResource> ResourceManager::resources = {};
+std::unordered_map<std::string, std::shared_ptr<ResourceSlot>> ResourceManager::slots = {};
+std::vector<ResourceManager::RetiredResource> ResourceManager::retired = {};
+std::size_t ResourceManager::updateCount = 0;
+ResourceWorkers ResourceManager::workers;
+bool ResourceManager::hotReload = false;
+long long ResourceManager::lastChangeCheck = 0;
+
+// Time between two checks for changed files when hot reloading
+constexpr long long CHANGE_CHECK_INTERVAL_MS = 500;
+
+// Updates a value replaced by a reload is kept alive for, so pointers taken earlier in the frame stay valid
+constexpr std::size_t RETIRED_RESOURCE_UPDATES = 2;
+
+// Loading is mostly bound by disk access and decoding, a few threads are enough to keep it busy
+constexpr unsigned int MAX_LOADER_THREADS = 4;
 
 ResourceManager::ResourceManager() {
 
@@ -9,4 +28,116 @@ ResourceManager::ResourceManager() {
 
 ResourceManager::~ResourceManager() {
 	ResourceManager::close();
-}
\ No newline at end of file
+}
+
+void ResourceManager::startWorkers() {
+	if (workers.isRunning())
+		return;
+
+	unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	unsigned int threadCount = std::clamp(hardwareThreads > 1 ? hardwareThreads - 1 : 1u, 1u, MAX_LOADER_THREADS);
+	workers.start(threadCount);
+}
+
+void ResourceManager::install(const std::shared_ptr<ResourceSlot>& slot, Resource* resource) {
+	if (resource == nullptr) {
+		Log::warn("Resource not loaded: (%s, %s)", slot->name.c_str(), slot->path.c_str());
+
+		// A failed reload keeps the previous value
+		slot->state = slot->value != nullptr ? ResourceState::Ready : ResourceState::Failed;
+		return;
+	}
+
+	Resource* previous = slot->value;
+	slot->value = resource;
+	slot->state = ResourceState::Ready;
+	slot->generation++;
+
+	// The slot may have been renamed or removed while loading
+	resource->name = slot->name;
+
+	auto iterator = ResourceManager::resources.find(slot->name);
+	if (iterator == ResourceManager::resources.end()) {
+		CountedResource countedResource = { resource, 1 };
+		ResourceManager::resources.emplace(slot->name, countedResource);
+	} else {
+		iterator->second.value = resource;
+	}
+
+	// Whoever still holds the previous value keeps using it for a few more updates
+	if (previous != nullptr && previous != resource)
+		retired.push_back(RetiredResource { previous, updateCount });
+}
+
+void ResourceManager::releaseRetired(bool all) {
+	auto isReleased = [all] (const RetiredResource& entry) {
+		return all || updateCount - entry.retiredAt >= RETIRED_RESOURCE_UPDATES;
+	};
+
+	for (const RetiredResource& entry : retired) {
+		if (isReleased(entry)) {
+			entry.value->close();
+			delete entry.value;
+		}
+	}
+	retired.erase(std::remove_if(retired.begin(), retired.end(), isReleased), retired.end());
+}
+
+std::size_t ResourceManager::update() {
+	updateCount++;
+	releaseRetired(false);
+
+	return finishLoads();
+}
+
+std::size_t ResourceManager::finishLoads() {
+	std::size_t finished = workers.runPosted();
+
+	if (hotReload) {
+		long long now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		if (now - lastChangeCheck >= CHANGE_CHECK_INTERVAL_MS) {
+			lastChangeCheck = now;
+			checkForChanges();
+		}
+	}
+
+	return finished;
+}
+
+void ResourceManager::waitForAll() {
+	auto isLoading = [] (const auto& entry) {
+		return entry.second->state == ResourceState::Loading;
+	};
+
+	while (std::any_of(slots.begin(), slots.end(), isLoading)) {
+		workers.waitForPosted();
+		finishLoads();
+	}
+}
+
+void ResourceManager::reload(const std::string& name) {
+	auto iterator = ResourceManager::slots.find(name);
+	if (iterator == ResourceManager::slots.end()) {
+		Log::warn("Resource can not be reloaded, it was not loaded asynchronously (%s)", name.c_str());
+		return;
+	}
+
+	const std::shared_ptr<ResourceSlot>& slot = iterator->second;
+	if (!slot->owned || slot->state == ResourceState::Loading)
+		return;
+
+	slot->reload(slot);
+}
+
+void ResourceManager::checkForChanges() {
+	for (auto& [name, slot] : slots) {
+		if (!slot->owned || slot->state == ResourceState::Loading)
+			continue;
+
+		long long lastWriteTime = Util::getLastWriteTime(slot->path);
+		if (lastWriteTime != 0 && lastWriteTime != slot->lastWriteTime) {
+			Log::info("Reloading changed resource (%s, %s)", name.c_str(), slot->path.c_str());
+			slot->reload(slot);
+		}
+	}
+}
@@ -1,13 +1,18 @@
 #pragma once
 
 #include "../log.h"
+#include "../fileUtils.h"
 
 #include <typeinfo>
 #include <unordered_map>
 #include <map>
 #include <vector>
+#include <memory>
+#include <exception>
 
 #include "resource.h"
+#include "resourceHandle.h"
+#include "resourceWorkers.h"
 
 class ResourceManager {
 	friend Resource;
@@ -21,6 +26,56 @@ private:
 	static std::unordered_map<ResourceType, Resource*> defaultResources;
 	static std::unordered_map<std::string, CountedResource> resources;
 
+	// Asynchronously loaded resources, accessed from the main thread only
+	static std::unordered_map<std::string, std::shared_ptr<ResourceSlot>> slots;
+
+	struct RetiredResource {
+		Resource* value;
+		std::size_t retiredAt;
+	};
+
+	// Values replaced by a reload, pointers to them may still be held during the frame so they are deleted a few updates later
+	static std::vector<RetiredResource> retired;
+	static std::size_t updateCount;
+	static ResourceWorkers workers;
+	static bool hotReload;
+	static long long lastChangeCheck;
+
+	static void startWorkers();
+	static void releaseRetired(bool all);
+	static std::size_t finishLoads();
+	static void install(const std::shared_ptr<ResourceSlot>& slot, Resource* resource);
+
+	template<typename T>
+	static void scheduleLoad(const std::shared_ptr<ResourceSlot>& slot) {
+		startWorkers();
+
+		slot->state = ResourceState::Loading;
+		slot->lastWriteTime = Util::getLastWriteTime(slot->path);
+
+		workers.submit([slot, name = slot->name, path = slot->path] () {
+			std::function<T*()> finish;
+			try {
+				finish = T::getAllocator().decode(name, path);
+			} catch (const std::exception& error) {
+				Log::error("Failed to decode resource (%s, %s): %s", name.c_str(), path.c_str(), error.what());
+			}
+
+			workers.post([slot, finish = std::move(finish)] () {
+				T* resource = nullptr;
+				if (finish) {
+					try {
+						resource = finish();
+					} catch (const std::exception& error) {
+						Log::error("Failed to load resource (%s, %s): %s", slot->name.c_str(), slot->path.c_str(), error.what());
+					}
+				}
+
+				install(slot, resource);
+			});
+		});
+	}
+
 	static void onResourceNameChange(Resource* changedResource, const std::string& newName) {
 		auto iterator = ResourceManager::resources.find(changedResource->getName());
 
@@ -36,6 +91,14 @@ private:
 				countedResource.value->name = newName;
 				ResourceManager::resources.emplace(newName, countedResource);
 				ResourceManager::resources.erase(iterator);
+
+				auto slotIterator = ResourceManager::slots.find(changedResource->getName());
+				if (slotIterator != ResourceManager::slots.end()) {
+					std::shared_ptr<ResourceSlot> slot = slotIterator->second;
+					slot->name = newName;
+					ResourceManager::slots.erase(slotIterator);
+					ResourceManager::slots.emplace(newName, slot);
+				}
 			}
 		}
 	}
@@ -155,7 +218,90 @@ public:
 		return add<T>(path, path);
 	}
 
+	/*
+		Starts loading the resource on a loader thread and returns immediately. The resource becomes available through the handle,
+		and through get, once update has finished it on the main thread. Handles stay valid when the resource is reloaded.
+	*/
+	template<typename T, typename = std::enable_if_t<std::is_base_of<Resource, T>::value>>
+	static ResourceHandle<T> addAsync(const std::string& name, const std::string& path) {
+		auto slotIterator = ResourceManager::slots.find(name);
+		if (slotIterator != ResourceManager::slots.end()) {
+			auto iterator = ResourceManager::resources.find(name);
+			if (iterator != ResourceManager::resources.end())
+				iterator->second.count++;
+
+			return ResourceHandle<T>(slotIterator->second);
+		}
+
+		std::shared_ptr<ResourceSlot> slot = std::make_shared<ResourceSlot>();
+		slot->name = name;
+		slot->path = path;
+		ResourceManager::slots.emplace(name, slot);
+
+		auto iterator = ResourceManager::resources.find(name);
+		if (iterator != ResourceManager::resources.end()) {
+			// Already loaded synchronously, the manager does not own this value and will not reload it
+			iterator->second.count++;
+			slot->value = iterator->second.value;
+			slot->state = ResourceState::Ready;
+
+			return ResourceHandle<T>(slot);
+		}
+
+		slot->owned = true;
+		slot->reload = &ResourceManager::scheduleLoad<T>;
+		scheduleLoad<T>(slot);
+
+		return ResourceHandle<T>(slot);
+	}
+
+	template<typename T, typename = std::enable_if_t<std::is_base_of<Resource, T>::value>>
+	static ResourceHandle<T> addAsync(const std::string& path) {
+		return addAsync<T>(path, path);
+	}
+
+	/*
+		Called once per frame. Finishes asynchronous loads on the calling thread, which must own the GL context, and checks for changed files
+		when hot reloading is enabled. Values replaced by a reload are deleted once RETIRED_RESOURCE_UPDATES more updates have passed.
+	*/
+	static std::size_t update();
+
+	// Blocks until the resource has finished loading, finishing other loads in the meantime
+	template<typename T>
+	static T* wait(const ResourceHandle<T>& handle) {
+		while (handle.isLoading()) {
+			workers.waitForPosted();
+			finishLoads();
+		}
+
+		return handle.get();
+	}
+
+	// Blocks until all asynchronous loads have finished
+	static void waitForAll();
+
+	// Reloads an asynchronously loaded resource, handles keep pointing to the old value until the new one is ready.
+	// Pointers obtained before the reload keep pointing to the old value, which stays valid for the rest of the frame. Hold a handle to follow reloads.
+	static void reload(const std::string& name);
+
+	// Reloads asynchronously loaded resources whose files changed on disk, called from update when hot reloading is enabled
+	static void checkForChanges();
+
+	static void setHotReload(bool enabled) {
+		hotReload = enabled;
+	}
+
 	static void close() {
+		workers.stop();
+
+		for (auto& [name, slot] : slots) {
+			slot->value = nullptr;
+			slot->state = ResourceState::Failed;
+		}
+		slots.clear();
+
+		releaseRetired(true);
+
 		for (auto iterator : resources) {
 			iterator.second.value->close();
 		}
@@ -216,4 +362,12 @@ public:
 
 		return map;
 	}
-};
\ No newline at end of file
+};
+
+template<typename T>
+T* ResourceHandle<T>::get() const {
+	if (slot != nullptr && slot->value != nullptr)
+		return static_cast<T*>(slot->value);
+
+	return ResourceManager::getDefaultResource<T>();
+}
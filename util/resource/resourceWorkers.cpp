@@ -0,0 +1,84 @@
+#include "resourceWorkers.h"
+
+ResourceWorkers::~ResourceWorkers() {
+	stop();
+}
+
+void ResourceWorkers::start(unsigned int threadCount) {
+	if (isRunning())
+		return;
+
+	stopping = false;
+	threads.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; i++) {
+		threads.emplace_back([this] () {
+			std::unique_lock<std::mutex> lock(jobMutex);
+			while (true) {
+				jobAvailable.wait(lock, [this] () { return stopping || !jobs.empty(); });
+				if (stopping)
+					break;
+
+				std::function<void()> job = std::move(jobs.front());
+				jobs.pop_front();
+
+				lock.unlock();
+				job();
+				lock.lock();
+			}
+		});
+	}
+}
+
+void ResourceWorkers::stop() {
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		stopping = true;
+		jobs.clear();
+	}
+	jobAvailable.notify_all();
+
+	for (std::thread& thread : threads)
+		thread.join();
+	threads.clear();
+
+	std::lock_guard<std::mutex> lock(postedMutex);
+	posted.clear();
+}
+
+bool ResourceWorkers::isRunning() const {
+	return !threads.empty();
+}
+
+void ResourceWorkers::submit(std::function<void()>&& job) {
+	{
+		std::lock_guard<std::mutex> lock(jobMutex);
+		jobs.push_back(std::move(job));
+	}
+	jobAvailable.notify_one();
+}
+
+void ResourceWorkers::post(std::function<void()>&& job) {
+	{
+		std::lock_guard<std::mutex> lock(postedMutex);
+		posted.push_back(std::move(job));
+	}
+	postedAvailable.notify_all();
+}
+
+std::size_t ResourceWorkers::runPosted() {
+	std::vector<std::function<void()>> ready;
+	{
+		std::lock_guard<std::mutex> lock(postedMutex);
+		ready.swap(posted);
+	}
+
+	for (std::function<void()>& job : ready)
+		job();
+
+	return ready.size();
+}
+
+void ResourceWorkers::waitForPosted() {
+	std::unique_lock<std::mutex> lock(postedMutex);
+	postedAvailable.wait(lock, [this] () { return !posted.empty(); });
+}
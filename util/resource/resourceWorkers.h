@@ -0,0 +1,48 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*
+	Background threads for asynchronous resource loading.
+	Jobs submitted to the workers run on a loader thread, jobs posted back run on the thread calling runPosted, which is the main thread owning the GL context.
+*/
+class ResourceWorkers {
+private:
+	std::vector<std::thread> threads;
+
+	// protects jobs and stopping
+	std::mutex jobMutex;
+	std::condition_variable jobAvailable;
+	std::deque<std::function<void()>> jobs;
+	bool stopping = false;
+
+	// protects posted
+	std::mutex postedMutex;
+	std::condition_variable postedAvailable;
+	std::vector<std::function<void()>> posted;
+
+public:
+	ResourceWorkers() = default;
+	~ResourceWorkers();
+
+	ResourceWorkers(const ResourceWorkers&) = delete;
+	ResourceWorkers& operator=(const ResourceWorkers&) = delete;
+
+	void start(unsigned int threadCount);
+	void stop();
+	bool isRunning() const;
+
+	void submit(std::function<void()>&& job);
+	void post(std::function<void()>&& job);
+
+	// Runs all jobs posted so far, returns the amount of jobs that were run
+	std::size_t runPosted();
+
+	// Blocks until at least one job has been posted
+	void waitForPosted();
+};